@@ -19,6 +19,8 @@
 
 #include "azimuth/control/gameover.h"
 
+#include <string.h>
+
 #include "azimuth/constants.h"
 #include "azimuth/gui/audio.h"
 #include "azimuth/gui/event.h"
@@ -31,18 +33,24 @@
 /*===========================================================================*/
 
 az_gameover_action_t az_gameover_event_loop(void) {
-  static az_gameover_state_t state;
+  static az_gameover_state_t state, last_state;
   az_init_gameover_state(&state);
   az_change_music(&state.soundboard, AZ_MUS_TITLE);
   az_change_music_flag(&state.soundboard, 2);
 
   while (true) {
-    // Tick the state and redraw the screen.
+    // Tick the state, and redraw the screen if anything visible changed (see
+    // az_title_event_loop).
+    memcpy(&last_state, &state, sizeof(state));
     az_tick_gameover_state(&state, AZ_FRAME_TIME_SECONDS);
     az_tick_audio(&state.soundboard);
-    az_start_screen_redraw(); {
-      az_gameover_draw_screen(&state);
-    } az_finish_screen_redraw();
+    last_state.clock = state.clock;
+    if (az_idle_screen_changed(
+            memcmp(&last_state, &state, sizeof(state)) != 0)) {
+      az_start_screen_redraw(); {
+        az_gameover_draw_screen(&state);
+      } az_finish_screen_redraw();
+    }
 
     // Check if we need to return with an action.
     if (state.mode == AZ_GMODE_QUITTING) {
@@ -21,6 +21,7 @@
 
 #include <assert.h>
 #include <stdbool.h>
+#include <string.h>
 
 #include "azimuth/constants.h"
 #include "azimuth/control/util.h"
@@ -37,19 +38,25 @@
 az_paused_action_t az_paused_event_loop(
     const az_planet_t *planet, az_preferences_t *prefs,
     az_ship_t *ship) {
-  static az_paused_state_t state;
+  static az_paused_state_t state, last_state;
   az_init_paused_state(&state, planet, prefs, ship);
   az_player_t *player = &ship->player;
 
   bool prefs_changed = false;
 
   while (true) {
-    // Tick the state and redraw the screen.
+    // Tick the state, and redraw the screen if anything visible changed (see
+    // az_title_event_loop).
+    memcpy(&last_state, &state, sizeof(state));
     az_tick_paused_state(&state, AZ_FRAME_TIME_SECONDS);
     az_tick_audio(&state.soundboard);
-    az_start_screen_redraw(); {
-      az_paused_draw_screen(&state);
-    } az_finish_screen_redraw();
+    last_state.clock = state.clock;
+    if (az_idle_screen_changed(
+            memcmp(&last_state, &state, sizeof(state)) != 0)) {
+      az_start_screen_redraw(); {
+        az_paused_draw_screen(&state);
+      } az_finish_screen_redraw();
+    }
 
     // Get and process GUI events.
     az_event_t event;
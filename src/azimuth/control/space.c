@@ -23,6 +23,10 @@
 #include <stdbool.h>
 #include <stdlib.h>
 
+#include <SDL_atomic.h>
+#include <SDL_mutex.h>
+#include <SDL_thread.h>
+
 #include "azimuth/constants.h"
 #include "azimuth/control/paused.h"
 #include "azimuth/control/util.h"
@@ -33,11 +37,13 @@
 #include "azimuth/state/dialog.h"
 #include "azimuth/state/planet.h"
 #include "azimuth/state/player.h"
+#include "azimuth/state/room.h"
 #include "azimuth/state/save.h"
 #include "azimuth/state/space.h"
 #include "azimuth/tick/script.h"
 #include "azimuth/tick/space.h"
 #include "azimuth/util/misc.h"
+#include "azimuth/util/warning.h"
 #include "azimuth/view/space.h"
 
 /*===========================================================================*/
@@ -49,6 +55,131 @@ static const char save_success_paragraph[] =
 
 static az_space_state_t state;
 
+/*===========================================================================*/
+// Room prefetching:
+
+// When the planet is being read lazily, a background thread reads the contents
+// of the rooms that the current room's doors lead to, so that they're usually
+// ready by the time the ship passes through one of those doors.  As with the
+// music part cache in azimuth/gui/audio.c, each slot is handed back and forth
+// between the game thread and the prefetch thread by atomically changing its
+// state, and only the side that the state says owns a slot may change it:
+//   EMPTY -> REQUESTED: game thread, after filling in room_key
+//   REQUESTED -> READING: prefetch thread, to claim the request
+//   READING -> READY: prefetch thread, after filling in ok and contents
+//   READY -> EMPTY: game thread, after adopting (or discarding) the contents
+
+typedef enum {
+  PREFETCH_SLOT_EMPTY = 0,
+  PREFETCH_SLOT_REQUESTED,
+  PREFETCH_SLOT_READING,
+  PREFETCH_SLOT_READY
+} prefetch_slot_state_t;
+
+typedef struct {
+  SDL_atomic_t state;
+  az_room_key_t room_key;
+  bool ok;
+  az_room_t contents;
+} prefetch_slot_t;
+
+static prefetch_slot_t prefetch_slots[AZ_MAX_NUM_DOORS];
+
+// The prefetch thread is started the first time it's needed, and then runs
+// (mostly asleep) until the program exits.
+static bool prefetch_started = false;
+static SDL_Thread *prefetch_thread = NULL;
+static SDL_sem *prefetch_sem = NULL;
+
+// The room whose doors we last requested prefetches for, or -1 if none.
+static int prefetched_for_room = -1;
+
+static int prefetch_thread_main(void *data) {
+  const az_planet_t *planet = data;
+  while (true) {
+    SDL_SemWait(prefetch_sem);
+    AZ_ARRAY_LOOP(slot, prefetch_slots) {
+      if (SDL_AtomicCAS(&slot->state, PREFETCH_SLOT_REQUESTED,
+                        PREFETCH_SLOT_READING)) {
+        slot->ok =
+          az_read_room_contents(planet, slot->room_key, &slot->contents);
+        SDL_AtomicSet(&slot->state, PREFETCH_SLOT_READY);
+      }
+    }
+  }
+  return 0;
+}
+
+static void start_prefetch_thread(const az_planet_t *planet) {
+  assert(!prefetch_started);
+  prefetch_started = true;
+  prefetch_sem = SDL_CreateSemaphore(0);
+  if (prefetch_sem == NULL) {
+    AZ_FATAL("SDL_CreateSemaphore failed: %s\n", SDL_GetError());
+  }
+  // The planet lives for the rest of the program, so the thread can keep a
+  // pointer to it.
+  prefetch_thread = SDL_CreateThread(prefetch_thread_main, "az_prefetch",
+                                     (void*)planet);
+  if (prefetch_thread == NULL) {
+    AZ_WARNING_ALWAYS("Failed to start prefetch thread: %s\n",
+                      SDL_GetError());
+  }
+}
+
+// Called once per frame.  Hands any rooms that have finished prefetching over
+// to the planet, and if the ship has entered a new room since last time,
+// requests prefetches for whichever rooms its doors lead to that aren't
+// already loaded.
+static void update_room_prefetching(void) {
+  const az_planet_t *planet = state.planet;
+  if (planet->room_cache == NULL) return;
+  if (!prefetch_started) start_prefetch_thread(planet);
+  if (prefetch_thread == NULL) return;
+  // As in az_enter_room, don't evict any room whose script is still suspended
+  // in the countdown or sync VM to make room for the adopted contents.
+  const az_script_t *running_scripts[] = {
+    state.countdown.vm.script, state.sync_vm.script
+  };
+  AZ_ARRAY_LOOP(slot, prefetch_slots) {
+    if (SDL_AtomicGet(&slot->state) != PREFETCH_SLOT_READY) continue;
+    if (slot->ok) {
+      az_adopt_room_contents(planet, slot->room_key, &slot->contents,
+                             state.ship.player.current_room,
+                             AZ_ARRAY_SIZE(running_scripts), running_scripts);
+    }
+    SDL_AtomicSet(&slot->state, PREFETCH_SLOT_EMPTY);
+  }
+  const az_room_key_t room_key = state.ship.player.current_room;
+  if (room_key == prefetched_for_room) return;
+  prefetched_for_room = room_key;
+  const az_room_t *room = &planet->rooms[room_key];
+  bool any_requested = false;
+  for (int i = 0; i < room->num_doors; ++i) {
+    const az_room_key_t destination = room->doors[i].destination;
+    if (az_room_contents_loaded(planet, destination)) continue;
+    prefetch_slot_t *empty_slot = NULL;
+    bool pending = false;
+    AZ_ARRAY_LOOP(slot, prefetch_slots) {
+      if (SDL_AtomicGet(&slot->state) == PREFETCH_SLOT_EMPTY) {
+        if (empty_slot == NULL) empty_slot = slot;
+      } else if (slot->room_key == destination) {
+        pending = true;
+        break;
+      }
+    }
+    // If all the slots are busy, this room will just be read when (and if)
+    // the ship enters it.
+    if (pending || empty_slot == NULL) continue;
+    empty_slot->room_key = destination;
+    SDL_AtomicSet(&empty_slot->state, PREFETCH_SLOT_REQUESTED);
+    any_requested = true;
+  }
+  if (any_requested) SDL_SemPost(prefetch_sem);
+}
+
+/*===========================================================================*/
+
 static void position_ship_at_save_point_if_any(void) {
   const az_room_t *room = &state.planet->rooms[state.ship.player.current_room];
   state.ship.position = az_bounds_center(&room->camera_bounds);
@@ -74,6 +205,7 @@ static void begin_saved_game(
   state.prefs = prefs;
   state.save_file_index = saved_game_index;
   state.mode = AZ_MODE_NORMAL;
+  prefetched_for_room = -1;
 
   if (saved_game->present) {
     // Resume saved game:
@@ -133,6 +265,7 @@ az_space_action_t az_space_event_loop(
     }
 
     // Tick the state and redraw the screen.
+    update_room_prefetching();
     update_held_controls(prefs->key_for_control);
     az_tick_space_state(&state, AZ_FRAME_TIME_SECONDS);
     az_tick_audio(&state.soundboard);
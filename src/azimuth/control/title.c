@@ -21,6 +21,7 @@
 
 #include <assert.h>
 #include <stdbool.h>
+#include <string.h>
 
 #include "azimuth/constants.h"
 #include "azimuth/control/util.h"
@@ -54,7 +55,7 @@ static void clear_records(az_saved_games_t *saved_games) {
 az_title_action_t az_title_event_loop(
     const az_planet_t *planet, az_saved_games_t *saved_games,
     az_preferences_t *prefs, az_title_intro_t title_intro) {
-  static az_title_state_t state;
+  static az_title_state_t state, last_state;
   az_init_title_state(&state, planet, saved_games, prefs);
   if (title_intro != AZ_TI_SHOW_INTRO) {
     az_title_skip_intro(&state);
@@ -67,12 +68,19 @@ az_title_action_t az_title_event_loop(
   bool prefs_changed = false;
 
   while (true) {
-    // Tick the state and redraw the screen.
+    // Tick the state, and redraw the screen if anything visible changed.  The
+    // state changed if any of its bytes did, other than the clock (changes
+    // that only the clock drives are tracked by az_idle_screen_changed).
+    memcpy(&last_state, &state, sizeof(state));
     az_tick_title_state(&state, AZ_FRAME_TIME_SECONDS);
     az_tick_audio(&state.soundboard);
-    az_start_screen_redraw(); {
-      az_title_draw_screen(&state);
-    } az_finish_screen_redraw();
+    last_state.clock = state.clock;
+    if (az_idle_screen_changed(
+            memcmp(&last_state, &state, sizeof(state)) != 0)) {
+      az_start_screen_redraw(); {
+        az_title_draw_screen(&state);
+      } az_finish_screen_redraw();
+    }
 
     // Check if we need to return with an action.
     if (state.mode == AZ_TMODE_QUITTING) {
@@ -33,9 +33,13 @@
 
 #include "azimuth/gui/audio.h"
 #include "azimuth/state/save.h"
+#include "azimuth/state/sound.h"
+#include "azimuth/system/mapped_file.h"
+#include "azimuth/system/parallel.h"
 #include "azimuth/system/resource.h"
 #include "azimuth/util/prefs.h"
 #include "azimuth/util/string.h"
+#include "azimuth/util/warning.h"
 #include "azimuth/view/prefs.h"
 
 #define ORG_NAME ""
@@ -75,6 +79,35 @@ static char *az_get_app_data_directory(void) {
   return SDL_GetPrefPath(ORG_NAME, APP_NAME);
 }
 
+static az_mapped_file_t sound_cache;
+
+static void unmap_sound_cache(void) {
+  az_system_unmap_file(&sound_cache);
+}
+
+void az_load_sound_datas(void) {
+  char *data_dir = az_get_app_data_directory();
+  char *cache_path = NULL;
+  if (data_dir != NULL) {
+    cache_path = az_strprintf("%s/sounds.cache", data_dir);
+    SDL_free(data_dir);
+    az_system_map_file(cache_path, &sound_cache);
+  }
+  // The sound data may end up pointing into the mapped cache, so make sure we
+  // don't unmap it until after the sound data has been destroyed.
+  atexit(unmap_sound_cache);
+  if (!az_init_sound_datas(sound_cache.contents, sound_cache.size,
+                           &az_system_parallel_for)) {
+    // Some sounds were missing from the cache (or it didn't exist), so
+    // nothing uses the old cache anymore; replace it with a fresh one.
+    az_system_unmap_file(&sound_cache);
+    if (cache_path != NULL && !az_save_sound_datas_cache(cache_path)) {
+      AZ_WARNING_ONCE("Failed to save sound cache to %s\n", cache_path);
+    }
+  }
+  free(cache_path);
+}
+
 void az_load_preferences(az_preferences_t *prefs) {
   assert(prefs != NULL);
   char *data_dir = az_get_app_data_directory();
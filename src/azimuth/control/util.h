@@ -30,6 +30,10 @@
 
 /*===========================================================================*/
 
+// Initialize sound data for all sound keys, using the sound cache file in the
+// user's data directory if it's up to date, and (re)writing it if not.
+void az_load_sound_datas(void);
+
 void az_load_preferences(az_preferences_t *prefs);
 bool az_save_preferences(const az_preferences_t *prefs);
 
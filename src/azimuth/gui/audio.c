@@ -20,8 +20,11 @@
 #include "azimuth/gui/audio.h"
 
 #include <assert.h>
+#include <limits.h>
 #include <stdbool.h>
 #include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
 
 #include <SDL.h>
 
@@ -35,24 +38,315 @@
 /*===========================================================================*/
 // Constants:
 
-// We use 16-bit mono at 22050 samples/sec and a buffer size of 1024 samples.
+// We use 16-bit mono, at whatever sample rate the device natively runs at (so
+// that the OS doesn't have to resample our output), or this rate if we can't
+// tell what that is:
 #define AUDIO_FORMAT AUDIO_S16SYS
 #define AUDIO_CHANNELS 1
-AZ_STATIC_ASSERT(AZ_AUDIO_RATE == 22050);
-#define AUDIO_BUFFERSIZE 1024
+#define DEFAULT_OUTPUT_RATE 48000
+// We ask for the smallest power-of-two buffer size that lasts at least this
+// long (e.g. 512 samples at 44.1 or 48 kHz), which keeps latency low while
+// leaving the callback plenty of time to fill each buffer:
+#define MIN_BUFFER_MSEC 10
 
 // Values controlling global_music_volume and global_sound_volume:
 #define VOLUME_SHIFT 8
 #define MAX_VOLUME (1 << VOLUME_SHIFT)
-// How many sound effects we can play simultaneously:
-#define MAX_SIMULTANEOUS_SOUNDS 16
+// How many sound effects we can play simultaneously (the size of the voice
+// pool).  Idle voices cost nothing to mix, so this can be generous:
+#define MAX_SIMULTANEOUS_SOUNDS 48
+// How many samples we mix at a time (the size of the mixing accumulator):
+#define MIX_BLOCK_SIZE 512
+// How many commands the game thread can queue up for the audio callback.  The
+// game sends at most a couple dozen commands per frame, and the callback
+// drains the queue once per buffer (every frame or so), so this leaves plenty
+// of slack.  This must be a power of two.
+#define COMMAND_QUEUE_SIZE 1024
+AZ_STATIC_ASSERT((COMMAND_QUEUE_SIZE & (COMMAND_QUEUE_SIZE - 1)) == 0);
+// How many pre-rendered music parts we can hold onto at once.  This is more
+// than any one piece of music needs (and parts from other music are freed as
+// soon as the music changes).
+#define MAX_CACHED_MUSIC_PARTS 64
+
+/*===========================================================================*/
+// Command queue:
+
+// The game thread never touches the audio state directly; instead, it sends
+// commands to the audio callback through a single-producer/single-consumer
+// ring buffer, which the callback drains at the start of each buffer.  Neither
+// side ever takes a lock, so the game thread never waits for mixing to finish
+// and the callback never waits for the game thread.
+
+typedef enum {
+  AUDIO_CMD_SET_MUSIC_VOLUME,
+  AUDIO_CMD_SET_SOUND_VOLUME,
+  AUDIO_CMD_CHANGE_MUSIC,
+  // The persisted sounds for a frame are sent as a BEGIN_PERSISTS command,
+  // then a PERSIST command for each sound, then an END_PERSISTS command; any
+  // persisted sound that wasn't mentioned in between gets halted.
+  AUDIO_CMD_BEGIN_PERSISTS,
+  AUDIO_CMD_PERSIST,
+  AUDIO_CMD_END_PERSISTS,
+  AUDIO_CMD_PLAY_SOUND,
+  AUDIO_CMD_PLAY_STREAM
+} audio_command_kind_t;
+
+typedef struct {
+  audio_command_kind_t kind;
+  union {
+    int volume; // for SET_MUSIC_VOLUME and SET_SOUND_VOLUME
+    struct {
+      bool change_music, change_current_flag, change_next_flag;
+      int current_flag, next_flag;
+      const az_music_t *next_music;
+      double fade_out_seconds;
+    } music; // for CHANGE_MUSIC
+    struct {
+      const az_sound_data_t *data;
+      int volume; // 0 to MAX_VOLUME
+      bool play, loop, reset;
+    } sound; // for PERSIST and PLAY_SOUND
+    struct {
+      az_sound_stream_t *stream; // NULL to stop the current stream
+      int volume; // 0 to MAX_VOLUME
+    } stream; // for PLAY_STREAM
+  } arg;
+} audio_command_t;
+
+static struct {
+  audio_command_t commands[COMMAND_QUEUE_SIZE];
+  // The index of the next command to be pushed; only the game thread writes
+  // this.  The queue is full when head is just behind tail.
+  SDL_atomic_t head;
+  // The index of the next command to be popped (that is, one past the last
+  // command the callback has finished executing); only the audio callback
+  // writes this, and only once it has executed every command before it.  The
+  // queue is empty when tail == head.
+  SDL_atomic_t tail;
+} command_queue;
+
+// Sound streams that the callback is done with go back to the game thread
+// through a second ring buffer, running the other way, so that the callback
+// never has to free memory.  Each stream passes through the command queue
+// before it can be retired, so this needs no more room than that does.
+static struct {
+  az_sound_stream_t *streams[COMMAND_QUEUE_SIZE];
+  // The index of the next stream to be pushed; only the callback writes this.
+  SDL_atomic_t head;
+  // The index of the next stream to be popped; only the game thread writes
+  // this.
+  SDL_atomic_t tail;
+} retired_streams;
+
+// Called only from the audio callback.
+static void retire_stream(az_sound_stream_t *stream) {
+  const int head = SDL_AtomicGet(&retired_streams.head);
+  const int next_head = (head + 1) & (COMMAND_QUEUE_SIZE - 1);
+  if (next_head == SDL_AtomicGet(&retired_streams.tail)) {
+    AZ_WARNING_ONCE("Retired sound stream queue is full\n");
+    return; // leak the stream, rather than free it here
+  }
+  retired_streams.streams[head] = stream;
+  SDL_AtomicSet(&retired_streams.head, next_head);
+}
+
+// Called only from the game thread.
+static void delete_retired_streams(void) {
+  const int head = SDL_AtomicGet(&retired_streams.head);
+  int tail = SDL_AtomicGet(&retired_streams.tail);
+  while (tail != head) {
+    az_delete_sound_stream(retired_streams.streams[tail]);
+    tail = (tail + 1) & (COMMAND_QUEUE_SIZE - 1);
+  }
+  SDL_AtomicSet(&retired_streams.tail, tail);
+}
+
+/*===========================================================================*/
+// Output rate:
+
+// The device's sample rate, and how far to step through sound data (which is
+// always at AZ_AUDIO_RATE) per output sample.  These are set before the
+// callback first runs (and so before the music part cache is first used),
+// and never change after that.
+static int output_rate = AZ_AUDIO_RATE;
+static uint64_t sound_step = UINT64_C(1) << AZ_RESAMPLE_FRAC_BITS;
+
+/*===========================================================================*/
+// Music part cache:
+
+// Rather than synthesizing all the music live in the audio callback, we have
+// a background thread render each part of the current music to PCM the first
+// time the synth starts that part (with a given set of voice settings), so
+// that each time the music loops back around to it, the callback need only
+// copy samples.  The first time through a part is still synthesized live.
+//
+// Each slot is handed back and forth between the audio callback and the cache
+// thread by atomically changing its state, and only the side that the state
+// says owns a slot may change it:
+//   EMPTY -> REQUESTED: callback, after filling in the key fields
+//   REQUESTED -> RENDERING: cache thread, to claim the request
+//   REQUESTED -> EMPTY: callback, to cancel a request for old music
+//   RENDERING -> READY: cache thread, after filling in the samples
+//   READY -> RETIRED: callback, once it won't use the samples again
+//   RETIRED -> EMPTY: cache thread, after freeing the samples
+// The key fields (music, part_index, and entry_settings) don't change from
+// REQUESTED until EMPTY, so the callback may read them in any of those states.
+
+typedef enum {
+  PART_SLOT_EMPTY = 0,
+  PART_SLOT_REQUESTED,
+  PART_SLOT_RENDERING,
+  PART_SLOT_READY,
+  PART_SLOT_RETIRED
+} part_slot_state_t;
+
+typedef struct {
+  SDL_atomic_t state;
+  az_music_part_pcm_t pcm;
+} part_slot_t;
+
+static part_slot_t part_slots[MAX_CACHED_MUSIC_PARTS];
+
+static SDL_Thread *part_cache_thread = NULL;
+static SDL_sem *part_cache_sem = NULL;
+static SDL_atomic_t part_cache_quit;
+
+static int part_cache_thread_main(void *data) {
+  (void)data;
+  while (true) {
+    SDL_SemWait(part_cache_sem);
+    if (SDL_AtomicGet(&part_cache_quit)) break;
+    AZ_ARRAY_LOOP(slot, part_slots) {
+      if (SDL_AtomicGet(&slot->state) == PART_SLOT_RETIRED) {
+        free(slot->pcm.samples);
+        slot->pcm.samples = NULL;
+        slot->pcm.num_samples = 0;
+        SDL_AtomicSet(&slot->state, PART_SLOT_EMPTY);
+      } else if (SDL_AtomicCAS(&slot->state, PART_SLOT_REQUESTED,
+                               PART_SLOT_RENDERING)) {
+        // Render into a separate struct, so that we don't write to the key
+        // fields while the callback may be reading them.
+        az_music_part_pcm_t pcm;
+        az_render_music_part(slot->pcm.music, slot->pcm.part_index,
+                             slot->pcm.entry_settings, output_rate, &pcm);
+        slot->pcm.num_samples = pcm.num_samples;
+        slot->pcm.samples = pcm.samples;
+        for (int i = 0; i < AZ_MUSIC_NUM_TRACKS; ++i) {
+          slot->pcm.exit_settings[i] = pcm.exit_settings[i];
+        }
+        SDL_AtomicSet(&slot->state, PART_SLOT_READY);
+      }
+    }
+  }
+  return 0;
+}
+
+static bool voice_settings_equal(const az_music_voice_settings_t *settings1,
+                                 const az_music_voice_settings_t *settings2) {
+  for (int i = 0; i < AZ_MUSIC_NUM_TRACKS; ++i) {
+    const az_music_voice_settings_t *s1 = &settings1[i];
+    const az_music_voice_settings_t *s2 = &settings2[i];
+    if (s1->waveform != s2->waveform || s1->duty != s2->duty ||
+        s1->loudness != s2->loudness || s1->attack_time != s2->attack_time ||
+        s1->decay_fraction != s2->decay_fraction ||
+        s1->dutymod_depth != s2->dutymod_depth ||
+        s1->dutymod_speed != s2->dutymod_speed ||
+        s1->vibrato_depth != s2->vibrato_depth ||
+        s1->vibrato_speed != s2->vibrato_speed) return false;
+  }
+  return true;
+}
+
+// Called only from the audio callback (via az_synthesize_music).  Returns the
+// pre-rendered PCM for the part if it's ready; otherwise, requests that it be
+// rendered (unless it already has been) and returns NULL.
+static const az_music_part_pcm_t *lookup_part_pcm(
+    void *userdata, const az_music_t *music, int part_index,
+    const az_music_voice_settings_t entry_settings[AZ_MUSIC_NUM_TRACKS]) {
+  (void)userdata;
+  part_slot_t *empty_slot = NULL;
+  AZ_ARRAY_LOOP(slot, part_slots) {
+    const int state = SDL_AtomicGet(&slot->state);
+    if (state == PART_SLOT_EMPTY) {
+      if (empty_slot == NULL) empty_slot = slot;
+      continue;
+    }
+    if (state == PART_SLOT_RETIRED || slot->pcm.music != music ||
+        slot->pcm.part_index != part_index ||
+        !voice_settings_equal(slot->pcm.entry_settings, entry_settings)) {
+      continue;
+    }
+    return (state == PART_SLOT_READY ? &slot->pcm : NULL);
+  }
+  if (empty_slot != NULL) {
+    empty_slot->pcm.music = music;
+    empty_slot->pcm.part_index = part_index;
+    for (int i = 0; i < AZ_MUSIC_NUM_TRACKS; ++i) {
+      empty_slot->pcm.entry_settings[i] = entry_settings[i];
+    }
+    SDL_AtomicSet(&empty_slot->state, PART_SLOT_REQUESTED);
+    SDL_SemPost(part_cache_sem);
+  }
+  return NULL;
+}
+
+// Called only from the audio callback, whenever the music synth is reset, to
+// release any pre-rendered parts that aren't from the given music (which may
+// be NULL).
+static void retire_part_pcms(const az_music_t *music_to_keep) {
+  bool any_retired = false;
+  AZ_ARRAY_LOOP(slot, part_slots) {
+    const int state = SDL_AtomicGet(&slot->state);
+    if (state == PART_SLOT_EMPTY || state == PART_SLOT_RETIRED ||
+        slot->pcm.music == music_to_keep) continue;
+    if (state == PART_SLOT_REQUESTED) {
+      SDL_AtomicCAS(&slot->state, PART_SLOT_REQUESTED, PART_SLOT_EMPTY);
+    } else if (state == PART_SLOT_READY) {
+      SDL_AtomicSet(&slot->state, PART_SLOT_RETIRED);
+      any_retired = true;
+    }
+    // A slot that is still RENDERING will be retired the next time the music
+    // changes, or when the audio system shuts down.
+  }
+  if (any_retired) SDL_SemPost(part_cache_sem);
+}
+
+static void start_part_cache_thread(void) {
+  // The thread renders parts with az_render_music_part, which needs the
+  // wavetables to be set up already.
+  az_init_music_synth_tables();
+  part_cache_sem = SDL_CreateSemaphore(0);
+  if (part_cache_sem == NULL) {
+    AZ_FATAL("SDL_CreateSemaphore failed: %s\n", SDL_GetError());
+  }
+  part_cache_thread =
+    SDL_CreateThread(part_cache_thread_main, "az_music_cache", NULL);
+  if (part_cache_thread == NULL) {
+    AZ_FATAL("SDL_CreateThread failed: %s\n", SDL_GetError());
+  }
+}
+
+// Called at exit, after the audio device has been closed (so the callback is
+// no longer running), but before the music has been freed.
+static void stop_part_cache_thread(void) {
+  SDL_AtomicSet(&part_cache_quit, 1);
+  SDL_SemPost(part_cache_sem);
+  SDL_WaitThread(part_cache_thread, NULL);
+  part_cache_thread = NULL;
+  SDL_DestroySemaphore(part_cache_sem);
+  part_cache_sem = NULL;
+  AZ_ARRAY_LOOP(slot, part_slots) {
+    free(slot->pcm.samples);
+    AZ_ZERO_OBJECT(&slot->pcm);
+    SDL_AtomicSet(&slot->state, PART_SLOT_EMPTY);
+  }
+}
 
 /*===========================================================================*/
 // Globals:
 
-// All of these globals are protected by the SDL audio mutex.  Any reads/writes
-// outside of audio_callback() must be wrapped in calls to SDL_LockAudio() and
-// SDL_UnlockAudio().
+// All of these globals are only accessed from audio_callback(), on the audio
+// thread.  The game thread changes them by sending commands (see above).
 
 static int global_music_volume = MAX_VOLUME; // 0 to MAX_VOLUME
 static int global_sound_volume = MAX_VOLUME; // 0 to MAX_VOLUME
@@ -64,165 +358,493 @@ static int music_fade_counter = 0;
 static const az_music_t *next_music = NULL;
 static int next_music_flag = 0;
 
-static struct {
+typedef struct {
   const az_sound_data_t *data;
-  size_t sample_index;
+  uint64_t position; // see az_resample_sound
   int volume; // 0 to MAX_VOLUME
   bool loop, persisted, paused, finished;
-} active_sounds[MAX_SIMULTANEOUS_SOUNDS];
+  // True if this (persisted) sound has been mentioned since the last
+  // AUDIO_CMD_BEGIN_PERSISTS.
+  bool claimed;
+  // When this sound was started, relative to the others (for voice stealing).
+  uint32_t start_order;
+} active_sound_t;
 
-static void audio_callback(void *userdata, Uint8 *bytes, int numbytes) {
-  assert(numbytes % sizeof(int16_t) == 0);
-  const int num_samples = numbytes / sizeof(int16_t);
-  int16_t *samples = (int16_t*)bytes;
+static active_sound_t active_sounds[MAX_SIMULTANEOUS_SOUNDS];
+static uint32_t next_start_order = 0;
 
-  if (next_music != NULL && music_fade_volume == 0) {
-    az_reset_music_synth(&music_synth, next_music, next_music_flag);
-    music_fade_volume = MAX_VOLUME;
-    music_fade_slowdown = 0;
-    music_fade_counter = 0;
-    next_music = NULL;
-    next_music_flag = 0;
+// The sound stream currently playing (see az_play_sound_stream), if any.
+// This plays alongside the voice pool, rather than taking up a voice in it.
+static az_sound_stream_t *current_stream = NULL;
+static int current_stream_volume = 0; // 0 to MAX_VOLUME
+
+// These are written by the audio callback (and num_sounds_dropped also by
+// push_command), and summarized by log_callback_timing at exit.
+static SDL_atomic_t num_voices_stolen;
+static SDL_atomic_t num_sounds_dropped;
+
+// Persisted sounds that need to be started at the next AUDIO_CMD_END_PERSISTS
+// (after any unclaimed sounds have been halted, to free up their slots).
+static int num_pending_persists = 0;
+static struct {
+  const az_sound_data_t *data;
+  int volume; // 0 to MAX_VOLUME
+  bool loop;
+} pending_persists[AZ_ARRAY_SIZE(((az_soundboard_t*)NULL)->persists)];
+
+static void execute_command(const audio_command_t *command);
+
+// Execute all commands up to (but not including) the given head index.  This
+// is normally called only from the audio callback, but may also be called
+// from the game thread while the callback is paused or the device is locked.
+static void drain_commands(int head) {
+  int tail = SDL_AtomicGet(&command_queue.tail);
+  while (tail != head) {
+    execute_command(&command_queue.commands[tail]);
+    tail = (tail + 1) & (COMMAND_QUEUE_SIZE - 1);
   }
-  az_synthesize_music(&music_synth, samples, num_samples);
+  SDL_AtomicSet(&command_queue.tail, tail);
+}
 
-  for (int i = 0; i < num_samples; ++i) {
-    int sound_sample = 0;
-    AZ_ARRAY_LOOP(sound, active_sounds) {
-      if (sound->data == NULL) continue;
-      if (sound->paused || sound->finished) {
+// Add up to num_samples samples of the given active sound, scaled by its
+// volume, into the accumulator, and advance (or finish) the sound.
+static void mix_sound(active_sound_t *sound, int32_t *accum,
+                      int num_samples) {
+  assert(sound->data != NULL);
+  if (sound->paused || sound->finished) {
+    assert(sound->persisted);
+    return;
+  }
+  const az_sound_data_t *data = sound->data;
+  assert(data->num_samples > 0);
+  const uint64_t end = (uint64_t)data->num_samples << AZ_RESAMPLE_FRAC_BITS;
+  int16_t resampled[MIX_BLOCK_SIZE];
+  int offset = 0;
+  while (offset < num_samples) {
+    assert(sound->position < end);
+    // Mix in the longest contiguous span of the sound's samples that we can.
+    // If the output rate is the same as the sound's rate, we can read them
+    // straight out of the sound data; otherwise, we first resample the span
+    // into a temporary buffer.
+    int span;
+    const int16_t *restrict input;
+    if (sound_step == UINT64_C(1) << AZ_RESAMPLE_FRAC_BITS) {
+      const size_t index = sound->position >> AZ_RESAMPLE_FRAC_BITS;
+      span = az_imin(num_samples - offset,
+                     (int)(data->num_samples - index));
+      input = data->samples + index;
+      sound->position += (uint64_t)span << AZ_RESAMPLE_FRAC_BITS;
+    } else {
+      span = az_resample_sound(data, &sound->position, sound_step,
+                               resampled, num_samples - offset);
+      input = resampled;
+    }
+    assert(span > 0);
+    const int volume = sound->volume;
+    int32_t *restrict output = accum + offset;
+    for (int i = 0; i < span; ++i) {
+      output[i] += (input[i] * volume) >> VOLUME_SHIFT;
+    }
+    offset += span;
+    if (sound->position >= end) {
+      if (sound->loop) {
         assert(sound->persisted);
-        continue;
-      }
-      assert(sound->data->num_samples > 0);
-      assert(sound->sample_index < sound->data->num_samples);
-      sound_sample += (sound->data->samples[sound->sample_index] *
-                       sound->volume) >> VOLUME_SHIFT;
-      ++sound->sample_index;
-      if (sound->sample_index >= sound->data->num_samples) {
-        if (sound->loop) {
-          assert(sound->persisted);
-          sound->sample_index = 0;
-        } else if (sound->persisted) {
-          sound->finished = true;
-        } else AZ_ZERO_OBJECT(sound);
+        // Keep any fractional position, so that the loop stays in tune.
+        sound->position %= end;
+      } else {
+        if (sound->persisted) sound->finished = true;
+        else AZ_ZERO_OBJECT(sound);
+        return;
       }
     }
-    int sample = (global_music_volume * (int)samples[i]) >> VOLUME_SHIFT;
-    sample = (music_fade_volume * sample) >> VOLUME_SHIFT;
-    sample += (global_sound_volume * sound_sample) >> VOLUME_SHIFT;
-    samples[i] = az_imin(az_imax(INT16_MIN, sample), INT16_MAX);
+  }
+}
 
-    // Fade out music, if applicable:
-    if (music_fade_slowdown > 0 && music_fade_volume > 0) {
+// Synthesize up to num_samples samples of the current sound stream, and add
+// them (scaled by its volume) into the accumulator.
+static void mix_stream(int32_t *accum, int num_samples) {
+  assert(current_stream != NULL);
+  int16_t input[MIX_BLOCK_SIZE];
+  const int count =
+    az_stream_sound(current_stream, sound_step, input, num_samples);
+  const int volume = current_stream_volume;
+  for (int i = 0; i < count; ++i) {
+    accum[i] += (input[i] * volume) >> VOLUME_SHIFT;
+  }
+  if (count < num_samples) {
+    retire_stream(current_stream);
+    current_stream = NULL;
+  }
+}
+
+// Mix the sound effects into the music (which has already been synthesized
+// into the samples array), num_samples at a time.  Each active sound is mixed
+// in one contiguous span at a time into a 32-bit accumulator, the volumes are
+// applied to runs of samples over which they are constant, and the result is
+// saturated back to 16 bits in a final pass.  These inner loops are all simple
+// enough that the compiler can vectorize them.
+static void mix_block(int16_t *samples, int num_samples) {
+  assert(num_samples <= MIX_BLOCK_SIZE);
+  int32_t accum[MIX_BLOCK_SIZE] = {0};
+  AZ_ARRAY_LOOP(sound, active_sounds) {
+    if (sound->data == NULL) continue;
+    mix_sound(sound, accum, num_samples);
+  }
+  if (current_stream != NULL) mix_stream(accum, num_samples);
+
+  int offset = 0;
+  while (offset < num_samples) {
+    // Find how many samples we can go before the music fade volume changes.
+    const bool fading = (music_fade_slowdown > 0 && music_fade_volume > 0);
+    int run = num_samples - offset;
+    if (fading) {
       assert(music_fade_counter > 0);
       assert(music_fade_counter <= music_fade_slowdown);
-      --music_fade_counter;
+      run = az_imin(run, music_fade_counter);
+    }
+    const int music_volume = global_music_volume;
+    const int fade_volume = music_fade_volume;
+    const int sound_volume = global_sound_volume;
+    const int16_t *restrict music = samples + offset;
+    int32_t *restrict output = accum + offset;
+    for (int i = 0; i < run; ++i) {
+      const int sample = (music_volume * (int)music[i]) >> VOLUME_SHIFT;
+      output[i] = ((fade_volume * sample) >> VOLUME_SHIFT) +
+        ((sound_volume * output[i]) >> VOLUME_SHIFT);
+    }
+    offset += run;
+    // Fade out music, if applicable:
+    if (fading) {
+      music_fade_counter -= run;
       if (music_fade_counter == 0) {
         music_fade_counter = music_fade_slowdown;
         --music_fade_volume;
         if (music_fade_volume == 0 && music_synth.music != NULL) {
           az_reset_music_synth(&music_synth, NULL, 0);
+          retire_part_pcms(NULL);
         }
       }
     }
   }
+
+  for (int i = 0; i < num_samples; ++i) {
+    samples[i] = (accum[i] < INT16_MIN ? INT16_MIN :
+                  accum[i] > INT16_MAX ? INT16_MAX : accum[i]);
+  }
+}
+
+/*===========================================================================*/
+// Callback timing:
+
+// The callback has one buffer period (the time it takes the device to play
+// one buffer) to fill the next buffer; if it takes longer than that, or if it
+// starts too long after the previous callback, the device probably ran dry
+// and the user heard a crackle.  We count callbacks that start more than this
+// many buffer periods (in percent) after the previous one as late:
+#define LATE_CALLBACK_PERCENT 150
+// We keep a histogram of how much of its budget each callback used, in 0.1%
+// buckets, for the percentile summary logged at exit.  Callbacks normally use
+// well under 1% of their budget, so this needs to be fine-grained; anything
+// over budget just lands in the last bucket (and is counted separately).
+#define NUM_LOAD_BUCKETS 1024
+
+// These are written only by the audio callback, and summarized by
+// log_callback_timing at exit.
+static SDL_atomic_t num_callbacks;
+static SDL_atomic_t num_late_callbacks;
+static SDL_atomic_t num_over_budget_callbacks;
+static SDL_atomic_t budget_usec;
+static SDL_atomic_t max_callback_usec;
+static SDL_atomic_t max_music_usec;
+static SDL_atomic_t max_active_voices;
+static SDL_atomic_t load_histogram[NUM_LOAD_BUCKETS];
+
+// When the previous callback started, or zero if there hasn't been one since
+// the audio was (un)paused.  This is only touched by the callback, or while
+// the callback is paused.
+static Uint64 last_callback_start = 0;
+
+static int ticks_to_usec(Uint64 ticks) {
+  const double usec =
+    (double)ticks * 1000000.0 / (double)SDL_GetPerformanceFrequency();
+  return (usec < (double)INT_MAX ? (int)usec : INT_MAX);
+}
+
+static void record_callback_timing(int num_samples, Uint64 start,
+                                   Uint64 music_done, Uint64 end) {
+  const int budget = (int)((int64_t)num_samples * 1000000 / output_rate);
+  const int elapsed = ticks_to_usec(end - start);
+  SDL_AtomicAdd(&num_callbacks, 1);
+  SDL_AtomicSet(&budget_usec, budget);
+  if (elapsed > SDL_AtomicGet(&max_callback_usec)) {
+    SDL_AtomicSet(&max_callback_usec, elapsed);
+  }
+  const int music_elapsed = ticks_to_usec(music_done - start);
+  if (music_elapsed > SDL_AtomicGet(&max_music_usec)) {
+    SDL_AtomicSet(&max_music_usec, music_elapsed);
+  }
+  if (elapsed > budget) SDL_AtomicAdd(&num_over_budget_callbacks, 1);
+  if (last_callback_start != 0 &&
+      (int64_t)ticks_to_usec(start - last_callback_start) * 100 >
+      (int64_t)budget * LATE_CALLBACK_PERCENT) {
+    SDL_AtomicAdd(&num_late_callbacks, 1);
+  }
+  last_callback_start = start;
+  const int load_permille = (budget > 0 ? (int)((int64_t)elapsed * 1000 /
+                                                budget) : 0);
+  SDL_AtomicAdd(&load_histogram[az_imin(load_permille,
+                                        NUM_LOAD_BUCKETS - 1)], 1);
+
+  int num_active = 0;
+  AZ_ARRAY_LOOP(sound, active_sounds) {
+    if (sound->data != NULL) ++num_active;
+  }
+  if (num_active > SDL_AtomicGet(&max_active_voices)) {
+    SDL_AtomicSet(&max_active_voices, num_active);
+  }
+}
+
+// Return the smallest load (as a percentage of the budget) that at least the
+// given fraction of callbacks were at or under.
+static double load_percentile(int total, double fraction) {
+  int count = 0;
+  for (int i = 0; i < NUM_LOAD_BUCKETS; ++i) {
+    count += SDL_AtomicGet(&load_histogram[i]);
+    if (count >= fraction * total) return 0.1 * i;
+  }
+  return 0.1 * (NUM_LOAD_BUCKETS - 1);
+}
+
+static void log_callback_timing(void) {
+  const int total = SDL_AtomicGet(&num_callbacks);
+  if (total == 0) return;
+  fprintf(stderr, "Audio callback: %d calls at %d Hz, budget %d us, "
+          "load (%% of budget) p50=%.1f p90=%.1f p99=%.1f p99.9=%.1f, "
+          "max %d us (%d us music), "
+          "%d over budget, %d late, peak %d voices, "
+          "%d voices stolen, %d sounds dropped\n",
+          total, output_rate, SDL_AtomicGet(&budget_usec),
+          load_percentile(total, 0.5), load_percentile(total, 0.9),
+          load_percentile(total, 0.99), load_percentile(total, 0.999),
+          SDL_AtomicGet(&max_callback_usec), SDL_AtomicGet(&max_music_usec),
+          SDL_AtomicGet(&num_over_budget_callbacks),
+          SDL_AtomicGet(&num_late_callbacks),
+          SDL_AtomicGet(&max_active_voices),
+          SDL_AtomicGet(&num_voices_stolen),
+          SDL_AtomicGet(&num_sounds_dropped));
+}
+
+/*===========================================================================*/
+
+static void audio_callback(void *userdata, Uint8 *bytes, int numbytes) {
+  const Uint64 start = SDL_GetPerformanceCounter();
+  assert(numbytes % sizeof(int16_t) == 0);
+  const int num_samples = numbytes / sizeof(int16_t);
+  int16_t *samples = (int16_t*)bytes;
+
+  // Drain the command queue.  Any commands pushed while we're doing this will
+  // wait until the next buffer.  Once this publishes the new tail, nothing
+  // below (or in any later callback) will touch data that those commands
+  // stopped using, which is what az_wait_for_audio_commands relies on.
+  drain_commands(SDL_AtomicGet(&command_queue.head));
+
+  if (next_music != NULL && music_fade_volume == 0) {
+    az_reset_music_synth(&music_synth, next_music, next_music_flag);
+    retire_part_pcms(next_music);
+    music_fade_volume = MAX_VOLUME;
+    music_fade_slowdown = 0;
+    music_fade_counter = 0;
+    next_music = NULL;
+    next_music_flag = 0;
+  }
+  az_synthesize_music(&music_synth, samples, num_samples);
+  const Uint64 music_done = SDL_GetPerformanceCounter();
+
+  for (int block = 0; block < num_samples; block += MIX_BLOCK_SIZE) {
+    mix_block(samples + block, az_imin(MIX_BLOCK_SIZE, num_samples - block));
+  }
+
+  record_callback_timing(num_samples, start, music_done,
+                         SDL_GetPerformanceCounter());
 }
 
 /*===========================================================================*/
 // Music:
 
-static void tick_music(const az_soundboard_t *soundboard) {
-  if (soundboard->change_current_music_flag) {
-    music_synth.flag = soundboard->new_current_music_flag;
+static void change_music(const audio_command_t *command) {
+  assert(command->kind == AUDIO_CMD_CHANGE_MUSIC);
+  if (command->arg.music.change_current_flag) {
+    music_synth.flag = command->arg.music.current_flag;
   }
-  if (soundboard->change_music) {
-    if (soundboard->next_music == music_synth.music) {
+  if (command->arg.music.change_music) {
+    if (command->arg.music.next_music == music_synth.music) {
       music_fade_slowdown = 0;
       next_music = NULL;
       next_music_flag = 0;
-      if (soundboard->change_next_music_flag) {
-        music_synth.flag = soundboard->new_next_music_flag;
+      if (command->arg.music.change_next_flag) {
+        music_synth.flag = command->arg.music.next_flag;
       }
     } else {
       music_fade_slowdown =
-        (int)((soundboard->music_fade_out_seconds * AZ_AUDIO_RATE) /
+        (int)((command->arg.music.fade_out_seconds * output_rate) /
               MAX_VOLUME);
-      next_music = soundboard->next_music;
-      next_music_flag = (soundboard->change_next_music_flag ?
-                         soundboard->new_next_music_flag : 0);
+      next_music = command->arg.music.next_music;
+      next_music_flag = (command->arg.music.change_next_flag ?
+                         command->arg.music.next_flag : 0);
     }
     music_fade_counter = music_fade_slowdown;
-  } else assert(!soundboard->change_next_music_flag);
+  } else assert(!command->arg.music.change_next_flag);
 }
 
 /*===========================================================================*/
 // Sound effects:
 
-static void tick_sounds(const az_soundboard_t *soundboard) {
-  // First, go through each of the active persisted sounds and update their
-  // status based on the soundboard.
-  bool already_active[soundboard->num_persists];
-  memset(already_active, 0, sizeof(bool) * soundboard->num_persists);
+// Return true if sound1 should be cut off in preference to sound2.  Lower
+// priority voices go first, then quieter ones, then older ones.
+static bool better_victim(const active_sound_t *sound1,
+                          const active_sound_t *sound2) {
+  if (sound1->data->priority != sound2->data->priority) {
+    return sound1->data->priority < sound2->data->priority;
+  }
+  if (sound1->volume != sound2->volume) return sound1->volume < sound2->volume;
+  return (int32_t)(sound1->start_order - sound2->start_order) < 0;
+}
+
+// Find a voice on which to start playing the given sound, cutting off a
+// playing sound if necessary, and start the sound on it.  Returns NULL (and
+// leaves the pool alone) if every voice is busy with a sound that is more
+// important than the new one.  Persisted sounds are never cut off, since they
+// would just be restarted from the beginning on the next frame.
+static active_sound_t *start_sound(const az_sound_data_t *data, int volume,
+                                   bool loop, bool persisted) {
+  assert(data->num_samples > 0);
+  active_sound_t *idle = NULL; // the first idle voice, if any
+  active_sound_t *victim = NULL; // the best voice to steal, if any
+  active_sound_t *oldest_instance = NULL; // oldest one-shot of the same sound
+  int num_instances = 0;
   AZ_ARRAY_LOOP(sound, active_sounds) {
-    if (sound->data == NULL) continue;
-    if (!sound->persisted) {
-      assert(!sound->loop);
+    if (sound->data == NULL) {
+      if (idle == NULL) idle = sound;
       continue;
     }
-    // Check if this sound is in the soundboard's persists array.  If not, we
-    // will implicitly halt and reset the sound.
-    bool reset = true;
-    for (int i = 0; i < soundboard->num_persists; ++i) {
-      if (soundboard->persists[i].sound_data != sound->data) continue;
-      if (!soundboard->persists[i].reset) {
-        reset = false;
-        already_active[i] = true;
-        sound->volume = (int)(soundboard->persists[i].volume * MAX_VOLUME);
-        sound->paused = !soundboard->persists[i].play;
+    if (sound->persisted) continue;
+    if (sound->data == data) {
+      ++num_instances;
+      if (oldest_instance == NULL ||
+          (int32_t)(sound->start_order - oldest_instance->start_order) < 0) {
+        oldest_instance = sound;
       }
-      break;
     }
-    // If we're supposed to reset this sound, halt it.
-    if (reset) AZ_ZERO_OBJECT(sound);
+    if (sound->data->priority > data->priority) continue;
+    if (victim == NULL || better_victim(sound, victim)) victim = sound;
   }
+  active_sound_t *voice;
+  if (!persisted && data->max_instances > 0 &&
+      num_instances >= data->max_instances) {
+    voice = oldest_instance;
+  } else if (idle != NULL) {
+    voice = idle;
+  } else voice = victim;
+  if (voice == NULL) {
+    SDL_AtomicAdd(&num_sounds_dropped, 1);
+    return NULL;
+  }
+  if (voice->data != NULL) SDL_AtomicAdd(&num_voices_stolen, 1);
+  AZ_ZERO_OBJECT(voice);
+  voice->data = data;
+  voice->volume = volume;
+  voice->loop = loop;
+  voice->persisted = persisted;
+  voice->claimed = persisted;
+  voice->start_order = next_start_order++;
+  return voice;
+}
 
-  // Second, go through the soundboard and start playing any new persistent
-  // sounds that need to be started.
-  for (int i = 0; i < soundboard->num_persists; ++i) {
-    if (already_active[i] || !soundboard->persists[i].play) continue;
-    if (soundboard->persists[i].sound_data->num_samples == 0) continue;
-    bool success = false;
-    AZ_ARRAY_LOOP(sound, active_sounds) {
-      if (sound->data != NULL) continue;
-      sound->data = soundboard->persists[i].sound_data;
-      sound->sample_index = 0;
-      sound->volume = (int)(soundboard->persists[i].volume * MAX_VOLUME);
-      sound->loop = soundboard->persists[i].loop;
-      sound->persisted = true;
-      sound->paused = false;
-      success = true;
+static void begin_persists(void) {
+  AZ_ARRAY_LOOP(sound, active_sounds) sound->claimed = false;
+  num_pending_persists = 0;
+}
+
+static void persist_sound(const audio_command_t *command) {
+  assert(command->kind == AUDIO_CMD_PERSIST);
+  // If this sound is already active, update its status (unless we're supposed
+  // to reset it, in which case we halt it and then start it over below).
+  AZ_ARRAY_LOOP(sound, active_sounds) {
+    if (sound->data != command->arg.sound.data || !sound->persisted) continue;
+    if (command->arg.sound.reset) {
+      AZ_ZERO_OBJECT(sound);
       break;
     }
-    if (!success) AZ_WARNING_ONCE("Could not play persistent sound\n");
+    sound->volume = command->arg.sound.volume;
+    sound->paused = !command->arg.sound.play;
+    sound->claimed = true;
+    return;
+  }
+  // Otherwise, start playing the sound (once END_PERSISTS arrives), if we're
+  // supposed to.
+  if (!command->arg.sound.play) return;
+  if (command->arg.sound.data->num_samples == 0) return;
+  if (num_pending_persists >= AZ_ARRAY_SIZE(pending_persists)) {
+    AZ_WARNING_ONCE("Too many persistent sounds\n");
+    return;
   }
+  pending_persists[num_pending_persists].data = command->arg.sound.data;
+  pending_persists[num_pending_persists].volume = command->arg.sound.volume;
+  pending_persists[num_pending_persists].loop = command->arg.sound.loop;
+  ++num_pending_persists;
+}
 
-  // Third, start playing any new one-shot sounds.
-  for (int i = 0; i < soundboard->num_oneshots; ++i) {
-    if (soundboard->oneshots[i].sound_data->num_samples == 0) continue;
-    bool success = false;
-    AZ_ARRAY_LOOP(sound, active_sounds) {
-      if (sound->data != NULL) continue;
-      sound->data = soundboard->oneshots[i].sound_data;
-      sound->sample_index = 0;
-      sound->volume = (int)(soundboard->oneshots[i].volume * MAX_VOLUME);
-      sound->loop = false;
-      sound->persisted = false;
-      sound->paused = false;
-      success = true;
-      break;
+static void end_persists(void) {
+  // First, halt and reset any persisted sounds that weren't mentioned this
+  // frame.
+  AZ_ARRAY_LOOP(sound, active_sounds) {
+    if (sound->data == NULL) continue;
+    if (!sound->persisted) {
+      assert(!sound->loop);
+      continue;
     }
-    if (!success) AZ_WARNING_ONCE("Could not play sound effect\n");
+    if (!sound->claimed) AZ_ZERO_OBJECT(sound);
+  }
+  // Second, start playing any new persistent sounds.
+  for (int i = 0; i < num_pending_persists; ++i) {
+    if (start_sound(pending_persists[i].data, pending_persists[i].volume,
+                    pending_persists[i].loop, true) == NULL) {
+      AZ_WARNING_ONCE("Could not play persistent sound\n");
+    }
+  }
+  num_pending_persists = 0;
+}
+
+static void play_sound(const audio_command_t *command) {
+  assert(command->kind == AUDIO_CMD_PLAY_SOUND);
+  if (command->arg.sound.data->num_samples == 0) return;
+  if (start_sound(command->arg.sound.data, command->arg.sound.volume,
+                  false, false) == NULL) {
+    AZ_WARNING_ONCE("Could not play sound effect\n");
+  }
+}
+
+static void play_stream(const audio_command_t *command) {
+  assert(command->kind == AUDIO_CMD_PLAY_STREAM);
+  if (current_stream != NULL) retire_stream(current_stream);
+  current_stream = command->arg.stream.stream;
+  current_stream_volume = command->arg.stream.volume;
+}
+
+static void execute_command(const audio_command_t *command) {
+  switch (command->kind) {
+    case AUDIO_CMD_SET_MUSIC_VOLUME:
+      global_music_volume = command->arg.volume;
+      break;
+    case AUDIO_CMD_SET_SOUND_VOLUME:
+      global_sound_volume = command->arg.volume;
+      break;
+    case AUDIO_CMD_CHANGE_MUSIC: change_music(command); break;
+    case AUDIO_CMD_BEGIN_PERSISTS: begin_persists(); break;
+    case AUDIO_CMD_PERSIST: persist_sound(command); break;
+    case AUDIO_CMD_END_PERSISTS: end_persists(); break;
+    case AUDIO_CMD_PLAY_SOUND: play_sound(command); break;
+    case AUDIO_CMD_PLAY_STREAM: play_stream(command); break;
   }
 }
 
@@ -231,25 +853,92 @@ static void tick_sounds(const az_soundboard_t *soundboard) {
 
 static bool audio_system_initialized = false;
 static bool audio_system_paused = false;
+static SDL_AudioDeviceID audio_device = 0;
+
+// Return the sample rate that the default output device natively runs at, or
+// DEFAULT_OUTPUT_RATE if we can't tell.
+static int native_output_rate(void) {
+#if SDL_VERSION_ATLEAST(2, 24, 0)
+  SDL_AudioSpec spec;
+  if (SDL_GetDefaultAudioInfo(NULL, &spec, 0) == 0 && spec.freq > 0) {
+    return spec.freq;
+  }
+#endif
+  return DEFAULT_OUTPUT_RATE;
+}
+
+static void close_audio_device(void) {
+  SDL_CloseAudioDevice(audio_device);
+  audio_device = 0;
+}
 
 void az_init_audio(void) {
   assert(!audio_system_initialized);
 
-  SDL_AudioSpec audio_spec = {
-    .freq = AZ_AUDIO_RATE,
+  const int rate = native_output_rate();
+  Uint16 buffer_size = 1;
+  while (buffer_size < rate * MIN_BUFFER_MSEC / 1000) buffer_size *= 2;
+  const SDL_AudioSpec desired_spec = {
+    .freq = rate,
     .format = AUDIO_FORMAT,
     .channels = AUDIO_CHANNELS,
-    .samples = AUDIO_BUFFERSIZE,
+    .samples = buffer_size,
     .callback = &audio_callback
   };
-  if (SDL_OpenAudio(&audio_spec, NULL) != 0) {
-    AZ_FATAL("SDL_OpenAudio failed: %s\n", SDL_GetError());
+  SDL_AudioSpec obtained_spec;
+  start_part_cache_thread();
+  // We let SDL give us a different rate than we asked for (in case the
+  // device can't do the one we guessed), but not a different format, since
+  // then SDL would have to convert our output anyway.
+  audio_device = SDL_OpenAudioDevice(NULL, 0, &desired_spec, &obtained_spec,
+                                     SDL_AUDIO_ALLOW_FREQUENCY_CHANGE);
+  if (audio_device == 0) {
+    AZ_FATAL("SDL_OpenAudioDevice failed: %s\n", SDL_GetError());
   }
+  // The device starts out paused, so the callback can't be running yet.
+  output_rate = obtained_spec.freq;
+  sound_step = az_resample_step(output_rate);
+  az_set_music_sample_rate(&music_synth, output_rate);
+  az_set_music_pcm_lookup(&music_synth, lookup_part_pcm, NULL);
 
-  atexit(SDL_CloseAudio);
+  // The atexit functions run in reverse order, so this will close the audio
+  // device (stopping the callback) before stopping the cache thread, and
+  // before logging the callback timing summary.
+  atexit(log_callback_timing);
+  atexit(stop_part_cache_thread);
+  atexit(close_audio_device);
   audio_system_initialized = true;
 }
 
+// Called only from the game thread.  If the queue is full (which means that
+// the callback has fallen far behind, or has stopped running, e.g. because the
+// device was lost), a one-shot sound effect is dropped (and counted in
+// sounds_dropped), since playing it late would be no better.  Every other
+// command changes state that later commands rely on (such as which persisted
+// sounds are playing, what music comes next, or who owns a sound stream), so
+// rather than lose one of those, we lock the device, which waits for any
+// running callback to finish and keeps it from starting again, and execute
+// the queued commands ourselves to make room.
+static void push_command(const audio_command_t *command) {
+  const int head = SDL_AtomicGet(&command_queue.head);
+  const int next_head = (head + 1) & (COMMAND_QUEUE_SIZE - 1);
+  if (next_head == SDL_AtomicGet(&command_queue.tail)) {
+    AZ_WARNING_ONCE("Audio command queue is full\n");
+    if (command->kind == AUDIO_CMD_PLAY_SOUND) {
+      SDL_AtomicAdd(&num_sounds_dropped, 1);
+      return;
+    }
+    SDL_LockAudioDevice(audio_device);
+    drain_commands(head);
+    SDL_UnlockAudioDevice(audio_device);
+    delete_retired_streams();
+  }
+  command_queue.commands[head] = *command;
+  // SDL_AtomicSet is a full memory barrier, so the callback will never see
+  // the new head before it can see the command.
+  SDL_AtomicSet(&command_queue.head, next_head);
+}
+
 static int to_int_volume(float volume) {
   return az_imin(az_imax(0, (int)(volume * (float)MAX_VOLUME)), MAX_VOLUME);
 }
@@ -257,35 +946,96 @@ static int to_int_volume(float volume) {
 void az_set_global_music_volume(float volume) {
   assert(audio_system_initialized);
   assert(!audio_system_paused);
-  const int new_volume = to_int_volume(volume);
-  SDL_LockAudio(); {
-    global_music_volume = new_volume;
-  } SDL_UnlockAudio();
+  push_command(&(audio_command_t){
+    .kind = AUDIO_CMD_SET_MUSIC_VOLUME, .arg.volume = to_int_volume(volume)
+  });
 }
 
 void az_set_global_sound_volume(float volume) {
   assert(audio_system_initialized);
   assert(!audio_system_paused);
-  const int new_volume = to_int_volume(volume);
-  SDL_LockAudio(); {
-    global_sound_volume = new_volume;
-  } SDL_UnlockAudio();
+  push_command(&(audio_command_t){
+    .kind = AUDIO_CMD_SET_SOUND_VOLUME, .arg.volume = to_int_volume(volume)
+  });
 }
 
 void az_tick_audio(az_soundboard_t *soundboard) {
   assert(audio_system_initialized);
   assert(!audio_system_paused);
-  SDL_LockAudio(); {
-    tick_music(soundboard);
-    tick_sounds(soundboard);
-  } SDL_UnlockAudio();
+  if (soundboard->change_music || soundboard->change_current_music_flag) {
+    push_command(&(audio_command_t){
+      .kind = AUDIO_CMD_CHANGE_MUSIC,
+      .arg.music = {
+        .change_music = soundboard->change_music,
+        .change_current_flag = soundboard->change_current_music_flag,
+        .change_next_flag = soundboard->change_next_music_flag,
+        .current_flag = soundboard->new_current_music_flag,
+        .next_flag = soundboard->new_next_music_flag,
+        .next_music = soundboard->next_music,
+        .fade_out_seconds = soundboard->music_fade_out_seconds
+      }
+    });
+  } else assert(!soundboard->change_next_music_flag);
+  push_command(&(audio_command_t){.kind = AUDIO_CMD_BEGIN_PERSISTS});
+  for (int i = 0; i < soundboard->num_persists; ++i) {
+    push_command(&(audio_command_t){
+      .kind = AUDIO_CMD_PERSIST,
+      .arg.sound = {
+        .data = soundboard->persists[i].sound_data,
+        .volume = (int)(soundboard->persists[i].volume * MAX_VOLUME),
+        .play = soundboard->persists[i].play,
+        .loop = soundboard->persists[i].loop,
+        .reset = soundboard->persists[i].reset
+      }
+    });
+  }
+  push_command(&(audio_command_t){.kind = AUDIO_CMD_END_PERSISTS});
+  for (int i = 0; i < soundboard->num_oneshots; ++i) {
+    push_command(&(audio_command_t){
+      .kind = AUDIO_CMD_PLAY_SOUND,
+      .arg.sound = {
+        .data = soundboard->oneshots[i].sound_data,
+        .volume = (int)(soundboard->oneshots[i].volume * MAX_VOLUME)
+      }
+    });
+  }
   AZ_ZERO_OBJECT(soundboard);
+  delete_retired_streams();
+}
+
+void az_play_sound_stream(az_sound_stream_t *stream, float volume) {
+  assert(audio_system_initialized);
+  assert(!audio_system_paused);
+  push_command(&(audio_command_t){
+    .kind = AUDIO_CMD_PLAY_STREAM,
+    .arg.stream = {
+      .stream = stream,
+      .volume = to_int_volume(volume)
+    }
+  });
+}
+
+void az_wait_for_audio_commands(void) {
+  if (!audio_system_initialized) return;
+  // Only this thread pushes commands, so head won't move while we wait.
+  const int head = SDL_AtomicGet(&command_queue.head);
+  if (audio_system_paused) {
+    // The callback won't run again until we unpause, so rather than waiting
+    // for it, execute the commands ourselves.
+    drain_commands(head);
+    return;
+  }
+  while (SDL_AtomicGet(&command_queue.tail) != head) SDL_Delay(1);
 }
 
 void az_pause_all_audio(void) {
   if (!audio_system_initialized) return;
   assert(!audio_system_paused);
-  SDL_PauseAudio(1);
+  SDL_PauseAudioDevice(audio_device, 1);
+  // The callback won't run again until we unpause, so it's safe to touch its
+  // state here.  The gap while we're paused shouldn't count as a late
+  // callback.
+  last_callback_start = 0;
   audio_system_paused = true;
 }
 
@@ -293,7 +1043,7 @@ void az_unpause_all_audio(void) {
   if (!audio_system_initialized) return;
   assert(audio_system_paused);
   audio_system_paused = false;
-  SDL_PauseAudio(0);
+  SDL_PauseAudioDevice(audio_device, 0);
 }
 
 /*===========================================================================*/
@@ -22,12 +22,15 @@
 #define AZIMUTH_GUI_AUDIO_H_
 
 #include "azimuth/util/audio.h"
+#include "azimuth/util/sound.h" // for az_sound_stream_t
 
 /*===========================================================================*/
 
 // Call this once per frame to update our audio system.  The audio system must
 // be initialized first (by calling az_init_gui, which will in turn call
-// az_init_audio below).
+// az_init_audio below).  This and the volume setters below never block; they
+// queue up commands that the audio thread applies at the start of its next
+// buffer, so they must all be called from the same (main) thread.
 void az_tick_audio(az_soundboard_t *soundboard);
 
 // Set the global volume for music or sound effects, respectively.  The
@@ -37,10 +40,35 @@ void az_tick_audio(az_soundboard_t *soundboard);
 void az_set_global_music_volume(float volume);
 void az_set_global_sound_volume(float volume);
 
+// Start playing the given sound stream (see azimuth/util/sound.h) at the
+// given volume (from 0.0 to 1.0), cutting off the stream that was playing
+// before, if any; pass NULL to just stop the current stream.  The stream is
+// synthesized as it plays, so this is for previewing sound effects while
+// they're being edited, when there's no time to synthesize them up front.
+// The audio system takes ownership of the stream, and deletes it (from within
+// a later call to az_tick_audio) once it is done with it.
+void az_play_sound_stream(az_sound_stream_t *stream, float volume);
+
+// Block until the audio callback has executed every command queued so far
+// (by az_tick_audio and friends).  Since those calls return before the
+// callback sees their commands, the audio system may still be mixing sound
+// data (or synthesizing music) for a while after the last soundboard that
+// mentioned it; so to free sound or music data while the audio system is
+// running, first stop playing it, then call az_tick_audio, then call this, and
+// only then free the data.  This is cheap if the queue is already empty, but
+// otherwise can take up to one audio buffer period.
+void az_wait_for_audio_commands(void);
+
 /*===========================================================================*/
 
 // Initialize our audio system (once the GUI has been initialized).  This is
-// called by az_init_gui, and should not be called from elsewhere.
+// called by az_init_gui, and should not be called from elsewhere.  At exit,
+// the audio system logs a summary to stderr, to help track down crackles: how
+// many callbacks started late or ran over their buffer period (either of
+// which probably means the device ran out of samples), percentiles of
+// callback time, and how often the voice pool had to cut off a playing sound
+// (voices stolen) or couldn't play a new one at all (sounds dropped, which
+// also counts sound effects dropped because the command queue filled up).
 void az_init_audio(void);
 
 // Pause and unpause all audio (sounds and music).  These are automatically
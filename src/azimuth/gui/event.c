@@ -224,6 +224,9 @@ static void pause_until_refocus(void) {
 bool az_poll_event(az_event_t *event) {
   SDL_Event sdl_event;
   while (SDL_PollEvent(&sdl_event)) {
+    // Whatever this event is, it may change what's on screen, so idle screens
+    // should redraw promptly.
+    az_invalidate_screen();
     switch (sdl_event.type) {
       case SDL_WINDOWEVENT:
         if (sdl_event.window.event == SDL_WINDOWEVENT_FOCUS_LOST) {
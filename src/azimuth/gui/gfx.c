@@ -0,0 +1,2261 @@
+/*=============================================================================
+| Copyright 2012 Matthew D. Steele <mdsteele@alum.mit.edu>                    |
+|                                                                             |
+| This file is part of Azimuth.                                               |
+|                                                                             |
+| Azimuth is free software: you can redistribute it and/or modify it under    |
+| the terms of the GNU General Public License as published by the Free        |
+| Software Foundation, either version 3 of the License, or (at your option)   |
+| any later version.                                                          |
+|                                                                             |
+| Azimuth is distributed in the hope that it will be useful, but WITHOUT      |
+| ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       |
+| FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for   |
+| more details.                                                               |
+|                                                                             |
+| You should have received a copy of the GNU General Public License along     |
+| with Azimuth.  If not, see <http://www.gnu.org/licenses/>.                  |
+=============================================================================*/
+
+
+#include "azimuth/gui/gfx.h"
+
+#include <assert.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <SDL.h>
+#include <SDL_opengl.h>
+
+#include "azimuth/util/misc.h"
+#include "azimuth/util/prefs.h"
+#include "azimuth/util/vector.h"
+#include "azimuth/util/warning.h"
+
+/*===========================================================================*/
+// Core-profile GL entry points:
+
+// These aren't part of the GL 1.1 ABI, so on some platforms (e.g. Windows) we
+// can't link against them directly, and instead have to look them up at
+// runtime once we have a context.
+static struct {
+  PFNGLATTACHSHADERPROC AttachShader;
+  PFNGLBINDATTRIBLOCATIONPROC BindAttribLocation;
+  PFNGLBINDBUFFERPROC BindBuffer;
+  PFNGLBINDFRAMEBUFFERPROC BindFramebuffer;
+  PFNGLBINDRENDERBUFFERPROC BindRenderbuffer;
+  PFNGLBINDVERTEXARRAYPROC BindVertexArray;
+  PFNGLBLITFRAMEBUFFERPROC BlitFramebuffer;
+  PFNGLBUFFERDATAPROC BufferData;
+  PFNGLCHECKFRAMEBUFFERSTATUSPROC CheckFramebufferStatus;
+  PFNGLCOMPILESHADERPROC CompileShader;
+  PFNGLCREATEPROGRAMPROC CreateProgram;
+  PFNGLCREATESHADERPROC CreateShader;
+  PFNGLDELETEBUFFERSPROC DeleteBuffers;
+  PFNGLDELETESHADERPROC DeleteShader;
+  PFNGLDELETEVERTEXARRAYSPROC DeleteVertexArrays;
+  PFNGLDISABLEVERTEXATTRIBARRAYPROC DisableVertexAttribArray;
+  PFNGLDRAWARRAYSINSTANCEDPROC DrawArraysInstanced;
+  PFNGLENABLEVERTEXATTRIBARRAYPROC EnableVertexAttribArray;
+  PFNGLFRAMEBUFFERRENDERBUFFERPROC FramebufferRenderbuffer;
+  PFNGLFRAMEBUFFERTEXTURE2DPROC FramebufferTexture2D;
+  PFNGLGENBUFFERSPROC GenBuffers;
+  PFNGLGENFRAMEBUFFERSPROC GenFramebuffers;
+  PFNGLGENRENDERBUFFERSPROC GenRenderbuffers;
+  PFNGLGENVERTEXARRAYSPROC GenVertexArrays;
+  PFNGLGETPROGRAMINFOLOGPROC GetProgramInfoLog;
+  PFNGLGETPROGRAMIVPROC GetProgramiv;
+  PFNGLGETSHADERINFOLOGPROC GetShaderInfoLog;
+  PFNGLGETSHADERIVPROC GetShaderiv;
+  PFNGLGETUNIFORMLOCATIONPROC GetUniformLocation;
+  PFNGLLINKPROGRAMPROC LinkProgram;
+  PFNGLRENDERBUFFERSTORAGEMULTISAMPLEPROC RenderbufferStorageMultisample;
+  PFNGLSHADERSOURCEPROC ShaderSource;
+  PFNGLUNIFORM1IPROC Uniform1i;
+  PFNGLUNIFORM2FPROC Uniform2f;
+  PFNGLUNIFORM4FVPROC Uniform4fv;
+  PFNGLUNIFORMMATRIX4FVPROC UniformMatrix4fv;
+  PFNGLUSEPROGRAMPROC UseProgram;
+  PFNGLVERTEXATTRIBDIVISORPROC VertexAttribDivisor;
+  PFNGLVERTEXATTRIBPOINTERPROC VertexAttribPointer;
+} gl;
+
+static az_gfx_proc_loader_t proc_loader = SDL_GL_GetProcAddress;
+
+static bool load_gl_functions(void) {
+  // ISO C doesn't allow casting a void* to a function pointer, so copy the
+  // bits instead.
+#define LOAD_GL_FUNCTION(name) do { \
+    void *proc = proc_loader("gl" #name); \
+    memcpy(&gl.name, &proc, sizeof(proc)); \
+    if (proc == NULL) { \
+      AZ_WARNING_ALWAYS("Missing GL function: gl%s\n", #name); \
+      return false; \
+    } \
+  } while (false)
+  LOAD_GL_FUNCTION(AttachShader);
+  LOAD_GL_FUNCTION(BindAttribLocation);
+  LOAD_GL_FUNCTION(BindBuffer);
+  LOAD_GL_FUNCTION(BindFramebuffer);
+  LOAD_GL_FUNCTION(BindRenderbuffer);
+  LOAD_GL_FUNCTION(BindVertexArray);
+  LOAD_GL_FUNCTION(BlitFramebuffer);
+  LOAD_GL_FUNCTION(BufferData);
+  LOAD_GL_FUNCTION(CheckFramebufferStatus);
+  LOAD_GL_FUNCTION(CompileShader);
+  LOAD_GL_FUNCTION(CreateProgram);
+  LOAD_GL_FUNCTION(CreateShader);
+  LOAD_GL_FUNCTION(DeleteBuffers);
+  LOAD_GL_FUNCTION(DeleteShader);
+  LOAD_GL_FUNCTION(DeleteVertexArrays);
+  LOAD_GL_FUNCTION(DisableVertexAttribArray);
+  LOAD_GL_FUNCTION(DrawArraysInstanced);
+  LOAD_GL_FUNCTION(EnableVertexAttribArray);
+  LOAD_GL_FUNCTION(FramebufferRenderbuffer);
+  LOAD_GL_FUNCTION(FramebufferTexture2D);
+  LOAD_GL_FUNCTION(GenBuffers);
+  LOAD_GL_FUNCTION(GenFramebuffers);
+  LOAD_GL_FUNCTION(GenRenderbuffers);
+  LOAD_GL_FUNCTION(GenVertexArrays);
+  LOAD_GL_FUNCTION(GetProgramInfoLog);
+  LOAD_GL_FUNCTION(GetProgramiv);
+  LOAD_GL_FUNCTION(GetShaderInfoLog);
+  LOAD_GL_FUNCTION(GetShaderiv);
+  LOAD_GL_FUNCTION(GetUniformLocation);
+  LOAD_GL_FUNCTION(LinkProgram);
+  LOAD_GL_FUNCTION(RenderbufferStorageMultisample);
+  LOAD_GL_FUNCTION(ShaderSource);
+  LOAD_GL_FUNCTION(Uniform1i);
+  LOAD_GL_FUNCTION(Uniform2f);
+  LOAD_GL_FUNCTION(Uniform4fv);
+  LOAD_GL_FUNCTION(UniformMatrix4fv);
+  LOAD_GL_FUNCTION(UseProgram);
+  LOAD_GL_FUNCTION(VertexAttribDivisor);
+  LOAD_GL_FUNCTION(VertexAttribPointer);
+#undef LOAD_GL_FUNCTION
+  return true;
+}
+
+/*===========================================================================*/
+// Shaders:
+
+// Attribute locations for the vertex-color program.  The color delta
+// attributes are only enabled for modulated display lists (see
+// az_gfx_call_list_modulated); otherwise, color_weights are always zero.
+#define POSITION_ATTRIB 0
+#define COLOR_ATTRIB 1
+#define COLOR_DELTA1_ATTRIB 2
+#define COLOR_DELTA2_ATTRIB 3
+
+static const char *const vertex_color_attribs[] = {
+  "position", "color", "color_delta1", "color_delta2", NULL
+};
+
+// Batched vertices have already had the modelview matrix applied on the CPU,
+// so the modelview uniform is only ever set to something other than the
+// identity while drawing a display list's static vertex buffer.
+static const char vertex_color_vert_source[] =
+  "#version 330 core\n"
+  "uniform mat4 projection;\n"
+  "uniform mat4 modelview;\n"
+  "uniform vec4 color_weights[2];\n"
+  "in vec2 position;\n"
+  "in vec4 color;\n"
+  "in vec4 color_delta1;\n"
+  "in vec4 color_delta2;\n"
+  "out vec4 frag_color;\n"
+  "void main() {\n"
+  "  gl_Position = projection * modelview * vec4(position, 0.0, 1.0);\n"
+  "  frag_color = clamp(color + color_weights[0] * color_delta1 +\n"
+  "                     color_weights[1] * color_delta2, 0.0, 1.0);\n"
+  "}\n";
+
+static const char vertex_color_frag_source[] =
+  "#version 330 core\n"
+  "in vec4 frag_color;\n"
+  "out vec4 out_color;\n"
+  "void main() {\n"
+  "  out_color = frag_color;\n"
+  "}\n";
+
+// Attribute locations for the glow program.  The corner attribute comes from
+// a fixed unit quad, while the rest are per-instance (see az_gfx_glow_t).
+#define GLOW_CORNER_ATTRIB 0
+#define GLOW_CENTER_ATTRIB 1
+#define GLOW_COLOR_ATTRIB 2
+#define GLOW_RADIUS_ATTRIB 3
+#define GLOW_ALPHA_ATTRIB 4
+
+static const char *const glow_attribs[] = {
+  "corner", "center", "color", "radius", "alpha", NULL
+};
+
+static const char glow_vert_source[] =
+  "#version 330 core\n"
+  "uniform mat4 projection;\n"
+  "in vec2 corner;\n"
+  "in vec2 center;\n"
+  "in vec3 color;\n"
+  "in vec3 radius;\n"
+  "in vec3 alpha;\n"
+  "out vec2 offset;\n"
+  "flat out vec3 glow_color;\n"
+  "flat out vec3 glow_radius;\n"
+  "flat out vec3 glow_alpha;\n"
+  "void main() {\n"
+  "  offset = corner * radius.z;\n"
+  "  gl_Position = projection * vec4(center + offset, 0.0, 1.0);\n"
+  "  glow_color = color;\n"
+  "  glow_radius = radius;\n"
+  "  glow_alpha = alpha;\n"
+  "}\n";
+
+static const char glow_frag_source[] =
+  "#version 330 core\n"
+  "in vec2 offset;\n"
+  "flat in vec3 glow_color;\n"
+  "flat in vec3 glow_radius;\n"
+  "flat in vec3 glow_alpha;\n"
+  "out vec4 out_color;\n"
+  "void main() {\n"
+  "  float dist = length(offset);\n"
+  "  if (dist < glow_radius.x || dist > glow_radius.z) discard;\n"
+  "  float alpha = (dist <= glow_radius.y ?\n"
+  "    mix(glow_alpha.x, glow_alpha.y, (dist - glow_radius.x) /\n"
+  "        max(glow_radius.y - glow_radius.x, 1e-6)) :\n"
+  "    mix(glow_alpha.y, glow_alpha.z, (dist - glow_radius.y) /\n"
+  "        max(glow_radius.z - glow_radius.y, 1e-6)));\n"
+  "  out_color = vec4(glow_color, alpha);\n"
+  "}\n";
+
+// Attribute locations for the starfield program, all of which are
+// per-instance (see az_gfx_star_t).  Each star is drawn as a line, whose first
+// vertex is the star itself and whose second is the end of its tail.
+#define STAR_POSITION_ATTRIB 0
+#define STAR_GRAY_ATTRIB 1
+#define STAR_PHASE_ATTRIB 2
+
+static const char *const star_attribs[] = {"position", "gray", "phase", NULL};
+
+// The stroke uniform holds the style's scroll, wrap, tail_length, and
+// tail_gray, and the twinkle uniform its twinkle_gray, twinkle_modulus, and
+// twinkle_slowdown, and the clock (already reduced modulo the twinkle's
+// period, so that it's exact as a float).
+static const char star_vert_source[] =
+  "#version 330 core\n"
+  "uniform mat4 projection;\n"
+  "uniform mat4 modelview;\n"
+  "uniform vec4 stroke;\n"
+  "uniform vec4 twinkle;\n"
+  "in vec2 position;\n"
+  "in float gray;\n"
+  "in float phase;\n"
+  "out vec4 frag_color;\n"
+  "void main() {\n"
+  "  float x = position.x + stroke.x;\n"
+  "  if (stroke.y > 0.0 && x >= stroke.y) x -= stroke.y;\n"
+  "  float g = gray;\n"
+  "  if (twinkle.x != 0.0) {\n"
+  "    int m = int(twinkle.y) - 1;\n"
+  "    int d = ((int(twinkle.w) + int(phase)) / int(twinkle.z)) % (2 * m);\n"
+  "    g += twinkle.x * float(d <= m ? d : 2 * m - d);\n"
+  "  }\n"
+  "  if (gl_VertexID == 1) {\n"
+  "    x -= stroke.z;\n"
+  "    g *= stroke.w;\n"
+  "  }\n"
+  "  gl_Position = projection * modelview * vec4(x, position.y, 0.0, 1.0);\n"
+  "  frag_color = vec4(g, g, g, 1.0);\n"
+  "}\n";
+
+// The post-processing program draws the offscreen framebuffer to the screen as
+// a single (bilinearly filtered) quad, using the same unit-quad corners as the
+// glow program.  Optionally, it also smooths edges with a cut-down FXAA: at
+// each pixel, estimate the direction of any edge from the luma of the
+// diagonal neighbors, and blur along (never across) that edge.
+#define POST_CORNER_ATTRIB 0
+
+static const char *const post_attribs[] = {"corner", NULL};
+
+static const char post_vert_source[] =
+  "#version 330 core\n"
+  "in vec2 corner;\n"
+  "out vec2 tex_coord;\n"
+  "void main() {\n"
+  "  gl_Position = vec4(corner, 0.0, 1.0);\n"
+  "  tex_coord = 0.5 * corner + 0.5;\n"
+  "}\n";
+
+static const char post_frag_source[] =
+  "#version 330 core\n"
+  "uniform sampler2D source;\n"
+  "uniform vec2 texel_size;\n"
+  "uniform bool smooth_edges;\n"
+  "in vec2 tex_coord;\n"
+  "out vec4 out_color;\n"
+  "const vec3 luma_weights = vec3(0.299, 0.587, 0.114);\n"
+  "vec3 sample_at(vec2 offset) {\n"
+  "  return texture(source, tex_coord + offset * texel_size).rgb;\n"
+  "}\n"
+  "void main() {\n"
+  "  vec3 center = sample_at(vec2(0.0));\n"
+  "  if (!smooth_edges) {\n"
+  "    out_color = vec4(center, 1.0);\n"
+  "    return;\n"
+  "  }\n"
+  "  float luma_nw = dot(sample_at(vec2(-1.0, -1.0)), luma_weights);\n"
+  "  float luma_ne = dot(sample_at(vec2(1.0, -1.0)), luma_weights);\n"
+  "  float luma_sw = dot(sample_at(vec2(-1.0, 1.0)), luma_weights);\n"
+  "  float luma_se = dot(sample_at(vec2(1.0, 1.0)), luma_weights);\n"
+  "  float luma_m = dot(center, luma_weights);\n"
+  "  float luma_min = min(luma_m, min(min(luma_nw, luma_ne),\n"
+  "                                   min(luma_sw, luma_se)));\n"
+  "  float luma_max = max(luma_m, max(max(luma_nw, luma_ne),\n"
+  "                                   max(luma_sw, luma_se)));\n"
+  "  if (luma_max - luma_min < max(0.0312, 0.125 * luma_max)) {\n"
+  "    out_color = vec4(center, 1.0);\n"
+  "    return;\n"
+  "  }\n"
+  "  vec2 dir = vec2((luma_sw + luma_se) - (luma_nw + luma_ne),\n"
+  "                  (luma_nw + luma_sw) - (luma_ne + luma_se));\n"
+  "  float reduce = max(0.03125 * (luma_nw + luma_ne + luma_sw + luma_se),\n"
+  "                     0.0078125);\n"
+  "  dir = clamp(dir / (min(abs(dir.x), abs(dir.y)) + reduce),\n"
+  "              -8.0, 8.0);\n"
+  "  vec3 near = 0.5 * (sample_at(dir * (1.0 / 3.0 - 0.5)) +\n"
+  "                     sample_at(dir * (2.0 / 3.0 - 0.5)));\n"
+  "  vec3 far = 0.5 * near + 0.25 * (sample_at(dir * -0.5) +\n"
+  "                                  sample_at(dir * 0.5));\n"
+  "  float luma_far = dot(far, luma_weights);\n"
+  "  out_color = vec4((luma_far < luma_min || luma_far > luma_max ?\n"
+  "                    near : far), 1.0);\n"
+  "}\n";
+
+static GLuint compile_shader(GLenum type, const char *source) {
+  const GLuint shader = gl.CreateShader(type);
+  gl.ShaderSource(shader, 1, &source, NULL);
+  gl.CompileShader(shader);
+  GLint status = GL_FALSE;
+  gl.GetShaderiv(shader, GL_COMPILE_STATUS, &status);
+  if (status != GL_TRUE) {
+    char log[1024] = {0};
+    gl.GetShaderInfoLog(shader, sizeof(log) - 1, NULL, log);
+    AZ_WARNING_ALWAYS("Shader failed to compile:\n%s\n", log);
+    gl.DeleteShader(shader);
+    return 0u;
+  }
+  return shader;
+}
+
+// Link a program from the given shader sources, binding the attributes named
+// in the NULL-terminated attribs array to locations 0, 1, 2, etc.
+static GLuint link_program(const char *vert_source, const char *frag_source,
+                           const char *const *attribs) {
+  const GLuint vert = compile_shader(GL_VERTEX_SHADER, vert_source);
+  if (vert == 0u) return 0u;
+  const GLuint frag = compile_shader(GL_FRAGMENT_SHADER, frag_source);
+  if (frag == 0u) {
+    gl.DeleteShader(vert);
+    return 0u;
+  }
+  const GLuint program = gl.CreateProgram();
+  gl.AttachShader(program, vert);
+  gl.AttachShader(program, frag);
+  for (GLuint i = 0u; attribs[i] != NULL; ++i) {
+    gl.BindAttribLocation(program, i, attribs[i]);
+  }
+  gl.LinkProgram(program);
+  gl.DeleteShader(vert);
+  gl.DeleteShader(frag);
+  GLint status = GL_FALSE;
+  gl.GetProgramiv(program, GL_LINK_STATUS, &status);
+  if (status != GL_TRUE) {
+    char log[1024] = {0};
+    gl.GetProgramInfoLog(program, sizeof(log) - 1, NULL, log);
+    AZ_WARNING_ALWAYS("Shader program failed to link:\n%s\n", log);
+    return 0u;
+  }
+  return program;
+}
+
+/*===========================================================================*/
+// Matrices:
+
+// A 4x4 matrix, stored column-major, as GL expects.
+typedef struct {
+  GLfloat m[16];
+} matrix_t;
+
+static const matrix_t identity_matrix = {{1, 0, 0, 0, 0, 1, 0, 0,
+                                          0, 0, 1, 0, 0, 0, 0, 1}};
+
+static void matrix_multiply(matrix_t *dest, const GLfloat *rhs) {
+  const matrix_t lhs = *dest;
+  for (int col = 0; col < 4; ++col) {
+    for (int row = 0; row < 4; ++row) {
+      GLfloat sum = 0;
+      for (int k = 0; k < 4; ++k) {
+        sum += lhs.m[4 * k + row] * rhs[4 * col + k];
+      }
+      dest->m[4 * col + row] = sum;
+    }
+  }
+}
+
+#define MATRIX_STACK_DEPTH 32
+
+typedef struct {
+  int top;
+  matrix_t matrices[MATRIX_STACK_DEPTH];
+} matrix_stack_t;
+
+/*===========================================================================*/
+// Command lists:
+
+// Every call made through the az_gfx_* API can be represented as a command.
+// Commands are used both to emulate display lists in the core backend, and to
+// record whole frames to be replayed later (possibly on another thread).
+typedef enum {
+  CMD_BEGIN,
+  CMD_END,
+  CMD_VERTEX,
+  CMD_COLOR,
+  CMD_MATRIX_MODE,
+  CMD_LOAD_IDENTITY,
+  CMD_PUSH_MATRIX,
+  CMD_POP_MATRIX,
+  CMD_TRANSLATE,
+  CMD_ROTATE,
+  CMD_SCALE,
+  CMD_MULT_MATRIX, // the matrix is stored in the command list's data
+  CMD_GEN_LISTS,
+  CMD_DELETE_LISTS,
+  CMD_NEW_LIST, // arg.i[1] is the variant being compiled, or -1 if none
+  CMD_END_LIST,
+  CMD_CALL_LIST,
+  // arg.u[1] is the list; the color weights are stored in the command list's
+  // data, as in az_gfx_call_list_modulated_rgba:
+  CMD_CALL_LIST_MODULATED,
+  CMD_ENABLE,
+  CMD_DISABLE,
+  CMD_HINT,
+  CMD_BLEND_FUNC,
+  CMD_LINE_WIDTH,
+  CMD_SCISSOR,
+  CMD_VIEWPORT,
+  CMD_CLEAR,
+  CMD_DRAW_GLOWS, // the glows are stored in the command list's data
+  CMD_GEN_STARFIELD, // the stars are stored in the command list's data
+  CMD_DELETE_STARFIELD,
+  CMD_DRAW_STARFIELD, // the style is stored in the command list's data
+  CMD_BEGIN_OFFSCREEN,
+  CMD_END_OFFSCREEN,
+} command_kind_t;
+
+typedef struct {
+  command_kind_t kind;
+  union {
+    GLuint u[4];
+    GLint i[4];
+    GLfloat f[4];
+  } arg;
+} command_t;
+
+// Commands with larger arguments (matrices, color weights, glows, stars, and
+// starfield styles) store them in the list's data array, with arg.i[0] holding
+// the index of the first value.
+struct az_gfx_command_list {
+  int num_commands, max_commands;
+  command_t *commands;
+  int num_data, max_data;
+  GLfloat *data;
+};
+
+#define GLOW_NUM_FLOATS ((int)(sizeof(az_gfx_glow_t) / sizeof(GLfloat)))
+AZ_STATIC_ASSERT(sizeof(az_gfx_glow_t) % sizeof(GLfloat) == 0);
+#define STAR_NUM_FLOATS ((int)(sizeof(az_gfx_star_t) / sizeof(GLfloat)))
+AZ_STATIC_ASSERT(sizeof(az_gfx_star_t) % sizeof(GLfloat) == 0);
+// A starfield style is stored as its stroke and twinkle uniforms.
+#define STARFIELD_STYLE_NUM_FLOATS 8
+// Color weights are stored as the four channels of weight1, then of weight2.
+#define COLOR_WEIGHTS_NUM_FLOATS 8
+
+// Make sure that the array has room for at least min_size elements, doubling
+// its capacity as needed, and return the (possibly moved) array.
+static void *reserve_array(void *array, int *capacity, int min_size,
+                           size_t element_size) {
+  if (min_size <= *capacity) return array;
+  int new_capacity = (*capacity == 0 ? 64 : *capacity);
+  while (new_capacity < min_size) new_capacity *= 2;
+  array = realloc(array, new_capacity * element_size);
+  if (array == NULL) AZ_FATAL("realloc failed.\n");
+  *capacity = new_capacity;
+  return array;
+}
+
+static int command_data_size(const command_t *command) {
+  switch (command->kind) {
+    case CMD_MULT_MATRIX: return 16;
+    case CMD_CALL_LIST_MODULATED: return COLOR_WEIGHTS_NUM_FLOATS;
+    case CMD_DRAW_GLOWS: return command->arg.i[1] * GLOW_NUM_FLOATS;
+    case CMD_GEN_STARFIELD: return command->arg.i[1] * STAR_NUM_FLOATS;
+    case CMD_DRAW_STARFIELD: return STARFIELD_STYLE_NUM_FLOATS;
+    default: return 0;
+  }
+}
+
+static void append_command(az_gfx_command_list_t *list,
+                           const command_t *command, const GLfloat *data) {
+  list->commands = reserve_array(list->commands, &list->max_commands,
+                                 list->num_commands + 1, sizeof(command_t));
+  command_t *dest = &list->commands[list->num_commands++];
+  *dest = *command;
+  const int data_size = command_data_size(command);
+  if (data_size > 0) {
+    list->data = reserve_array(list->data, &list->max_data,
+                               list->num_data + data_size, sizeof(GLfloat));
+    memcpy(&list->data[list->num_data], data, data_size * sizeof(GLfloat));
+    dest->arg.i[0] = list->num_data;
+    list->num_data += data_size;
+  }
+}
+
+static void execute_command(const command_t *command, const GLfloat *data);
+
+static void execute_command_list(const az_gfx_command_list_t *list) {
+  for (int i = 0; i < list->num_commands; ++i) {
+    const command_t *command = &list->commands[i];
+    execute_command(command, (command_data_size(command) > 0 ?
+                              &list->data[command->arg.i[0]] : NULL));
+  }
+}
+
+// Fail unless each variant of a display list holds the same commands as the
+// list itself, other than the arguments to its CMD_COLOR commands.
+static void check_list_variants(
+    const az_gfx_command_list_t *variants[AZ_GFX_NUM_LIST_VARIANTS]) {
+  const az_gfx_command_list_t *list = variants[0];
+  for (int v = 1; v < AZ_GFX_NUM_LIST_VARIANTS; ++v) {
+    const az_gfx_command_list_t *variant = variants[v];
+    bool ok = (variant->num_commands == list->num_commands &&
+               variant->num_data == list->num_data &&
+               memcmp(variant->data, list->data,
+                      list->num_data * sizeof(GLfloat)) == 0);
+    for (int i = 0; ok && i < list->num_commands; ++i) {
+      const command_t *command = &list->commands[i];
+      ok = (variant->commands[i].kind == command->kind &&
+            (command->kind == CMD_COLOR ||
+             memcmp(&variant->commands[i].arg, &command->arg,
+                    sizeof(command->arg)) == 0));
+    }
+    if (!ok) AZ_FATAL("Display list variant %d doesn't match the list.\n", v);
+  }
+}
+
+// Set color to the given channels of each variant, interpolated by the color
+// weights, as in az_gfx_call_list_modulated_rgba.
+static void modulate_color(const GLfloat *variants[AZ_GFX_NUM_LIST_VARIANTS],
+                           const GLfloat *weights, GLfloat color[4]) {
+  for (int j = 0; j < 4; ++j) {
+    const GLfloat base = variants[0][j];
+    color[j] = fmin(fmax(base + weights[j] * (variants[1][j] - base) +
+                         weights[4 + j] * (variants[2][j] - base), 0.0), 1.0);
+  }
+}
+
+// Execute a display list compiled with variants, one command at a time,
+// modulating each color by the weights.
+static void execute_modulated_command_lists(
+    const az_gfx_command_list_t *variants[AZ_GFX_NUM_LIST_VARIANTS],
+    const GLfloat *weights) {
+  const az_gfx_command_list_t *list = variants[0];
+  for (int i = 0; i < list->num_commands; ++i) {
+    const command_t *command = &list->commands[i];
+    if (command->kind != CMD_COLOR) {
+      execute_command(command, (command_data_size(command) > 0 ?
+                                &list->data[command->arg.i[0]] : NULL));
+      continue;
+    }
+    const GLfloat *colors[AZ_GFX_NUM_LIST_VARIANTS];
+    for (int v = 0; v < AZ_GFX_NUM_LIST_VARIANTS; ++v) {
+      colors[v] = variants[v]->commands[i].arg.f;
+    }
+    command_t modulated = {.kind = CMD_COLOR};
+    modulate_color(colors, weights, modulated.arg.f);
+    execute_command(&modulated, NULL);
+  }
+}
+
+/*===========================================================================*/
+// Core backend state:
+
+static az_gfx_stats_t stats;
+
+typedef struct {
+  GLfloat x, y;
+  GLfloat r, g, b, a;
+} vertex_t;
+
+typedef struct {
+  int num_vertices, max_vertices;
+  vertex_t *vertices;
+} vertex_array_t;
+
+static void append_vertex(vertex_array_t *array, const vertex_t *vertex) {
+  array->vertices = reserve_array(array->vertices, &array->max_vertices,
+                                  array->num_vertices + 1, sizeof(vertex_t));
+  array->vertices[array->num_vertices++] = *vertex;
+}
+
+// A run of vertices in a display list's vertex buffer, all to be drawn with
+// the same mode (one of GL_TRIANGLES, GL_LINES, or GL_POINTS).
+typedef struct {
+  GLenum mode;
+  GLint first;
+  GLsizei count;
+} list_segment_t;
+
+// Display lists don't exist in the core profile, so they are emulated by
+// recording the commands made between glNewList and glEndList.  Lists that
+// only draw geometry (see list_can_be_baked) are then run once, relative to
+// an identity modelview matrix, and the resulting vertices uploaded to a
+// static vertex buffer, so that glCallList is just a uniform update and a few
+// draw calls.  Any other list is replayed command by command on glCallList.
+typedef struct {
+  bool allocated;
+  az_gfx_command_list_t commands;
+  // For a list compiled with variants, the commands of variants 1 and up:
+  az_gfx_command_list_t variants[AZ_GFX_NUM_LIST_VARIANTS - 1];
+  bool modulated; // true once all of the variants have been compiled
+  bool baked;
+  GLuint vertex_array, vertex_buffer; // 0 until the list is first baked
+  int num_segments, max_segments;
+  list_segment_t *segments;
+  // The current color once each variant has run (only the first is used if
+  // the list isn't modulated):
+  GLfloat final_color[AZ_GFX_NUM_LIST_VARIANTS][4];
+  matrix_t transform; // net change the list makes to the modelview matrix
+} display_list_t;
+
+// The vertices of a modulated display list, which also carry the difference
+// between the vertex's color in each variant and in the list itself.
+typedef struct {
+  vertex_t vertex;
+  GLfloat color_delta[AZ_GFX_NUM_LIST_VARIANTS - 1][4];
+} modulated_vertex_t;
+
+static az_gfx_backend_t current_backend = AZ_GFX_LEGACY;
+
+static struct {
+  GLuint program;
+  GLint projection_uniform;
+  GLint modelview_uniform;
+  GLint color_weights_uniform;
+  GLuint vertex_array;
+  GLuint vertex_buffer;
+  // Matrices:
+  GLenum matrix_mode;
+  matrix_stack_t projection, modelview;
+  bool projection_dirty;
+  // Immediate mode:
+  GLfloat color[4];
+  GLenum primitive_mode; // GL_INVALID_ENUM when not between glBegin/glEnd
+  vertex_array_t primitive;
+  // Vertices waiting to be submitted, all to be drawn with batch_mode (which
+  // is one of GL_TRIANGLES, GL_LINES, or GL_POINTS):
+  GLenum batch_mode;
+  vertex_array_t batch;
+  // Glows:
+  GLuint glow_program;
+  GLint glow_projection_uniform;
+  GLuint glow_vertex_array;
+  GLuint glow_quad_buffer;
+  GLuint glow_instance_buffer;
+  int max_glows;
+  az_gfx_glow_t *glows;
+  // Starfields (indexed by name - 1, with vertex_array 0 if deleted):
+  GLuint star_program;
+  GLint star_projection_uniform;
+  GLint star_modelview_uniform;
+  GLint star_stroke_uniform;
+  GLint star_twinkle_uniform;
+  int num_starfields, max_starfields;
+  struct { GLuint vertex_array, vertex_buffer; } *starfields;
+  // Offscreen rendering:
+  GLuint post_program;
+  GLint post_texel_size_uniform;
+  GLint post_smooth_edges_uniform;
+  GLuint post_vertex_array;
+  GLuint offscreen_framebuffer;
+  GLuint offscreen_texture;
+  GLsizei offscreen_width, offscreen_height;
+  bool offscreen_smooth_edges;
+  // Multisampled framebuffer that we draw into instead when the window has
+  // MSAA, resolved into offscreen_texture by az_gfx_end_offscreen:
+  GLuint msaa_framebuffer;
+  GLuint msaa_renderbuffer;
+  GLsizei msaa_width, msaa_height, msaa_samples;
+  bool offscreen_multisampled;
+  // Display lists:
+  int num_lists, max_lists;
+  display_list_t *lists;
+  display_list_t *compiling;
+  int compiling_variant; // 0 if compiling the list itself
+  display_list_t *baking; // if non-NULL, flush batches into this list
+} core;
+
+/*===========================================================================*/
+// Core backend implementation:
+
+static void sync_projection(void) {
+  if (core.projection_dirty) {
+    gl.UniformMatrix4fv(core.projection_uniform, 1, GL_FALSE,
+                        core.projection.matrices[core.projection.top].m);
+    core.projection_dirty = false;
+  }
+}
+
+// While baking a display list, append the batch to the list's segments
+// instead of drawing it.  The vertices themselves are left in the batch (and
+// are uploaded by bake_display_list), so the segments index into it.
+static void bake_batch(void) {
+  display_list_t *list = core.baking;
+  const int first = (list->num_segments == 0 ? 0 :
+                     list->segments[list->num_segments - 1].first +
+                     list->segments[list->num_segments - 1].count);
+  const int count = core.batch.num_vertices - first;
+  if (count == 0) return;
+  list->segments = reserve_array(list->segments, &list->max_segments,
+                                 list->num_segments + 1,
+                                 sizeof(list_segment_t));
+  list->segments[list->num_segments++] = (list_segment_t){
+    .mode = core.batch_mode, .first = first, .count = count
+  };
+}
+
+static void core_flush(void) {
+  if (core.baking != NULL) {
+    bake_batch();
+    return;
+  }
+  if (core.batch.num_vertices == 0) return;
+  sync_projection();
+  gl.BufferData(GL_ARRAY_BUFFER, core.batch.num_vertices * sizeof(vertex_t),
+                core.batch.vertices, GL_STREAM_DRAW);
+  glDrawArrays(core.batch_mode, 0, core.batch.num_vertices);
+  ++stats.draw_calls;
+  stats.vertices += core.batch.num_vertices;
+  core.batch.num_vertices = 0;
+}
+
+static matrix_stack_t *current_matrix_stack(void) {
+  return (core.matrix_mode == GL_PROJECTION ? &core.projection :
+          &core.modelview);
+}
+
+static matrix_t *current_matrix(void) {
+  matrix_stack_t *stack = current_matrix_stack();
+  return &stack->matrices[stack->top];
+}
+
+static void current_matrix_changed(void) {
+  if (core.matrix_mode == GL_PROJECTION) {
+    core_flush();
+    core.projection_dirty = true;
+  }
+}
+
+static GLenum batch_mode_for_primitive(GLenum mode) {
+  switch (mode) {
+    case GL_POINTS:
+      return GL_POINTS;
+    case GL_LINES:
+    case GL_LINE_STRIP:
+    case GL_LINE_LOOP:
+      return GL_LINES;
+    case GL_TRIANGLES:
+    case GL_TRIANGLE_STRIP:
+    case GL_TRIANGLE_FAN:
+    case GL_QUADS:
+    case GL_QUAD_STRIP:
+    case GL_POLYGON:
+      return GL_TRIANGLES;
+    default:
+      AZ_FATAL("Unsupported primitive mode: %d\n", (int)mode);
+  }
+}
+
+static void batch_triangle(int i, int j, int k) {
+  const vertex_t *vertices = core.primitive.vertices;
+  append_vertex(&core.batch, &vertices[i]);
+  append_vertex(&core.batch, &vertices[j]);
+  append_vertex(&core.batch, &vertices[k]);
+}
+
+static void batch_line(int i, int j) {
+  const vertex_t *vertices = core.primitive.vertices;
+  append_vertex(&core.batch, &vertices[i]);
+  append_vertex(&core.batch, &vertices[j]);
+}
+
+// Convert the primitive built up between glBegin and glEnd into plain
+// triangles, lines, or points, and append them to the batch.
+static void batch_primitive(void) {
+  const GLenum batch_mode = batch_mode_for_primitive(core.primitive_mode);
+  if (batch_mode != core.batch_mode) {
+    core_flush();
+    core.batch_mode = batch_mode;
+  }
+  const int n = core.primitive.num_vertices;
+  switch (core.primitive_mode) {
+    case GL_POINTS:
+      for (int i = 0; i < n; ++i) {
+        append_vertex(&core.batch, &core.primitive.vertices[i]);
+      }
+      break;
+    case GL_LINES:
+      for (int i = 1; i < n; i += 2) batch_line(i - 1, i);
+      break;
+    case GL_LINE_STRIP:
+      for (int i = 1; i < n; ++i) batch_line(i - 1, i);
+      break;
+    case GL_LINE_LOOP:
+      for (int i = 1; i < n; ++i) batch_line(i - 1, i);
+      if (n >= 2) batch_line(n - 1, 0);
+      break;
+    case GL_TRIANGLES:
+      for (int i = 2; i < n; i += 3) batch_triangle(i - 2, i - 1, i);
+      break;
+    case GL_TRIANGLE_STRIP:
+      for (int i = 2; i < n; ++i) {
+        if (i % 2 == 0) batch_triangle(i - 2, i - 1, i);
+        else batch_triangle(i - 1, i - 2, i);
+      }
+      break;
+    case GL_TRIANGLE_FAN:
+    case GL_POLYGON:
+      for (int i = 2; i < n; ++i) batch_triangle(0, i - 1, i);
+      break;
+    case GL_QUADS:
+      for (int i = 3; i < n; i += 4) {
+        batch_triangle(i - 3, i - 2, i - 1);
+        batch_triangle(i - 3, i - 1, i);
+      }
+      break;
+    case GL_QUAD_STRIP:
+      for (int i = 3; i < n; i += 2) {
+        batch_triangle(i - 3, i - 2, i);
+        batch_triangle(i - 3, i, i - 1);
+      }
+      break;
+    default: AZ_ASSERT_UNREACHABLE();
+  }
+}
+
+static void core_begin(GLenum mode) {
+  assert(core.primitive_mode == GL_INVALID_ENUM);
+  core.primitive_mode = mode;
+  core.primitive.num_vertices = 0;
+}
+
+static void core_end(void) {
+  assert(core.primitive_mode != GL_INVALID_ENUM);
+  batch_primitive();
+  core.primitive_mode = GL_INVALID_ENUM;
+}
+
+static void core_vertex(GLfloat x, GLfloat y) {
+  assert(core.primitive_mode != GL_INVALID_ENUM);
+  // The view code only ever uses 2D affine transforms, so we can apply the
+  // modelview matrix here and keep just the resulting x and y.
+  const GLfloat *m = core.modelview.matrices[core.modelview.top].m;
+  const vertex_t vertex = {
+    .x = m[0] * x + m[4] * y + m[12],
+    .y = m[1] * x + m[5] * y + m[13],
+    .r = core.color[0], .g = core.color[1],
+    .b = core.color[2], .a = core.color[3]
+  };
+  append_vertex(&core.primitive, &vertex);
+}
+
+static void core_color(GLfloat r, GLfloat g, GLfloat b, GLfloat a) {
+  core.color[0] = r; core.color[1] = g; core.color[2] = b; core.color[3] = a;
+}
+
+static void core_matrix_mode(GLenum mode) {
+  assert(mode == GL_PROJECTION || mode == GL_MODELVIEW);
+  core.matrix_mode = mode;
+}
+
+static void core_load_identity(void) {
+  *current_matrix() = identity_matrix;
+  current_matrix_changed();
+}
+
+static void core_push_matrix(void) {
+  matrix_stack_t *stack = current_matrix_stack();
+  if (stack->top + 1 >= MATRIX_STACK_DEPTH) {
+    AZ_FATAL("Matrix stack overflow.\n");
+  }
+  stack->matrices[stack->top + 1] = stack->matrices[stack->top];
+  ++stack->top;
+}
+
+static void core_pop_matrix(void) {
+  matrix_stack_t *stack = current_matrix_stack();
+  if (stack->top <= 0) AZ_FATAL("Matrix stack underflow.\n");
+  --stack->top;
+  current_matrix_changed();
+}
+
+static void core_mult_matrix(const GLfloat *matrix) {
+  matrix_multiply(current_matrix(), matrix);
+  current_matrix_changed();
+}
+
+static void core_translate(GLfloat x, GLfloat y, GLfloat z) {
+  const GLfloat matrix[16] = {1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, x, y, z, 1};
+  core_mult_matrix(matrix);
+}
+
+static void core_rotate(GLfloat degrees, GLfloat x, GLfloat y, GLfloat z) {
+  // We only ever rotate within the XY plane.
+  assert(x == 0 && y == 0 && z != 0);
+  const GLfloat radians = (z < 0 ? -degrees : degrees) * (AZ_PI / 180.0);
+  const GLfloat c = cos(radians), s = sin(radians);
+  const GLfloat matrix[16] = {c, s, 0, 0, -s, c, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1};
+  core_mult_matrix(matrix);
+}
+
+static void core_scale(GLfloat x, GLfloat y, GLfloat z) {
+  const GLfloat matrix[16] = {x, 0, 0, 0, 0, y, 0, 0, 0, 0, z, 0, 0, 0, 0, 1};
+  core_mult_matrix(matrix);
+}
+
+static display_list_t *get_display_list(GLuint list) {
+  if (list == 0u || list > (GLuint)core.num_lists) return NULL;
+  display_list_t *display_list = &core.lists[list - 1];
+  return display_list->allocated ? display_list : NULL;
+}
+
+static void core_gen_lists(GLuint first, GLsizei range) {
+  const int end = first - 1 + range;
+  core.lists = reserve_array(core.lists, &core.max_lists, end,
+                             sizeof(display_list_t));
+  while (core.num_lists < end) {
+    core.lists[core.num_lists++] = (display_list_t){.allocated = false};
+  }
+  for (int i = first - 1; i < end; ++i) core.lists[i].allocated = true;
+}
+
+static void core_delete_lists(GLuint first, GLsizei range) {
+  for (GLuint list = first; list < first + range; ++list) {
+    display_list_t *display_list = get_display_list(list);
+    if (display_list == NULL) continue;
+    free(display_list->commands.commands);
+    free(display_list->commands.data);
+    AZ_ARRAY_LOOP(variant, display_list->variants) {
+      free(variant->commands);
+      free(variant->data);
+    }
+    free(display_list->segments);
+    if (display_list->vertex_array != 0u) {
+      gl.DeleteVertexArrays(1, &display_list->vertex_array);
+      gl.DeleteBuffers(1, &display_list->vertex_buffer);
+    }
+    *display_list = (display_list_t){.allocated = false};
+  }
+}
+
+static az_gfx_command_list_t *list_variant(display_list_t *list,
+                                           int variant) {
+  return (variant == 0 ? &list->commands : &list->variants[variant - 1]);
+}
+
+static void core_new_list(GLuint list, int variant) {
+  assert(core.compiling == NULL);
+  display_list_t *display_list = get_display_list(list);
+  if (display_list == NULL) AZ_FATAL("Invalid display list: %u\n", list);
+  if (variant <= 0) {
+    variant = 0;
+    display_list->modulated = false;
+    display_list->baked = false;
+    display_list->num_segments = 0;
+  }
+  az_gfx_command_list_t *commands = list_variant(display_list, variant);
+  commands->num_commands = 0;
+  commands->num_data = 0;
+  core.compiling = display_list;
+  core.compiling_variant = variant;
+}
+
+// A list can be baked into a static vertex buffer if running it only draws
+// vertices, without changing any state that outlives the call other than the
+// current color and modelview matrix; that is, if it contains nothing but
+// primitives, colors, and modelview transforms, and never pops more matrices
+// than it pushes.  Also, the list must set the color before its first vertex,
+// since otherwise the vertex colors would depend on the color at the time of
+// the call.
+static bool list_can_be_baked(const az_gfx_command_list_t *commands) {
+  bool has_color = false, has_vertices = false;
+  int depth = 0;
+  for (int i = 0; i < commands->num_commands; ++i) {
+    switch (commands->commands[i].kind) {
+      case CMD_BEGIN: case CMD_END: break;
+      case CMD_VERTEX:
+        if (!has_color) return false;
+        has_vertices = true;
+        break;
+      case CMD_COLOR: has_color = true; break;
+      case CMD_PUSH_MATRIX: ++depth; break;
+      case CMD_POP_MATRIX:
+        if (--depth < 0) return false;
+        break;
+      case CMD_TRANSLATE: case CMD_ROTATE: case CMD_SCALE:
+      case CMD_MULT_MATRIX: break;
+      default: return false;
+    }
+  }
+  return has_vertices && depth == 0;
+}
+
+// Run the commands relative to an identity modelview matrix, so that the
+// vertices come out in the list's own coordinates, and leave them in the
+// batch (with the list's segments indexing into it).
+static void run_commands_for_baking(display_list_t *list, int variant) {
+  core.modelview.top = 0;
+  core.modelview.matrices[0] = identity_matrix;
+  core.matrix_mode = GL_MODELVIEW;
+  core.batch.num_vertices = 0;
+  list->num_segments = 0;
+  core.baking = list;
+  execute_command_list(list_variant(list, variant));
+  core_flush();
+  core.baking = NULL;
+  memcpy(list->final_color[variant], core.color, sizeof(core.color));
+}
+
+static void set_vertex_attrib(GLuint index, GLint size, GLsizei stride,
+                              size_t offset) {
+  gl.EnableVertexAttribArray(index);
+  gl.VertexAttribPointer(index, size, GL_FLOAT, GL_FALSE, stride,
+                         (const GLvoid *)offset);
+}
+
+static void bake_display_list(display_list_t *list) {
+  core_flush();
+  const matrix_stack_t modelview = core.modelview;
+  const GLenum matrix_mode = core.matrix_mode;
+  const GLenum batch_mode = core.batch_mode;
+  GLfloat color[4];
+  memcpy(color, core.color, sizeof(color));
+  // For a modulated list, run each variant in turn (from last to first, so
+  // that the list itself ends up in the batch) and keep its colors.
+  vertex_array_t variant_vertices[AZ_GFX_NUM_LIST_VARIANTS - 1] = {{0}};
+  if (list->modulated) {
+    for (int v = AZ_GFX_NUM_LIST_VARIANTS - 1; v > 0; --v) {
+      run_commands_for_baking(list, v);
+      vertex_array_t *vertices = &variant_vertices[v - 1];
+      vertices->vertices = reserve_array(NULL, &vertices->max_vertices,
+                                         core.batch.num_vertices,
+                                         sizeof(vertex_t));
+      vertices->num_vertices = core.batch.num_vertices;
+      memcpy(vertices->vertices, core.batch.vertices,
+             core.batch.num_vertices * sizeof(vertex_t));
+    }
+  }
+  run_commands_for_baking(list, 0);
+  list->transform = core.modelview.matrices[0];
+  core.modelview = modelview;
+  core.matrix_mode = matrix_mode;
+  core.batch_mode = batch_mode;
+  memcpy(core.color, color, sizeof(color));
+  if (list->vertex_array == 0u) {
+    gl.GenVertexArrays(1, &list->vertex_array);
+    gl.GenBuffers(1, &list->vertex_buffer);
+  }
+  gl.BindVertexArray(list->vertex_array);
+  gl.BindBuffer(GL_ARRAY_BUFFER, list->vertex_buffer);
+  const int num_vertices = core.batch.num_vertices;
+  if (list->modulated) {
+    modulated_vertex_t *modulated =
+      AZ_ALLOC(num_vertices, modulated_vertex_t);
+    for (int i = 0; i < num_vertices; ++i) {
+      const vertex_t *vertex = &core.batch.vertices[i];
+      modulated[i].vertex = *vertex;
+      for (int v = 0; v < AZ_GFX_NUM_LIST_VARIANTS - 1; ++v) {
+        assert(variant_vertices[v].num_vertices == num_vertices);
+        const vertex_t *other = &variant_vertices[v].vertices[i];
+        modulated[i].color_delta[v][0] = other->r - vertex->r;
+        modulated[i].color_delta[v][1] = other->g - vertex->g;
+        modulated[i].color_delta[v][2] = other->b - vertex->b;
+        modulated[i].color_delta[v][3] = other->a - vertex->a;
+      }
+    }
+    gl.BufferData(GL_ARRAY_BUFFER, num_vertices * sizeof(modulated_vertex_t),
+                  modulated, GL_STATIC_DRAW);
+    free(modulated);
+    AZ_ARRAY_LOOP(vertices, variant_vertices) free(vertices->vertices);
+    const GLsizei stride = sizeof(modulated_vertex_t);
+    set_vertex_attrib(POSITION_ATTRIB, 2, stride, 0);
+    set_vertex_attrib(COLOR_ATTRIB, 4, stride, 2 * sizeof(GLfloat));
+    set_vertex_attrib(COLOR_DELTA1_ATTRIB, 4, stride,
+                      offsetof(modulated_vertex_t, color_delta[0]));
+    set_vertex_attrib(COLOR_DELTA2_ATTRIB, 4, stride,
+                      offsetof(modulated_vertex_t, color_delta[1]));
+  } else {
+    gl.BufferData(GL_ARRAY_BUFFER, num_vertices * sizeof(vertex_t),
+                  core.batch.vertices, GL_STATIC_DRAW);
+    set_vertex_attrib(POSITION_ATTRIB, 2, sizeof(vertex_t), 0);
+    set_vertex_attrib(COLOR_ATTRIB, 4, sizeof(vertex_t), 2 * sizeof(GLfloat));
+    gl.DisableVertexAttribArray(COLOR_DELTA1_ATTRIB);
+    gl.DisableVertexAttribArray(COLOR_DELTA2_ATTRIB);
+  }
+  core.batch.num_vertices = 0;
+  gl.BindVertexArray(core.vertex_array);
+  gl.BindBuffer(GL_ARRAY_BUFFER, core.vertex_buffer);
+  list->baked = true;
+}
+
+static void core_end_list(void) {
+  assert(core.compiling != NULL);
+  display_list_t *list = core.compiling;
+  const int variant = core.compiling_variant;
+  core.compiling = NULL;
+  // A list compiled with variants is baked once its last variant is done.
+  if (variant > 0) {
+    if (variant < AZ_GFX_NUM_LIST_VARIANTS - 1) return;
+    const az_gfx_command_list_t *variants[AZ_GFX_NUM_LIST_VARIANTS];
+    for (int v = 0; v < AZ_GFX_NUM_LIST_VARIANTS; ++v) {
+      variants[v] = list_variant(list, v);
+    }
+    check_list_variants(variants);
+    list->modulated = true;
+  }
+  if (list_can_be_baked(&list->commands)) bake_display_list(list);
+}
+
+// Draw a baked list, modulating its colors by the weights if they're non-NULL.
+static void call_baked_list(const display_list_t *list,
+                            const GLfloat *weights) {
+  const bool modulate = list->modulated && weights != NULL;
+  core_flush();
+  sync_projection();
+  gl.UniformMatrix4fv(core.modelview_uniform, 1, GL_FALSE,
+                      core.modelview.matrices[core.modelview.top].m);
+  if (modulate) gl.Uniform4fv(core.color_weights_uniform, 2, weights);
+  gl.BindVertexArray(list->vertex_array);
+  for (int i = 0; i < list->num_segments; ++i) {
+    const list_segment_t *segment = &list->segments[i];
+    glDrawArrays(segment->mode, segment->first, segment->count);
+    ++stats.draw_calls;
+    stats.vertices += segment->count;
+  }
+  gl.BindVertexArray(core.vertex_array);
+  gl.UniformMatrix4fv(core.modelview_uniform, 1, GL_FALSE,
+                      identity_matrix.m);
+  if (modulate) {
+    static const GLfloat zero_weights[COLOR_WEIGHTS_NUM_FLOATS] = {0};
+    gl.Uniform4fv(core.color_weights_uniform, 2, zero_weights);
+    const GLfloat *colors[AZ_GFX_NUM_LIST_VARIANTS];
+    for (int v = 0; v < AZ_GFX_NUM_LIST_VARIANTS; ++v) {
+      colors[v] = list->final_color[v];
+    }
+    modulate_color(colors, weights, core.color);
+  } else memcpy(core.color, list->final_color[0], sizeof(core.color));
+  if (memcmp(&list->transform, &identity_matrix, sizeof(matrix_t)) != 0) {
+    core_mult_matrix(list->transform.m);
+  }
+}
+
+// Call a list, modulating its colors by the weights if they're non-NULL.
+static void core_call_list(GLuint list, const GLfloat *weights) {
+  display_list_t *display_list = get_display_list(list);
+  if (display_list == NULL) return;
+  // A baked list's transforms were recorded relative to the modelview matrix,
+  // so if the projection matrix is current, replay the list instead.
+  if (display_list->baked && core.matrix_mode == GL_MODELVIEW) {
+    call_baked_list(display_list, weights);
+  } else if (display_list->modulated && weights != NULL) {
+    const az_gfx_command_list_t *variants[AZ_GFX_NUM_LIST_VARIANTS];
+    for (int v = 0; v < AZ_GFX_NUM_LIST_VARIANTS; ++v) {
+      variants[v] = list_variant(display_list, v);
+    }
+    execute_modulated_command_lists(variants, weights);
+  } else execute_command_list(&display_list->commands);
+}
+
+static void core_draw_glows(int num_glows, const GLfloat *data) {
+  assert(num_glows >= 0);
+  if (num_glows == 0) return;
+  core_flush();
+  core.glows = reserve_array(core.glows, &core.max_glows, num_glows,
+                             sizeof(az_gfx_glow_t));
+  // As with vertices, apply the modelview matrix on the CPU.  Glows are
+  // circular, so only the translation and the overall scale matter.
+  const GLfloat *m = core.modelview.matrices[core.modelview.top].m;
+  const GLfloat scale = sqrt(m[0] * m[0] + m[1] * m[1]);
+  for (int i = 0; i < num_glows; ++i) {
+    az_gfx_glow_t *glow = &core.glows[i];
+    memcpy(glow, &data[i * GLOW_NUM_FLOATS], sizeof(az_gfx_glow_t));
+    const GLfloat x = glow->x, y = glow->y;
+    glow->x = m[0] * x + m[4] * y + m[12];
+    glow->y = m[1] * x + m[5] * y + m[13];
+    for (int j = 0; j < 3; ++j) glow->radius[j] *= scale;
+  }
+  gl.UseProgram(core.glow_program);
+  gl.UniformMatrix4fv(core.glow_projection_uniform, 1, GL_FALSE,
+                      core.projection.matrices[core.projection.top].m);
+  gl.BindVertexArray(core.glow_vertex_array);
+  gl.BindBuffer(GL_ARRAY_BUFFER, core.glow_instance_buffer);
+  gl.BufferData(GL_ARRAY_BUFFER, num_glows * sizeof(az_gfx_glow_t),
+                core.glows, GL_STREAM_DRAW);
+  gl.DrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, num_glows);
+  ++stats.draw_calls;
+  gl.UseProgram(core.program);
+  gl.BindVertexArray(core.vertex_array);
+  gl.BindBuffer(GL_ARRAY_BUFFER, core.vertex_buffer);
+}
+
+static void core_gen_starfield(GLuint starfield, int num_stars,
+                               const GLfloat *data) {
+  assert(starfield == (GLuint)core.num_starfields + 1);
+  core.starfields = reserve_array(core.starfields, &core.max_starfields,
+                                  starfield, sizeof(*core.starfields));
+  ++core.num_starfields;
+  GLuint *vertex_array = &core.starfields[starfield - 1].vertex_array;
+  GLuint *vertex_buffer = &core.starfields[starfield - 1].vertex_buffer;
+  gl.GenVertexArrays(1, vertex_array);
+  gl.BindVertexArray(*vertex_array);
+  gl.GenBuffers(1, vertex_buffer);
+  gl.BindBuffer(GL_ARRAY_BUFFER, *vertex_buffer);
+  gl.BufferData(GL_ARRAY_BUFFER, num_stars * sizeof(az_gfx_star_t), data,
+                GL_STATIC_DRAW);
+  const struct { GLuint index; GLint size; size_t offset; } attribs[] = {
+    {STAR_POSITION_ATTRIB, 2, offsetof(az_gfx_star_t, x)},
+    {STAR_GRAY_ATTRIB, 1, offsetof(az_gfx_star_t, gray)},
+    {STAR_PHASE_ATTRIB, 1, offsetof(az_gfx_star_t, phase)},
+  };
+  AZ_ARRAY_LOOP(attrib, attribs) {
+    gl.EnableVertexAttribArray(attrib->index);
+    gl.VertexAttribPointer(attrib->index, attrib->size, GL_FLOAT, GL_FALSE,
+                           sizeof(az_gfx_star_t),
+                           (const GLvoid *)attrib->offset);
+    gl.VertexAttribDivisor(attrib->index, 1);
+  }
+  gl.BindVertexArray(core.vertex_array);
+  gl.BindBuffer(GL_ARRAY_BUFFER, core.vertex_buffer);
+}
+
+static void core_delete_starfield(GLuint starfield) {
+  assert(starfield != 0u && starfield <= (GLuint)core.num_starfields);
+  GLuint *vertex_array = &core.starfields[starfield - 1].vertex_array;
+  GLuint *vertex_buffer = &core.starfields[starfield - 1].vertex_buffer;
+  if (*vertex_array == 0u) return;
+  gl.DeleteVertexArrays(1, vertex_array);
+  gl.DeleteBuffers(1, vertex_buffer);
+  *vertex_array = *vertex_buffer = 0u;
+}
+
+static void core_draw_starfield(GLuint starfield, int num_stars,
+                                const GLfloat *data) {
+  assert(starfield != 0u && starfield <= (GLuint)core.num_starfields);
+  assert(core.starfields[starfield - 1].vertex_array != 0u);
+  if (num_stars <= 0) return;
+  core_flush();
+  gl.UseProgram(core.star_program);
+  gl.UniformMatrix4fv(core.star_projection_uniform, 1, GL_FALSE,
+                      core.projection.matrices[core.projection.top].m);
+  gl.UniformMatrix4fv(core.star_modelview_uniform, 1, GL_FALSE,
+                      core.modelview.matrices[core.modelview.top].m);
+  gl.Uniform4fv(core.star_stroke_uniform, 1, &data[0]);
+  gl.Uniform4fv(core.star_twinkle_uniform, 1, &data[4]);
+  gl.BindVertexArray(core.starfields[starfield - 1].vertex_array);
+  gl.DrawArraysInstanced(GL_LINES, 0, 2, num_stars);
+  ++stats.draw_calls;
+  stats.vertices += 2 * num_stars;
+  gl.UseProgram(core.program);
+  gl.BindVertexArray(core.vertex_array);
+  gl.BindBuffer(GL_ARRAY_BUFFER, core.vertex_buffer);
+}
+
+static void core_begin_msaa(GLsizei width, GLsizei height, GLsizei samples) {
+  if (core.msaa_framebuffer == 0u) {
+    gl.GenFramebuffers(1, &core.msaa_framebuffer);
+    gl.GenRenderbuffers(1, &core.msaa_renderbuffer);
+  }
+  gl.BindFramebuffer(GL_FRAMEBUFFER, core.msaa_framebuffer);
+  if (width != core.msaa_width || height != core.msaa_height ||
+      samples != core.msaa_samples) {
+    gl.BindRenderbuffer(GL_RENDERBUFFER, core.msaa_renderbuffer);
+    gl.RenderbufferStorageMultisample(GL_RENDERBUFFER, samples, GL_RGBA8,
+                                      width, height);
+    gl.FramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+                               GL_RENDERBUFFER, core.msaa_renderbuffer);
+    if (gl.CheckFramebufferStatus(GL_FRAMEBUFFER) !=
+        GL_FRAMEBUFFER_COMPLETE) {
+      AZ_FATAL("Multisampled offscreen framebuffer is incomplete.\n");
+    }
+    core.msaa_width = width;
+    core.msaa_height = height;
+    core.msaa_samples = samples;
+  }
+}
+
+static void core_begin_offscreen(GLsizei width, GLsizei height,
+                                 GLsizei samples, bool smooth_edges) {
+  core_flush();
+  core.offscreen_smooth_edges = smooth_edges;
+  if (core.offscreen_framebuffer == 0u) {
+    gl.GenFramebuffers(1, &core.offscreen_framebuffer);
+    glGenTextures(1, &core.offscreen_texture);
+    glBindTexture(GL_TEXTURE_2D, core.offscreen_texture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+  }
+  gl.BindFramebuffer(GL_FRAMEBUFFER, core.offscreen_framebuffer);
+  if (width != core.offscreen_width || height != core.offscreen_height) {
+    glBindTexture(GL_TEXTURE_2D, core.offscreen_texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA,
+                 GL_UNSIGNED_BYTE, NULL);
+    gl.FramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+                            GL_TEXTURE_2D, core.offscreen_texture, 0);
+    if (gl.CheckFramebufferStatus(GL_FRAMEBUFFER) !=
+        GL_FRAMEBUFFER_COMPLETE) {
+      AZ_FATAL("Offscreen framebuffer is incomplete.\n");
+    }
+    core.offscreen_width = width;
+    core.offscreen_height = height;
+  }
+  if (samples > 0) {
+    GLint max_samples = 0;
+    glGetIntegerv(GL_MAX_SAMPLES, &max_samples);
+    if (samples > max_samples) samples = max_samples;
+  }
+  core.offscreen_multisampled = (samples > 1);
+  if (core.offscreen_multisampled) core_begin_msaa(width, height, samples);
+}
+
+static void core_end_offscreen(GLint x, GLint y, GLsizei width,
+                               GLsizei height) {
+  core_flush();
+  if (core.offscreen_multisampled) {
+    // Resolve the multisampled image into the texture before filtering it.
+    // The blit is subject to the scissor test, so turn that off first.
+    const GLboolean scissor = glIsEnabled(GL_SCISSOR_TEST);
+    glDisable(GL_SCISSOR_TEST);
+    gl.BindFramebuffer(GL_READ_FRAMEBUFFER, core.msaa_framebuffer);
+    gl.BindFramebuffer(GL_DRAW_FRAMEBUFFER, core.offscreen_framebuffer);
+    gl.BlitFramebuffer(0, 0, core.msaa_width, core.msaa_height,
+                       0, 0, core.msaa_width, core.msaa_height,
+                       GL_COLOR_BUFFER_BIT, GL_NEAREST);
+    if (scissor) glEnable(GL_SCISSOR_TEST);
+  }
+  gl.BindFramebuffer(GL_FRAMEBUFFER, 0u);
+  const GLboolean blend = glIsEnabled(GL_BLEND);
+  const GLboolean scissor = glIsEnabled(GL_SCISSOR_TEST);
+  glDisable(GL_BLEND);
+  glDisable(GL_SCISSOR_TEST);
+  // Clear the whole window first, in case the image doesn't cover all of it.
+  glClear(GL_COLOR_BUFFER_BIT);
+  glViewport(x, y, width, height);
+  gl.UseProgram(core.post_program);
+  gl.Uniform2f(core.post_texel_size_uniform, 1.0f / core.offscreen_width,
+               1.0f / core.offscreen_height);
+  gl.Uniform1i(core.post_smooth_edges_uniform, core.offscreen_smooth_edges);
+  gl.BindVertexArray(core.post_vertex_array);
+  glBindTexture(GL_TEXTURE_2D, core.offscreen_texture);
+  glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+  ++stats.draw_calls;
+  gl.UseProgram(core.program);
+  gl.BindVertexArray(core.vertex_array);
+  gl.BindBuffer(GL_ARRAY_BUFFER, core.vertex_buffer);
+  if (blend) glEnable(GL_BLEND);
+  if (scissor) glEnable(GL_SCISSOR_TEST);
+}
+
+static void core_execute_command(const command_t *command,
+                                 const GLfloat *data) {
+  const command_kind_t kind = command->kind;
+  // While compiling a display list, record commands rather than executing
+  // them (except for those that manage display lists themselves).
+  if (core.compiling != NULL && kind != CMD_GEN_LISTS &&
+      kind != CMD_DELETE_LISTS && kind != CMD_END_LIST) {
+    assert(kind != CMD_NEW_LIST && kind != CMD_DRAW_GLOWS &&
+           kind != CMD_GEN_STARFIELD && kind != CMD_DELETE_STARFIELD &&
+           kind != CMD_DRAW_STARFIELD && kind != CMD_BEGIN_OFFSCREEN &&
+           kind != CMD_END_OFFSCREEN);
+    append_command(list_variant(core.compiling, core.compiling_variant),
+                   command, data);
+    return;
+  }
+  const GLuint *u = command->arg.u;
+  const GLint *i = command->arg.i;
+  const GLfloat *f = command->arg.f;
+  switch (kind) {
+    case CMD_BEGIN: core_begin(u[0]); break;
+    case CMD_END: core_end(); break;
+    case CMD_VERTEX: core_vertex(f[0], f[1]); break;
+    case CMD_COLOR: core_color(f[0], f[1], f[2], f[3]); break;
+    case CMD_MATRIX_MODE: core_matrix_mode(u[0]); break;
+    case CMD_LOAD_IDENTITY: core_load_identity(); break;
+    case CMD_PUSH_MATRIX: core_push_matrix(); break;
+    case CMD_POP_MATRIX: core_pop_matrix(); break;
+    case CMD_TRANSLATE: core_translate(f[0], f[1], f[2]); break;
+    case CMD_ROTATE: core_rotate(f[0], f[1], f[2], f[3]); break;
+    case CMD_SCALE: core_scale(f[0], f[1], f[2]); break;
+    case CMD_MULT_MATRIX: core_mult_matrix(data); break;
+    case CMD_GEN_LISTS: core_gen_lists(u[0], i[1]); break;
+    case CMD_DELETE_LISTS: core_delete_lists(u[0], i[1]); break;
+    case CMD_NEW_LIST: core_new_list(u[0], i[1]); break;
+    case CMD_END_LIST: core_end_list(); break;
+    case CMD_CALL_LIST: core_call_list(u[0], NULL); break;
+    case CMD_CALL_LIST_MODULATED: core_call_list(u[1], data); break;
+    case CMD_ENABLE:
+      // Point smoothing isn't available in the core profile.
+      if (u[0] == GL_POINT_SMOOTH) break;
+      core_flush();
+      glEnable(u[0]);
+      break;
+    case CMD_DISABLE:
+      if (u[0] == GL_POINT_SMOOTH) break;
+      core_flush();
+      glDisable(u[0]);
+      break;
+    case CMD_HINT:
+      if (u[0] == GL_POINT_SMOOTH_HINT) break;
+      glHint(u[0], u[1]);
+      break;
+    case CMD_BLEND_FUNC: core_flush(); glBlendFunc(u[0], u[1]); break;
+    case CMD_LINE_WIDTH: core_flush(); glLineWidth(f[0]); break;
+    case CMD_SCISSOR: core_flush(); glScissor(i[0], i[1], i[2], i[3]); break;
+    case CMD_VIEWPORT: core_flush(); glViewport(i[0], i[1], i[2], i[3]); break;
+    case CMD_CLEAR: core_flush(); glClear(u[0]); break;
+    case CMD_DRAW_GLOWS: core_draw_glows(i[1], data); break;
+    case CMD_GEN_STARFIELD: core_gen_starfield(u[2], i[1], data); break;
+    case CMD_DELETE_STARFIELD: core_delete_starfield(u[0]); break;
+    case CMD_DRAW_STARFIELD: core_draw_starfield(u[1], i[2], data); break;
+    case CMD_BEGIN_OFFSCREEN:
+      core_begin_offscreen(i[0], i[1], i[2], i[3]);
+      break;
+    case CMD_END_OFFSCREEN:
+      core_end_offscreen(i[0], i[1], i[2], i[3]);
+      break;
+  }
+}
+
+static bool init_glow_program(void) {
+  core.glow_program = link_program(glow_vert_source, glow_frag_source,
+                                   glow_attribs);
+  if (core.glow_program == 0u) return false;
+  core.glow_projection_uniform =
+    gl.GetUniformLocation(core.glow_program, "projection");
+  gl.GenVertexArrays(1, &core.glow_vertex_array);
+  gl.BindVertexArray(core.glow_vertex_array);
+  // Each glow is drawn as a single quad (as a triangle strip), with the
+  // falloff computed in the fragment shader.
+  static const GLfloat corners[] = {-1, -1, 1, -1, -1, 1, 1, 1};
+  gl.GenBuffers(1, &core.glow_quad_buffer);
+  gl.BindBuffer(GL_ARRAY_BUFFER, core.glow_quad_buffer);
+  gl.BufferData(GL_ARRAY_BUFFER, sizeof(corners), corners, GL_STATIC_DRAW);
+  gl.EnableVertexAttribArray(GLOW_CORNER_ATTRIB);
+  gl.VertexAttribPointer(GLOW_CORNER_ATTRIB, 2, GL_FLOAT, GL_FALSE,
+                         2 * sizeof(GLfloat), (const GLvoid *)0);
+  gl.GenBuffers(1, &core.glow_instance_buffer);
+  gl.BindBuffer(GL_ARRAY_BUFFER, core.glow_instance_buffer);
+  const struct { GLuint index; GLint size; size_t offset; } attribs[] = {
+    {GLOW_CENTER_ATTRIB, 2, offsetof(az_gfx_glow_t, x)},
+    {GLOW_COLOR_ATTRIB, 3, offsetof(az_gfx_glow_t, color)},
+    {GLOW_RADIUS_ATTRIB, 3, offsetof(az_gfx_glow_t, radius)},
+    {GLOW_ALPHA_ATTRIB, 3, offsetof(az_gfx_glow_t, alpha)},
+  };
+  AZ_ARRAY_LOOP(attrib, attribs) {
+    gl.EnableVertexAttribArray(attrib->index);
+    gl.VertexAttribPointer(attrib->index, attrib->size, GL_FLOAT, GL_FALSE,
+                           sizeof(az_gfx_glow_t),
+                           (const GLvoid *)attrib->offset);
+    gl.VertexAttribDivisor(attrib->index, 1);
+  }
+  return true;
+}
+
+static bool init_star_program(void) {
+  core.star_program = link_program(star_vert_source, vertex_color_frag_source,
+                                   star_attribs);
+  if (core.star_program == 0u) return false;
+  core.star_projection_uniform =
+    gl.GetUniformLocation(core.star_program, "projection");
+  core.star_modelview_uniform =
+    gl.GetUniformLocation(core.star_program, "modelview");
+  core.star_stroke_uniform = gl.GetUniformLocation(core.star_program, "stroke");
+  core.star_twinkle_uniform =
+    gl.GetUniformLocation(core.star_program, "twinkle");
+  return true;
+}
+
+// This must be called after init_glow_program, whose quad it borrows.
+static bool init_post_program(void) {
+  core.post_program = link_program(post_vert_source, post_frag_source,
+                                   post_attribs);
+  if (core.post_program == 0u) return false;
+  core.post_texel_size_uniform =
+    gl.GetUniformLocation(core.post_program, "texel_size");
+  core.post_smooth_edges_uniform =
+    gl.GetUniformLocation(core.post_program, "smooth_edges");
+  gl.GenVertexArrays(1, &core.post_vertex_array);
+  gl.BindVertexArray(core.post_vertex_array);
+  gl.BindBuffer(GL_ARRAY_BUFFER, core.glow_quad_buffer);
+  gl.EnableVertexAttribArray(POST_CORNER_ATTRIB);
+  gl.VertexAttribPointer(POST_CORNER_ATTRIB, 2, GL_FLOAT, GL_FALSE,
+                         2 * sizeof(GLfloat), (const GLvoid *)0);
+  return true;
+}
+
+static bool init_core_backend(void) {
+  if (!load_gl_functions()) return false;
+  if (!init_glow_program()) return false;
+  if (!init_star_program()) return false;
+  if (!init_post_program()) return false;
+  core.program = link_program(vertex_color_vert_source,
+                               vertex_color_frag_source, vertex_color_attribs);
+  if (core.program == 0u) return false;
+  core.projection_uniform = gl.GetUniformLocation(core.program, "projection");
+  core.modelview_uniform = gl.GetUniformLocation(core.program, "modelview");
+  core.color_weights_uniform =
+    gl.GetUniformLocation(core.program, "color_weights");
+  gl.GenVertexArrays(1, &core.vertex_array);
+  gl.BindVertexArray(core.vertex_array);
+  gl.GenBuffers(1, &core.vertex_buffer);
+  gl.BindBuffer(GL_ARRAY_BUFFER, core.vertex_buffer);
+  gl.EnableVertexAttribArray(POSITION_ATTRIB);
+  gl.VertexAttribPointer(POSITION_ATTRIB, 2, GL_FLOAT, GL_FALSE,
+                         sizeof(vertex_t), (const GLvoid *)0);
+  gl.EnableVertexAttribArray(COLOR_ATTRIB);
+  gl.VertexAttribPointer(COLOR_ATTRIB, 4, GL_FLOAT, GL_FALSE,
+                         sizeof(vertex_t),
+                         (const GLvoid *)(2 * sizeof(GLfloat)));
+  gl.UseProgram(core.program);
+  gl.UniformMatrix4fv(core.modelview_uniform, 1, GL_FALSE, identity_matrix.m);
+  core.matrix_mode = GL_MODELVIEW;
+  core.projection.top = core.modelview.top = 0;
+  core.projection.matrices[0] = core.modelview.matrices[0] = identity_matrix;
+  core.projection_dirty = true;
+  core_color(1, 1, 1, 1);
+  core.primitive_mode = GL_INVALID_ENUM;
+  core.batch_mode = GL_TRIANGLES;
+  core.batch.num_vertices = 0;
+  core.compiling = NULL;
+  core.baking = NULL;
+  return true;
+}
+
+/*===========================================================================*/
+// Legacy backend implementation:
+
+// Display list names handed out by az_gfx_gen_lists are our own, so that they
+// can be allocated even while commands are being recorded; this maps each of
+// them to the real GL display list.
+typedef struct {
+  GLuint gl_list; // 0 if the list isn't allocated
+  // For a list compiled with variants, a copy of each variant's commands, so
+  // that the list can be replayed with modulated colors (NULL otherwise):
+  az_gfx_command_list_t *variants;
+  bool modulated; // true once all of the variants have been compiled
+} legacy_list_t;
+
+static struct {
+  int num_lists, max_lists;
+  legacy_list_t *lists;
+  legacy_list_t *compiling;
+  int compiling_variant; // -1 if the list is being compiled without variants
+  az_gfx_command_list_t *copying; // if non-NULL, copy commands into this
+} legacy;
+
+static legacy_list_t *get_legacy_list(GLuint list) {
+  if (list == 0u || list > (GLuint)legacy.num_lists) return NULL;
+  legacy_list_t *legacy_list = &legacy.lists[list - 1];
+  return legacy_list->gl_list != 0u ? legacy_list : NULL;
+}
+
+static void legacy_gen_lists(GLuint first, GLsizei range) {
+  const GLuint gl_first = glGenLists(range);
+  if (gl_first == 0u) AZ_FATAL("glGenLists failed.\n");
+  const int end = first - 1 + range;
+  legacy.lists = reserve_array(legacy.lists, &legacy.max_lists, end,
+                               sizeof(legacy_list_t));
+  while (legacy.num_lists < end) {
+    legacy.lists[legacy.num_lists++] = (legacy_list_t){.gl_list = 0u};
+  }
+  for (GLsizei i = 0; i < range; ++i) {
+    legacy.lists[first - 1 + i] = (legacy_list_t){.gl_list = gl_first + i};
+  }
+}
+
+static void legacy_delete_lists(GLuint first, GLsizei range) {
+  for (GLuint list = first; list < first + range; ++list) {
+    legacy_list_t *legacy_list = get_legacy_list(list);
+    if (legacy_list == NULL) continue;
+    glDeleteLists(legacy_list->gl_list, 1);
+    if (legacy_list->variants != NULL) {
+      for (int v = 0; v < AZ_GFX_NUM_LIST_VARIANTS; ++v) {
+        free(legacy_list->variants[v].commands);
+        free(legacy_list->variants[v].data);
+      }
+      free(legacy_list->variants);
+    }
+    *legacy_list = (legacy_list_t){.gl_list = 0u};
+  }
+}
+
+static void legacy_new_list(GLuint list, int variant) {
+  legacy_list_t *legacy_list = get_legacy_list(list);
+  if (legacy_list == NULL) AZ_FATAL("Invalid display list: %u\n", list);
+  legacy.compiling = legacy_list;
+  legacy.compiling_variant = variant;
+  legacy.copying = NULL;
+  // Only the list itself is compiled into the GL display list; its other
+  // variants are just copied, for az_gfx_call_list_modulated to replay.
+  if (variant <= 0) {
+    legacy_list->modulated = false;
+    glNewList(legacy_list->gl_list, GL_COMPILE);
+    if (variant < 0) return;
+    if (legacy_list->variants == NULL) {
+      legacy_list->variants =
+        AZ_ALLOC(AZ_GFX_NUM_LIST_VARIANTS, az_gfx_command_list_t);
+    }
+  } else if (legacy_list->variants == NULL) {
+    AZ_FATAL("Display list variant %d compiled before the list.\n", variant);
+  }
+  legacy.copying = &legacy_list->variants[variant];
+  legacy.copying->num_commands = 0;
+  legacy.copying->num_data = 0;
+}
+
+static void legacy_end_list(void) {
+  legacy_list_t *legacy_list = legacy.compiling;
+  assert(legacy_list != NULL);
+  if (legacy.compiling_variant <= 0) glEndList();
+  if (legacy.compiling_variant == AZ_GFX_NUM_LIST_VARIANTS - 1) {
+    const az_gfx_command_list_t *variants[AZ_GFX_NUM_LIST_VARIANTS];
+    for (int v = 0; v < AZ_GFX_NUM_LIST_VARIANTS; ++v) {
+      variants[v] = &legacy_list->variants[v];
+    }
+    check_list_variants(variants);
+    legacy_list->modulated = true;
+  }
+  legacy.compiling = NULL;
+  legacy.copying = NULL;
+}
+
+// Call a list, modulating its colors by the weights if they're non-NULL.
+static void legacy_call_list(GLuint list, const GLfloat *weights) {
+  const legacy_list_t *legacy_list = get_legacy_list(list);
+  if (legacy_list == NULL) return;
+  if (legacy_list->modulated && weights != NULL) {
+    const az_gfx_command_list_t *variants[AZ_GFX_NUM_LIST_VARIANTS];
+    for (int v = 0; v < AZ_GFX_NUM_LIST_VARIANTS; ++v) {
+      variants[v] = &legacy_list->variants[v];
+    }
+    execute_modulated_command_lists(variants, weights);
+  } else {
+    glCallList(legacy_list->gl_list);
+    ++stats.draw_calls;
+  }
+}
+
+static void legacy_execute_command(const command_t *command,
+                                   const GLfloat *data) {
+  const command_kind_t kind = command->kind;
+  if (legacy.copying != NULL && kind != CMD_GEN_LISTS &&
+      kind != CMD_DELETE_LISTS && kind != CMD_END_LIST) {
+    append_command(legacy.copying, command, data);
+    if (legacy.compiling_variant > 0) return;
+  }
+  const GLuint *u = command->arg.u;
+  const GLint *i = command->arg.i;
+  const GLfloat *f = command->arg.f;
+  switch (kind) {
+    case CMD_BEGIN: glBegin(u[0]); ++stats.draw_calls; break;
+    case CMD_END: glEnd(); break;
+    case CMD_VERTEX: glVertex2f(f[0], f[1]); break;
+    case CMD_COLOR: glColor4f(f[0], f[1], f[2], f[3]); break;
+    case CMD_MATRIX_MODE: glMatrixMode(u[0]); break;
+    case CMD_LOAD_IDENTITY: glLoadIdentity(); break;
+    case CMD_PUSH_MATRIX: glPushMatrix(); break;
+    case CMD_POP_MATRIX: glPopMatrix(); break;
+    case CMD_TRANSLATE: glTranslatef(f[0], f[1], f[2]); break;
+    case CMD_ROTATE: glRotatef(f[0], f[1], f[2], f[3]); break;
+    case CMD_SCALE: glScalef(f[0], f[1], f[2]); break;
+    case CMD_MULT_MATRIX: glMultMatrixf(data); break;
+    case CMD_GEN_LISTS: legacy_gen_lists(u[0], i[1]); break;
+    case CMD_DELETE_LISTS: legacy_delete_lists(u[0], i[1]); break;
+    case CMD_NEW_LIST: legacy_new_list(u[0], i[1]); break;
+    case CMD_END_LIST: legacy_end_list(); break;
+    case CMD_CALL_LIST: legacy_call_list(u[0], NULL); break;
+    case CMD_CALL_LIST_MODULATED: legacy_call_list(u[1], data); break;
+    case CMD_ENABLE: glEnable(u[0]); break;
+    case CMD_DISABLE: glDisable(u[0]); break;
+    case CMD_HINT: glHint(u[0], u[1]); break;
+    case CMD_BLEND_FUNC: glBlendFunc(u[0], u[1]); break;
+    case CMD_LINE_WIDTH: glLineWidth(f[0]); break;
+    case CMD_SCISSOR: glScissor(i[0], i[1], i[2], i[3]); break;
+    case CMD_VIEWPORT: glViewport(i[0], i[1], i[2], i[3]); break;
+    case CMD_CLEAR: glClear(u[0]); break;
+    case CMD_DRAW_GLOWS:
+    case CMD_GEN_STARFIELD:
+    case CMD_DELETE_STARFIELD:
+    case CMD_DRAW_STARFIELD:
+    case CMD_BEGIN_OFFSCREEN:
+    case CMD_END_OFFSCREEN:
+      AZ_ASSERT_UNREACHABLE();
+  }
+}
+
+static void execute_command(const command_t *command, const GLfloat *data) {
+  if (current_backend == AZ_GFX_LEGACY) {
+    legacy_execute_command(command, data);
+  } else core_execute_command(command, data);
+}
+
+/*===========================================================================*/
+// Frontend:
+
+// The frontend state is only ever touched by the thread making az_gfx_* calls
+// (which need not be the thread that owns the GL context, if commands are
+// being recorded).
+static struct {
+  az_gfx_command_list_t *recording;
+  int num_lists, max_lists;
+  bool *list_allocated;
+  bool compiling_list, compiling_variant;
+  int num_starfields;
+  // How much each matrix on the modelview stack scales lengths, as far as can
+  // be told from the calls made (see az_gfx_modelview_scale).  The depth may
+  // exceed the stack size, in which case the top scale is shared.
+  GLenum matrix_mode;
+  int scale_depth;
+  GLfloat modelview_scales[MATRIX_STACK_DEPTH];
+} frontend;
+
+static GLfloat *top_modelview_scale(void) {
+  return &frontend.modelview_scales[
+      frontend.scale_depth < MATRIX_STACK_DEPTH ? frontend.scale_depth :
+      MATRIX_STACK_DEPTH - 1];
+}
+
+// Return the scale of the top of the modelview stack, or NULL if calls that
+// are being made now don't affect it.
+static GLfloat *tracked_scale(void) {
+  if (frontend.matrix_mode != GL_MODELVIEW || frontend.compiling_list) {
+    return NULL;
+  }
+  return top_modelview_scale();
+}
+
+// Return true if calls can be passed straight through to GL, as in the days
+// before this module existed.  Every az_gfx_* call either passes through or
+// submits a command (but not both), so this and submit() count API calls.
+// The legacy backend keeps a copy of each list variant's commands, so those
+// don't pass through either.
+static bool pass_through(void) {
+  const bool result = current_backend == AZ_GFX_LEGACY &&
+    frontend.recording == NULL && !frontend.compiling_variant;
+  if (result) ++stats.api_calls;
+  return result;
+}
+
+static void submit(const command_t *command, const GLfloat *data) {
+  ++stats.api_calls;
+  if (frontend.recording != NULL) {
+    append_command(frontend.recording, command, data);
+  } else execute_command(command, data);
+}
+
+/*===========================================================================*/
+
+bool az_gfx_init(az_gfx_backend_t backend) {
+  frontend.matrix_mode = GL_MODELVIEW;
+  frontend.scale_depth = 0;
+  frontend.modelview_scales[0] = 1.0f;
+  current_backend = AZ_GFX_LEGACY;
+  if (backend == AZ_GFX_CORE) {
+    if (!init_core_backend()) return false;
+    current_backend = AZ_GFX_CORE;
+  }
+  return true;
+}
+
+az_gfx_backend_t az_gfx_backend(void) {
+  return current_backend;
+}
+
+void az_gfx_set_proc_loader(az_gfx_proc_loader_t loader) {
+  proc_loader = loader;
+}
+
+az_gfx_stats_t az_gfx_get_stats(void) {
+  return stats;
+}
+
+void az_gfx_reset_stats(void) {
+  AZ_ZERO_OBJECT(&stats);
+}
+
+void az_gfx_flush(void) {
+  if (current_backend == AZ_GFX_LEGACY) return;
+  core_flush();
+}
+
+GLfloat az_gfx_modelview_scale(void) {
+  return *top_modelview_scale();
+}
+
+bool az_gfx_compiling_list(void) {
+  return frontend.compiling_list;
+}
+
+void az_gfx_draw_glows(int num_glows, const az_gfx_glow_t *glows) {
+  assert(current_backend == AZ_GFX_CORE);
+  assert(num_glows >= 0);
+  if (num_glows == 0) return;
+  submit(&(command_t){.kind = CMD_DRAW_GLOWS, .arg.i = {0, num_glows}},
+         (const GLfloat *)glows);
+}
+
+GLuint az_gfx_gen_starfield(int num_stars, const az_gfx_star_t *stars) {
+  assert(current_backend == AZ_GFX_CORE);
+  assert(num_stars >= 0);
+  const GLuint starfield = ++frontend.num_starfields;
+  submit(&(command_t){.kind = CMD_GEN_STARFIELD,
+                      .arg.i = {0, num_stars, starfield}},
+         (const GLfloat *)stars);
+  return starfield;
+}
+
+void az_gfx_delete_starfield(GLuint starfield) {
+  assert(current_backend == AZ_GFX_CORE);
+  submit(&(command_t){.kind = CMD_DELETE_STARFIELD, .arg.u = {starfield}},
+         NULL);
+}
+
+void az_gfx_draw_starfield(GLuint starfield, int num_stars,
+                           const az_gfx_starfield_style_t *style,
+                           az_clock_t clock) {
+  assert(current_backend == AZ_GFX_CORE);
+  assert(num_stars >= 0);
+  if (num_stars == 0) return;
+  // Only the clock's phase within the twinkle period matters, so reduce it to
+  // that before handing it to the shader as a float.
+  GLfloat reduced_clock = 0.0f;
+  if (style->twinkle_gray != 0.0f) {
+    assert(style->twinkle_modulus >= 2);
+    assert(style->twinkle_slowdown >= 1);
+    reduced_clock = clock % (2 * (style->twinkle_modulus - 1) *
+                             style->twinkle_slowdown);
+  }
+  const GLfloat data[STARFIELD_STYLE_NUM_FLOATS] = {
+    style->scroll, style->wrap, style->tail_length, style->tail_gray,
+    style->twinkle_gray, style->twinkle_modulus, style->twinkle_slowdown,
+    reduced_clock
+  };
+  submit(&(command_t){.kind = CMD_DRAW_STARFIELD,
+                      .arg.i = {0, starfield, num_stars}}, data);
+}
+
+void az_gfx_begin_offscreen(GLsizei width, GLsizei height, GLsizei samples,
+                            bool smooth_edges) {
+  assert(current_backend == AZ_GFX_CORE);
+  assert(width > 0 && height > 0);
+  assert(samples >= 0);
+  submit(&(command_t){.kind = CMD_BEGIN_OFFSCREEN,
+                      .arg.i = {width, height, samples, smooth_edges}}, NULL);
+}
+
+void az_gfx_end_offscreen(GLint x, GLint y, GLsizei width, GLsizei height) {
+  assert(current_backend == AZ_GFX_CORE);
+  submit(&(command_t){.kind = CMD_END_OFFSCREEN,
+                      .arg.i = {x, y, width, height}}, NULL);
+}
+
+/*===========================================================================*/
+
+az_gfx_command_list_t *az_gfx_new_command_list(void) {
+  az_gfx_command_list_t *list = AZ_ALLOC(1, az_gfx_command_list_t);
+  return list;
+}
+
+void az_gfx_delete_command_list(az_gfx_command_list_t *list) {
+  if (list == NULL) return;
+  free(list->commands);
+  free(list->data);
+  free(list);
+}
+
+void az_gfx_record_commands(az_gfx_command_list_t *list) {
+  if (list != NULL) {
+    list->num_commands = 0;
+    list->num_data = 0;
+  }
+  frontend.recording = list;
+}
+
+void az_gfx_replay_commands(const az_gfx_command_list_t *list) {
+  execute_command_list(list);
+}
+
+/*===========================================================================*/
+
+void az_gfx_begin(GLenum mode) {
+  if (pass_through()) {
+    glBegin(mode);
+    ++stats.draw_calls;
+    return;
+  }
+  submit(&(command_t){.kind = CMD_BEGIN, .arg.u = {mode}}, NULL);
+}
+
+void az_gfx_end(void) {
+  if (pass_through()) {
+    glEnd();
+    return;
+  }
+  submit(&(command_t){.kind = CMD_END}, NULL);
+}
+
+void az_gfx_vertex2f(GLfloat x, GLfloat y) {
+  if (pass_through()) {
+    glVertex2f(x, y);
+    return;
+  }
+  submit(&(command_t){.kind = CMD_VERTEX, .arg.f = {x, y}}, NULL);
+}
+
+void az_gfx_vertex2d(GLdouble x, GLdouble y) {
+  if (pass_through()) {
+    glVertex2d(x, y);
+    return;
+  }
+  submit(&(command_t){.kind = CMD_VERTEX, .arg.f = {x, y}}, NULL);
+}
+
+void az_gfx_vertex2i(GLint x, GLint y) {
+  if (pass_through()) {
+    glVertex2i(x, y);
+    return;
+  }
+  submit(&(command_t){.kind = CMD_VERTEX, .arg.f = {x, y}}, NULL);
+}
+
+void az_gfx_color3f(GLfloat r, GLfloat g, GLfloat b) {
+  if (pass_through()) {
+    glColor3f(r, g, b);
+    return;
+  }
+  submit(&(command_t){.kind = CMD_COLOR, .arg.f = {r, g, b, 1}}, NULL);
+}
+
+void az_gfx_color4f(GLfloat r, GLfloat g, GLfloat b, GLfloat a) {
+  if (pass_through()) {
+    glColor4f(r, g, b, a);
+    return;
+  }
+  submit(&(command_t){.kind = CMD_COLOR, .arg.f = {r, g, b, a}}, NULL);
+}
+
+void az_gfx_color3ub(GLubyte r, GLubyte g, GLubyte b) {
+  if (pass_through()) {
+    glColor3ub(r, g, b);
+    return;
+  }
+  az_gfx_color4f(r / 255.0f, g / 255.0f, b / 255.0f, 1);
+}
+
+void az_gfx_color4ub(GLubyte r, GLubyte g, GLubyte b, GLubyte a) {
+  if (pass_through()) {
+    glColor4ub(r, g, b, a);
+    return;
+  }
+  az_gfx_color4f(r / 255.0f, g / 255.0f, b / 255.0f, a / 255.0f);
+}
+
+/*===========================================================================*/
+
+void az_gfx_matrix_mode(GLenum mode) {
+  if (!frontend.compiling_list) frontend.matrix_mode = mode;
+  if (pass_through()) {
+    glMatrixMode(mode);
+    return;
+  }
+  submit(&(command_t){.kind = CMD_MATRIX_MODE, .arg.u = {mode}}, NULL);
+}
+
+void az_gfx_load_identity(void) {
+  GLfloat *scale = tracked_scale();
+  if (scale != NULL) *scale = 1.0f;
+  if (pass_through()) {
+    glLoadIdentity();
+    return;
+  }
+  submit(&(command_t){.kind = CMD_LOAD_IDENTITY}, NULL);
+}
+
+void az_gfx_push_matrix(void) {
+  const GLfloat *scale = tracked_scale();
+  if (scale != NULL) {
+    ++frontend.scale_depth;
+    *tracked_scale() = *scale;
+  }
+  if (pass_through()) {
+    glPushMatrix();
+    return;
+  }
+  submit(&(command_t){.kind = CMD_PUSH_MATRIX}, NULL);
+}
+
+void az_gfx_pop_matrix(void) {
+  if (tracked_scale() != NULL && frontend.scale_depth > 0) {
+    --frontend.scale_depth;
+  }
+  if (pass_through()) {
+    glPopMatrix();
+    return;
+  }
+  submit(&(command_t){.kind = CMD_POP_MATRIX}, NULL);
+}
+
+void az_gfx_translatef(GLfloat x, GLfloat y, GLfloat z) {
+  if (pass_through()) {
+    glTranslatef(x, y, z);
+    return;
+  }
+  submit(&(command_t){.kind = CMD_TRANSLATE, .arg.f = {x, y, z}}, NULL);
+}
+
+void az_gfx_translated(GLdouble x, GLdouble y, GLdouble z) {
+  if (pass_through()) {
+    glTranslated(x, y, z);
+    return;
+  }
+  az_gfx_translatef(x, y, z);
+}
+
+void az_gfx_rotatef(GLfloat degrees, GLfloat x, GLfloat y, GLfloat z) {
+  if (pass_through()) {
+    glRotatef(degrees, x, y, z);
+    return;
+  }
+  submit(&(command_t){.kind = CMD_ROTATE, .arg.f = {degrees, x, y, z}},
+         NULL);
+}
+
+void az_gfx_rotated(GLdouble degrees, GLdouble x, GLdouble y, GLdouble z) {
+  if (pass_through()) {
+    glRotated(degrees, x, y, z);
+    return;
+  }
+  az_gfx_rotatef(degrees, x, y, z);
+}
+
+void az_gfx_scalef(GLfloat x, GLfloat y, GLfloat z) {
+  GLfloat *scale = tracked_scale();
+  if (scale != NULL) *scale *= sqrtf(fabsf(x * y));
+  if (pass_through()) {
+    glScalef(x, y, z);
+    return;
+  }
+  submit(&(command_t){.kind = CMD_SCALE, .arg.f = {x, y, z}}, NULL);
+}
+
+void az_gfx_scaled(GLdouble x, GLdouble y, GLdouble z) {
+  if (pass_through()) {
+    glScaled(x, y, z);
+    return;
+  }
+  az_gfx_scalef(x, y, z);
+}
+
+void az_gfx_mult_matrixf(const GLfloat *matrix) {
+  GLfloat *scale = tracked_scale();
+  if (scale != NULL) {
+    *scale *= sqrtf(fabsf(matrix[0] * matrix[5] - matrix[1] * matrix[4]));
+  }
+  if (pass_through()) {
+    glMultMatrixf(matrix);
+    return;
+  }
+  submit(&(command_t){.kind = CMD_MULT_MATRIX}, matrix);
+}
+
+void az_gfx_ortho(GLdouble left, GLdouble right, GLdouble bottom,
+                  GLdouble top, GLdouble near_val, GLdouble far_val) {
+  if (pass_through()) {
+    glOrtho(left, right, bottom, top, near_val, far_val);
+    return;
+  }
+  const GLfloat matrix[16] = {
+    2 / (right - left), 0, 0, 0,
+    0, 2 / (top - bottom), 0, 0,
+    0, 0, -2 / (far_val - near_val), 0,
+    -(right + left) / (right - left), -(top + bottom) / (top - bottom),
+    -(far_val + near_val) / (far_val - near_val), 1
+  };
+  az_gfx_mult_matrixf(matrix);
+}
+
+/*===========================================================================*/
+
+GLuint az_gfx_gen_lists(GLsizei range) {
+  assert(range > 0);
+  const GLuint first = frontend.num_lists + 1;
+  frontend.list_allocated =
+    reserve_array(frontend.list_allocated, &frontend.max_lists,
+                  frontend.num_lists + range, sizeof(bool));
+  for (GLsizei i = 0; i < range; ++i) {
+    frontend.list_allocated[frontend.num_lists++] = true;
+  }
+  submit(&(command_t){.kind = CMD_GEN_LISTS, .arg.i = {first, range}}, NULL);
+  return first;
+}
+
+void az_gfx_delete_lists(GLuint list, GLsizei range) {
+  for (GLuint i = list; i < list + range; ++i) {
+    if (az_gfx_is_list(i)) frontend.list_allocated[i - 1] = false;
+  }
+  submit(&(command_t){.kind = CMD_DELETE_LISTS, .arg.i = {list, range}},
+         NULL);
+}
+
+GLboolean az_gfx_is_list(GLuint list) {
+  return (list != 0u && list <= (GLuint)frontend.num_lists &&
+          frontend.list_allocated[list - 1] ? GL_TRUE : GL_FALSE);
+}
+
+void az_gfx_new_list(GLuint list, GLenum mode) {
+  assert(mode == GL_COMPILE);
+  assert(az_gfx_is_list(list));
+  frontend.compiling_list = true;
+  submit(&(command_t){.kind = CMD_NEW_LIST, .arg.i = {list, -1}}, NULL);
+}
+
+void az_gfx_new_list_variant(GLuint list, int variant) {
+  assert(az_gfx_is_list(list));
+  assert(variant >= 0 && variant < AZ_GFX_NUM_LIST_VARIANTS);
+  frontend.compiling_list = frontend.compiling_variant = true;
+  submit(&(command_t){.kind = CMD_NEW_LIST, .arg.i = {list, variant}}, NULL);
+}
+
+void az_gfx_end_list(void) {
+  submit(&(command_t){.kind = CMD_END_LIST}, NULL);
+  frontend.compiling_list = frontend.compiling_variant = false;
+}
+
+void az_gfx_call_list(GLuint list) {
+  submit(&(command_t){.kind = CMD_CALL_LIST, .arg.u = {list}}, NULL);
+}
+
+void az_gfx_call_list_modulated(GLuint list, GLfloat weight1,
+                                GLfloat weight2) {
+  const GLfloat rgba1[4] = {weight1, weight1, weight1, weight1};
+  const GLfloat rgba2[4] = {weight2, weight2, weight2, weight2};
+  az_gfx_call_list_modulated_rgba(list, rgba1, rgba2);
+}
+
+void az_gfx_call_list_modulated_rgba(GLuint list, const GLfloat weight1[4],
+                                     const GLfloat weight2[4]) {
+  GLfloat weights[COLOR_WEIGHTS_NUM_FLOATS];
+  bool any_nonzero = false;
+  for (int j = 0; j < 4; ++j) {
+    weights[j] = weight1[j];
+    weights[4 + j] = weight2[j];
+    any_nonzero |= (weight1[j] != 0.0f || weight2[j] != 0.0f);
+  }
+  if (!any_nonzero) {
+    az_gfx_call_list(list);
+    return;
+  }
+  submit(&(command_t){.kind = CMD_CALL_LIST_MODULATED, .arg.u = {0, list}},
+         weights);
+}
+
+void az_gfx_call_lists(GLsizei n, GLenum type, const GLvoid *lists) {
+  assert(type == GL_UNSIGNED_INT);
+  for (GLsizei i = 0; i < n; ++i) {
+    az_gfx_call_list(((const GLuint *)lists)[i]);
+  }
+}
+
+/*===========================================================================*/
+
+void az_gfx_enable(GLenum cap) {
+  if (pass_through()) {
+    glEnable(cap);
+    return;
+  }
+  submit(&(command_t){.kind = CMD_ENABLE, .arg.u = {cap}}, NULL);
+}
+
+void az_gfx_disable(GLenum cap) {
+  if (pass_through()) {
+    glDisable(cap);
+    return;
+  }
+  submit(&(command_t){.kind = CMD_DISABLE, .arg.u = {cap}}, NULL);
+}
+
+void az_gfx_hint(GLenum target, GLenum mode) {
+  if (pass_through()) {
+    glHint(target, mode);
+    return;
+  }
+  submit(&(command_t){.kind = CMD_HINT, .arg.u = {target, mode}}, NULL);
+}
+
+void az_gfx_blend_func(GLenum sfactor, GLenum dfactor) {
+  if (pass_through()) {
+    glBlendFunc(sfactor, dfactor);
+    return;
+  }
+  submit(&(command_t){.kind = CMD_BLEND_FUNC, .arg.u = {sfactor, dfactor}},
+         NULL);
+}
+
+void az_gfx_line_width(GLfloat width) {
+  if (pass_through()) {
+    glLineWidth(width);
+    return;
+  }
+  submit(&(command_t){.kind = CMD_LINE_WIDTH, .arg.f = {width}}, NULL);
+}
+
+void az_gfx_scissor(GLint x, GLint y, GLsizei width, GLsizei height) {
+  if (pass_through()) {
+    glScissor(x, y, width, height);
+    return;
+  }
+  submit(&(command_t){.kind = CMD_SCISSOR, .arg.i = {x, y, width, height}},
+         NULL);
+}
+
+void az_gfx_viewport(GLint x, GLint y, GLsizei width, GLsizei height) {
+  if (pass_through()) {
+    glViewport(x, y, width, height);
+    return;
+  }
+  submit(&(command_t){.kind = CMD_VIEWPORT, .arg.i = {x, y, width, height}},
+         NULL);
+}
+
+void az_gfx_clear(GLbitfield mask) {
+  if (pass_through()) {
+    glClear(mask);
+    return;
+  }
+  submit(&(command_t){.kind = CMD_CLEAR, .arg.u = {mask}}, NULL);
+}
+
+/*===========================================================================*/
@@ -0,0 +1,234 @@
+/*=============================================================================
+| Copyright 2012 Matthew D. Steele <mdsteele@alum.mit.edu>                    |
+|                                                                             |
+| This file is part of Azimuth.                                               |
+|                                                                             |
+| Azimuth is free software: you can redistribute it and/or modify it under    |
+| the terms of the GNU General Public License as published by the Free        |
+| Software Foundation, either version 3 of the License, or (at your option)   |
+| any later version.                                                          |
+|                                                                             |
+| Azimuth is distributed in the hope that it will be useful, but WITHOUT      |
+| ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       |
+| FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for   |
+| more details.                                                               |
+|                                                                             |
+| You should have received a copy of the GNU General Public License along     |
+| with Azimuth.  If not, see <http://www.gnu.org/licenses/>.                  |
+=============================================================================*/
+
+
+#pragma once
+#ifndef AZIMUTH_GUI_GFX_H_
+#define AZIMUTH_GUI_GFX_H_
+
+#include <stdbool.h>
+
+#include <SDL_opengl.h>
+
+#include "azimuth/util/clock.h"
+#include "azimuth/util/prefs.h" // for az_gfx_backend_t
+
+/*===========================================================================*/
+
+// The view code is written against the subset of the fixed-function OpenGL
+// pipeline that is redirected in azimuth/gui/opengl.h.  Each of those calls
+// goes through one of the functions below, which either passes it straight
+// through to GL (for AZ_GFX_LEGACY), or emulates it on top of a GL 3.3 core
+// profile context (for AZ_GFX_CORE), using CPU-side matrix stacks, batched
+// vertex buffers, and a vertex-color shader program.
+
+// Set up the given backend for the current GL context.  This is called by
+// az_init_gui, and should not be called from elsewhere.
+// Returns false if the backend could not be initialized (e.g. because a shader
+// failed to compile), in which case the caller should fall back to a legacy
+// context.
+bool az_gfx_init(az_gfx_backend_t backend);
+
+// Return the backend that is currently in use.
+az_gfx_backend_t az_gfx_backend(void);
+
+// Set the function used to look up GL entry points for the core backend,
+// which is SDL_GL_GetProcAddress by default.  This is for programs that set up
+// their GL context without SDL (such as the headless benchmark), and must be
+// called before az_gfx_init.
+typedef void *(*az_gfx_proc_loader_t)(const char *name);
+void az_gfx_set_proc_loader(az_gfx_proc_loader_t loader);
+
+// Counts of calls made since the last call to az_gfx_reset_stats, for
+// benchmarking.  These are not synchronized, so are only accurate without a
+// render thread.
+typedef struct {
+  int api_calls; // az_gfx_* calls made (i.e. redirected gl* calls)
+  int draw_calls; // glBegin/glCallList (legacy) or glDraw* (core) calls
+  int vertices; // vertices drawn (core only)
+} az_gfx_stats_t;
+
+az_gfx_stats_t az_gfx_get_stats(void);
+void az_gfx_reset_stats(void);
+
+// Submit any geometry that the core backend is still batching.  This must be
+// called before swapping buffers or reading back pixels; it is a no-op for the
+// legacy backend.
+void az_gfx_flush(void);
+
+// Return roughly how many units (usually screen pixels) one unit of the
+// current modelview matrix spans, for picking a level of detail.  This is
+// tracked from the calls made on this thread, so it is available while
+// recording commands, but it ignores transforms made while compiling (or by
+// calling) display lists, and rotations other than around the Z axis.
+GLfloat az_gfx_modelview_scale(void);
+
+// Return true if calls made on this thread are currently being compiled into
+// a display list (i.e. between glNewList and glEndList).
+bool az_gfx_compiling_list(void);
+
+// A circular glow, whose alpha varies linearly with distance from the center:
+// from alpha[0] at radius[0], to alpha[1] at radius[1], to alpha[2] at
+// radius[2].  It is fully transparent outside of radius[0] to radius[2].
+typedef struct {
+  GLfloat x, y;
+  GLfloat color[3];
+  GLfloat radius[3];
+  GLfloat alpha[3];
+} az_gfx_glow_t;
+
+// Draw the given glows (relative to the current modelview matrix) with a
+// single instanced draw call, computing the falloff in a fragment shader.
+// This is only available with the AZ_GFX_CORE backend.
+void az_gfx_draw_glows(int num_glows, const az_gfx_glow_t *glows);
+
+// One star in a starfield, which is drawn as a horizontal line segment (see
+// az_gfx_starfield_style_t).  The phase offsets the star's twinkling.
+typedef struct {
+  GLfloat x, y;
+  GLfloat gray;
+  GLfloat phase;
+} az_gfx_star_t;
+
+// How to draw a starfield: each star's x is offset by scroll, wrapping back
+// by wrap if that takes it past wrap (unless wrap is zero), and the star is
+// then drawn from there to tail_length units to its left, fading to
+// tail_gray times its gray at the far end.  If twinkle_gray is nonzero, each
+// star's gray is raised by twinkle_gray times
+// az_clock_zigzag(twinkle_modulus, twinkle_slowdown, clock + phase).
+typedef struct {
+  GLfloat scroll, wrap;
+  GLfloat tail_length, tail_gray;
+  GLfloat twinkle_gray;
+  int twinkle_modulus, twinkle_slowdown;
+} az_gfx_starfield_style_t;
+
+// Upload the given stars into a static vertex buffer, and return a name for
+// the new starfield, so that drawing it each frame only needs to set a few
+// uniforms rather than resubmit every star.  Delete it when it's no longer
+// needed.  These are only available with the AZ_GFX_CORE backend, and must
+// not be called while compiling a display list.
+GLuint az_gfx_gen_starfield(int num_stars, const az_gfx_star_t *stars);
+void az_gfx_delete_starfield(GLuint starfield);
+
+// Draw the first num_stars stars of the starfield (relative to the current
+// modelview matrix) with a single instanced draw call.
+void az_gfx_draw_starfield(GLuint starfield, int num_stars,
+                           const az_gfx_starfield_style_t *style,
+                           az_clock_t clock);
+
+// Draw everything up until the matching az_gfx_end_offscreen call into an
+// offscreen framebuffer of the given size (in pixels), rather than into the
+// window.  az_gfx_end_offscreen then clears the window and draws the offscreen
+// image into the given viewport rectangle with a single filtered quad, which
+// need not be the same size, smoothing jagged edges on the way if
+// smooth_edges is true.  If samples is more than 1, the offscreen image is
+// multisampled (clamped to what the driver supports) and resolved before it
+// is drawn, so that it keeps the window's MSAA; pass 0 for none.  These are
+// only available with the AZ_GFX_CORE backend, and must not be called while
+// compiling a display list.
+void az_gfx_begin_offscreen(GLsizei width, GLsizei height, GLsizei samples,
+                            bool smooth_edges);
+void az_gfx_end_offscreen(GLint x, GLint y, GLsizei width, GLsizei height);
+
+/*===========================================================================*/
+
+// A command list records az_gfx_* calls so that they can be executed later,
+// possibly on another thread (the one that owns the GL context).
+typedef struct az_gfx_command_list az_gfx_command_list_t;
+
+az_gfx_command_list_t *az_gfx_new_command_list(void);
+void az_gfx_delete_command_list(az_gfx_command_list_t *list);
+
+// Clear the given list, and record all subsequent az_gfx_* calls (other than
+// the ones above) into it rather than executing them.  Pass NULL to go back to
+// executing calls immediately.  Display list names are still returned
+// immediately by glGenLists while recording.
+void az_gfx_record_commands(az_gfx_command_list_t *list);
+
+// Execute the commands recorded in the list.  This must be called from the
+// thread that owns the GL context, which need not be the thread that recorded
+// the commands, but the list must not be recorded into while this is running.
+void az_gfx_replay_commands(const az_gfx_command_list_t *list);
+
+/*===========================================================================*/
+
+void az_gfx_begin(GLenum mode);
+void az_gfx_end(void);
+void az_gfx_vertex2f(GLfloat x, GLfloat y);
+void az_gfx_vertex2d(GLdouble x, GLdouble y);
+void az_gfx_vertex2i(GLint x, GLint y);
+void az_gfx_color3f(GLfloat r, GLfloat g, GLfloat b);
+void az_gfx_color4f(GLfloat r, GLfloat g, GLfloat b, GLfloat a);
+void az_gfx_color3ub(GLubyte r, GLubyte g, GLubyte b);
+void az_gfx_color4ub(GLubyte r, GLubyte g, GLubyte b, GLubyte a);
+
+void az_gfx_matrix_mode(GLenum mode);
+void az_gfx_load_identity(void);
+void az_gfx_push_matrix(void);
+void az_gfx_pop_matrix(void);
+void az_gfx_translatef(GLfloat x, GLfloat y, GLfloat z);
+void az_gfx_translated(GLdouble x, GLdouble y, GLdouble z);
+void az_gfx_rotatef(GLfloat degrees, GLfloat x, GLfloat y, GLfloat z);
+void az_gfx_rotated(GLdouble degrees, GLdouble x, GLdouble y, GLdouble z);
+void az_gfx_scalef(GLfloat x, GLfloat y, GLfloat z);
+void az_gfx_scaled(GLdouble x, GLdouble y, GLdouble z);
+void az_gfx_mult_matrixf(const GLfloat *matrix);
+void az_gfx_ortho(GLdouble left, GLdouble right, GLdouble bottom,
+                  GLdouble top, GLdouble near_val, GLdouble far_val);
+
+GLuint az_gfx_gen_lists(GLsizei range);
+void az_gfx_delete_lists(GLuint list, GLsizei range);
+GLboolean az_gfx_is_list(GLuint list);
+void az_gfx_new_list(GLuint list, GLenum mode);
+void az_gfx_end_list(void);
+void az_gfx_call_list(GLuint list);
+void az_gfx_call_lists(GLsizei n, GLenum type, const GLvoid *lists);
+
+// Some display lists are drawn in colors that vary from call to call (such as
+// a baddie's body, which flares when hit and turns blue when frozen), as an
+// affine function of two weights.  Such a list is compiled once per variant,
+// starting each with az_gfx_new_list_variant (in order) rather than
+// glNewList: variant 0 is drawn with both weights zero, and variants 1 and 2
+// with the first or second weight (respectively) at one.  The variants must
+// differ only in their colors.  az_gfx_call_list_modulated then draws the
+// list with each color interpolated between the variants by the weights, and
+// clamped to [0, 1]; with both weights zero, it is the same as glCallList.
+#define AZ_GFX_NUM_LIST_VARIANTS 3
+void az_gfx_new_list_variant(GLuint list, int variant);
+void az_gfx_call_list_modulated(GLuint list, GLfloat weight1,
+                                GLfloat weight2);
+// As az_gfx_call_list_modulated, but with a separate weight for each of the
+// red, green, blue and alpha channels.  For example, a list whose variant 0 is
+// all zero can be drawn in any two colors, by giving them as the weights.
+void az_gfx_call_list_modulated_rgba(GLuint list, const GLfloat weight1[4],
+                                     const GLfloat weight2[4]);
+
+void az_gfx_enable(GLenum cap);
+void az_gfx_disable(GLenum cap);
+void az_gfx_hint(GLenum target, GLenum mode);
+void az_gfx_blend_func(GLenum sfactor, GLenum dfactor);
+void az_gfx_line_width(GLfloat width);
+void az_gfx_scissor(GLint x, GLint y, GLsizei width, GLsizei height);
+void az_gfx_viewport(GLint x, GLint y, GLsizei width, GLsizei height);
+void az_gfx_clear(GLbitfield mask);
+
+/*===========================================================================*/
+
+#endif // AZIMUTH_GUI_GFX_H_
@@ -0,0 +1,78 @@
+/*=============================================================================
+| Copyright 2012 Matthew D. Steele <mdsteele@alum.mit.edu>                    |
+|                                                                             |
+| This file is part of Azimuth.                                               |
+|                                                                             |
+| Azimuth is free software: you can redistribute it and/or modify it under    |
+| the terms of the GNU General Public License as published by the Free        |
+| Software Foundation, either version 3 of the License, or (at your option)   |
+| any later version.                                                          |
+|                                                                             |
+| Azimuth is distributed in the hope that it will be useful, but WITHOUT      |
+| ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       |
+| FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for   |
+| more details.                                                               |
+|                                                                             |
+| You should have received a copy of the GNU General Public License along     |
+| with Azimuth.  If not, see <http://www.gnu.org/licenses/>.                  |
+=============================================================================*/
+
+
+#pragma once
+#ifndef AZIMUTH_GUI_OPENGL_H_
+#define AZIMUTH_GUI_OPENGL_H_
+
+// Code that draws with OpenGL should include this header instead of
+// <SDL_opengl.h>.  It redirects the fixed-function calls that we use to the
+// az_gfx_* functions, so that they work with either graphics backend (see
+// azimuth/gui/gfx.h).
+
+#include <SDL_opengl.h>
+
+#include "azimuth/gui/gfx.h"
+
+/*===========================================================================*/
+
+#define glBegin az_gfx_begin
+#define glEnd az_gfx_end
+#define glVertex2f az_gfx_vertex2f
+#define glVertex2d az_gfx_vertex2d
+#define glVertex2i az_gfx_vertex2i
+#define glColor3f az_gfx_color3f
+#define glColor4f az_gfx_color4f
+#define glColor3ub az_gfx_color3ub
+#define glColor4ub az_gfx_color4ub
+
+#define glMatrixMode az_gfx_matrix_mode
+#define glLoadIdentity az_gfx_load_identity
+#define glPushMatrix az_gfx_push_matrix
+#define glPopMatrix az_gfx_pop_matrix
+#define glTranslatef az_gfx_translatef
+#define glTranslated az_gfx_translated
+#define glRotatef az_gfx_rotatef
+#define glRotated az_gfx_rotated
+#define glScalef az_gfx_scalef
+#define glScaled az_gfx_scaled
+#define glMultMatrixf az_gfx_mult_matrixf
+#define glOrtho az_gfx_ortho
+
+#define glGenLists az_gfx_gen_lists
+#define glDeleteLists az_gfx_delete_lists
+#define glIsList az_gfx_is_list
+#define glNewList az_gfx_new_list
+#define glEndList az_gfx_end_list
+#define glCallList az_gfx_call_list
+#define glCallLists az_gfx_call_lists
+
+#define glEnable az_gfx_enable
+#define glDisable az_gfx_disable
+#define glHint az_gfx_hint
+#define glBlendFunc az_gfx_blend_func
+#define glLineWidth az_gfx_line_width
+#define glScissor az_gfx_scissor
+#define glViewport az_gfx_viewport
+#define glClear az_gfx_clear
+
+/*===========================================================================*/
+
+#endif // AZIMUTH_GUI_OPENGL_H_
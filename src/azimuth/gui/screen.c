@@ -20,14 +20,18 @@
 #include "azimuth/gui/screen.h"
 
 #include <assert.h>
+#include <math.h>
 #include <stdbool.h>
 
 #include <SDL.h>
-#include <SDL_opengl.h>
 
 #include "azimuth/constants.h"
 #include "azimuth/gui/audio.h"
+#include "azimuth/gui/gfx.h"
+#include "azimuth/gui/opengl.h"
+#include "azimuth/util/clock.h"
 #include "azimuth/util/misc.h"
+#include "azimuth/util/prefs.h"
 #include "azimuth/util/warning.h"
 
 /*===========================================================================*/
@@ -52,6 +56,61 @@ static float current_screen_scale = 1.0f;
 static float current_screen_xoffset = 0;
 static float current_screen_yoffset = 0;
 static double nanoseconds_per_count = 1000000000;
+// True if frames are run through an edge-smoothing pass (for
+// AZ_AA_POST_PROCESS), which means drawing them offscreen first.
+static bool post_process_antialiasing = false;
+// MSAA samples per pixel that the window actually got (0 if none), which the
+// offscreen framebuffer must match so that a render scale below 1 doesn't
+// silently drop MSAA.
+static int window_msaa_samples = 0;
+
+// Internal resolution, as a fraction of the letterboxed area's size in pixels
+// (see az_set_render_scale).  When dynamic, the scale in use drifts between
+// MIN_RENDER_SCALE and max_render_scale depending on whether we keep up.
+#define MIN_RENDER_SCALE 0.25f
+static float max_render_scale = 1.0f;
+static bool dynamic_render_scale = false;
+static float current_render_scale = 1.0f;
+static int frames_late = 0, frames_on_time = 0;
+
+// The pixel scale and offsets to draw with this frame.  When drawing
+// offscreen, the offscreen framebuffer covers just the letterboxed area, at
+// the current render scale, so the offsets are zero.
+static bool drawing_offscreen = false;
+static float current_draw_scale = 1.0f;
+static float current_draw_xoffset = 0;
+static float current_draw_yoffset = 0;
+
+// Render thread state (only used if requested in az_init_gui).  The main
+// thread records each frame into one of the two command lists while the
+// render thread replays the other.
+static SDL_Thread *render_thread = NULL;
+static SDL_mutex *render_mutex = NULL;
+static SDL_cond *render_cond = NULL;
+static az_gfx_command_list_t *frame_command_lists[2];
+static int recording_frame = 0;
+static struct {
+  bool pending, quit;
+  const az_gfx_command_list_t *commands;
+  az_init_func_t func;
+  bool swap;
+} render_job;
+
+// Frames are paced so that each is presented no earlier than this time (see
+// az_finish_screen_redraw), in case vsync fails to lock us to 60Hz.
+static uint64_t frame_sync_time = 0;
+
+// Idle screens (see az_idle_screen_changed) are redrawn only when their state
+// changes, when something else has happened to the screen since the last
+// redraw (in which case idle_screen_dirty is true), or when the clock reaches
+// the next step of an animation in the last frame drawn.
+static bool idle_screen_dirty = true;
+// True while drawing a frame for az_idle_screen_changed, with clock tracking
+// on.
+static bool drawing_idle_frame = false;
+// How many more ticks the last idle frame drawn will look the same, or zero
+// if it doesn't depend on the clock.
+static az_clock_t idle_frame_ticks_left = 0;
 
 // Get the current time in nanoseconds, as measured from some unspecified zero
 // point.  Not guaranteed to be monotonic.
@@ -79,8 +138,178 @@ void az_register_gl_init_func(az_init_func_t func) {
   }
 }
 
-void az_init_gui(bool fullscreen, bool enable_audio) {
+/*===========================================================================*/
+
+static int render_thread_main(void *data) {
+  (void)data;
+  if (SDL_GL_MakeCurrent(window, context) != 0) {
+    AZ_FATAL("SDL_GL_MakeCurrent failed: %s\n", SDL_GetError());
+  }
+  SDL_LockMutex(render_mutex);
+  while (true) {
+    while (!render_job.pending && !render_job.quit) {
+      SDL_CondWait(render_cond, render_mutex);
+    }
+    if (!render_job.pending) break;
+    // The main thread won't touch the job until we clear the pending flag.
+    SDL_UnlockMutex(render_mutex);
+    az_gfx_replay_commands(render_job.commands);
+    if (render_job.func != NULL) render_job.func();
+    if (render_job.swap) {
+      az_gfx_flush();
+      SDL_GL_SwapWindow(window);
+    }
+    SDL_LockMutex(render_mutex);
+    render_job.pending = false;
+    SDL_CondBroadcast(render_cond);
+  }
+  SDL_UnlockMutex(render_mutex);
+  SDL_GL_MakeCurrent(window, NULL);
+  return 0;
+}
+
+// Block until the render thread has finished its current job (if any).
+static void wait_for_render_thread(void) {
+  if (render_thread == NULL) return;
+  SDL_LockMutex(render_mutex);
+  while (render_job.pending) SDL_CondWait(render_cond, render_mutex);
+  SDL_UnlockMutex(render_mutex);
+}
+
+// Hand the commands recorded so far to the render thread, to be followed by a
+// call to func (if not NULL) and a buffer swap (if swap is true), and start
+// recording into the other command list.  This waits for the previous job to
+// finish first, so the main thread is never more than one frame ahead.
+static void submit_to_render_thread(az_init_func_t func, bool swap) {
+  assert(render_thread != NULL);
+  wait_for_render_thread();
+  SDL_LockMutex(render_mutex);
+  render_job.commands = frame_command_lists[recording_frame];
+  render_job.func = func;
+  render_job.swap = swap;
+  render_job.pending = true;
+  SDL_CondBroadcast(render_cond);
+  SDL_UnlockMutex(render_mutex);
+  recording_frame = 1 - recording_frame;
+  az_gfx_record_commands(frame_command_lists[recording_frame]);
+}
+
+// Call func on whichever thread owns the GL context, after any OpenGL calls
+// that have already been recorded, and wait for it to finish.  Since func may
+// run on the render thread, it must make raw GL calls only, not az_gfx ones.
+static void run_with_gl_context(az_init_func_t func) {
+  if (render_thread == NULL) {
+    func();
+  } else {
+    submit_to_render_thread(func, false);
+    wait_for_render_thread();
+  }
+}
+
+static void start_render_thread(void) {
+  render_mutex = SDL_CreateMutex();
+  render_cond = SDL_CreateCond();
+  if (render_mutex == NULL || render_cond == NULL) {
+    AZ_FATAL("Failed to create render thread mutex: %s\n", SDL_GetError());
+  }
+  for (int i = 0; i < 2; ++i) {
+    frame_command_lists[i] = az_gfx_new_command_list();
+  }
+  recording_frame = 0;
+  az_gfx_record_commands(frame_command_lists[recording_frame]);
+  SDL_GL_MakeCurrent(window, NULL);
+  render_thread = SDL_CreateThread(render_thread_main, "render", NULL);
+  if (render_thread == NULL) {
+    AZ_WARNING_ALWAYS("Failed to start render thread: %s\n", SDL_GetError());
+    SDL_GL_MakeCurrent(window, context);
+    az_gfx_record_commands(NULL);
+  }
+}
+
+static void stop_render_thread(void) {
+  if (render_thread == NULL) return;
+  wait_for_render_thread();
+  SDL_LockMutex(render_mutex);
+  render_job.quit = true;
+  SDL_CondBroadcast(render_cond);
+  SDL_UnlockMutex(render_mutex);
+  SDL_WaitThread(render_thread, NULL);
+  render_thread = NULL;
+  az_gfx_record_commands(NULL);
+  for (int i = 0; i < 2; ++i) {
+    az_gfx_delete_command_list(frame_command_lists[i]);
+    frame_command_lists[i] = NULL;
+  }
+  SDL_GL_MakeCurrent(window, context);
+}
+
+/*===========================================================================*/
+
+// Try to create a GL 3.3 core profile context for the window, and set up the
+// core graphics backend for it.  Returns NULL on failure.
+static SDL_GLContext create_core_context(void) {
+  SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 3);
+  SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 3);
+  SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK,
+                      SDL_GL_CONTEXT_PROFILE_CORE);
+#ifdef __APPLE__
+  SDL_GL_SetAttribute(SDL_GL_CONTEXT_FLAGS,
+                      SDL_GL_CONTEXT_FORWARD_COMPATIBLE_FLAG);
+#endif
+  SDL_GLContext core_context = SDL_GL_CreateContext(window);
+  if (core_context != NULL && !az_gfx_init(AZ_GFX_CORE)) {
+    SDL_GL_DeleteContext(core_context);
+    core_context = NULL;
+  }
+  if (core_context == NULL) {
+    AZ_WARNING_ALWAYS("Falling back to legacy OpenGL: %s\n", SDL_GetError());
+    // Restore SDL's defaults for the legacy context:
+    SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 2);
+    SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 1);
+    SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK, 0);
+    SDL_GL_SetAttribute(SDL_GL_CONTEXT_FLAGS, 0);
+  }
+  return core_context;
+}
+
+#ifndef NDEBUG
+static void print_gl_info(void) {
+  fprintf(stderr, "Using GL implementation:\n"
+          "    Vendor: %s\n"
+          "  Renderer: %s\n"
+          "   Version: %s\n",
+          glGetString(GL_VENDOR), glGetString(GL_RENDERER),
+          glGetString(GL_VERSION));
+}
+#endif
+
+static int msaa_samples(az_antialiasing_t antialiasing) {
+  switch (antialiasing) {
+    case AZ_AA_MSAA_2X: return 2;
+    case AZ_AA_MSAA_4X: return 4;
+    case AZ_AA_MSAA_8X: return 8;
+    case AZ_AA_OFF:
+    case AZ_AA_POST_PROCESS:
+      return 0;
+  }
+  AZ_ASSERT_UNREACHABLE();
+}
+
+static SDL_Window *create_window(bool fullscreen, int msaa_samples) {
+  SDL_GL_SetAttribute(SDL_GL_MULTISAMPLEBUFFERS, (msaa_samples > 0 ? 1 : 0));
+  SDL_GL_SetAttribute(SDL_GL_MULTISAMPLESAMPLES, msaa_samples);
   SDL_DisplayMode display_mode = {0};
+  SDL_GetDesktopDisplayMode(0, &display_mode);
+  return SDL_CreateWindow(
+    "Azimuth",
+    SDL_WINDOWPOS_CENTERED_DISPLAY(0), SDL_WINDOWPOS_CENTERED_DISPLAY(0),
+    display_mode.w, display_mode.h,
+    SDL_WINDOW_RESIZABLE | SDL_WINDOW_OPENGL | (fullscreen ? SDL_WINDOW_FULLSCREEN : 0));
+}
+
+void az_init_gui(bool fullscreen, az_gfx_backend_t gfx_backend,
+                 az_antialiasing_t antialiasing, bool use_render_thread,
+                 bool enable_audio) {
   assert(!sdl_initialized);
   if (SDL_Init(SDL_INIT_VIDEO | (enable_audio ? SDL_INIT_AUDIO : 0)) != 0) {
     AZ_FATAL("SDL_Init failed: %s\n", SDL_GetError());
@@ -92,40 +321,52 @@ void az_init_gui(bool fullscreen, bool enable_audio) {
   }
   // Enable OpenGL double-buffering:
   SDL_GL_SetAttribute(SDL_GL_DOUBLEBUFFER, 1);
-  // Enable antialiasing:
-  SDL_GL_SetAttribute(SDL_GL_MULTISAMPLEBUFFERS, 1);
-  SDL_GL_SetAttribute(SDL_GL_MULTISAMPLESAMPLES, 2);
-  SDL_GetDesktopDisplayMode(0, &display_mode);
-  window = SDL_CreateWindow(
-    "Azimuth",
-    SDL_WINDOWPOS_CENTERED_DISPLAY(0), SDL_WINDOWPOS_CENTERED_DISPLAY(0),
-    display_mode.w, display_mode.h,
-    SDL_WINDOW_RESIZABLE | SDL_WINDOW_OPENGL | (fullscreen ? SDL_WINDOW_FULLSCREEN : 0));
+  // Set up a multisampled framebuffer if requested, falling back to a plain
+  // one if the driver can't give us that many samples:
+  window_msaa_samples = msaa_samples(antialiasing);
+  window = create_window(fullscreen, window_msaa_samples);
+  if (NULL == window && window_msaa_samples > 0) {
+    AZ_WARNING_ALWAYS("Failed to enable %dx MSAA: %s\n", window_msaa_samples,
+                      SDL_GetError());
+    window_msaa_samples = 0;
+    window = create_window(fullscreen, 0);
+  }
   if (NULL == window) {
     AZ_FATAL("SDL_CreateWindow failed: %s\n", SDL_GetError());
   }
   // TODO: set window title on maximize/minimize in event.c somehow?
   SDL_SetWindowTitle(window, "Azimuth (press " CMD_KEY_NAME "F to run full-screen)");
-  context = SDL_GL_CreateContext(window);
+  if (gfx_backend == AZ_GFX_CORE) {
+    context = create_core_context();
+  }
   if (!context) {
-      AZ_FATAL("SDL_GL_CreateContext failed: %s\n", SDL_GetError());
+    context = SDL_GL_CreateContext(window);
+    if (!context) {
+        AZ_FATAL("SDL_GL_CreateContext failed: %s\n", SDL_GetError());
+    }
+    az_gfx_init(AZ_GFX_LEGACY);
   }
+  if (antialiasing == AZ_AA_POST_PROCESS) {
+    if (az_gfx_backend() == AZ_GFX_CORE) {
+      post_process_antialiasing = true;
+    } else {
+      AZ_WARNING_ALWAYS("Post-process antialiasing requires the core "
+                        "graphics backend; disabling antialiasing\n");
+    }
+  }
+  if (use_render_thread) start_render_thread();
 
   sdl_initialized = true;
   az_set_fullscreen(fullscreen);
   SDL_ShowCursor(SDL_DISABLE);
 
 #ifndef NDEBUG
-  fprintf(stderr, "Using GL implementation:\n"
-          "    Vendor: %s\n"
-          "  Renderer: %s\n"
-          "   Version: %s\n",
-          glGetString(GL_VENDOR), glGetString(GL_RENDERER),
-          glGetString(GL_VERSION));
+  run_with_gl_context(print_gl_info);
 #endif
 }
 
 void az_deinit_gui(void) {
+  stop_render_thread();
   SDL_GL_DeleteContext(context);
   SDL_DestroyWindow(window);
   SDL_Quit();
@@ -137,6 +378,22 @@ bool az_is_fullscreen(void) {
   return currently_fullscreen;
 }
 
+// Set up the GL state that isn't managed through azimuth/gui/gfx.h.
+static void init_gl_context_state(void) {
+  // Enable vsync:
+  const int vsync_result = SDL_GL_SetSwapInterval(1);
+  if (vsync_result != 0) {
+    AZ_WARNING_ALWAYS("Failed to enable vsync: %s\n", SDL_GetError());
+  }
+  // Turn off depth writes:
+  glDepthMask(GL_FALSE);
+#ifndef WIN32
+  glBlendEquation(GL_FUNC_ADD);
+#endif
+  glClearColor(0, 0, 0, 0);
+  glClearDepth(1.0f);
+}
+
 void az_set_fullscreen(bool fullscreen) {
   int display_index = 0;
   SDL_DisplayMode display_mode = {0};
@@ -144,6 +401,8 @@ void az_set_fullscreen(bool fullscreen) {
   if (display_initialized && fullscreen == currently_fullscreen) return;
   currently_fullscreen = fullscreen;
   az_pause_all_audio();
+  wait_for_render_thread();
+  idle_screen_dirty = true;
 
   // Init the display:
   int x = 0, y = 0;
@@ -158,33 +417,17 @@ void az_set_fullscreen(bool fullscreen) {
       AZ_FATAL("SDL_SetWindowFullscreen failed: %s\n", SDL_GetError());
   }
 
-  // Enable vsync:
-  const int vsync_result = SDL_GL_SetSwapInterval(1);
-  if (vsync_result != 0) {
-    AZ_WARNING_ALWAYS("Failed to enable vsync: %s\n", SDL_GetError());
-  }
   if (display_initialized) {
     SDL_WarpMouseInWindow(window, x, y);
   }
 
+  run_with_gl_context(init_gl_context_state);
   // Turn off the depth buffer:
   glDisable(GL_DEPTH_TEST);
-  glDepthMask(GL_FALSE);
   // Enable alpha blending:
   glEnable(GL_BLEND);
-#ifndef WIN32
-  glBlendEquation(GL_FUNC_ADD);
-#endif
   glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-  // Set antialiasing:
-  glEnable(GL_POINT_SMOOTH);
-  glHint(GL_POINT_SMOOTH_HINT, GL_NICEST);
-  glDisable(GL_LINE_SMOOTH);
-  glEnable(GL_POLYGON_SMOOTH);
-  glHint(GL_POLYGON_SMOOTH_HINT, GL_NICEST);
   // Set the view:
-  glClearColor(0, 0, 0, 0);
-  glClearDepth(1.0f);
   glMatrixMode(GL_PROJECTION);
   glLoadIdentity();
   glOrtho(0, AZ_SCREEN_WIDTH, AZ_SCREEN_HEIGHT, 0, 1, -1);
@@ -205,11 +448,45 @@ bool az_has_mousefocus(void) {
   return (SDL_GetWindowFlags(window) & SDL_WINDOW_MOUSE_FOCUS);
 }
 
+void az_set_render_scale(float scale, bool dynamic) {
+  assert(sdl_initialized);
+  max_render_scale = fmin(fmax(MIN_RENDER_SCALE, scale), 1.0f);
+  dynamic_render_scale = dynamic;
+  current_render_scale = max_render_scale;
+  frames_late = frames_on_time = 0;
+  if (max_render_scale < 1.0f || dynamic) {
+    if (az_gfx_backend() != AZ_GFX_CORE) {
+      AZ_WARNING_ALWAYS("Render scaling requires the core graphics backend; "
+                        "drawing at full resolution\n");
+      max_render_scale = current_render_scale = 1.0f;
+      dynamic_render_scale = false;
+    }
+  }
+}
+
+// Given how long the last frame took, in nanoseconds, back off the render
+// scale quickly if we keep falling behind, and creep back up slowly once
+// we've been keeping up for a while.
+static void update_dynamic_render_scale(uint64_t frame_nanos) {
+  if (frame_nanos > AZ_FRAME_TIME_NANOS + AZ_FRAME_TIME_NANOS / 4) {
+    frames_on_time = 0;
+    if (++frames_late < 3) return;
+    frames_late = 0;
+    current_render_scale =
+      fmax(MIN_RENDER_SCALE, current_render_scale * 0.85f);
+  } else {
+    frames_late = 0;
+    if (++frames_on_time < 120) return;
+    frames_on_time = 0;
+    current_render_scale =
+      fmin(current_render_scale + 0.05f, max_render_scale);
+  }
+}
+
 void az_start_screen_redraw(void) {
   assert(sdl_initialized);
   assert(display_initialized);
-  glClear(GL_COLOR_BUFFER_BIT);
-  glLoadIdentity();
+  if (drawing_idle_frame) az_start_clock_tracking();
 
   // Calculate letterboxing scaling factor & offsets
   SDL_GL_GetDrawableSize(window, &current_screen_width, &current_screen_height);
@@ -222,29 +499,96 @@ void az_start_screen_redraw(void) {
   current_screen_xoffset = (current_screen_width - (AZ_SCREEN_WIDTH * current_screen_scale)) / 2.0f;
   current_screen_yoffset = (current_screen_height - (AZ_SCREEN_HEIGHT * current_screen_scale)) / 2.0f;
 
-  glLineWidth(current_screen_scale);
+  drawing_offscreen = (post_process_antialiasing ||
+                       current_render_scale < 1.0f);
+  if (drawing_offscreen) {
+    current_draw_scale = current_screen_scale * current_render_scale;
+    current_draw_xoffset = current_draw_yoffset = 0;
+    az_gfx_begin_offscreen(fmax(1, current_draw_scale * AZ_SCREEN_WIDTH),
+                           fmax(1, current_draw_scale * AZ_SCREEN_HEIGHT),
+                           window_msaa_samples, post_process_antialiasing);
+  } else {
+    current_draw_scale = current_screen_scale;
+    current_draw_xoffset = current_screen_xoffset;
+    current_draw_yoffset = current_screen_yoffset;
+  }
+  glClear(GL_COLOR_BUFFER_BIT);
+  glLoadIdentity();
+  glLineWidth(current_draw_scale);
   glViewport(
-    current_screen_xoffset,
-    current_screen_yoffset,
-    current_screen_scale * AZ_SCREEN_WIDTH,
-    current_screen_scale * AZ_SCREEN_HEIGHT);
+    current_draw_xoffset,
+    current_draw_yoffset,
+    current_draw_scale * AZ_SCREEN_WIDTH,
+    current_draw_scale * AZ_SCREEN_HEIGHT);
+}
+
+bool az_idle_screen_changed(bool state_changed) {
+  assert(sdl_initialized);
+  assert(display_initialized);
+  assert(!drawing_idle_frame);
+  bool changed = state_changed || idle_screen_dirty;
+  if (idle_frame_ticks_left > 0 && --idle_frame_ticks_left == 0) {
+    changed = true;
+  }
+  if (changed) {
+    // Have the coming az_start_screen_redraw call track the clock, so that
+    // we know how long the new frame will stay the same.
+    drawing_idle_frame = true;
+    return true;
+  }
+  // Nothing visible has changed, so skip this frame, but still keep the state
+  // ticking at the usual rate.  If an event arrives first, return early so
+  // that the caller can answer it within this frame's slot.
+  const uint64_t now = az_current_time_nanos();
+  if (frame_sync_time > now &&
+      SDL_WaitEventTimeout(NULL, (frame_sync_time - now) / 1000000)) {
+    frame_sync_time += AZ_FRAME_TIME_NANOS;
+  } else {
+    frame_sync_time = az_sleep_until(frame_sync_time) + AZ_FRAME_TIME_NANOS;
+  }
+  return false;
+}
+
+void az_invalidate_screen(void) {
+  idle_screen_dirty = true;
 }
 
 void az_finish_screen_redraw(void) {
   assert(sdl_initialized);
   assert(display_initialized);
-  SDL_GL_SwapWindow(window);
+  if (drawing_idle_frame) {
+    idle_frame_ticks_left = az_stop_clock_tracking();
+    idle_screen_dirty = drawing_idle_frame = false;
+  } else {
+    // Whatever screen comes next, it can't assume that this frame is the
+    // one it last drew.
+    idle_screen_dirty = true;
+  }
+  if (drawing_offscreen) {
+    az_gfx_end_offscreen(current_screen_xoffset, current_screen_yoffset,
+                         current_screen_scale * AZ_SCREEN_WIDTH,
+                         current_screen_scale * AZ_SCREEN_HEIGHT);
+  }
+  if (render_thread != NULL) {
+    submit_to_render_thread(NULL, true);
+  } else {
+    az_gfx_flush();
+    SDL_GL_SwapWindow(window);
+  }
   // Synchronize, in case vsync fails to lock us to 60Hz:
-  static uint64_t sync_time = 0;
-  sync_time = az_sleep_until(sync_time) + AZ_FRAME_TIME_NANOS;
+  const uint64_t previous_sync_time = frame_sync_time;
+  frame_sync_time = az_sleep_until(frame_sync_time) + AZ_FRAME_TIME_NANOS;
+  if (dynamic_render_scale) {
+    update_dynamic_render_scale(frame_sync_time - previous_sync_time);
+  }
 }
 
 void az_gl_scissor(int x, int y, int width, int height) {
   glScissor(
-    (current_screen_scale * x) + current_screen_xoffset,
-    (current_screen_scale * y) + current_screen_yoffset,
-    current_screen_scale * width,
-    current_screen_scale * height);
+    (current_draw_scale * x) + current_draw_xoffset,
+    (current_draw_scale * y) + current_draw_yoffset,
+    current_draw_scale * width,
+    current_draw_scale * height);
 }
 
 void az_map_mouse_coords(int x_in, int y_in, int *x_out, int *y_out) {
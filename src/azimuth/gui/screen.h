@@ -23,6 +23,8 @@
 
 #include <stdbool.h>
 
+#include "azimuth/util/prefs.h" // for az_antialiasing_t and az_gfx_backend_t
+
 /*===========================================================================*/
 
 typedef void (*az_init_func_t)(void);
@@ -33,8 +35,17 @@ typedef void (*az_init_func_t)(void);
 void az_register_gl_init_func(az_init_func_t func);
 
 // Initialize the GUI/window.  This should be called exactly once, at program
-// startup, before making any OpenGL calls.
-void az_init_gui(bool fullscreen, bool enable_audio);
+// startup, before making any OpenGL calls.  If the requested graphics backend
+// can't be set up, this falls back to AZ_GFX_LEGACY.  The antialiasing mode
+// is fixed once the window has been created; if it isn't available, the
+// window is created without antialiasing instead.  If render_thread is
+// true, the GL context is handed to a separate render thread; OpenGL calls
+// made between az_start_screen_redraw and az_finish_screen_redraw (or from GL
+// init funcs) are then recorded, and replayed on the render thread while the
+// caller goes on to compute the next frame.
+void az_init_gui(bool fullscreen, az_gfx_backend_t gfx_backend,
+                 az_antialiasing_t antialiasing, bool render_thread,
+                 bool enable_audio);
 
 // Tear down the GUI/window.  Should be called before exiting.
 void az_deinit_gui(void);
@@ -46,6 +57,14 @@ bool az_is_fullscreen(void);
 // az_init_gui.
 void az_set_fullscreen(bool fullscreen);
 
+// Set the resolution that frames are drawn at, as a fraction (between 0.25
+// and 1) of the letterboxed area's size in pixels; frames drawn at less than
+// full resolution are drawn offscreen and then scaled up to fill the window.
+// If dynamic is true, the scale is lowered automatically (from the given
+// maximum) whenever we can't keep up with the frame rate.  This requires the
+// AZ_GFX_CORE backend, and must not be called before az_init_gui.
+void az_set_render_scale(float scale, bool dynamic);
+
 // Query whether we have mouse focus.
 bool az_has_mousefocus(void);
 
@@ -54,6 +73,21 @@ bool az_has_mousefocus(void);
 void az_start_screen_redraw(void);
 void az_finish_screen_redraw(void);
 
+// For screens that often sit still (such as menus), call this after ticking
+// the state for each frame, passing whether the tick changed anything other
+// than the clock.  Returns true if the screen must be redrawn: because the
+// state changed, az_invalidate_screen was called, or the clock has advanced
+// far enough that the last frame drawn would now look different (frames
+// drawn after this returns true keep track of which az_clock_mod and
+// az_clock_zigzag results they used).  The caller should then draw the frame
+// as usual.  Otherwise, this blocks in SDL_WaitEventTimeout until the next
+// frame is due or an event arrives, and the caller should skip drawing.
+bool az_idle_screen_changed(bool state_changed);
+
+// Make the next call to az_idle_screen_changed return true (for example,
+// because an event arrived, or the window contents were lost).
+void az_invalidate_screen(void);
+
 // Wrapper for glScissor() that applies virtual-resolution scaling factor & offsets
 void az_gl_scissor(int x, int y, int width, int height);
 
@@ -18,6 +18,7 @@
 =============================================================================*/
 
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdlib.h>
 
 #include "azimuth/control/gameover.h"
@@ -30,12 +31,18 @@
 #include "azimuth/state/music.h" // for az_init_music_datas
 #include "azimuth/state/planet.h"
 #include "azimuth/state/save.h"
-#include "azimuth/state/sound.h" // for az_init_sound_datas
 #include "azimuth/state/wall.h" // for az_init_wall_datas
+#include "azimuth/system/parallel.h"
 #include "azimuth/system/resource.h"
 #include "azimuth/util/misc.h" // for AZ_ASSERT_UNREACHABLE
 #include "azimuth/util/prefs.h"
+#include "azimuth/util/warning.h"
+#include "azimuth/view/baddie.h" // for az_init_baddie_drawing
 #include "azimuth/view/dialog.h" // for az_init_portrait_drawing
+#include "azimuth/view/doodad.h" // for az_init_doodad_drawing
+#include "azimuth/view/minimap.h" // for az_init_minimap_drawing
+#include "azimuth/view/node.h" // for az_init_node_drawing
+#include "azimuth/view/shape.h" // for az_init_shape_drawing
 #include "azimuth/view/wall.h" // for az_init_wall_drawing
 
 /*===========================================================================*/
@@ -45,7 +52,27 @@ static az_saved_games_t saved_games;
 static az_preferences_t preferences;
 
 static bool load_scenario(void) {
-  if (!az_init_music_datas(&az_system_resource_reader)) return false;
+  if (!az_init_music_datas(&az_system_resource_reader,
+                           &az_system_parallel_for)) return false;
+  // Use the compiled planet image if this build has one, since it loads much
+  // faster than the text files that it was compiled from (which such a build
+  // doesn't even include).  The image is used in place, so we only look it up
+  // once.
+  void *image;
+  size_t image_size;
+  if (az_system_resource_writable_contents("rooms/planet.img", &image,
+                                           &image_size)) {
+    if (az_load_planet_image(image, image_size, &planet)) return true;
+    AZ_WARNING_ALWAYS("Ignoring incompatible planet image.\n");
+  }
+  // Otherwise, we have to parse the text files, so (unless the player has
+  // asked us not to) only read each room's header up front, and parse the
+  // rest of each room as the ship first enters it.
+  if (preferences.room_cache_kb > 0) {
+    return az_read_planet_lazily(&az_system_resource_reader,
+                                 (size_t)preferences.room_cache_kb * 1024,
+                                 &planet);
+  }
   if (!az_read_planet(&az_system_resource_reader, &planet)) return false;
   return true;
 }
@@ -57,19 +84,27 @@ typedef enum {
 } az_controller_t;
 
 int main(int argc, char **argv) {
-  az_init_sound_datas();
+  az_load_sound_datas();
   az_init_baddie_datas();
   az_init_wall_datas();
+  az_register_gl_init_func(az_init_baddie_drawing);
+  az_register_gl_init_func(az_init_doodad_drawing);
+  az_register_gl_init_func(az_init_minimap_drawing);
+  az_register_gl_init_func(az_init_node_drawing);
   az_register_gl_init_func(az_init_portrait_drawing);
+  az_register_gl_init_func(az_init_shape_drawing);
   az_register_gl_init_func(az_init_wall_drawing);
 
+  az_load_preferences(&preferences);
   if (!load_scenario()) {
     printf("Failed to load scenario.\n");
     return EXIT_FAILURE;
   }
-  az_load_preferences(&preferences);
   az_load_saved_games(&planet, &saved_games);
-  az_init_gui(preferences.fullscreen_on_startup, true);
+  az_init_gui(preferences.fullscreen_on_startup, preferences.gfx_backend,
+              preferences.antialiasing, preferences.render_thread, true);
+  az_set_render_scale(preferences.render_scale,
+                      preferences.dynamic_render_scale);
   az_set_global_music_volume(preferences.music_volume);
   az_set_global_sound_volume(preferences.sound_volume);
 
@@ -25,6 +25,7 @@
 #include "azimuth/util/audio.h"
 #include "azimuth/util/misc.h"
 #include "azimuth/util/music.h"
+#include "azimuth/util/parallel.h"
 #include "azimuth/util/rw.h"
 #include "azimuth/util/string.h"
 #include "azimuth/util/vector.h"
@@ -117,14 +118,19 @@ static void destroy_drums(void) {
   AZ_ARRAY_LOOP(data, drum_datas) az_destroy_sound_data(data);
 }
 
+static void create_drum_job(void *userdata, int index) {
+  az_create_sound_data(&drum_specs[index], &drum_datas[index]);
+}
+
+static void init_drums(az_parallel_for_fn_t parallel_for) {
+  if (drums_initialized) return;
+  parallel_for(AZ_ARRAY_SIZE(drum_specs), create_drum_job, NULL);
+  atexit(destroy_drums);
+  drums_initialized = true;
+}
+
 void az_get_drum_kit(int *num_drums_out, const az_sound_data_t **drums_out) {
-  if (!drums_initialized) {
-    for (int i = 0; i < AZ_ARRAY_SIZE(drum_specs); ++i) {
-      az_create_sound_data(&drum_specs[i], &drum_datas[i]);
-    }
-    atexit(destroy_drums);
-    drums_initialized = true;
-  }
+  init_drums(&az_serial_for);
   *num_drums_out = AZ_ARRAY_SIZE(drum_datas);
   *drums_out = drum_datas;
 }
@@ -192,13 +198,15 @@ static void destroy_music_datas(void) {
   AZ_ARRAY_LOOP(music, music_datas) az_destroy_music(music);
 }
 
-bool az_init_music_datas(az_resource_reader_fn_t resource_reader) {
+bool az_init_music_datas(az_resource_reader_fn_t resource_reader,
+                         az_parallel_for_fn_t parallel_for) {
   assert(!music_data_initialized);
   // Initialize inverse music keys:
   for (int i = 0; i < AZ_NUM_MUSIC_KEYS; ++i) {
     inverse_music_keys[ordered_music_keys[i] - 1] = i;
   }
   // Initialize drum kit:
+  init_drums(parallel_for);
   int num_drums = 0;
   const az_sound_data_t *drums = NULL;
   az_get_drum_kit(&num_drums, &drums);
@@ -237,6 +245,11 @@ const char *az_get_music_title(az_music_key_t music_key) {
   return music_data_for_key(music_key)->title;
 }
 
+const az_music_t *az_get_music_data(az_music_key_t music_key) {
+  assert(music_key != AZ_MUS_NOTHING);
+  return music_data_for_key(music_key);
+}
+
 az_music_key_t az_advance_music_key(az_music_key_t music_key, int delta) {
   assert(music_data_initialized);
   const int key_index = (int)music_key - 1;
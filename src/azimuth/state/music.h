@@ -23,6 +23,7 @@
 
 #include "azimuth/util/audio.h"
 #include "azimuth/util/music.h"
+#include "azimuth/util/parallel.h"
 #include "azimuth/util/rw.h"
 
 /*===========================================================================*/
@@ -58,13 +59,22 @@ typedef enum {
 
 /*===========================================================================*/
 
+// Get the drum sounds used by all music, generating them first (on the calling
+// thread) if they haven't been already.
 void az_get_drum_kit(int *num_drums_out, const az_sound_data_t **drums_out);
 
-bool az_init_music_datas(az_resource_reader_fn_t resource_reader);
+// Generate the drum kit (using parallel_for to spread the work across threads)
+// and load all music data.  Returns false on failure.
+bool az_init_music_datas(az_resource_reader_fn_t resource_reader,
+                         az_parallel_for_fn_t parallel_for);
 
 // Returns the title of the music, or NULL if it has no title.
 const char *az_get_music_title(az_music_key_t music_key);
 
+// Returns the loaded music for the given key (which must not be
+// AZ_MUS_NOTHING).
+const az_music_t *az_get_music_data(az_music_key_t music_key);
+
 // Get the delta-th next music key in the Music Test jukebox ordering.  The
 // music_key argument must not be AZ_MUS_NOTHING.
 az_music_key_t az_advance_music_key(az_music_key_t music_key, int delta);
@@ -22,12 +22,16 @@
 #include <assert.h>
 #include <setjmp.h>
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "azimuth/constants.h"
 #include "azimuth/state/dialog.h"
 #include "azimuth/state/room.h"
+#include "azimuth/state/wall.h"
 #include "azimuth/util/misc.h"
 #include "azimuth/util/string.h"
 
@@ -217,12 +221,28 @@ static bool parse_planet_basis(az_load_planet_t *loader) {
 
 static bool read_planet_basis(az_reader_t *reader, az_planet_t *planet_out) {
   assert(planet_out != NULL);
+  AZ_ZERO_OBJECT(planet_out);
   az_load_planet_t loader = {.reader = reader, .planet = planet_out};
   return parse_planet_basis(&loader);
 }
 
-bool az_read_planet(az_resource_reader_fn_t resource_reader,
-                    az_planet_t *planet_out) {
+typedef bool (*read_room_fn_t)(az_reader_t *reader, az_room_t *room_out);
+
+static bool read_room_resource(az_resource_reader_fn_t resource_reader,
+                               read_room_fn_t read_room, int room_index,
+                               az_room_t *room_out) {
+  char *room_name = az_strprintf("rooms/room%03d.txt", room_index);
+  az_reader_t reader;
+  bool success = resource_reader(room_name, &reader);
+  free(room_name);
+  if (!success) return false;
+  success = read_room(&reader, room_out);
+  az_rclose(&reader);
+  return success;
+}
+
+static bool read_planet(az_resource_reader_fn_t resource_reader,
+                        read_room_fn_t read_room, az_planet_t *planet_out) {
   assert(planet_out != NULL);
 
   az_reader_t reader;
@@ -232,12 +252,9 @@ bool az_read_planet(az_resource_reader_fn_t resource_reader,
   if (!success) return false;
 
   for (int i = 0; i < planet_out->num_rooms; ++i) {
-    char *room_name = az_strprintf("rooms/room%03d.txt", i);
-    resource_reader(room_name, &reader);
-    success = az_read_room(&reader, &planet_out->rooms[i]) &&
+    success = read_room_resource(resource_reader, read_room, i,
+                                 &planet_out->rooms[i]) &&
       planet_out->rooms[i].zone_key < planet_out->num_zones;
-    az_rclose(&reader);
-    free(room_name);
     if (!success) {
       az_destroy_planet(planet_out);
       return false;
@@ -247,6 +264,11 @@ bool az_read_planet(az_resource_reader_fn_t resource_reader,
   return true;
 }
 
+bool az_read_planet(az_resource_reader_fn_t resource_reader,
+                    az_planet_t *planet_out) {
+  return read_planet(resource_reader, az_read_room, planet_out);
+}
+
 /*===========================================================================*/
 
 #define WRITE(...) do { \
@@ -337,8 +359,571 @@ bool az_write_planet(const az_planet_t *planet,
 
 /*===========================================================================*/
 
+// A planet image holds a whole planet in one block of memory, with every
+// object stored in its native struct layout, so that loading it is just a
+// matter of relocating pointers.  Each pointer in the image is stored as a
+// byte offset from the start of the image (with zero standing for NULL),
+// except for wall data pointers (including those of fake wall nodes), which
+// are stored as wall data indices.  The header records a fingerprint of the
+// struct layouts; as with the sound cache, an image written by a build with
+// different layouts (or byte order) will simply fail to load.
+#define PLANET_IMAGE_MAGIC "AZPLANET"
+#define PLANET_IMAGE_VERSION 1
+
+typedef struct {
+  char magic[8];
+  uint32_t version;
+  uint32_t layout; // see planet_image_layout()
+  uint64_t size; // size of the whole image, in bytes
+  az_planet_t planet; // with pointers stored as offsets
+} planet_image_header_t;
+
+static uint32_t planet_image_layout(void) {
+  const uint32_t layout[] = {
+    0x01020304u, // to detect byte order
+    sizeof(void*), sizeof(double), AZ_NUM_WALL_DATAS,
+    sizeof(planet_image_header_t), sizeof(az_planet_t),
+    offsetof(az_planet_t, on_start), offsetof(az_planet_t, paragraphs),
+    offsetof(az_planet_t, zones), offsetof(az_planet_t, hints),
+    offsetof(az_planet_t, rooms), offsetof(az_planet_t, image),
+    sizeof(az_zone_t), offsetof(az_zone_t, name),
+    offsetof(az_zone_t, entering_message), sizeof(az_hint_t),
+    sizeof(az_room_t), offsetof(az_room_t, on_start),
+    offsetof(az_room_t, baddies), offsetof(az_room_t, doors),
+    offsetof(az_room_t, gravfields), offsetof(az_room_t, nodes),
+    offsetof(az_room_t, walls),
+    sizeof(az_baddie_spec_t), offsetof(az_baddie_spec_t, on_kill),
+    sizeof(az_door_spec_t), offsetof(az_door_spec_t, on_open),
+    sizeof(az_gravfield_spec_t), offsetof(az_gravfield_spec_t, on_enter),
+    sizeof(az_node_spec_t), offsetof(az_node_spec_t, on_use),
+    offsetof(az_node_spec_t, subkind), sizeof(az_node_subkind_t),
+    sizeof(az_wall_spec_t), offsetof(az_wall_spec_t, data),
+    sizeof(az_script_t), offsetof(az_script_t, instructions),
+    sizeof(az_instruction_t)
+  };
+  // FNV-1a (see http://www.isthe.com/chongo/tech/comp/fnv/)
+  const unsigned char *bytes = (const unsigned char *)layout;
+  uint32_t hash = 2166136261u;
+  for (size_t i = 0; i < sizeof(layout); ++i) {
+    hash ^= bytes[i];
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+static bool is_fake_wall_node(const az_node_spec_t *node) {
+  return (node->kind == AZ_NODE_FAKE_WALL_FG ||
+          node->kind == AZ_NODE_FAKE_WALL_BG);
+}
+
+typedef struct {
+  char *data;
+  size_t size, capacity;
+} image_writer_t;
+
+// Get a pointer to the object at the given offset in the image being written.
+// This is invalidated by the next call to image_add, so don't hold onto it.
+#define IMAGE_AT(writer, offset, type) ((type *)((writer)->data + (offset)))
+#define AS_OFFSET(offset) ((void *)(uintptr_t)(offset))
+
+// Append a copy of the given bytes to the image, and return the offset at
+// which they were placed, or zero if size is zero.
+static uintptr_t image_add(image_writer_t *writer, const void *data,
+                           size_t size) {
+  if (size == 0) return 0;
+  const size_t offset = (writer->size + AZ_PLANET_IMAGE_ALIGN - 1) /
+    AZ_PLANET_IMAGE_ALIGN * AZ_PLANET_IMAGE_ALIGN;
+  if (offset + size > writer->capacity) {
+    writer->capacity = 2 * writer->capacity;
+    if (writer->capacity < offset + size) writer->capacity = offset + size;
+    writer->data = realloc(writer->data, writer->capacity);
+    if (writer->data == NULL) AZ_FATAL("realloc failed.\n");
+  }
+  memset(writer->data + writer->size, 0, offset - writer->size);
+  memcpy(writer->data + offset, data, size);
+  writer->size = offset + size;
+  return offset;
+}
+
+static az_script_t *image_add_script(image_writer_t *writer,
+                                     const az_script_t *script) {
+  if (script == NULL) return NULL;
+  // Copy with memcpy rather than assignment, so that the struct padding is
+  // copied too, and images come out the same every time.
+  az_script_t copy;
+  memcpy(&copy, script, sizeof(copy));
+  copy.instructions = AS_OFFSET(image_add(
+      writer, script->instructions,
+      script->num_instructions * sizeof(az_instruction_t)));
+  return AS_OFFSET(image_add(writer, &copy, sizeof(copy)));
+}
+
+static char *image_add_string(image_writer_t *writer, const char *string) {
+  return AS_OFFSET(image_add(writer, string, strlen(string) + 1));
+}
+
+// Add the spec array field of the room at room_offset, and the scripts that
+// each of its specs points to.
+#define IMAGE_ADD_SPECS(writer, room_offset, room, field, num, type, \
+                        script_field) do { \
+    const uintptr_t specs_offset = \
+      image_add((writer), (room)->field, (room)->num * sizeof(type)); \
+    IMAGE_AT((writer), (room_offset), az_room_t)->field = \
+      AS_OFFSET(specs_offset); \
+    for (int i = 0; i < (room)->num; ++i) { \
+      az_script_t *script = \
+        image_add_script((writer), (room)->field[i].script_field); \
+      IMAGE_AT((writer), specs_offset, type)[i].script_field = script; \
+    } \
+  } while (false)
+
+static void image_add_room_contents(image_writer_t *writer,
+                                    uintptr_t room_offset,
+                                    const az_room_t *room) {
+  az_script_t *on_start = image_add_script(writer, room->on_start);
+  IMAGE_AT(writer, room_offset, az_room_t)->on_start = on_start;
+  IMAGE_ADD_SPECS(writer, room_offset, room, baddies, num_baddies,
+                  az_baddie_spec_t, on_kill);
+  IMAGE_ADD_SPECS(writer, room_offset, room, doors, num_doors,
+                  az_door_spec_t, on_open);
+  IMAGE_ADD_SPECS(writer, room_offset, room, gravfields, num_gravfields,
+                  az_gravfield_spec_t, on_enter);
+  // Nodes are done by hand, since fake wall nodes also point to wall data:
+  const uintptr_t nodes_offset = image_add(
+      writer, room->nodes, room->num_nodes * sizeof(az_node_spec_t));
+  IMAGE_AT(writer, room_offset, az_room_t)->nodes = AS_OFFSET(nodes_offset);
+  for (int i = 0; i < room->num_nodes; ++i) {
+    const az_node_spec_t *node = &room->nodes[i];
+    az_script_t *on_use = image_add_script(writer, node->on_use);
+    az_node_spec_t *image_node =
+      &IMAGE_AT(writer, nodes_offset, az_node_spec_t)[i];
+    image_node->on_use = on_use;
+    if (is_fake_wall_node(node)) {
+      image_node->subkind.fake_wall =
+        AS_OFFSET(az_wall_data_index(node->subkind.fake_wall));
+    }
+  }
+  const uintptr_t walls_offset = image_add(
+      writer, room->walls, room->num_walls * sizeof(az_wall_spec_t));
+  IMAGE_AT(writer, room_offset, az_room_t)->walls = AS_OFFSET(walls_offset);
+  for (int i = 0; i < room->num_walls; ++i) {
+    IMAGE_AT(writer, walls_offset, az_wall_spec_t)[i].data =
+      AS_OFFSET(az_wall_data_index(room->walls[i].data));
+  }
+}
+
+#undef IMAGE_ADD_SPECS
+
+bool az_save_planet_image_to_path(const az_planet_t *planet,
+                                  const char *filepath) {
+  assert(filepath != NULL);
+  FILE *file = fopen(filepath, "wb");
+  if (file == NULL) return false;
+  const bool ok = az_save_planet_image_to_file(planet, file);
+  fclose(file);
+  return ok;
+}
+
+bool az_save_planet_image_to_file(const az_planet_t *planet, FILE *file) {
+  assert(planet != NULL);
+  assert(planet->room_cache == NULL);
+  assert(file != NULL);
+  image_writer_t writer = {.size = 0};
+  planet_image_header_t header;
+  memset(&header, 0, sizeof(header));
+  image_add(&writer, &header, sizeof(header));
+  memcpy(&header.planet, planet, sizeof(header.planet));
+  header.planet.image = NULL;
+  header.planet.room_cache = NULL;
+  header.planet.on_start = image_add_script(&writer, planet->on_start);
+  // Paragraphs:
+  char **paragraphs = AZ_ALLOC(planet->num_paragraphs, char*);
+  for (int i = 0; i < planet->num_paragraphs; ++i) {
+    paragraphs[i] = image_add_string(&writer, planet->paragraphs[i]);
+  }
+  header.planet.paragraphs = AS_OFFSET(image_add(
+      &writer, paragraphs, planet->num_paragraphs * sizeof(char*)));
+  free(paragraphs);
+  // Zones:
+  const uintptr_t zones_offset = image_add(
+      &writer, planet->zones, planet->num_zones * sizeof(az_zone_t));
+  header.planet.zones = AS_OFFSET(zones_offset);
+  for (int i = 0; i < planet->num_zones; ++i) {
+    char *name = image_add_string(&writer, planet->zones[i].name);
+    char *entering_message =
+      image_add_string(&writer, planet->zones[i].entering_message);
+    az_zone_t *zone = &IMAGE_AT(&writer, zones_offset, az_zone_t)[i];
+    zone->name = name;
+    zone->entering_message = entering_message;
+  }
+  // Hints:
+  header.planet.hints = AS_OFFSET(image_add(
+      &writer, planet->hints, planet->num_hints * sizeof(az_hint_t)));
+  // Rooms:
+  const uintptr_t rooms_offset = image_add(
+      &writer, planet->rooms, planet->num_rooms * sizeof(az_room_t));
+  header.planet.rooms = AS_OFFSET(rooms_offset);
+  for (int i = 0; i < planet->num_rooms; ++i) {
+    image_add_room_contents(&writer, rooms_offset + i * sizeof(az_room_t),
+                            &planet->rooms[i]);
+  }
+  // Now that we know how big the image is, fill in the header:
+  memcpy(header.magic, PLANET_IMAGE_MAGIC, sizeof(header.magic));
+  header.version = PLANET_IMAGE_VERSION;
+  header.layout = planet_image_layout();
+  header.size = writer.size;
+  memcpy(writer.data, &header, sizeof(header));
+  const bool ok = (fwrite(writer.data, 1, writer.size, file) == writer.size);
+  free(writer.data);
+  return ok && fflush(file) == 0;
+}
+
+#undef IMAGE_AT
+
+typedef struct {
+  char *data;
+  size_t size;
+  bool ok;
+} image_loader_t;
+
+// Turn an offset read from the image back into a pointer, or set loader->ok
+// to false if the offset doesn't point to count objects of the given size
+// that lie within the image (so that a corrupted image can't make us read out
+// of bounds).
+static void *relocate(image_loader_t *loader, const void *offset_ptr,
+                      int count, size_t size) {
+  const uintptr_t offset = (uintptr_t)offset_ptr;
+  if (offset == 0 && count == 0) return NULL;
+  if (count < 0 || offset % AZ_PLANET_IMAGE_ALIGN != 0 ||
+      offset < sizeof(planet_image_header_t) || offset > loader->size ||
+      (size_t)count > (loader->size - offset) / size) {
+    loader->ok = false;
+    return NULL;
+  }
+  return loader->data + offset;
+}
+
+#define RELOCATE(loader, field, count) \
+  ((field) = relocate((loader), (field), (count), sizeof(*(field))))
+
+static char *relocate_string(image_loader_t *loader, const char *offset_ptr) {
+  char *string = relocate(loader, offset_ptr, 1, 1);
+  if (string == NULL || memchr(string, '\0', loader->data + loader->size -
+                               string) == NULL) {
+    loader->ok = false;
+    return NULL;
+  }
+  return string;
+}
+
+static az_script_t *relocate_script(image_loader_t *loader,
+                                    az_script_t *offset_ptr) {
+  if (offset_ptr == NULL) return NULL;
+  az_script_t *script = relocate(loader, offset_ptr, 1, sizeof(az_script_t));
+  if (script == NULL) return NULL;
+  RELOCATE(loader, script->instructions, script->num_instructions);
+  return script;
+}
+
+static const az_wall_data_t *relocate_wall_data(
+    image_loader_t *loader, const az_wall_data_t *index_ptr) {
+  const uintptr_t index = (uintptr_t)index_ptr;
+  if (index >= (uintptr_t)AZ_NUM_WALL_DATAS) {
+    loader->ok = false;
+    return NULL;
+  }
+  return az_get_wall_data(index);
+}
+
+#define RELOCATE_SPECS(loader, room, field, num, script_field) do { \
+    RELOCATE((loader), (room)->field, (room)->num); \
+    if (!(loader)->ok) return; \
+    for (int i = 0; i < (room)->num; ++i) { \
+      (room)->field[i].script_field = \
+        relocate_script((loader), (room)->field[i].script_field); \
+    } \
+  } while (false)
+
+static void relocate_room(image_loader_t *loader, const az_planet_t *planet,
+                          az_room_t *room) {
+  if (room->zone_key < 0 || room->zone_key >= planet->num_zones) {
+    loader->ok = false;
+    return;
+  }
+  room->on_start = relocate_script(loader, room->on_start);
+  RELOCATE_SPECS(loader, room, baddies, num_baddies, on_kill);
+  RELOCATE_SPECS(loader, room, doors, num_doors, on_open);
+  RELOCATE_SPECS(loader, room, gravfields, num_gravfields, on_enter);
+  RELOCATE_SPECS(loader, room, nodes, num_nodes, on_use);
+  for (int i = 0; i < room->num_nodes; ++i) {
+    az_node_spec_t *node = &room->nodes[i];
+    if (!is_fake_wall_node(node)) continue;
+    node->subkind.fake_wall =
+      relocate_wall_data(loader, node->subkind.fake_wall);
+  }
+  RELOCATE(loader, room->walls, room->num_walls);
+  if (!loader->ok) return;
+  for (int i = 0; i < room->num_walls; ++i) {
+    room->walls[i].data = relocate_wall_data(loader, room->walls[i].data);
+  }
+}
+
+#undef RELOCATE_SPECS
+
+bool az_load_planet_image(void *image, size_t size, az_planet_t *planet_out) {
+  assert(image != NULL || size == 0);
+  assert(planet_out != NULL);
+  AZ_ZERO_OBJECT(planet_out);
+  if (size < sizeof(planet_image_header_t) ||
+      (uintptr_t)image % AZ_PLANET_IMAGE_ALIGN != 0) return false;
+  planet_image_header_t header;
+  memcpy(&header, image, sizeof(header));
+  if (memcmp(header.magic, PLANET_IMAGE_MAGIC, sizeof(header.magic)) != 0 ||
+      header.version != PLANET_IMAGE_VERSION ||
+      header.layout != planet_image_layout() || header.size != size) {
+    return false;
+  }
+  // Relocate the image in place, so that the planet's arrays point straight
+  // into it.
+  image_loader_t loader = {.data = image, .size = size, .ok = true};
+  az_planet_t planet = header.planet;
+  planet.room_cache = NULL;
+  planet.on_start = relocate_script(&loader, planet.on_start);
+  RELOCATE(&loader, planet.paragraphs, planet.num_paragraphs);
+  for (int i = 0; loader.ok && i < planet.num_paragraphs; ++i) {
+    planet.paragraphs[i] = relocate_string(&loader, planet.paragraphs[i]);
+  }
+  RELOCATE(&loader, planet.zones, planet.num_zones);
+  for (int i = 0; loader.ok && i < planet.num_zones; ++i) {
+    az_zone_t *zone = &planet.zones[i];
+    zone->name = relocate_string(&loader, zone->name);
+    zone->entering_message = relocate_string(&loader, zone->entering_message);
+  }
+  RELOCATE(&loader, planet.hints, planet.num_hints);
+  RELOCATE(&loader, planet.rooms, planet.num_rooms);
+  if (planet.num_rooms < 1 || planet.start_room < 0 ||
+      planet.start_room >= planet.num_rooms) {
+    loader.ok = false;
+  }
+  for (int i = 0; loader.ok && i < planet.num_rooms; ++i) {
+    relocate_room(&loader, &planet, &planet.rooms[i]);
+  }
+  if (!loader.ok) return false;
+  planet.image = image;
+  *planet_out = planet;
+  return true;
+}
+
+#undef RELOCATE
+
+/*===========================================================================*/
+
+typedef struct {
+  bool loaded;
+  size_t size; // bytes of contents loaded for this room
+  unsigned long last_used; // cache clock reading when last used
+} room_cache_entry_t;
+
+struct az_room_cache {
+  az_resource_reader_fn_t resource_reader;
+  size_t max_contents_size, contents_size;
+  unsigned long clock;
+  room_cache_entry_t *entries; // one per room
+};
+
+bool az_read_planet_lazily(az_resource_reader_fn_t resource_reader,
+                           size_t max_contents_size, az_planet_t *planet_out) {
+  if (!read_planet(resource_reader, az_read_room_header, planet_out)) {
+    return false;
+  }
+  az_room_cache_t *cache = AZ_ALLOC(1, az_room_cache_t);
+  cache->resource_reader = resource_reader;
+  cache->max_contents_size = max_contents_size;
+  cache->entries = AZ_ALLOC(planet_out->num_rooms, room_cache_entry_t);
+  planet_out->room_cache = cache;
+  return true;
+}
+
+static size_t script_size(const az_script_t *script) {
+  if (script == NULL) return 0;
+  return sizeof(az_script_t) +
+    script->num_instructions * sizeof(az_instruction_t);
+}
+
+// Return roughly how many bytes of memory the room's contents (i.e. everything
+// that az_read_room_header doesn't read) take up.
+static size_t room_contents_size(const az_room_t *room) {
+  size_t size = script_size(room->on_start) +
+    room->num_baddies * sizeof(az_baddie_spec_t) +
+    room->num_gravfields * sizeof(az_gravfield_spec_t) +
+    room->num_nodes * sizeof(az_node_spec_t) +
+    room->num_walls * sizeof(az_wall_spec_t);
+  for (int i = 0; i < room->num_baddies; ++i) {
+    size += script_size(room->baddies[i].on_kill);
+  }
+  for (int i = 0; i < room->num_gravfields; ++i) {
+    size += script_size(room->gravfields[i].on_enter);
+  }
+  for (int i = 0; i < room->num_nodes; ++i) {
+    size += script_size(room->nodes[i].on_use);
+  }
+  return size;
+}
+
+static bool room_contents_own_script(const az_room_t *room,
+                                     const az_script_t *script) {
+  if (script == NULL) return false;
+  if (room->on_start == script) return true;
+  for (int i = 0; i < room->num_baddies; ++i) {
+    if (room->baddies[i].on_kill == script) return true;
+  }
+  for (int i = 0; i < room->num_gravfields; ++i) {
+    if (room->gravfields[i].on_enter == script) return true;
+  }
+  for (int i = 0; i < room->num_nodes; ++i) {
+    if (room->nodes[i].on_use == script) return true;
+  }
+  return false;
+}
+
+// Move the contents (but not the header or doors) from a fully-read room into
+// the planet's room, freeing whatever is left over.
+static void install_room_contents(const az_planet_t *planet,
+                                  az_room_key_t room_key,
+                                  az_room_t *contents) {
+  az_room_cache_t *cache = planet->room_cache;
+  room_cache_entry_t *entry = &cache->entries[room_key];
+  assert(!entry->loaded);
+  az_room_t *room = &planet->rooms[room_key];
+  room->on_start = contents->on_start;
+  room->num_baddies = contents->num_baddies;
+  room->baddies = contents->baddies;
+  room->num_gravfields = contents->num_gravfields;
+  room->gravfields = contents->gravfields;
+  room->num_nodes = contents->num_nodes;
+  room->nodes = contents->nodes;
+  room->num_walls = contents->num_walls;
+  room->walls = contents->walls;
+  az_room_t leftovers = {
+    .num_doors = contents->num_doors, .doors = contents->doors
+  };
+  az_destroy_room(&leftovers);
+  AZ_ZERO_OBJECT(contents);
+  entry->loaded = true;
+  entry->size = room_contents_size(room);
+  entry->last_used = ++cache->clock;
+  cache->contents_size += entry->size;
+}
+
+static void unload_room_contents(const az_planet_t *planet,
+                                 az_room_key_t room_key) {
+  az_room_cache_t *cache = planet->room_cache;
+  room_cache_entry_t *entry = &cache->entries[room_key];
+  assert(entry->loaded);
+  az_room_t *room = &planet->rooms[room_key];
+  az_room_t contents = *room;
+  contents.num_doors = 0;
+  contents.doors = NULL;
+  az_destroy_room(&contents);
+  room->on_start = NULL;
+  room->num_baddies = room->num_gravfields = 0;
+  room->num_nodes = room->num_walls = 0;
+  room->baddies = NULL;
+  room->gravfields = NULL;
+  room->nodes = NULL;
+  room->walls = NULL;
+  assert(cache->contents_size >= entry->size);
+  cache->contents_size -= entry->size;
+  entry->loaded = false;
+  entry->size = 0;
+}
+
+// Evict the least recently used rooms' contents until we're back under the
+// cap, except for the current room and any rooms that own a running script.
+static void evict_room_contents(const az_planet_t *planet,
+                                az_room_key_t current_room,
+                                int num_running_scripts,
+                                const az_script_t *const *running_scripts) {
+  az_room_cache_t *cache = planet->room_cache;
+  while (cache->contents_size > cache->max_contents_size) {
+    int victim = -1;
+    for (int i = 0; i < planet->num_rooms; ++i) {
+      const room_cache_entry_t *candidate = &cache->entries[i];
+      if (!candidate->loaded || i == current_room) continue;
+      if (victim >= 0 &&
+          candidate->last_used >= cache->entries[victim].last_used) continue;
+      bool running = false;
+      for (int j = 0; j < num_running_scripts && !running; ++j) {
+        running = room_contents_own_script(&planet->rooms[i],
+                                           running_scripts[j]);
+      }
+      if (!running) victim = i;
+    }
+    if (victim < 0) break;
+    unload_room_contents(planet, victim);
+  }
+}
+
+void az_load_room_contents(const az_planet_t *planet, az_room_key_t room_key,
+                           int num_running_scripts,
+                           const az_script_t *const *running_scripts) {
+  assert(0 <= room_key && room_key < planet->num_rooms);
+  az_room_cache_t *cache = planet->room_cache;
+  if (cache == NULL) return;
+  room_cache_entry_t *entry = &cache->entries[room_key];
+  if (entry->loaded) {
+    entry->last_used = ++cache->clock;
+  } else {
+    az_room_t contents;
+    if (!az_read_room_contents(planet, room_key, &contents)) {
+      AZ_FATAL("Failed to load room %03d.\n", (int)room_key);
+    }
+    install_room_contents(planet, room_key, &contents);
+  }
+  evict_room_contents(planet, room_key, num_running_scripts, running_scripts);
+}
+
+bool az_room_contents_loaded(const az_planet_t *planet,
+                             az_room_key_t room_key) {
+  assert(0 <= room_key && room_key < planet->num_rooms);
+  return (planet->room_cache == NULL ||
+          planet->room_cache->entries[room_key].loaded);
+}
+
+bool az_read_room_contents(const az_planet_t *planet, az_room_key_t room_key,
+                           az_room_t *contents_out) {
+  assert(planet->room_cache != NULL);
+  assert(0 <= room_key && room_key < planet->num_rooms);
+  return read_room_resource(planet->room_cache->resource_reader, az_read_room,
+                            room_key, contents_out);
+}
+
+void az_adopt_room_contents(const az_planet_t *planet, az_room_key_t room_key,
+                            az_room_t *contents, az_room_key_t current_room,
+                            int num_running_scripts,
+                            const az_script_t *const *running_scripts) {
+  assert(planet->room_cache != NULL);
+  assert(0 <= room_key && room_key < planet->num_rooms);
+  assert(0 <= current_room && current_room < planet->num_rooms);
+  if (planet->room_cache->entries[room_key].loaded) {
+    az_destroy_room(contents);
+    return;
+  }
+  install_room_contents(planet, room_key, contents);
+  evict_room_contents(planet, current_room, num_running_scripts,
+                      running_scripts);
+}
+
+/*===========================================================================*/
+
 void az_destroy_planet(az_planet_t *planet) {
   assert(planet != NULL);
+  if (planet->image != NULL) {
+    // Everything points into the image, which the planet doesn't own, so
+    // there's nothing to free.
+    AZ_ZERO_OBJECT(planet);
+    return;
+  }
   az_free_script(planet->on_start);
   for (int i = 0; i < planet->num_paragraphs; ++i) {
     free(planet->paragraphs[i]);
@@ -349,10 +934,15 @@ void az_destroy_planet(az_planet_t *planet) {
     free(planet->zones[i].entering_message);
   }
   free(planet->zones);
+  free(planet->hints);
   for (int i = 0; i < planet->num_rooms; ++i) {
     az_destroy_room(&planet->rooms[i]);
   }
   free(planet->rooms);
+  if (planet->room_cache != NULL) {
+    free(planet->room_cache->entries);
+    free(planet->room_cache);
+  }
   AZ_ZERO_OBJECT(planet);
 }
 
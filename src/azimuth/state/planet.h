@@ -22,6 +22,8 @@
 #define AZIMUTH_STATE_PLANET_H_
 
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h> // for FILE
 
 #include "azimuth/state/dialog.h"
 #include "azimuth/state/player.h"
@@ -55,6 +57,10 @@ typedef struct {
   az_room_key_t target_room;
 } az_hint_t;
 
+// Tracks which rooms of a lazily-read planet currently have their contents
+// loaded (see az_read_planet_lazily below).
+typedef struct az_room_cache az_room_cache_t;
+
 typedef struct {
   az_room_key_t start_room;
   az_script_t *on_start;
@@ -66,16 +72,86 @@ typedef struct {
   az_hint_t *hints;
   int num_rooms;
   az_room_t *rooms;
+  // If non-NULL, the planet was loaded from a planet image, and all of the
+  // above arrays point into this block of memory, which the planet doesn't
+  // own (see az_load_planet_image).
+  void *image;
+  // If non-NULL, the planet was read with az_read_planet_lazily, and only some
+  // of its rooms have their contents loaded at any given time.
+  az_room_cache_t *room_cache;
 } az_planet_t;
 
 bool az_read_planet(az_resource_reader_fn_t resource_reader,
                     az_planet_t *planet_out);
 
+// Like az_read_planet, but only read each room's header and doors up front
+// (see az_read_room_header), which is all that the map, hints, and door
+// markers need.  The rest of each room (its other objects and all their
+// scripts, which we'll call the room's contents) is read when first needed by
+// az_load_room_contents, and the contents of the least recently used rooms are
+// freed again whenever more than max_contents_size bytes of them are loaded.
+bool az_read_planet_lazily(az_resource_reader_fn_t resource_reader,
+                           size_t max_contents_size, az_planet_t *planet_out);
+
+// Make sure that the contents of the given room are loaded (reading them now
+// if they haven't been prefetched), and then evict other rooms' contents as
+// needed to get back under the planet's cap, except for any rooms that own one
+// of the given scripts (which may still be running).  This does nothing for
+// planets that weren't read lazily.  Loading and evicting contents changes
+// the planet's rooms, even though the planet is otherwise treated as const, so
+// this must only be called from the game thread.
+void az_load_room_contents(const az_planet_t *planet, az_room_key_t room_key,
+                           int num_running_scripts,
+                           const az_script_t *const *running_scripts);
+
+// Return true if the contents of the given room are currently loaded (which is
+// always the case for planets that weren't read lazily).
+bool az_room_contents_loaded(const az_planet_t *planet,
+                             az_room_key_t room_key);
+
+// For prefetching rooms of a lazily-read planet in the background: read the
+// contents of the given room into contents_out without touching the planet
+// (so this is safe to call from another thread while the game runs), and
+// later hand them over with az_adopt_room_contents, which must be called from
+// the game thread.  Adopting contents then evicts other rooms' contents as
+// az_load_room_contents does, except for the current room (the one the ship
+// is in) and any rooms that own one of the given scripts; if that isn't
+// enough, the adopted contents may be evicted straight away.  If the room's
+// contents have been loaded in the meantime, the adopted copy is simply
+// destroyed.
+bool az_read_room_contents(const az_planet_t *planet, az_room_key_t room_key,
+                           az_room_t *contents_out);
+void az_adopt_room_contents(const az_planet_t *planet, az_room_key_t room_key,
+                            az_room_t *contents, az_room_key_t current_room,
+                            int num_running_scripts,
+                            const az_script_t *const *running_scripts);
+
 bool az_write_planet(const az_planet_t *planet,
                      az_resource_writer_fn_t resource_writer,
                      const az_room_key_t *rooms_to_write,
                      int num_rooms_to_write);
 
+// Attempt to compile a planet into a binary image, and save it to the file
+// located at the given path (or to the given file).  Return true on success,
+// or false on failure.  The planet must not have been read lazily.
+bool az_save_planet_image_to_path(const az_planet_t *planet,
+                                  const char *filepath);
+bool az_save_planet_image_to_file(const az_planet_t *planet, FILE *file);
+
+// Every object in a planet image starts at a multiple of this many bytes.
+#define AZ_PLANET_IMAGE_ALIGN 16
+
+// Load a planet from an image written by az_save_planet_image_to_*, which is
+// much faster than az_read_planet, since nothing needs to be parsed.  The
+// image is used in place: its pointers are relocated where they lie, and the
+// planet's arrays point straight into it.  So the image must be writable,
+// must start at a multiple of AZ_PLANET_IMAGE_ALIGN bytes, must stay valid
+// until the planet is destroyed, and can only be loaded once.  The image only
+// stores the native struct layouts, so this returns false (leaving planet_out
+// zeroed) if the image was written by an incompatible build, or is malformed,
+// in which case the image may have been partly relocated.
+bool az_load_planet_image(void *image, size_t size, az_planet_t *planet_out);
+
 // Delete the data arrays owned by a planet (but not the planet object itself).
 void az_destroy_planet(az_planet_t *planet);
 
@@ -50,6 +50,7 @@ void az_init_player(az_player_t *player) {
   AZ_ZERO_OBJECT(player);
   player->shields = player->max_shields = AZ_INITIAL_MAX_SHIELDS;
   player->energy = player->max_energy = AZ_INITIAL_MAX_ENERGY;
+  az_touch_player_map(player);
 }
 
 /*===========================================================================*/
@@ -133,7 +134,9 @@ void az_set_room_visited(az_player_t *player, az_room_key_t room) {
   const unsigned int idx = (unsigned int)room;
   assert(idx < AZ_MAX_NUM_ROOMS);
   assert(idx < 64 * AZ_ARRAY_SIZE(player->rooms_visited));
+  if (test_flag(player->rooms_visited, idx)) return;
   set_flag(player->rooms_visited, idx);
+  az_touch_player_map(player);
 }
 
 /*===========================================================================*/
@@ -149,7 +152,15 @@ void az_set_zone_mapped(az_player_t *player, az_zone_key_t zone) {
   const unsigned int idx = (unsigned int)zone;
   assert(idx < AZ_MAX_NUM_ZONES);
   assert(idx < 64 * AZ_ARRAY_SIZE(player->zones_mapped));
+  if (test_flag(player->zones_mapped, idx)) return;
   set_flag(player->zones_mapped, idx);
+  az_touch_player_map(player);
+}
+
+void az_touch_player_map(az_player_t *player) {
+  // Zero is left for zero-initialized players, whose maps are all empty.
+  static uint64_t last_map_generation = 0;
+  player->map_generation = ++last_map_generation;
 }
 
 /*===========================================================================*/
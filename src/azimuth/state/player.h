@@ -91,6 +91,10 @@ typedef struct {
   uint64_t rooms_visited[(AZ_MAX_NUM_ROOMS + 63) / 64];
   uint64_t zones_mapped[(AZ_MAX_NUM_ZONES + 63) / 64];
   uint64_t flags[(AZ_MAX_NUM_FLAGS + 63) / 64];
+  // A number that changes whenever rooms_visited or zones_mapped does, and
+  // that no two differently-mapped players share, so that the map can be
+  // redrawn only when it changes (see az_touch_player_map).
+  uint64_t map_generation;
   // Total game time for this playthrough so far, in seconds:
   double total_time;
   // The room we're currently in.  For save files, this indicates the room in
@@ -127,6 +131,11 @@ bool az_test_zone_mapped(const az_player_t *player, az_zone_key_t zone);
 // Set the player as having gotten map data for the given zone.
 void az_set_zone_mapped(az_player_t *player, az_zone_key_t zone);
 
+// Give the player a new map_generation.  This is called by az_init_player and
+// by the two setters above (when they change anything), and must also be
+// called after changing rooms_visited or zones_mapped directly.
+void az_touch_player_map(az_player_t *player);
+
 // Check whether a given game flag is set for the player.
 bool az_test_flag(const az_player_t *player, az_flag_t flag);
 // Set the given game flag for the player.
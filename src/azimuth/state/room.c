@@ -37,6 +37,10 @@ typedef struct {
   bool success;
   jmp_buf jump;
   int num_baddies, num_doors, num_gravfields, num_nodes, num_walls;
+  // If true, only parse the room header and doors, and skim past everything
+  // else, just counting how many other objects there are:
+  bool header_only;
+  int num_skimmed;
   az_room_t *room;
 } az_load_room_t;
 
@@ -66,6 +70,15 @@ static bool scan_to_script(az_load_room_t *loader) {
   else FAIL();
 }
 
+// Skip past the rest of the current directive (including any scripts),
+// stopping after the next '!' or at EOF.
+static void skip_to_bang(az_load_room_t *loader) {
+  int ch;
+  do {
+    ch = az_rgetc(loader->reader);
+  } while (ch != '!' && ch != EOF);
+}
+
 static az_script_t *maybe_parse_script(az_load_room_t *loader, char ch) {
   if (!scan_to_script(loader)) return NULL;
   if (az_rgetc(loader->reader) != ch) FAIL();
@@ -108,27 +121,39 @@ static void parse_room_header(az_load_room_t *loader) {
   loader->room->camera_bounds.theta_span = theta_span;
   if (num_baddies < 0 || num_baddies > AZ_MAX_NUM_BADDIES) FAIL();
   loader->num_baddies = num_baddies;
-  loader->room->num_baddies = 0;
-  loader->room->baddies = AZ_ALLOC(num_baddies, az_baddie_spec_t);
   if (num_doors < 0 || num_doors > AZ_MAX_NUM_DOORS) FAIL();
   loader->num_doors = num_doors;
   loader->room->num_doors = 0;
   loader->room->doors = AZ_ALLOC(num_doors, az_door_spec_t);
   if (num_gravfields < 0 || num_gravfields > AZ_MAX_NUM_GRAVFIELDS) FAIL();
   loader->num_gravfields = num_gravfields;
-  loader->room->num_gravfields = 0;
-  loader->room->gravfields = AZ_ALLOC(num_gravfields, az_gravfield_spec_t);
   if (num_nodes < 0 || num_nodes > AZ_MAX_NUM_NODES) FAIL();
   loader->num_nodes = num_nodes;
-  loader->room->num_nodes = 0;
-  loader->room->nodes = AZ_ALLOC(num_nodes, az_node_spec_t);
   if (num_walls < 0 || num_walls > AZ_MAX_NUM_WALLS) FAIL();
   loader->num_walls = num_walls;
+  if (loader->header_only) {
+    skip_to_bang(loader);
+    return;
+  }
+  loader->room->num_baddies = 0;
+  loader->room->baddies = AZ_ALLOC(num_baddies, az_baddie_spec_t);
+  loader->room->num_gravfields = 0;
+  loader->room->gravfields = AZ_ALLOC(num_gravfields, az_gravfield_spec_t);
+  loader->room->num_nodes = 0;
+  loader->room->nodes = AZ_ALLOC(num_nodes, az_node_spec_t);
   loader->room->num_walls = 0;
   loader->room->walls = AZ_ALLOC(num_walls, az_wall_spec_t);
   loader->room->on_start = maybe_parse_script(loader, 's');
 }
 
+static void mark_console(az_room_t *room, az_console_kind_t console) {
+  switch (console) {
+    case AZ_CONS_COMM:   room->properties |= AZ_ROOMF_WITH_COMM;   break;
+    case AZ_CONS_REFILL: room->properties |= AZ_ROOMF_WITH_REFILL; break;
+    case AZ_CONS_SAVE:   room->properties |= AZ_ROOMF_WITH_SAVE;   break;
+  }
+}
+
 static void parse_baddie_directive(az_load_room_t *loader) {
   if (loader->room->num_baddies >= loader->num_baddies) FAIL();
   int kind, uuid_slot;
@@ -230,11 +255,7 @@ static void parse_node_directive(az_load_room_t *loader) {
       case AZ_NODE_CONSOLE:
         if (subkind < 0 || subkind >= AZ_NUM_CONSOLE_KINDS) FAIL();
         node->subkind.console = (az_console_kind_t)subkind;
-        switch (node->subkind.console) {
-          case AZ_CONS_COMM:   room->properties |= AZ_ROOMF_WITH_COMM;   break;
-          case AZ_CONS_REFILL: room->properties |= AZ_ROOMF_WITH_REFILL; break;
-          case AZ_CONS_SAVE:   room->properties |= AZ_ROOMF_WITH_SAVE;   break;
-        }
+        mark_console(room, node->subkind.console);
         break;
       case AZ_NODE_UPGRADE:
         if (subkind < 0 || subkind >= AZ_NUM_UPGRADES) FAIL();
@@ -289,7 +310,38 @@ static void parse_wall_directive(az_load_room_t *loader) {
   if (scan_to_script(loader)) FAIL();
 }
 
+// When reading only the header, we still need to look at each node's kind,
+// since the room's WITH_* flags come from its consoles.
+static void skim_node_directive(az_load_room_t *loader) {
+  int kind;
+  READ("%d", &kind);
+  if (kind <= 0 || kind > AZ_NUM_NODE_KINDS) FAIL();
+  if ((az_node_kind_t)kind == AZ_NODE_CONSOLE) {
+    int subkind;
+    READ("/%d", &subkind);
+    if (subkind < 0 || subkind >= AZ_NUM_CONSOLE_KINDS) FAIL();
+    mark_console(loader->room, (az_console_kind_t)subkind);
+  }
+  ++loader->num_skimmed;
+  skip_to_bang(loader);
+}
+
+static bool skim_directive(az_load_room_t *loader) {
+  switch (az_rgetc(loader->reader)) {
+    case 'B': case 'G': case 'W':
+      ++loader->num_skimmed;
+      skip_to_bang(loader);
+      return true;
+    case 'D': parse_door_directive(loader); return true;
+    case 'N': skim_node_directive(loader); return true;
+    case EOF: return false;
+    default: FAIL();
+  }
+  AZ_ASSERT_UNREACHABLE();
+}
+
 static bool parse_directive(az_load_room_t *loader) {
+  if (loader->header_only) return skim_directive(loader);
   switch (az_rgetc(loader->reader)) {
     case 'B': parse_baddie_directive(loader); return true;
     case 'D': parse_door_directive(loader); return true;
@@ -303,6 +355,12 @@ static bool parse_directive(az_load_room_t *loader) {
 }
 
 static void validate_room(az_load_room_t *loader) {
+  if (loader->header_only) {
+    if (loader->room->num_doors != loader->num_doors ||
+        loader->num_skimmed != loader->num_baddies + loader->num_gravfields +
+        loader->num_nodes + loader->num_walls) FAIL();
+    return;
+  }
   if (loader->room->num_baddies != loader->num_baddies ||
       loader->room->num_doors != loader->num_doors ||
       loader->room->num_gravfields != loader->num_gravfields ||
@@ -342,6 +400,17 @@ bool az_read_room(az_reader_t *reader, az_room_t *room_out) {
   return loader.success;
 }
 
+bool az_read_room_header(az_reader_t *reader, az_room_t *room_out) {
+  assert(room_out != NULL);
+  AZ_ZERO_OBJECT(room_out);
+  az_load_room_t loader = {
+    .reader = reader, .room = room_out, .success = false,
+    .header_only = true
+  };
+  parse_room(&loader);
+  return loader.success;
+}
+
 /*===========================================================================*/
 
 #define WRITE(...) do { \
@@ -474,8 +543,21 @@ bool az_save_room_to_path(const az_room_t *room, const char *filepath) {
 void az_destroy_room(az_room_t *room) {
   assert(room != NULL);
   az_free_script(room->on_start);
+  for (int i = 0; i < room->num_baddies; ++i) {
+    az_free_script(room->baddies[i].on_kill);
+  }
   free(room->baddies);
+  for (int i = 0; i < room->num_doors; ++i) {
+    az_free_script(room->doors[i].on_open);
+  }
   free(room->doors);
+  for (int i = 0; i < room->num_gravfields; ++i) {
+    az_free_script(room->gravfields[i].on_enter);
+  }
+  free(room->gravfields);
+  for (int i = 0; i < room->num_nodes; ++i) {
+    az_free_script(room->nodes[i].on_use);
+  }
   free(room->nodes);
   free(room->walls);
   AZ_ZERO_OBJECT(room);
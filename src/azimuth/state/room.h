@@ -64,31 +64,35 @@ typedef struct {
   int uuid_slot; // 0 if none, otherwise from 1 to AZ_NUM_UUID_SLOTS inclusive
 } az_door_spec_t;
 
+// In the gravfield, node, and wall specs, uuid_slot comes right after kind so
+// that the two share an 8-byte word; there are tens of thousands of these in
+// the planet, so the padding would otherwise add up.
+
 typedef struct {
   az_gravfield_kind_t kind;
+  int uuid_slot; // 0 if none, otherwise from 1 to AZ_NUM_UUID_SLOTS inclusive
   az_script_t *on_enter; // owned; NULL if no script
   az_vector_t position;
   double angle;
   double strength;
   az_gravfield_size_t size;
-  int uuid_slot; // 0 if none, otherwise from 1 to AZ_NUM_UUID_SLOTS inclusive
 } az_gravfield_spec_t;
 
 typedef struct {
   az_node_kind_t kind;
+  int uuid_slot; // 0 if none, otherwise from 1 to AZ_NUM_UUID_SLOTS inclusive
   az_node_subkind_t subkind;
   az_script_t *on_use; // owned; NULL if no script
   az_vector_t position;
   double angle;
-  int uuid_slot; // 0 if none, otherwise from 1 to AZ_NUM_UUID_SLOTS inclusive
 } az_node_spec_t;
 
 typedef struct {
   az_wall_kind_t kind;
+  int uuid_slot; // 0 if none, otherwise from 1 to AZ_NUM_UUID_SLOTS inclusive
   const az_wall_data_t *data;
   az_vector_t position;
   double angle;
-  int uuid_slot; // 0 if none, otherwise from 1 to AZ_NUM_UUID_SLOTS inclusive
 } az_wall_spec_t;
 
 // Bitset of flags dictating special room behavior:
@@ -134,6 +138,12 @@ typedef struct {
 bool az_load_room_from_path(const char *filepath, az_room_t *room_out);
 bool az_read_room(az_reader_t *reader, az_room_t *room_out);
 
+// Like az_read_room, but only read the room's header fields and its doors
+// (everything needed to draw the room on the map, or to mark doors leading to
+// it), skimming past the rest.  The room's other object arrays are left empty,
+// and its on_start script NULL.
+bool az_read_room_header(az_reader_t *reader, az_room_t *room_out);
+
 // Attempt to save a room to the file located at the given path.  Return true
 // on success, or false on failure.
 bool az_save_room_to_path(const az_room_t *room, const char *filepath);
@@ -88,6 +88,7 @@ static bool parse_saved_game(const az_planet_t *planet, FILE *file,
   READ_BITFIELD(" up", upgrades);
   READ_BITFIELD(" rv", player->rooms_visited);
   READ_BITFIELD(" zm", player->zones_mapped);
+  az_touch_player_map(player);
   READ_BITFIELD(" fl", player->flags);
   int rockets, bombs, gun1, gun2, ordnance;
   if (fscanf(file, " tt=%lf cr=%d rk=%d bm=%d g1=%d g2=%d or=%d\n",
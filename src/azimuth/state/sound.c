@@ -20,10 +20,15 @@
 #include "azimuth/state/sound.h"
 
 #include <assert.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "azimuth/util/audio.h"
 #include "azimuth/util/misc.h"
+#include "azimuth/util/parallel.h"
 #include "azimuth/util/sound.h"
 
 /*===========================================================================*/
@@ -1018,6 +1023,51 @@ static az_sound_spec_t sound_specs[] = {
 
 AZ_STATIC_ASSERT(AZ_ARRAY_SIZE(sound_specs) == AZ_NUM_SOUND_KEYS + 1);
 
+// Voice pool hints (see az_sound_data_t) for sounds that are more or less
+// important than usual; any sound not listed here gets priority zero and no
+// instance limit.  Warnings about the ship's own condition should never be
+// drowned out by the noise of a big fight, whereas the many small impact and
+// gunfire sounds can be thinned out without anyone noticing.
+static const struct {
+  int priority;
+  int max_instances;
+} sound_hints[AZ_NUM_SOUND_KEYS + 1] = {
+  [AZ_SND_ALARM] = { .priority = 2 },
+  [AZ_SND_EXPLODE_SHIP] = { .priority = 2 },
+  [AZ_SND_KLAXON_COUNTDOWN] = { .priority = 2 },
+  [AZ_SND_KLAXON_COUNTDOWN_LOW] = { .priority = 2 },
+  [AZ_SND_KLAXON_SHIELDS_LOW] = { .priority = 2 },
+  [AZ_SND_KLAXON_SHIELDS_VERY_LOW] = { .priority = 2 },
+  [AZ_SND_PLANET_EXPLODE] = { .priority = 2 },
+  [AZ_SND_BOSS_EXPLODE] = { .priority = 1 },
+  [AZ_SND_DOOR_CLOSE] = { .priority = 1 },
+  [AZ_SND_DOOR_OPEN] = { .priority = 1 },
+  [AZ_SND_HURT_SHIP] = { .priority = 1, .max_instances = 2 },
+  [AZ_SND_HURT_SHIP_SLIGHTLY] = { .priority = 1, .max_instances = 2 },
+  [AZ_SND_MENU_CLICK] = { .priority = 1 },
+  [AZ_SND_PICKUP_ORDNANCE] = { .priority = 1, .max_instances = 2 },
+  [AZ_SND_PICKUP_SHIELDS] = { .priority = 1, .max_instances = 2 },
+  [AZ_SND_EXPLODE_FIREBALL_SMALL] = { .max_instances = 4 },
+  [AZ_SND_EXPLODE_ROCKET] = { .max_instances = 4 },
+  [AZ_SND_FIRE_GUN_FREEZE] = { .max_instances = 4 },
+  [AZ_SND_FIRE_GUN_NORMAL] = { .max_instances = 4 },
+  [AZ_SND_FIRE_GUN_PIERCE] = { .max_instances = 4 },
+  [AZ_SND_FIRE_OTH_SPRAY] = { .priority = -1, .max_instances = 3 },
+  [AZ_SND_FIRE_STINGER] = { .priority = -1, .max_instances = 3 },
+  [AZ_SND_HIT_ARMOR] = { .priority = -1, .max_instances = 3 },
+  [AZ_SND_HIT_WALL] = { .priority = -1, .max_instances = 3 },
+  [AZ_SND_HURT_BOUNCER] = { .priority = -1, .max_instances = 3 },
+  [AZ_SND_HURT_CRAWLER] = { .priority = -1, .max_instances = 3 },
+  [AZ_SND_HURT_FISH] = { .priority = -1, .max_instances = 3 },
+  [AZ_SND_HURT_PLANT] = { .priority = -1, .max_instances = 3 },
+  [AZ_SND_HURT_SWOOPER] = { .priority = -1, .max_instances = 3 },
+  [AZ_SND_HURT_TURRET] = { .priority = -1, .max_instances = 3 },
+  [AZ_SND_HURT_ZIPPER] = { .priority = -1, .max_instances = 3 },
+  [AZ_SND_MENU_HOVER] = { .priority = -1, .max_instances = 1 },
+  [AZ_SND_METAL_CLINK] = { .priority = -1, .max_instances = 2 },
+  [AZ_SND_SHRAPNEL_BURST] = { .priority = -1, .max_instances = 3 },
+};
+
 /*===========================================================================*/
 
 static az_sound_data_t sound_datas[AZ_ARRAY_SIZE(sound_specs)];
@@ -1042,14 +1092,53 @@ static const az_sound_data_t *sound_data_for_key(az_sound_key_t sound_key) {
   return sound_data;
 }
 
-void az_init_sound_datas(void) {
+// The indices into sound_specs of the sounds that weren't found in the cache:
+static int uncached_indices[AZ_ARRAY_SIZE(sound_specs)];
+
+static void create_sound_data_job(void *userdata, int index) {
+  const int i = uncached_indices[index];
+  az_create_sound_data(&sound_specs[i], &sound_datas[i]);
+}
+
+bool az_init_sound_datas(const void *cache, size_t cache_size,
+                         az_parallel_for_fn_t parallel_for) {
   assert(!sound_data_initialized);
+  // Validate the cache entry for each sound, pointing the sound data straight
+  // at the cached samples wherever we can, and generate the rest.
+  int num_uncached = 0;
   for (int i = 1; i < AZ_ARRAY_SIZE(sound_specs); ++i) {
-    az_create_sound_data(&sound_specs[i], &sound_datas[i]);
+    if (!az_find_cached_sound_data(cache, cache_size, &sound_specs[i],
+                                   &sound_datas[i])) {
+      uncached_indices[num_uncached++] = i;
+    }
+  }
+  parallel_for(num_uncached, create_sound_data_job, NULL);
+  // If the cache is stale, the caller will want to replace it, so copy out
+  // any data that we borrowed from it to let them release it.
+  if (num_uncached > 0) {
+    AZ_ARRAY_LOOP(data, sound_datas) {
+      if (!data->borrowed) continue;
+      int16_t *samples = AZ_ALLOC(data->num_samples, int16_t);
+      memcpy(samples, data->samples, data->num_samples * sizeof(int16_t));
+      data->samples = samples;
+      data->borrowed = false;
+    }
+  }
+  for (int i = 1; i < AZ_ARRAY_SIZE(sound_specs); ++i) {
+    sound_datas[i].priority = sound_hints[i].priority;
+    sound_datas[i].max_instances = sound_hints[i].max_instances;
   }
   sound_data_initialized = true;
   atexit(destroy_sound_datas);
   assert(sound_data_for_key(AZ_SND_NOTHING) == NULL);
+  return num_uncached == 0;
+}
+
+bool az_save_sound_datas_cache(const char *filepath) {
+  assert(sound_data_initialized);
+  return az_save_sound_cache_to_path(
+      AZ_ARRAY_SIZE(sound_specs) - 1, sound_specs + 1, sound_datas + 1,
+      filepath);
 }
 
 /*===========================================================================*/
@@ -21,7 +21,11 @@
 #ifndef AZIMUTH_STATE_SOUND_H_
 #define AZIMUTH_STATE_SOUND_H_
 
+#include <stdbool.h>
+#include <stddef.h>
+
 #include "azimuth/util/audio.h"
+#include "azimuth/util/parallel.h"
 #include "azimuth/util/sound.h"
 
 /*===========================================================================*/
@@ -170,7 +174,19 @@ typedef enum {
 
 /*===========================================================================*/
 
-void az_init_sound_datas(void);
+// Set up the sound data for all sound keys.  This must be called before any
+// sounds are played.  Sounds found in the given sound cache contents (which
+// may be NULL) are used in place, so the cache must stay valid until exit;
+// the rest are generated, using parallel_for to spread the work across
+// threads.  Returns false if any sounds had to be generated, in which case
+// nothing refers to the cache anymore, and the caller should replace it using
+// az_save_sound_datas_cache.
+bool az_init_sound_datas(const void *cache, size_t cache_size,
+                         az_parallel_for_fn_t parallel_for);
+
+// Save all sound data to a sound cache file at the given path.  Returns true
+// on success, or false on failure.
+bool az_save_sound_datas_cache(const char *filepath);
 
 // Indicate that we should play the given sound (once).  The sound will not
 // loop, and cannot be cancelled or paused once started.
@@ -59,6 +59,14 @@ static void put_uuid(az_space_state_t *state, int slot,
 }
 
 void az_enter_room(az_space_state_t *state, const az_room_t *room) {
+  // If the planet is being read lazily, make sure this room's objects are
+  // loaded, without evicting any room whose script is still suspended in the
+  // countdown or sync VM (either of which can outlast the room it came from).
+  const az_script_t *running_scripts[] = {
+    state->countdown.vm.script, state->sync_vm.script
+  };
+  az_load_room_contents(state->planet, room - state->planet->rooms,
+                        AZ_ARRAY_SIZE(running_scripts), running_scripts);
   state->darkness = state->dark_goal = 0.0;
   // Make a map from UUID table indices to the baddie (if any) carrying that
   // object as cargo.
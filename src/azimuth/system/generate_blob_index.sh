@@ -40,7 +40,9 @@ for RESOURCE_FILE in "$@"; do
     NAME="$(basename $(dirname $RESOURCE_FILE))/$(basename $RESOURCE_FILE)"
     SIZE=$(wc -c < $RESOURCE_FILE)
     echo "  {.name=\"$NAME\", .offset=$OFFSET, .length=$SIZE}," >> $OUTFILE
-    OFFSET=$((OFFSET + SIZE))
+    # Each resource is padded out to a multiple of 16 bytes (see the Makefile
+    # and AZ_RESOURCE_ALIGN), so that the next one is aligned.
+    OFFSET=$((OFFSET + (SIZE + 15) / 16 * 16))
     NUM_ENTRIES=$((NUM_ENTRIES + 1))
 done
 echo "};" >> $OUTFILE
@@ -0,0 +1,131 @@
+/*=============================================================================
+| Copyright 2012 Matthew D. Steele <mdsteele@alum.mit.edu>                    |
+|                                                                             |
+| This file is part of Azimuth.                                               |
+|                                                                             |
+| Azimuth is free software: you can redistribute it and/or modify it under    |
+| the terms of the GNU General Public License as published by the Free        |
+| Software Foundation, either version 3 of the License, or (at your option)   |
+| any later version.                                                          |
+|                                                                             |
+| Azimuth is distributed in the hope that it will be useful, but WITHOUT      |
+| ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       |
+| FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for   |
+| more details.                                                               |
+|                                                                             |
+| You should have received a copy of the GNU General Public License along     |
+| with Azimuth.  If not, see <http://www.gnu.org/licenses/>.                  |
+=============================================================================*/
+
+
+#include "azimuth/system/mapped_file.h"
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "azimuth/util/misc.h"
+
+/*===========================================================================*/
+
+#ifdef WIN32
+// Map the file (read-only, or copy-on-write), and return a pointer to the
+// contents, or NULL on failure.
+static void *map_file(const char *path, bool copy_on_write,
+                      az_mapped_file_t *mapped) {
+  assert(path != NULL);
+  assert(mapped != NULL);
+  AZ_ZERO_OBJECT(mapped);
+  HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL,
+                            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+  if (file == INVALID_HANDLE_VALUE) return NULL;
+  LARGE_INTEGER size;
+  if (!GetFileSizeEx(file, &size) || size.QuadPart <= 0 ||
+      (unsigned long long)size.QuadPart > (size_t)-1) {
+    CloseHandle(file);
+    return NULL;
+  }
+  HANDLE mapping = CreateFileMappingA(
+      file, NULL, (copy_on_write ? PAGE_WRITECOPY : PAGE_READONLY), 0, 0,
+      NULL);
+  // The mapping keeps the file open, so we can close our handle to it.
+  CloseHandle(file);
+  if (mapping == NULL) return NULL;
+  void *contents = MapViewOfFile(
+      mapping, (copy_on_write ? FILE_MAP_COPY : FILE_MAP_READ), 0, 0, 0);
+  if (contents == NULL) {
+    CloseHandle(mapping);
+    return NULL;
+  }
+  mapped->contents = contents;
+  mapped->size = (size_t)size.QuadPart;
+  mapped->handle = mapping;
+  return contents;
+}
+
+void az_system_unmap_file(az_mapped_file_t *mapped) {
+  assert(mapped != NULL);
+  if (mapped->contents == NULL) return;
+  UnmapViewOfFile(mapped->contents);
+  CloseHandle(mapped->handle);
+  AZ_ZERO_OBJECT(mapped);
+}
+#else
+// Map the file (read-only, or copy-on-write), and return a pointer to the
+// contents, or NULL on failure.
+static void *map_file(const char *path, bool copy_on_write,
+                      az_mapped_file_t *mapped) {
+  assert(path != NULL);
+  assert(mapped != NULL);
+  AZ_ZERO_OBJECT(mapped);
+  const int fd = open(path, O_RDONLY);
+  if (fd < 0) return NULL;
+  struct stat stat_buffer;
+  if (fstat(fd, &stat_buffer) != 0 || !S_ISREG(stat_buffer.st_mode) ||
+      stat_buffer.st_size <= 0) {
+    close(fd);
+    return NULL;
+  }
+  const size_t size = (size_t)stat_buffer.st_size;
+  // A private mapping never writes back to the file, so we can map it
+  // writable even though we only opened it for reading.
+  void *contents = mmap(NULL, size, (copy_on_write ? PROT_READ | PROT_WRITE :
+                                     PROT_READ), MAP_PRIVATE, fd, 0);
+  // The mapping stays valid after the file is closed.
+  close(fd);
+  if (contents == MAP_FAILED) return NULL;
+  mapped->contents = contents;
+  mapped->size = size;
+  return contents;
+}
+
+void az_system_unmap_file(az_mapped_file_t *mapped) {
+  assert(mapped != NULL);
+  if (mapped->contents == NULL) return;
+  munmap((void *)mapped->contents, mapped->size);
+  AZ_ZERO_OBJECT(mapped);
+}
+#endif
+
+bool az_system_map_file(const char *path, az_mapped_file_t *mapped) {
+  return map_file(path, false, mapped) != NULL;
+}
+
+bool az_system_map_file_copy_on_write(const char *path,
+                                      az_mapped_file_t *mapped,
+                                      void **contents_out) {
+  assert(contents_out != NULL);
+  *contents_out = map_file(path, true, mapped);
+  return *contents_out != NULL;
+}
+
+/*===========================================================================*/
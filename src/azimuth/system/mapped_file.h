@@ -0,0 +1,56 @@
+/*=============================================================================
+| Copyright 2012 Matthew D. Steele <mdsteele@alum.mit.edu>                    |
+|                                                                             |
+| This file is part of Azimuth.                                               |
+|                                                                             |
+| Azimuth is free software: you can redistribute it and/or modify it under    |
+| the terms of the GNU General Public License as published by the Free        |
+| Software Foundation, either version 3 of the License, or (at your option)   |
+| any later version.                                                          |
+|                                                                             |
+| Azimuth is distributed in the hope that it will be useful, but WITHOUT      |
+| ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       |
+| FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for   |
+| more details.                                                               |
+|                                                                             |
+| You should have received a copy of the GNU General Public License along     |
+| with Azimuth.  If not, see <http://www.gnu.org/licenses/>.                  |
+=============================================================================*/
+
+
+#pragma once
+#ifndef AZIMUTH_SYSTEM_MAPPED_FILE_H_
+#define AZIMUTH_SYSTEM_MAPPED_FILE_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/*===========================================================================*/
+
+// A view of a whole file's contents, mapped into memory so that pages are only
+// read from disk as they are used.
+typedef struct {
+  const void *contents; // NULL if nothing is mapped
+  size_t size;
+  void *handle; // platform-specific
+} az_mapped_file_t;
+
+// Map the file at the given path into memory.  Returns false (leaving mapped
+// zeroed) if the file doesn't exist, is empty, or can't be mapped.
+bool az_system_map_file(const char *path, az_mapped_file_t *mapped);
+
+// Like az_system_map_file, but map the file copy-on-write, and also store a
+// writable pointer to the contents in contents_out (NULL on failure).  Changes
+// made through it are private to this process, and never reach the file; each
+// page is only copied the first time it is written to.
+bool az_system_map_file_copy_on_write(const char *path,
+                                      az_mapped_file_t *mapped,
+                                      void **contents_out);
+
+// Unmap a file mapped by az_system_map_file, and zero mapped.  This is a no-op
+// if nothing is mapped.  Any pointers into the contents become invalid.
+void az_system_unmap_file(az_mapped_file_t *mapped);
+
+/*===========================================================================*/
+
+#endif // AZIMUTH_SYSTEM_MAPPED_FILE_H_
@@ -0,0 +1,88 @@
+/*=============================================================================
+| Copyright 2012 Matthew D. Steele <mdsteele@alum.mit.edu>                    |
+|                                                                             |
+| This file is part of Azimuth.                                               |
+|                                                                             |
+| Azimuth is free software: you can redistribute it and/or modify it under    |
+| the terms of the GNU General Public License as published by the Free        |
+| Software Foundation, either version 3 of the License, or (at your option)   |
+| any later version.                                                          |
+|                                                                             |
+| Azimuth is distributed in the hope that it will be useful, but WITHOUT      |
+| ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       |
+| FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for   |
+| more details.                                                               |
+|                                                                             |
+| You should have received a copy of the GNU General Public License along     |
+| with Azimuth.  If not, see <http://www.gnu.org/licenses/>.                  |
+=============================================================================*/
+
+
+#include "azimuth/system/parallel.h"
+
+#include <assert.h>
+#include <stdbool.h>
+
+#include <SDL_atomic.h>
+#include <SDL_cpuinfo.h>
+#include <SDL_thread.h>
+
+#include "azimuth/util/misc.h"
+#include "azimuth/util/parallel.h"
+#include "azimuth/util/vector.h"
+#include "azimuth/util/warning.h"
+
+/*===========================================================================*/
+
+// We won't ever start more worker threads than this, no matter how many CPUs
+// there are.
+#define MAX_WORKERS 16
+
+typedef struct {
+  int num_jobs;
+  az_parallel_job_fn_t job;
+  void *userdata;
+  SDL_atomic_t next_index;
+} work_t;
+
+// Each worker claims the next unclaimed index until there are none left, so
+// that a few slow jobs don't hold up the rest.
+static int worker_main(void *arg) {
+  work_t *work = arg;
+  while (true) {
+    const int index = SDL_AtomicAdd(&work->next_index, 1);
+    if (index >= work->num_jobs) break;
+    work->job(work->userdata, index);
+  }
+  return 0;
+}
+
+void az_system_parallel_for(int num_jobs, az_parallel_job_fn_t job,
+                            void *userdata) {
+  assert(num_jobs >= 0);
+  assert(job != NULL);
+  const int num_workers =
+    az_imin(az_imin(SDL_GetCPUCount(), MAX_WORKERS), num_jobs);
+  if (num_workers <= 1) {
+    az_serial_for(num_jobs, job, userdata);
+    return;
+  }
+  work_t work = { .num_jobs = num_jobs, .job = job, .userdata = userdata };
+  SDL_AtomicSet(&work.next_index, 0);
+  // The calling thread acts as one of the workers, so we only need to start
+  // num_workers - 1 extra threads.  If we can't start a thread, the others
+  // will simply pick up its share of the jobs.
+  SDL_Thread *threads[MAX_WORKERS - 1] = {NULL};
+  for (int i = 0; i < num_workers - 1; ++i) {
+    threads[i] = SDL_CreateThread(worker_main, "az_worker", &work);
+    if (threads[i] == NULL) {
+      AZ_WARNING_ONCE("SDL_CreateThread failed: %s\n", SDL_GetError());
+    }
+  }
+  worker_main(&work);
+  AZ_ARRAY_LOOP(thread, threads) {
+    if (*thread != NULL) SDL_WaitThread(*thread, NULL);
+  }
+}
+
+/*===========================================================================*/
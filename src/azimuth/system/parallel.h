@@ -0,0 +1,36 @@
+/*=============================================================================
+| Copyright 2012 Matthew D. Steele <mdsteele@alum.mit.edu>                    |
+|                                                                             |
+| This file is part of Azimuth.                                               |
+|                                                                             |
+| Azimuth is free software: you can redistribute it and/or modify it under    |
+| the terms of the GNU General Public License as published by the Free        |
+| Software Foundation, either version 3 of the License, or (at your option)   |
+| any later version.                                                          |
+|                                                                             |
+| Azimuth is distributed in the hope that it will be useful, but WITHOUT      |
+| ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       |
+| FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for   |
+| more details.                                                               |
+|                                                                             |
+| You should have received a copy of the GNU General Public License along     |
+| with Azimuth.  If not, see <http://www.gnu.org/licenses/>.                  |
+=============================================================================*/
+
+
+#pragma once
+#ifndef AZIMUTH_SYSTEM_PARALLEL_H_
+#define AZIMUTH_SYSTEM_PARALLEL_H_
+
+#include "azimuth/util/parallel.h"
+
+/*===========================================================================*/
+
+// An az_parallel_for_fn_t that spreads the jobs across one worker thread per
+// CPU (including the calling thread).
+void az_system_parallel_for(int num_jobs, az_parallel_job_fn_t job,
+                            void *userdata);
+
+/*===========================================================================*/
+
+#endif // AZIMUTH_SYSTEM_PARALLEL_H_
@@ -25,6 +25,7 @@
 
 #include <SDL_filesystem.h>
 
+#include "azimuth/system/mapped_file.h"
 #include "azimuth/util/rw.h"
 #include "azimuth/util/string.h"
 
@@ -40,19 +41,45 @@ extern const struct resource_entry {
   size_t offset, length;
 } resource_index[];
 extern const size_t resource_index_size;
-extern const char _binary_resources_start[];
+// The blob is linked into a writable data section, aligned to
+// AZ_RESOURCE_ALIGN bytes, and each resource within it is padded out to a
+// multiple of AZ_RESOURCE_ALIGN bytes (see the Makefile).
+extern char _binary_resources_start[];
 
 #if defined(__APPLE__)
 // Use app-bundle resources on macOS
-bool az_system_resource_reader(const char *name, az_reader_t *reader) {
+static char *resource_path(const char *name) {
   char *resource_dir = SDL_GetBasePath();
-  if (resource_dir == NULL) return false;
+  if (resource_dir == NULL) return NULL;
   char *path = az_strprintf("%s/%s", resource_dir, name);
   SDL_free(resource_dir);
+  return path;
+}
+
+bool az_system_resource_reader(const char *name, az_reader_t *reader) {
+  char *path = resource_path(name);
+  if (path == NULL) return false;
   const bool success = az_file_reader(path, reader);
   free(path);
   return success;
 }
+
+bool az_system_resource_writable_contents(const char *name,
+                                          void **contents_out,
+                                          size_t *size_out) {
+  char *path = resource_path(name);
+  if (path == NULL) return false;
+  // Mappings start on a page boundary, so they are suitably aligned.  The
+  // mapping is deliberately never unmapped, so that the contents stay valid
+  // for the rest of the program's run.
+  az_mapped_file_t mapped;
+  const bool success =
+    az_system_map_file_copy_on_write(path, &mapped, contents_out);
+  free(path);
+  if (!success) return false;
+  *size_out = mapped.size;
+  return true;
+}
 #else
 // Comparison function for bsearch.
 static int compare_resource_entries(const void *key_ptr,
@@ -62,15 +89,28 @@ static int compare_resource_entries(const void *key_ptr,
   return strcmp(name, entry->name);
 }
 
+static const struct resource_entry *find_resource(const char *name) {
+  return bsearch(name, resource_index, resource_index_size,
+                 sizeof(struct resource_entry), &compare_resource_entries);
+}
+
 bool az_system_resource_reader(const char *name, az_reader_t *reader) {
-  struct resource_entry *entry =
-    bsearch(name, resource_index, resource_index_size,
-            sizeof(struct resource_entry), &compare_resource_entries);
+  const struct resource_entry *entry = find_resource(name);
   if (entry == NULL) return false;
   az_charbuf_reader(_binary_resources_start + entry->offset, entry->length,
                     reader);
   return true;
 }
+
+bool az_system_resource_writable_contents(const char *name,
+                                          void **contents_out,
+                                          size_t *size_out) {
+  const struct resource_entry *entry = find_resource(name);
+  if (entry == NULL) return false;
+  *contents_out = _binary_resources_start + entry->offset;
+  *size_out = entry->length;
+  return true;
+}
 #endif
 
 /*===========================================================================*/
@@ -22,6 +22,7 @@
 #define AZIMUTH_SYSTEM_RESOURCE_H_
 
 #include <stdbool.h>
+#include <stddef.h>
 
 #include "azimuth/util/rw.h"
 
@@ -30,6 +31,17 @@
 // An az_resource_reader_fn_t for reading game resources.
 bool az_system_resource_reader(const char *name, az_reader_t *reader);
 
+// Get the raw contents of a game resource, without copying them.  Returns
+// false if the resource doesn't exist.  On success, the contents remain valid
+// until the program exits, start at a multiple of AZ_RESOURCE_ALIGN bytes,
+// and may be modified in place (which never touches the resource's file on
+// disk, if any).  Later lookups of the same resource may or may not see such
+// changes, so a resource that gets modified should only be looked up once.
+#define AZ_RESOURCE_ALIGN 16
+bool az_system_resource_writable_contents(const char *name,
+                                          void **contents_out,
+                                          size_t *size_out);
+
 /*===========================================================================*/
 
 #endif // AZIMUTH_SYSTEM_RESOURCE_H_
@@ -20,12 +20,40 @@
 #include "azimuth/util/clock.h"
 
 #include <assert.h>
+#include <stdbool.h>
+
+/*===========================================================================*/
+
+static bool tracking = false;
+// The fewest ticks until something noted while tracking changes (or zero if
+// nothing has been noted yet).
+static az_clock_t tracked_ticks = 0;
+
+void az_start_clock_tracking(void) {
+  assert(!tracking);
+  tracking = true;
+  tracked_ticks = 0;
+}
+
+void az_clock_note_change(int slowdown, az_clock_t clock) {
+  assert(slowdown >= 1);
+  if (!tracking) return;
+  const az_clock_t ticks = slowdown - clock % slowdown;
+  if (tracked_ticks == 0 || ticks < tracked_ticks) tracked_ticks = ticks;
+}
+
+az_clock_t az_stop_clock_tracking(void) {
+  assert(tracking);
+  tracking = false;
+  return tracked_ticks;
+}
 
 /*===========================================================================*/
 
 int az_clock_mod(int modulus, int slowdown, az_clock_t clock) {
   assert(modulus >= 1);
   assert(slowdown >= 1);
+  if (modulus > 1) az_clock_note_change(slowdown, clock);
   return (clock % (modulus * slowdown)) / slowdown;
 }
 
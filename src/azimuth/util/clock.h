@@ -33,6 +33,23 @@ int az_clock_mod(int modulus, int slowdown, az_clock_t clock);
 // again, with the number advancing by one every `slowdown` ticks of the clock.
 int az_clock_zigzag(int modulus, int slowdown, az_clock_t clock);
 
+// Start keeping track of how soon the results of az_clock_mod and
+// az_clock_zigzag calls would change if their clock arguments advanced,
+// so that a screen drawn from the clock can tell how long it will look the
+// same.  Tracking is not thread-safe; only use it while no other thread is
+// calling these functions.
+void az_start_clock_tracking(void);
+
+// While tracking, note that something that changes every `slowdown` ticks
+// was computed from the given clock value, for animations that don't go
+// through az_clock_mod or az_clock_zigzag.
+void az_clock_note_change(int slowdown, az_clock_t clock);
+
+// Stop tracking, and return how many ticks the clock can advance before
+// anything computed since az_start_clock_tracking might change, or zero if
+// nothing computed in that time depended on the clock.
+az_clock_t az_stop_clock_tracking(void);
+
 /*===========================================================================*/
 
 #endif // AZIMUTH_UTIL_CLOCK_H_
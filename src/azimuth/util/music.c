@@ -720,18 +720,92 @@ void az_destroy_music(az_music_t *music) {
 
 /*===========================================================================*/
 
-#define SECONDS_PER_SAMPLE (1.0 / (double)(AZ_AUDIO_RATE))
-// How many virtual samples to average together for each sample array entry:
-#define SYNTH_SUPERSAMPLE 8
 // The wave amplitude produced by an L100 note:
 #define BASE_LOUDNESS 6500.0
+// Oscillator phases are unsigned 32-bit fixed-point fractions of a cycle, so
+// that they wrap around on their own:
+#define PHASE_PER_CYCLE 4294967296.0
+// The sine wavetable has 2^SINE_TABLE_BITS entries per cycle:
+#define SINE_TABLE_BITS 10
+#define SINE_TABLE_SIZE (1 << SINE_TABLE_BITS)
+#define SINE_FRAC_BITS (32 - SINE_TABLE_BITS)
 
-static uint64_t generate_noise(void) {
+// One cycle of a sine wave, plus a copy of the first entry at the end so that
+// we can interpolate past the last entry without wrapping.
+static float sine_table[SINE_TABLE_SIZE + 1];
+static bool sine_table_initialized = false;
+
+void az_init_music_synth_tables(void) {
+  if (sine_table_initialized) return;
+  for (int i = 0; i < SINE_TABLE_SIZE; ++i) {
+    sine_table[i] = sin(i * (AZ_TWO_PI / SINE_TABLE_SIZE));
+  }
+  sine_table[SINE_TABLE_SIZE] = sine_table[0];
+  sine_table_initialized = true;
+}
+
+// Return the sine of the given phase, interpolating linearly between
+// wavetable entries (which is accurate to within about 5e-6).
+static double table_sine(uint32_t phase) {
+  assert(sine_table_initialized);
+  const uint32_t index = phase >> SINE_FRAC_BITS;
+  const double frac = (phase & ((UINT32_C(1) << SINE_FRAC_BITS) - 1)) *
+    (1.0 / (double)(UINT32_C(1) << SINE_FRAC_BITS));
+  return sine_table[index] + frac * (sine_table[index + 1] - sine_table[index]);
+}
+
+// Return sin(time * speed), for the vibrato and duty modulation LFOs.  These
+// are functions of the time since the start of the note, so rather than
+// keeping a separate phase accumulator for them, we just convert that time
+// into a phase.
+static double lfo_sine(double time, double speed) {
+  return table_sine((uint32_t)(int64_t)(time * speed *
+                                        (PHASE_PER_CYCLE / AZ_TWO_PI)));
+}
+
+// Return the PolyBLEP correction for a wave that jumps from -1 up to 1 when
+// its phase t (from 0 to 1) wraps around, given that the phase advances by dt
+// per sample.  Adding this to the naive wave smooths out the discontinuity
+// over the two samples nearest to it, which removes most of the aliasing
+// that the naive wave would produce.
+static double poly_blep(double t, double dt) {
+  if (t < dt) {
+    t /= dt;
+    return t + t - t * t - 1.0;
+  } else if (t > 1.0 - dt) {
+    t = (t - 1.0) / dt;
+    return t * t + t + t + 1.0;
+  }
+  return 0.0;
+}
+
+#define INITIAL_NOISE_SEED UINT64_C(123456789123456789)
+
+static uint64_t generate_noise(uint64_t *seed) {
   // This is a simple linear congruential generator, using the parameters
   // suggested by http://nuclear.llnl.gov/CNP/rng/rngman/node4.html
-  static uint64_t seed = UINT64_C(123456789123456789);
-  seed = UINT64_C(2862933555777941757) * seed + UINT64_C(3037000493);
-  return seed;
+  *seed = UINT64_C(2862933555777941757) * *seed + UINT64_C(3037000493);
+  return *seed;
+}
+
+// Start playing the given part from the beginning, with every voice at phase
+// zero, so that how the part sounds depends only on the voice settings.
+static void synth_start_part(az_music_synth_t *synth, int part_index) {
+  const az_music_t *music = synth->music;
+  assert(part_index >= 0);
+  assert(part_index < music->num_parts);
+  const az_music_part_t *part = &music->parts[part_index];
+  for (int i = 0; i < AZ_MUSIC_NUM_TRACKS; ++i) {
+    synth->voices[i].track = &part->tracks[i];
+    synth->voices[i].note_index = 0;
+    synth->voices[i].drum_position = 0;
+    synth->voices[i].time_from_note_start = 0.0;
+    synth->voices[i].phase = 0;
+    synth->part_entry_settings[i] = synth->voices[i].settings;
+  }
+  synth->part_index = part_index;
+  synth->part_just_started = true;
+  synth->part_pcm = NULL;
 }
 
 static void synth_begin_next_part(az_music_synth_t *synth) {
@@ -746,16 +820,9 @@ static void synth_begin_next_part(az_music_synth_t *synth) {
     az_music_instruction_t *ins = &music->instructions[synth->pc++];
     switch (ins->opcode) {
       case AZ_MUSOP_NOP: break;
-      case AZ_MUSOP_PLAY: {
-        assert(ins->index >= 0);
-        assert(ins->index < music->num_parts);
-        const az_music_part_t *part = &music->parts[ins->index];
-        for (int i = 0; i < AZ_MUSIC_NUM_TRACKS; ++i) {
-          synth->voices[i].track = &part->tracks[i];
-          synth->voices[i].note_index = 0;
-          synth->voices[i].time_from_note_start = 0.0;
-        }
-      } return;
+      case AZ_MUSOP_PLAY:
+        synth_start_part(synth, ins->index);
+        return;
       case AZ_MUSOP_SETF:
         synth->flag = ins->value;
         break;
@@ -808,28 +875,28 @@ static void synth_advance(az_music_synth_t *synth) {
             voice->time_from_note_start -= note->attributes.drum.duration;
             break;
           case AZ_NOTE_DUTYMOD:
-            voice->dutymod_depth = note->attributes.dutymod.depth;
-            voice->dutymod_speed = note->attributes.dutymod.speed;
+            voice->settings.dutymod_depth = note->attributes.dutymod.depth;
+            voice->settings.dutymod_speed = note->attributes.dutymod.speed;
             break;
           case AZ_NOTE_ENVELOPE:
-            voice->attack_time = note->attributes.envelope.attack_time;
-            voice->decay_fraction = note->attributes.envelope.decay_fraction;
+            voice->settings.attack_time = note->attributes.envelope.attack_time;
+            voice->settings.decay_fraction = note->attributes.envelope.decay_fraction;
             break;
           case AZ_NOTE_LOUDNESS:
-            voice->loudness = BASE_LOUDNESS * note->attributes.loudness.volume;
-            assert(voice->loudness >= 0.0);
+            voice->settings.loudness = BASE_LOUDNESS * note->attributes.loudness.volume;
+            assert(voice->settings.loudness >= 0.0);
             break;
           case AZ_NOTE_VIBRATO:
-            voice->vibrato_depth = note->attributes.vibrato.depth;
-            voice->vibrato_speed = note->attributes.vibrato.speed;
+            voice->settings.vibrato_depth = note->attributes.vibrato.depth;
+            voice->settings.vibrato_speed = note->attributes.vibrato.speed;
             break;
           case AZ_NOTE_WAVEFORM:
-            voice->waveform = note->attributes.waveform.kind;
-            voice->duty = note->attributes.waveform.duty;
+            voice->settings.waveform = note->attributes.waveform.kind;
+            voice->settings.duty = note->attributes.waveform.duty;
             break;
         }
         ++voice->note_index;
-        voice->drum_index = 0;
+        voice->drum_position = 0;
       }
     sustain:
       synth->steps_since_last_sustain = 0;
@@ -842,104 +909,234 @@ static void synth_advance(az_music_synth_t *synth) {
 void az_reset_music_synth(az_music_synth_t *synth, const az_music_t *music,
                           int flag) {
   assert(synth != NULL);
+  const az_music_pcm_lookup_fn_t pcm_lookup = synth->pcm_lookup;
+  void *pcm_lookup_userdata = synth->pcm_lookup_userdata;
+  const int sample_rate = synth->sample_rate;
   AZ_ZERO_OBJECT(synth);
+  synth->pcm_lookup = pcm_lookup;
+  synth->pcm_lookup_userdata = pcm_lookup_userdata;
+  az_set_music_sample_rate(synth, (sample_rate > 0 ? sample_rate :
+                                   AZ_AUDIO_RATE));
+  az_init_music_synth_tables();
   if (music == NULL) return;
   synth->music = music;
   synth->flag = flag;
+  synth->noise_seed = INITIAL_NOISE_SEED;
   AZ_ARRAY_LOOP(voice, synth->voices) {
-    voice->waveform = AZ_SQUARE_WAVE;
-    voice->duty = 0.5;
-    voice->loudness = BASE_LOUDNESS;
-    voice->noise_bits = generate_noise();
+    voice->settings.waveform = AZ_SQUARE_WAVE;
+    voice->settings.duty = 0.5;
+    voice->settings.loudness = BASE_LOUDNESS;
+    voice->noise_bits = generate_noise(&synth->noise_seed);
   }
   synth_begin_next_part(synth);
   synth_advance(synth);
 }
 
+void az_set_music_pcm_lookup(az_music_synth_t *synth,
+                             az_music_pcm_lookup_fn_t lookup, void *userdata) {
+  synth->pcm_lookup = lookup;
+  synth->pcm_lookup_userdata = userdata;
+}
+
+void az_set_music_sample_rate(az_music_synth_t *synth, int sample_rate) {
+  assert(sample_rate > 0);
+  synth->sample_rate = sample_rate;
+  synth->drum_step = az_resample_step(sample_rate);
+}
+
+// Synthesize the next sample of the current part live, and advance the synth
+// past it.
+static int16_t synthesize_sample(az_music_synth_t *synth) {
+  assert(!synth->stopped);
+  int sample = 0;
+  AZ_ARRAY_LOOP(voice, synth->voices) {
+    if (voice->settings.loudness <= 0.0) continue;
+    const az_music_track_t *track = voice->track;
+    if (voice->note_index >= track->num_notes) continue;
+    const az_music_note_t *note = &track->notes[voice->note_index];
+    if (note->type == AZ_NOTE_TONE) {
+      const double vibrato = 1.0 + voice->settings.vibrato_depth *
+        lfo_sine(voice->time_from_note_start, voice->settings.vibrato_speed);
+      const double frequency = note->attributes.tone.frequency * vibrato;
+      assert(frequency >= 0.0 && frequency < synth->sample_rate);
+      const uint32_t delta =
+        (uint32_t)(frequency * (PHASE_PER_CYCLE / synth->sample_rate));
+      const uint32_t old_phase = voice->phase;
+      voice->phase += delta;
+      if (voice->phase < old_phase &&
+          voice->settings.waveform == AZ_NOISE_WAVE) {
+        voice->noise_bits = generate_noise(&synth->noise_seed);
+      }
+      const double phase = voice->phase * (1.0 / PHASE_PER_CYCLE);
+      const double dt = delta * (1.0 / PHASE_PER_CYCLE);
+      double duty = voice->settings.duty;
+      if (voice->settings.dutymod_depth != 0.0) {
+        duty *= 1.0 + voice->settings.dutymod_depth *
+          lfo_sine(voice->time_from_note_start, voice->settings.dutymod_speed);
+      }
+      double amplitude = 0.0;
+      switch (voice->settings.waveform) {
+        case AZ_NOISE_WAVE:
+          amplitude = ((voice->noise_bits >> (voice->phase >> 26)) & 0x1 ?
+                       1.0 : -1.0);
+          break;
+        case AZ_SINE_WAVE:
+          amplitude = table_sine(voice->phase);
+          break;
+        case AZ_SQUARE_WAVE: {
+          // A square wave is a rising edge at phase 0 plus a falling edge
+          // at phase duty, each of which needs its own correction.
+          duty = fmin(fmax(0.0, duty), 1.0);
+          double falling = phase + (1.0 - duty);
+          if (falling >= 1.0) falling -= 1.0;
+          amplitude = (phase < duty ? 1.0 : -1.0) +
+            poly_blep(phase, dt) - poly_blep(falling, dt);
+        } break;
+        case AZ_TRIANGLE_WAVE:
+          // A triangle wave has no discontinuities, only corners, so it
+          // aliases little enough that the naive wave will do.
+          amplitude = (phase < duty ? 2.0 * (phase / duty) - 1.0 :
+                       1.0 - 2.0 * ((phase - duty) / (1.0 - duty)));
+          break;
+        case AZ_SAWTOOTH_WAVE:
+        case AZ_WOBBLE_WAVE:
+          AZ_ASSERT_UNREACHABLE();
+      }
+      const double decay_time =
+        note->attributes.tone.duration * voice->settings.decay_fraction;
+      assert(decay_time >= 0.0);
+      const double time_remaining =
+        note->attributes.tone.duration - voice->time_from_note_start;
+      assert(time_remaining > 0.0);
+      const double envelope =
+        (voice->time_from_note_start < voice->settings.attack_time ?
+         voice->time_from_note_start / voice->settings.attack_time : 1.0) *
+        (time_remaining < decay_time ? time_remaining / decay_time : 1.0);
+      sample += amplitude * envelope * voice->settings.loudness;
+    } else if (note->type == AZ_NOTE_DRUM) {
+      const az_sound_data_t *data = note->attributes.drum.data;
+      // Drum sounds are stored at AZ_AUDIO_RATE, so unless that's also our
+      // output rate, we need to resample them as we go.
+      if ((voice->drum_position >> AZ_RESAMPLE_FRAC_BITS) <
+          data->num_samples) {
+        const int drum_sample =
+          (synth->drum_step == UINT64_C(1) << AZ_RESAMPLE_FRAC_BITS ?
+           data->samples[voice->drum_position >> AZ_RESAMPLE_FRAC_BITS] :
+           az_resample_sound_at(data, voice->drum_position));
+        sample += ((1.0 / BASE_LOUDNESS) * voice->settings.loudness *
+                   drum_sample);
+        voice->drum_position += synth->drum_step;
+      }
+    } else assert(note->type == AZ_NOTE_REST);
+  }
+  const double seconds_per_sample = 1.0 / synth->sample_rate;
+  AZ_ARRAY_LOOP(voice, synth->voices) {
+    if (voice->note_index < voice->track->num_notes) {
+      voice->time_from_note_start += seconds_per_sample;
+    }
+  }
+  synth_advance(synth);
+  return az_imin(az_imax(INT16_MIN, sample), INT16_MAX);
+}
+
+// Called when we reach the end of a part that we were playing from
+// pre-rendered PCM, to put the synth into the same state as if we had
+// synthesized the part live, and move on to the next part.
+static void finish_pcm_part(az_music_synth_t *synth) {
+  const az_music_part_pcm_t *pcm = synth->part_pcm;
+  assert(pcm != NULL);
+  assert(synth->part_pcm_index == pcm->num_samples);
+  synth->part_pcm = NULL;
+  for (int i = 0; i < AZ_MUSIC_NUM_TRACKS; ++i) {
+    synth->voices[i].settings = pcm->exit_settings[i];
+    synth->voices[i].note_index = synth->voices[i].track->num_notes;
+    synth->voices[i].drum_position = 0;
+    synth->voices[i].time_from_note_start = 0.0;
+  }
+  synth_advance(synth);
+}
+
 void az_synthesize_music(az_music_synth_t *synth, int16_t *samples,
                          int num_samples) {
   assert(synth != NULL);
-  if (synth->music == NULL) {
-    memset(samples, 0, num_samples * sizeof(int16_t));
-    return;
-  }
-  for (int sample_index = 0; sample_index < num_samples; ++sample_index) {
-    if (synth->stopped) break;
-    int sample = 0;
-    AZ_ARRAY_LOOP(voice, synth->voices) {
-      if (voice->loudness <= 0.0) continue;
-      const az_music_track_t *track = voice->track;
-      if (voice->note_index >= track->num_notes) continue;
-      const az_music_note_t *note = &track->notes[voice->note_index];
-      if (note->type == AZ_NOTE_TONE) {
-        const double vibrato = 1.0 + voice->vibrato_depth *
-          sin(voice->time_from_note_start * voice->vibrato_speed);
-        const double period =
-          1.0 / (note->attributes.tone.frequency * vibrato);
-        const int iperiod = (int)(AZ_AUDIO_RATE * SYNTH_SUPERSAMPLE * period);
-        double amplitude = 0.0;
-        for (int s = 0; s < SYNTH_SUPERSAMPLE; ++s) {
-          ++voice->iphase;
-          if (voice->iphase >= iperiod) {
-            voice->iphase %= iperiod;
-            if (voice->waveform == AZ_NOISE_WAVE) {
-              voice->noise_bits = generate_noise();
-            }
-          }
-          const double phase = (double)voice->iphase / (double)iperiod;
-          const double duty = voice->duty *
-            (1.0 + voice->dutymod_depth *
-             sin(voice->time_from_note_start * voice->dutymod_speed));
-          switch (voice->waveform) {
-            case AZ_NOISE_WAVE:
-              amplitude += ((voice->noise_bits >>
-                             (64 * voice->iphase / iperiod)) & 0x1 ?
-                            1.0 : -1.0);
-              break;
-            case AZ_SINE_WAVE:
-              amplitude += sin(phase * AZ_TWO_PI);
-              break;
-            case AZ_SQUARE_WAVE:
-              amplitude += (phase < duty ? 1.0 : -1.0);
-              break;
-            case AZ_TRIANGLE_WAVE:
-              amplitude += (phase < duty ? 2.0 * (phase / duty) - 1.0 :
-                            1.0 - 2.0 * ((phase - duty) / (1.0 - duty)));
-              break;
-            case AZ_SAWTOOTH_WAVE:
-            case AZ_WOBBLE_WAVE:
-              AZ_ASSERT_UNREACHABLE();
-          }
-        }
-        const double decay_time =
-          note->attributes.tone.duration * voice->decay_fraction;
-        assert(decay_time >= 0.0);
-        const double time_remaining =
-          note->attributes.tone.duration - voice->time_from_note_start;
-        assert(time_remaining > 0.0);
-        const double envelope =
-          (voice->time_from_note_start < voice->attack_time ?
-           voice->time_from_note_start / voice->attack_time : 1.0) *
-          (time_remaining < decay_time ? time_remaining / decay_time : 1.0);
-        sample += (amplitude / SYNTH_SUPERSAMPLE) * envelope * voice->loudness;
-      } else if (note->type == AZ_NOTE_DRUM) {
-        const az_sound_data_t *data = note->attributes.drum.data;
-        if (voice->drum_index < data->num_samples) {
-          sample += ((1.0 / BASE_LOUDNESS) * voice->loudness *
-                     data->samples[voice->drum_index]);
-          ++voice->drum_index;
-        }
-      } else assert(note->type == AZ_NOTE_REST);
+  int sample_index = 0;
+  while (sample_index < num_samples && synth->music != NULL &&
+         !synth->stopped) {
+    if (synth->part_just_started) {
+      synth->part_just_started = false;
+      if (synth->pcm_lookup != NULL) {
+        synth->part_pcm = synth->pcm_lookup(
+            synth->pcm_lookup_userdata, synth->music, synth->part_index,
+            synth->part_entry_settings);
+        synth->part_pcm_index = 0;
+      }
     }
-    samples[sample_index] = az_imin(az_imax(INT16_MIN, sample), INT16_MAX);
+    const az_music_part_pcm_t *pcm = synth->part_pcm;
+    if (pcm != NULL) {
+      assert(pcm->music == synth->music);
+      assert(pcm->part_index == synth->part_index);
+      const size_t count =
+        az_imin(num_samples - sample_index,
+                (int)(pcm->num_samples - synth->part_pcm_index));
+      memcpy(samples + sample_index, pcm->samples + synth->part_pcm_index,
+             count * sizeof(int16_t));
+      sample_index += count;
+      synth->part_pcm_index += count;
+      if (synth->part_pcm_index == pcm->num_samples) finish_pcm_part(synth);
+    } else {
+      samples[sample_index++] = synthesize_sample(synth);
+    }
+  }
+  memset(samples + sample_index, 0,
+         (num_samples - sample_index) * sizeof(int16_t));
+}
 
-    AZ_ARRAY_LOOP(voice, synth->voices) {
-      if (voice->note_index < voice->track->num_notes) {
-        voice->time_from_note_start += SECONDS_PER_SAMPLE;
-      }
+void az_render_music_part(
+    const az_music_t *music, int part_index,
+    const az_music_voice_settings_t entry_settings[AZ_MUSIC_NUM_TRACKS],
+    int sample_rate, az_music_part_pcm_t *pcm_out) {
+  assert(sine_table_initialized);
+  // Set up a private synth to play just this one part (starting with the
+  // program counter at the end of the program, so that it'll stop once the
+  // part is done).
+  az_music_synth_t synth;
+  AZ_ZERO_OBJECT(&synth);
+  synth.music = music;
+  synth.pc = music->num_instructions;
+  synth.noise_seed = INITIAL_NOISE_SEED;
+  az_set_music_sample_rate(&synth, sample_rate);
+  for (int i = 0; i < AZ_MUSIC_NUM_TRACKS; ++i) {
+    synth.voices[i].settings = entry_settings[i];
+    synth.voices[i].noise_bits = generate_noise(&synth.noise_seed);
+  }
+  synth_start_part(&synth, part_index);
+  synth_advance(&synth);
+
+  AZ_ZERO_OBJECT(pcm_out);
+  pcm_out->music = music;
+  pcm_out->part_index = part_index;
+  for (int i = 0; i < AZ_MUSIC_NUM_TRACKS; ++i) {
+    pcm_out->entry_settings[i] = entry_settings[i];
+  }
+  size_t capacity = sample_rate;
+  pcm_out->samples = AZ_ALLOC(capacity, int16_t);
+  while (!synth.stopped) {
+    if (pcm_out->num_samples == capacity) {
+      capacity *= 2;
+      pcm_out->samples =
+        realloc(pcm_out->samples, capacity * sizeof(int16_t));
+      if (pcm_out->samples == NULL) AZ_FATAL("realloc failed.\n");
     }
-    synth_advance(synth);
+    pcm_out->samples[pcm_out->num_samples++] = synthesize_sample(&synth);
   }
+  for (int i = 0; i < AZ_MUSIC_NUM_TRACKS; ++i) {
+    pcm_out->exit_settings[i] = synth.voices[i].settings;
+  }
+}
+
+void az_destroy_music_part_pcm(az_music_part_pcm_t *pcm) {
+  free(pcm->samples);
+  AZ_ZERO_OBJECT(pcm);
 }
 
 /*===========================================================================*/
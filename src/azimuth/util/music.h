@@ -118,35 +118,109 @@ void az_destroy_music(az_music_t *music);
 
 /*===========================================================================*/
 
+// The settings of one synth voice that carry over from one part to the next
+// (that is, everything set by the non-sounding notes).
+typedef struct {
+  az_sound_wave_kind_t waveform;
+  double duty;
+  double loudness;
+  double attack_time, decay_fraction;
+  double dutymod_depth, dutymod_speed;
+  double vibrato_depth, vibrato_speed;
+} az_music_voice_settings_t;
+
+// One part of a piece of music, pre-rendered to PCM.  The synth always starts
+// a part at phase zero, so the part's samples depend only on the voice
+// settings it starts with (and on the noise generator, which we ignore).
+typedef struct {
+  const az_music_t *music;
+  int part_index;
+  az_music_voice_settings_t entry_settings[AZ_MUSIC_NUM_TRACKS];
+  az_music_voice_settings_t exit_settings[AZ_MUSIC_NUM_TRACKS];
+  size_t num_samples;
+  int16_t *samples;
+} az_music_part_pcm_t;
+
+// A function that the synth calls whenever it starts a part, to ask whether
+// there is a pre-rendered PCM for that part with those entry settings; it
+// should return NULL if not, in which case the part is synthesized live.
+// This is called from az_synthesize_music (so must be as cheap as that needs
+// to be).
+typedef const az_music_part_pcm_t *(*az_music_pcm_lookup_fn_t)(
+    void *userdata, const az_music_t *music, int part_index,
+    const az_music_voice_settings_t entry_settings[AZ_MUSIC_NUM_TRACKS]);
+
 typedef struct {
   const az_music_t *music;
   int flag;
   int pc;
   int steps_since_last_sustain;
   double time_index;
+  uint64_t noise_seed;
   struct {
     const az_music_track_t *track;
     int note_index;
-    size_t drum_index;
+    uint64_t drum_position; // see az_resample_sound
     double time_from_note_start;
-    az_sound_wave_kind_t waveform;
-    double duty;
-    double loudness;
-    double attack_time, decay_fraction;
-    double dutymod_depth, dutymod_speed;
-    double vibrato_depth, vibrato_speed;
-    int iphase;
+    az_music_voice_settings_t settings;
+    uint32_t phase; // fixed-point; 2^32 is one full cycle
     uint64_t noise_bits;
   } voices[AZ_MUSIC_NUM_TRACKS];
   bool stopped;
+  // Output samples per second (see az_set_music_sample_rate), and the
+  // corresponding step through drum sound data:
+  int sample_rate;
+  uint64_t drum_step;
+  // Pre-rendered PCM lookup (see az_set_music_pcm_lookup):
+  az_music_pcm_lookup_fn_t pcm_lookup;
+  void *pcm_lookup_userdata;
+  // The part most recently started, and the voice settings it started with:
+  int part_index;
+  az_music_voice_settings_t part_entry_settings[AZ_MUSIC_NUM_TRACKS];
+  bool part_just_started;
+  // The pre-rendered PCM we're playing the current part from, if any:
+  const az_music_part_pcm_t *part_pcm;
+  size_t part_pcm_index;
 } az_music_synth_t;
 
+// Initialize the wavetables shared by all synths.  az_reset_music_synth does
+// this itself if it hasn't been done yet, but that isn't thread-safe, so a
+// program that synthesizes music on more than one thread must call this
+// before starting those threads.
+void az_init_music_synth_tables(void);
+
 void az_reset_music_synth(az_music_synth_t *synth, const az_music_t *music,
                           int flag);
 
+// Have the synth play parts from pre-rendered PCM where the lookup function
+// (which may be NULL) provides it.  This setting survives
+// az_reset_music_synth.  The returned PCM must stay valid until the synth is
+// done playing it (that is, until it is reset or finishes the part).
+void az_set_music_pcm_lookup(az_music_synth_t *synth,
+                             az_music_pcm_lookup_fn_t lookup, void *userdata);
+
+// Have the synth produce the given number of samples per second, rather than
+// the default of AZ_AUDIO_RATE.  Like the PCM lookup, this setting survives
+// az_reset_music_synth; it should be set before the synth is first reset.
+void az_set_music_sample_rate(az_music_synth_t *synth, int sample_rate);
+
+// Fill the samples array with the next num_samples samples of music.  Once
+// the music has stopped (or if there is none), the rest is filled with
+// silence.
 void az_synthesize_music(az_music_synth_t *synth, int16_t *samples,
                          int num_samples);
 
+// Render the given part of the music to PCM at the given sample rate, as it
+// would sound if started with the given voice settings.  This doesn't touch
+// any shared state, so (once az_init_music_synth_tables has been called) it
+// is safe to call from any thread, concurrently with az_synthesize_music.
+void az_render_music_part(
+    const az_music_t *music, int part_index,
+    const az_music_voice_settings_t entry_settings[AZ_MUSIC_NUM_TRACKS],
+    int sample_rate, az_music_part_pcm_t *pcm_out);
+
+void az_destroy_music_part_pcm(az_music_part_pcm_t *pcm);
+
 /*===========================================================================*/
 
 #endif // AZIMUTH_UTIL_MUSIC_H_
@@ -0,0 +1,34 @@
+/*=============================================================================
+| Copyright 2012 Matthew D. Steele <mdsteele@alum.mit.edu>                    |
+|                                                                             |
+| This file is part of Azimuth.                                               |
+|                                                                             |
+| Azimuth is free software: you can redistribute it and/or modify it under    |
+| the terms of the GNU General Public License as published by the Free        |
+| Software Foundation, either version 3 of the License, or (at your option)   |
+| any later version.                                                          |
+|                                                                             |
+| Azimuth is distributed in the hope that it will be useful, but WITHOUT      |
+| ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       |
+| FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for   |
+| more details.                                                               |
+|                                                                             |
+| You should have received a copy of the GNU General Public License along     |
+| with Azimuth.  If not, see <http://www.gnu.org/licenses/>.                  |
+=============================================================================*/
+
+
+#include "azimuth/util/parallel.h"
+
+#include <assert.h>
+#include <stddef.h>
+
+/*===========================================================================*/
+
+void az_serial_for(int num_jobs, az_parallel_job_fn_t job, void *userdata) {
+  assert(num_jobs >= 0);
+  assert(job != NULL);
+  for (int i = 0; i < num_jobs; ++i) job(userdata, i);
+}
+
+/*===========================================================================*/
@@ -0,0 +1,45 @@
+/*=============================================================================
+| Copyright 2012 Matthew D. Steele <mdsteele@alum.mit.edu>                    |
+|                                                                             |
+| This file is part of Azimuth.                                               |
+|                                                                             |
+| Azimuth is free software: you can redistribute it and/or modify it under    |
+| the terms of the GNU General Public License as published by the Free        |
+| Software Foundation, either version 3 of the License, or (at your option)   |
+| any later version.                                                          |
+|                                                                             |
+| Azimuth is distributed in the hope that it will be useful, but WITHOUT      |
+| ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       |
+| FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for   |
+| more details.                                                               |
+|                                                                             |
+| You should have received a copy of the GNU General Public License along     |
+| with Azimuth.  If not, see <http://www.gnu.org/licenses/>.                  |
+=============================================================================*/
+
+
+#pragma once
+#ifndef AZIMUTH_UTIL_PARALLEL_H_
+#define AZIMUTH_UTIL_PARALLEL_H_
+
+/*===========================================================================*/
+
+// A job that does one piece of a larger computation.  The index is from 0 to
+// num_jobs - 1; jobs for different indices may run at the same time on
+// different threads, so they must not write to any shared state other than
+// their own piece of the result.
+typedef void (*az_parallel_job_fn_t)(void *userdata, int index);
+
+// Run job once for each index from 0 to num_jobs - 1, and return once all of
+// them have finished.
+typedef void (*az_parallel_for_fn_t)(int num_jobs, az_parallel_job_fn_t job,
+                                     void *userdata);
+
+// An az_parallel_for_fn_t that runs all of the jobs in order on the calling
+// thread.  This is for programs (such as the unit tests) that don't link
+// against the system code.
+void az_serial_for(int num_jobs, az_parallel_job_fn_t job, void *userdata);
+
+/*===========================================================================*/
+
+#endif // AZIMUTH_UTIL_PARALLEL_H_
@@ -40,7 +40,10 @@ void az_reset_prefs_to_defaults(az_preferences_t *prefs) {
   *prefs = (az_preferences_t){
     .music_volume = 0.8, .sound_volume = 0.8,
     .speedrun_timer = false, .fullscreen_on_startup = DEFAULT_FULLSCREEN,
-    .enable_hints = false,
+    .enable_hints = false, .gfx_backend = AZ_GFX_LEGACY,
+    .antialiasing = AZ_AA_MSAA_2X, .render_scale = 1.0,
+    .dynamic_render_scale = false, .render_thread = false,
+    .room_cache_kb = 1024,
     .key_for_control = {
       [AZ_CONTROL_UP] = AZ_KEY_UP_ARROW,
       [AZ_CONTROL_DOWN] = AZ_KEY_DOWN_ARROW,
@@ -93,6 +96,37 @@ static bool read_key(FILE *file, az_key_id_t *key_for_control,
   return true;
 }
 
+static bool read_gfx_backend(FILE *file, az_gfx_backend_t *out) {
+  int value;
+  if (fscanf(file, "=%d ", &value) < 1) return false;
+  if (value < 0 || value >= AZ_NUM_GFX_BACKENDS) return false;
+  *out = (az_gfx_backend_t)value;
+  return true;
+}
+
+static bool read_antialiasing(FILE *file, az_antialiasing_t *out) {
+  int value;
+  if (fscanf(file, "=%d ", &value) < 1) return false;
+  if (value < 0 || value >= AZ_NUM_ANTIALIASING_MODES) return false;
+  *out = (az_antialiasing_t)value;
+  return true;
+}
+
+static bool read_room_cache_kb(FILE *file, int *out) {
+  int value;
+  if (fscanf(file, "=%d ", &value) < 1) return false;
+  if (value < 0) return false;
+  *out = value;
+  return true;
+}
+
+static bool read_render_scale(FILE *file, float *out) {
+  double value;
+  if (fscanf(file, "=%lf ", &value) < 1) return false;
+  *out = fmin(fmax(0.25, value), 1.0);
+  return true;
+}
+
 static bool read_volume(FILE *file, float *out) {
   double value;
   if (fscanf(file, "=%lf ", &value) < 1) return false;
@@ -129,6 +163,24 @@ bool az_load_prefs_from_file(FILE *file, az_preferences_t *prefs_out) {
     if (strcmp(name, "eh") == 0) {
       if (!read_bool(file, &prefs.enable_hints)) return false;
     }
+    if (strcmp(name, "gb") == 0) {
+      if (!read_gfx_backend(file, &prefs.gfx_backend)) return false;
+    }
+    if (strcmp(name, "aa") == 0) {
+      if (!read_antialiasing(file, &prefs.antialiasing)) return false;
+    }
+    if (strcmp(name, "rs") == 0) {
+      if (!read_render_scale(file, &prefs.render_scale)) return false;
+    }
+    if (strcmp(name, "dr") == 0) {
+      if (!read_bool(file, &prefs.dynamic_render_scale)) return false;
+    }
+    if (strcmp(name, "rt") == 0) {
+      if (!read_bool(file, &prefs.render_thread)) return false;
+    }
+    if (strcmp(name, "rc") == 0) {
+      if (!read_room_cache_kb(file, &prefs.room_cache_kb)) return false;
+    }
     if (strcmp(name, "uk") == 0) {
       if (!read_key(file, key_for_control, AZ_CONTROL_UP)) return false;
     }
@@ -211,12 +263,16 @@ bool az_save_prefs_to_file(const az_preferences_t *prefs, FILE *file) {
   assert(file != NULL);
   const az_key_id_t* key_for_control = prefs->key_for_control;
   return (fprintf(
-      file, "@F mv=%.03f sv=%.03f st=%d fs=%d eh=%d\n"
+      file, "@F mv=%.03f sv=%.03f st=%d fs=%d eh=%d gb=%d aa=%d\n"
+      "   rs=%.03f dr=%d rt=%d rc=%d\n"
       "   uk=%d dk=%d rk=%d lk=%d fk=%d ok=%d tk=%d pk=%d\n"
       "   0k=%d 1k=%d 2k=%d 3k=%d 4k=%d 5k=%d 6k=%d 7k=%d 8k=%d 9k=%d\n",
       (double)prefs->music_volume, (double)prefs->sound_volume,
       (prefs->speedrun_timer ? 1 : 0), (prefs->fullscreen_on_startup ? 1 : 0),
-      (prefs->enable_hints ? 1 : 0),
+      (prefs->enable_hints ? 1 : 0), (int)prefs->gfx_backend,
+      (int)prefs->antialiasing, (double)prefs->render_scale,
+      (prefs->dynamic_render_scale ? 1 : 0), (prefs->render_thread ? 1 : 0),
+      prefs->room_cache_kb,
       key_for_control[AZ_CONTROL_UP],
       key_for_control[AZ_CONTROL_DOWN],
       key_for_control[AZ_CONTROL_RIGHT],
@@ -54,9 +54,36 @@ typedef enum {
 #define AZ_FIRST_CONTROL AZ_CONTROL_UP
 #define AZ_NUM_CONTROLS (AZ_CONTROL_ROCKETS + 1)
 
+// Which OpenGL pipeline to render with (see azimuth/gui/gfx.h).
+typedef enum {
+  AZ_GFX_LEGACY = 0, // fixed-function pipeline
+  AZ_GFX_CORE, // GL 3.3 core profile with shaders
+} az_gfx_backend_t;
+
+#define AZ_NUM_GFX_BACKENDS (AZ_GFX_CORE + 1)
+
+// How to antialias the edges of what we draw (see azimuth/gui/screen.h).
+typedef enum {
+  AZ_AA_OFF = 0,
+  AZ_AA_MSAA_2X, // multisampled framebuffer
+  AZ_AA_MSAA_4X,
+  AZ_AA_MSAA_8X,
+  AZ_AA_POST_PROCESS, // edge-smoothing pass (requires AZ_GFX_CORE)
+} az_antialiasing_t;
+
+#define AZ_NUM_ANTIALIASING_MODES (AZ_AA_POST_PROCESS + 1)
+
 typedef struct {
   float music_volume, sound_volume;
   bool speedrun_timer, fullscreen_on_startup, enable_hints;
+  az_gfx_backend_t gfx_backend;
+  az_antialiasing_t antialiasing;
+  float render_scale; // fraction of the window's resolution to draw at
+  bool dynamic_render_scale; // lower render_scale when falling behind
+  bool render_thread; // draw on a separate thread from the game logic
+  // How much memory (in kilobytes) to spend on parsed room contents when
+  // reading the planet from text lazily, or zero to read every room up front.
+  int room_cache_kb;
   az_key_id_t key_for_control[AZ_NUM_CONTROLS];
 } az_preferences_t;
 
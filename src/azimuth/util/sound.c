@@ -21,11 +21,19 @@
 
 #include <assert.h>
 #include <math.h>
+#include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
+#ifdef WIN32
+#include <windows.h>
+#endif
+
 #include "azimuth/util/misc.h"
+#include "azimuth/util/string.h"
 #include "azimuth/util/vector.h"
 
 /*===========================================================================*/
@@ -65,7 +73,10 @@
 // Many thanks to DrPetter for developing sfxr, and for releasing it as Free
 // Software.
 
-static struct {
+// The state of the sfxr synth while generating one sound effect.  Each call to
+// az_create_sound_data (and each sound stream) uses its own, so that
+// different sounds can be generated on different threads at once.
+typedef struct {
   int phase;
   double fperiod, fmaxperiod, fslide, fdslide;
   int period;
@@ -85,179 +96,201 @@ static struct {
   int rep_time, rep_limit;
   int arp_time, arp_limit;
   double arp_mod;
-  size_t num_samples;
-  int16_t samples[128 * 1024];
-} synth;
+  uint32_t rng_x, rng_y, rng_z, rng_w;
+  // The synth runs at twice AZ_AUDIO_RATE, and averages each pair of steps
+  // into one output sample:
+  float filesample;
+  int fileacc;
+  bool finished;
+} sfxr_synth_t;
+
+// The most samples that we'll generate for one sound effect:
+#define MAX_SAMPLES (128 * 1024)
 
-// Fill each entry in synth.noise_buffer with a random float from -1 to 1.
-static void refill_noise_buffer(void) {
+// Fill each entry in synth->noise_buffer with a random float from -1 to 1.
+static void refill_noise_buffer(sfxr_synth_t *synth) {
   // Xorshift RNG (see http://en.wikipedia.org/wiki/Xorshift)
-  static uint32_t x = 123456789;
-  static uint32_t y = 362436069;
-  static uint32_t z = 521288629;
-  static uint32_t w = 88675123;
   for (int i = 0; i < 32; ++i) {
-    const uint32_t t = x ^ (x << 11);
-    x = y; y = z; z = w;
-    w = w ^ (w >> 19) ^ t ^ (t >> 8);
-    synth.noise_buffer[i] = (float)((w * 4.656612874161595e-10) - 1.0);
+    const uint32_t t = synth->rng_x ^ (synth->rng_x << 11);
+    synth->rng_x = synth->rng_y;
+    synth->rng_y = synth->rng_z;
+    synth->rng_z = synth->rng_w;
+    synth->rng_w = synth->rng_w ^ (synth->rng_w >> 19) ^ t ^ (t >> 8);
+    synth->noise_buffer[i] =
+      (float)((synth->rng_w * 4.656612874161595e-10) - 1.0);
   }
 }
 
 // Reset the sfxr synth.  This code is taken directly from sfxr, with only
 // minor changes.
-static void reset_synth(const az_sound_spec_t *spec, bool restart) {
-  if (!restart) synth.phase = 0;
-  synth.fperiod = 100.0 / (spec->start_freq * spec->start_freq + 0.001);
-  synth.period = (int)synth.fperiod;
-  synth.fmaxperiod = 100.0 / (spec->freq_limit * spec->freq_limit + 0.001);
-  synth.fslide = 1.0 - pow(spec->freq_slide, 3) * 0.01;
-  synth.fdslide = -pow(spec->freq_delta_slide, 3) * 0.000001;
-  synth.square_duty = 0.5f - spec->square_duty * 0.5f;
-  synth.square_slide = -spec->duty_sweep * 0.00005f;
+static void reset_synth(sfxr_synth_t *synth, const az_sound_spec_t *spec,
+                        bool restart) {
+  if (!restart) synth->phase = 0;
+  synth->fperiod = 100.0 / (spec->start_freq * spec->start_freq + 0.001);
+  synth->period = (int)synth->fperiod;
+  synth->fmaxperiod = 100.0 / (spec->freq_limit * spec->freq_limit + 0.001);
+  synth->fslide = 1.0 - pow(spec->freq_slide, 3) * 0.01;
+  synth->fdslide = -pow(spec->freq_delta_slide, 3) * 0.000001;
+  synth->square_duty = 0.5f - spec->square_duty * 0.5f;
+  synth->square_slide = -spec->duty_sweep * 0.00005f;
   if (spec->arp_mod >= 0.0f) {
-    synth.arp_mod = 1.0 - pow(spec->arp_mod, 2) * 0.9;
+    synth->arp_mod = 1.0 - pow(spec->arp_mod, 2) * 0.9;
   } else {
-    synth.arp_mod = 1.0 + pow(spec->arp_mod, 2) * 10.0;
+    synth->arp_mod = 1.0 + pow(spec->arp_mod, 2) * 10.0;
   }
-  synth.arp_time = 0;
-  synth.arp_limit = (int)(pow(1.0 - spec->arp_speed, 2) * 20000 + 32);
-  if (spec->arp_speed == 1.0f) synth.arp_limit = 0;
+  synth->arp_time = 0;
+  synth->arp_limit = (int)(pow(1.0 - spec->arp_speed, 2) * 20000 + 32);
+  if (spec->arp_speed == 1.0f) synth->arp_limit = 0;
   if (!restart) {
     // Reset filter:
-    synth.fltp = 0.0f;
-    synth.fltdp = 0.0f;
-    synth.fltw = powf(1.0f - spec->lpf_cutoff, 3) * 0.1f;
-    synth.fltw_d = 1.0f + spec->lpf_ramp * 0.0001f;
-    synth.fltdmp = 5.0f / (1.0f + powf(spec->lpf_resonance, 2) * 20.0f) *
-      (0.01f + synth.fltw);
-    if (synth.fltdmp > 0.8f) synth.fltdmp = 0.8f;
-    synth.fltphp = 0.0f;
-    synth.flthp = powf(spec->hpf_cutoff, 2) * 0.1f;
-    synth.flthp_d = 1.0f + spec->hpf_ramp * 0.0003f;
+    synth->fltp = 0.0f;
+    synth->fltdp = 0.0f;
+    synth->fltw = powf(1.0f - spec->lpf_cutoff, 3) * 0.1f;
+    synth->fltw_d = 1.0f + spec->lpf_ramp * 0.0001f;
+    synth->fltdmp = 5.0f / (1.0f + powf(spec->lpf_resonance, 2) * 20.0f) *
+      (0.01f + synth->fltw);
+    if (synth->fltdmp > 0.8f) synth->fltdmp = 0.8f;
+    synth->fltphp = 0.0f;
+    synth->flthp = powf(spec->hpf_cutoff, 2) * 0.1f;
+    synth->flthp_d = 1.0f + spec->hpf_ramp * 0.0003f;
     // Reset vibrato:
-    synth.vib_phase = 0.0f;
-    synth.vib_speed = powf(spec->vibrato_speed, 2) * 0.01f;
-    synth.vib_amp = spec->vibrato_depth * 0.5f;
+    synth->vib_phase = 0.0f;
+    synth->vib_speed = powf(spec->vibrato_speed, 2) * 0.01f;
+    synth->vib_amp = spec->vibrato_depth * 0.5f;
     // Reset envelope:
-    synth.env_vol = 0.0f;
-    synth.env_stage = 0;
-    synth.env_time = 0;
-    synth.env_length[0] =
+    synth->env_vol = 0.0f;
+    synth->env_stage = 0;
+    synth->env_time = 0;
+    synth->env_length[0] =
       (int)(spec->env_attack * spec->env_attack * 100000.0f);
-    synth.env_length[1] =
+    synth->env_length[1] =
       (int)(spec->env_sustain * spec->env_sustain * 100000.0f);
-    synth.env_length[2] =
+    synth->env_length[2] =
       (int)(spec->env_decay * spec->env_decay * 100000.0f);
     // Reset phaser:
-    synth.fphase = powf(spec->phaser_offset, 2) * 1020.0f;
-    if (spec->phaser_offset < 0.0f) synth.fphase = -synth.fphase;
-    synth.fdphase = powf(spec->phaser_sweep, 2);
-    if (spec->phaser_sweep < 0.0f) synth.fdphase = -synth.fdphase;
-    synth.iphase = abs((int)synth.fphase);
-    synth.ipp = 0;
-    AZ_ZERO_ARRAY(synth.phaser_buffer);
+    synth->fphase = powf(spec->phaser_offset, 2) * 1020.0f;
+    if (spec->phaser_offset < 0.0f) synth->fphase = -synth->fphase;
+    synth->fdphase = powf(spec->phaser_sweep, 2);
+    if (spec->phaser_sweep < 0.0f) synth->fdphase = -synth->fdphase;
+    synth->iphase = abs((int)synth->fphase);
+    synth->ipp = 0;
+    AZ_ZERO_ARRAY(synth->phaser_buffer);
     // Refill noise buffer:
-    refill_noise_buffer();
+    refill_noise_buffer(synth);
     // Reset repeat:
-    synth.rep_time = 0;
-    synth.rep_limit =
+    synth->rep_time = 0;
+    synth->rep_limit =
       (int)(powf(1.0f - spec->repeat_speed, 2) * 20000 + 32);
-    if (spec->repeat_speed == 0.0f) synth.rep_limit = 0;
+    if (spec->repeat_speed == 0.0f) synth->rep_limit = 0;
   }
 }
 
-// Generate the given sound effect and populate the synth.samples array.
-// This code is taken directly from sfxr, with only minor changes.
-static void synth_sound(const az_sound_spec_t *spec) {
-  synth.num_samples = 0;
-  reset_synth(spec, false);
-  float filesample = 0.0f;
-  int fileacc = 0;
-  bool finished = false;
-
-  while (synth.num_samples < AZ_ARRAY_SIZE(synth.samples) && !finished) {
-    ++synth.rep_time;
-    if (synth.rep_limit != 0 && synth.rep_time >= synth.rep_limit) {
-      synth.rep_time = 0;
-      reset_synth(spec, true);
+// Start the synth on the given sound effect, and return the most samples
+// that the sound can last.
+static size_t start_synth(sfxr_synth_t *synth, const az_sound_spec_t *spec) {
+  AZ_ZERO_OBJECT(synth);
+  synth->rng_x = 123456789;
+  synth->rng_y = 362436069;
+  synth->rng_z = 521288629;
+  synth->rng_w = 88675123;
+  reset_synth(synth, spec, false);
+  // The sound lasts until the envelope finishes (though it may stop sooner, if
+  // the frequency limit is hit).  Each stage of the envelope lasts one step
+  // longer than its length, and each sample takes two steps, so we can
+  // allocate an exactly-sized buffer up front in the common case.
+  const size_t max_steps = (size_t)synth->env_length[0] +
+    (size_t)synth->env_length[1] + (size_t)synth->env_length[2] + 3;
+  return (max_steps / 2 < MAX_SAMPLES ? max_steps / 2 : MAX_SAMPLES);
+}
+
+// Generate up to max_samples more samples of the sound effect into samples,
+// stopping early if the sound finishes, and return the number of samples
+// written.  This code is taken directly from sfxr, with only minor changes.
+static size_t synth_samples(sfxr_synth_t *synth, const az_sound_spec_t *spec,
+                            int16_t *samples, size_t max_samples) {
+  size_t num_samples = 0;
+  while (num_samples < max_samples && !synth->finished) {
+    ++synth->rep_time;
+    if (synth->rep_limit != 0 && synth->rep_time >= synth->rep_limit) {
+      synth->rep_time = 0;
+      reset_synth(synth, spec, true);
     }
 
     // frequency envelopes/arpeggios
-    ++synth.arp_time;
-    if (synth.arp_limit != 0 && synth.arp_time >= synth.arp_limit) {
-      synth.arp_limit = 0;
-      synth.fperiod *= synth.arp_mod;
+    ++synth->arp_time;
+    if (synth->arp_limit != 0 && synth->arp_time >= synth->arp_limit) {
+      synth->arp_limit = 0;
+      synth->fperiod *= synth->arp_mod;
     }
-    synth.fslide += synth.fdslide;
-    synth.fperiod *= synth.fslide;
-    if (synth.fperiod > synth.fmaxperiod) {
-      synth.fperiod = synth.fmaxperiod;
-      if (spec->freq_limit > 0.0f) finished = true;
+    synth->fslide += synth->fdslide;
+    synth->fperiod *= synth->fslide;
+    if (synth->fperiod > synth->fmaxperiod) {
+      synth->fperiod = synth->fmaxperiod;
+      if (spec->freq_limit > 0.0f) synth->finished = true;
     }
-    float rfperiod = (float)synth.fperiod;
-    if (synth.vib_amp > 0.0f) {
-      synth.vib_phase += synth.vib_speed;
+    float rfperiod = (float)synth->fperiod;
+    if (synth->vib_amp > 0.0f) {
+      synth->vib_phase += synth->vib_speed;
       rfperiod =
-        (float)(synth.fperiod * (1.0 + sin(synth.vib_phase) * synth.vib_amp));
+        (float)(synth->fperiod * (1.0 + sin(synth->vib_phase) * synth->vib_amp));
     }
-    synth.period = (int)rfperiod;
-    if (synth.period < 8) synth.period = 8;
-    synth.square_duty += synth.square_slide;
-    if (synth.square_duty < 0.0f) synth.square_duty = 0.0f;
-    if (synth.square_duty > 0.5f) synth.square_duty = 0.5f;
+    synth->period = (int)rfperiod;
+    if (synth->period < 8) synth->period = 8;
+    synth->square_duty += synth->square_slide;
+    if (synth->square_duty < 0.0f) synth->square_duty = 0.0f;
+    if (synth->square_duty > 0.5f) synth->square_duty = 0.5f;
     // volume envelope
-    synth.env_time++;
-    if (synth.env_time > synth.env_length[synth.env_stage]) {
-      synth.env_time = 0;
-      ++synth.env_stage;
-      if (synth.env_stage == 3) finished = true;
+    synth->env_time++;
+    if (synth->env_time > synth->env_length[synth->env_stage]) {
+      synth->env_time = 0;
+      ++synth->env_stage;
+      if (synth->env_stage == 3) synth->finished = true;
     }
-    if (synth.env_stage == 0) {
-      assert(synth.env_length[0] > 0);
-      synth.env_vol = (float)synth.env_time / synth.env_length[0];
+    if (synth->env_stage == 0) {
+      assert(synth->env_length[0] > 0);
+      synth->env_vol = (float)synth->env_time / synth->env_length[0];
     }
-    if (synth.env_stage == 1) {
-      synth.env_vol = 1.0f;
-      if (synth.env_length[1] > 0) {
-        synth.env_vol +=
-          powf(1.0f - (float)synth.env_time / synth.env_length[1], 1.0f) *
+    if (synth->env_stage == 1) {
+      synth->env_vol = 1.0f;
+      if (synth->env_length[1] > 0) {
+        synth->env_vol +=
+          powf(1.0f - (float)synth->env_time / synth->env_length[1], 1.0f) *
           2.0f * spec->env_punch;
       }
     }
-    if (synth.env_stage == 2) {
-      synth.env_vol = (synth.env_length[2] > 0 ?
-                       1.0f - (float)synth.env_time / synth.env_length[2] :
+    if (synth->env_stage == 2) {
+      synth->env_vol = (synth->env_length[2] > 0 ?
+                       1.0f - (float)synth->env_time / synth->env_length[2] :
                        1.0f);
     }
 
     // phaser step
-    synth.fphase += synth.fdphase;
-    synth.iphase = abs((int)synth.fphase);
-    if (synth.iphase > 1023) synth.iphase = 1023;
-
-    if (synth.flthp_d != 0.0f) {
-      synth.flthp *= synth.flthp_d;
-      if (synth.flthp < 0.00001f) synth.flthp=0.00001f;
-      if (synth.flthp > 0.1f) synth.flthp=0.1f;
+    synth->fphase += synth->fdphase;
+    synth->iphase = abs((int)synth->fphase);
+    if (synth->iphase > 1023) synth->iphase = 1023;
+
+    if (synth->flthp_d != 0.0f) {
+      synth->flthp *= synth->flthp_d;
+      if (synth->flthp < 0.00001f) synth->flthp=0.00001f;
+      if (synth->flthp > 0.1f) synth->flthp=0.1f;
     }
 
     float ssample = 0.0f;
     for (int si = 0; si < 8; ++si) { // 8x supersampling
       float sample = 0.0f;
-      synth.phase++;
-      if (synth.phase >= synth.period) {
-        synth.phase %= synth.period;
+      synth->phase++;
+      if (synth->phase >= synth->period) {
+        synth->phase %= synth->period;
         if (spec->wave_kind == AZ_NOISE_WAVE) {
-          refill_noise_buffer();
+          refill_noise_buffer(synth);
         }
       }
       // base waveform
-      assert(synth.period > 0);
-      float fp = (float)synth.phase / synth.period;
+      assert(synth->period > 0);
+      float fp = (float)synth->phase / synth->period;
       switch (spec->wave_kind) {
         case AZ_NOISE_WAVE:
-          sample = synth.noise_buffer[synth.phase * 32 / synth.period];
+          sample = synth->noise_buffer[synth->phase * 32 / synth->period];
           break;
         case AZ_SAWTOOTH_WAVE:
           sample = 1.0f - fp * 2.0f;
@@ -266,7 +299,7 @@ static void synth_sound(const az_sound_spec_t *spec) {
           sample = (float)sin(fp * AZ_TWO_PI);
           break;
         case AZ_SQUARE_WAVE:
-          sample = (fp < synth.square_duty ? 0.5f : -0.5f);
+          sample = (fp < synth->square_duty ? 0.5f : -0.5f);
           break;
         case AZ_TRIANGLE_WAVE:
           sample = 4.0f * fabsf(fp - 0.5f) - 1.0f;
@@ -277,28 +310,28 @@ static void synth_sound(const az_sound_spec_t *spec) {
           break;
       }
       // lp filter
-      float pp = synth.fltp;
-      synth.fltw *= synth.fltw_d;
-      if (synth.fltw < 0.0f) synth.fltw = 0.0f;
-      if (synth.fltw > 0.1f) synth.fltw = 0.1f;
+      float pp = synth->fltp;
+      synth->fltw *= synth->fltw_d;
+      if (synth->fltw < 0.0f) synth->fltw = 0.0f;
+      if (synth->fltw > 0.1f) synth->fltw = 0.1f;
       if (spec->lpf_cutoff != 0.0f) {
-        synth.fltdp += (sample - synth.fltp) * synth.fltw;
-        synth.fltdp -= synth.fltdp * synth.fltdmp;
+        synth->fltdp += (sample - synth->fltp) * synth->fltw;
+        synth->fltdp -= synth->fltdp * synth->fltdmp;
       } else {
-        synth.fltp = sample;
-        synth.fltdp = 0.0f;
+        synth->fltp = sample;
+        synth->fltdp = 0.0f;
       }
-      synth.fltp += synth.fltdp;
+      synth->fltp += synth->fltdp;
       // hp filter
-      synth.fltphp += synth.fltp - pp;
-      synth.fltphp -= synth.fltphp * synth.flthp;
-      sample = synth.fltphp;
+      synth->fltphp += synth->fltp - pp;
+      synth->fltphp -= synth->fltphp * synth->flthp;
+      sample = synth->fltphp;
       // phaser
-      synth.phaser_buffer[synth.ipp & 1023] = sample;
-      sample += synth.phaser_buffer[(synth.ipp - synth.iphase + 1024) & 1023];
-      synth.ipp = (synth.ipp + 1) & 1023;
+      synth->phaser_buffer[synth->ipp & 1023] = sample;
+      sample += synth->phaser_buffer[(synth->ipp - synth->iphase + 1024) & 1023];
+      synth->ipp = (synth->ipp + 1) & 1023;
       // final accumulation and envelope application
-      ssample += sample * synth.env_vol;
+      ssample += sample * synth->env_vol;
     }
     const float master_vol = 0.05f;
     ssample = ssample / 8 * master_vol;
@@ -308,21 +341,37 @@ static void synth_sound(const az_sound_spec_t *spec) {
     ssample *= 4.0f; // arbitrary gain to get reasonable output volume...
     if (ssample > 1.0f) ssample = 1.0f;
     if (ssample < -1.0f) ssample = -1.0f;
-    filesample += ssample;
-    ++fileacc;
-    if (fileacc == 2) {
-      filesample /= fileacc;
-      fileacc = 0;
-      synth.samples[synth.num_samples++] = (int16_t)(filesample * 32000);
-      filesample = 0.0f;
+    synth->filesample += ssample;
+    ++synth->fileacc;
+    if (synth->fileacc == 2) {
+      synth->filesample /= synth->fileacc;
+      synth->fileacc = 0;
+      samples[num_samples++] = (int16_t)(synth->filesample * 32000);
+      synth->filesample = 0.0f;
     }
   }
+  return num_samples;
+}
+
+// Generate the given sound effect into data, which must be zeroed.
+static void synth_sound(sfxr_synth_t *synth, const az_sound_spec_t *spec,
+                        az_sound_data_t *data) {
+  assert(data->num_samples == 0 && data->samples == NULL);
+  const size_t capacity = start_synth(synth, spec);
+  int16_t *samples = AZ_ALLOC(capacity, int16_t);
+  size_t num_samples = synth_samples(synth, spec, samples, capacity);
 
-  // Trim unneeded zeros off the end.
-  while (synth.num_samples > 0 &&
-         synth.samples[synth.num_samples - 1] == 0) {
-    --synth.num_samples;
+  // Trim unneeded zeros off the end, and give back any unused space.
+  while (num_samples > 0 && samples[num_samples - 1] == 0) --num_samples;
+  if (num_samples == 0) {
+    free(samples);
+    samples = NULL;
+  } else if (num_samples < capacity) {
+    int16_t *shrunk = realloc(samples, num_samples * sizeof(int16_t));
+    if (shrunk != NULL) samples = shrunk;
   }
+  data->num_samples = num_samples;
+  data->samples = samples;
 }
 
 /*===========================================================================*/
@@ -330,16 +379,389 @@ static void synth_sound(const az_sound_spec_t *spec) {
 void az_create_sound_data(const az_sound_spec_t *spec, az_sound_data_t *data) {
   assert(spec != NULL);
   assert(data != NULL);
-  synth_sound(spec);
-  data->num_samples = synth.num_samples;
-  data->samples = AZ_ALLOC(synth.num_samples, int16_t);
-  memcpy(data->samples, synth.samples, synth.num_samples * sizeof(int16_t));
+  AZ_ZERO_OBJECT(data);
+  sfxr_synth_t synth;
+  synth_sound(&synth, spec, data);
 }
 
 void az_destroy_sound_data(az_sound_data_t *data) {
   assert(data != NULL);
-  free(data->samples);
+  if (!data->borrowed) free((void *)data->samples);
   AZ_ZERO_OBJECT(data);
 }
 
 /*===========================================================================*/
+
+// The resampling filter has RESAMPLE_TAPS taps for each of RESAMPLE_PHASES
+// fractional positions between two input samples.  Each set of taps is
+// centered on its fractional position, covering the RESAMPLE_TAPS / 2 input
+// samples on either side of it, and sums to exactly 1 << RESAMPLE_COEF_BITS
+// so that the filter has unity gain at DC.
+#define RESAMPLE_TAPS 8
+#define RESAMPLE_PHASE_BITS 6
+#define RESAMPLE_PHASES (1 << RESAMPLE_PHASE_BITS)
+#define RESAMPLE_COEF_BITS 14
+
+static int16_t resample_coefs[RESAMPLE_PHASES][RESAMPLE_TAPS];
+static bool resample_coefs_initialized = false;
+
+static void init_resample_coefs(void) {
+  if (resample_coefs_initialized) return;
+  for (int phase = 0; phase < RESAMPLE_PHASES; ++phase) {
+    const double frac = (double)phase / RESAMPLE_PHASES;
+    double weights[RESAMPLE_TAPS];
+    double total = 0.0;
+    for (int tap = 0; tap < RESAMPLE_TAPS; ++tap) {
+      // Distance from the interpolated position to this tap's input sample:
+      const double x = (tap - (RESAMPLE_TAPS / 2 - 1)) - frac;
+      const double sinc = (x == 0.0 ? 1.0 : sin(AZ_PI * x) / (AZ_PI * x));
+      // Blackman window over the span of the filter:
+      const double w = AZ_TWO_PI * (x + RESAMPLE_TAPS / 2) / RESAMPLE_TAPS;
+      weights[tap] = sinc * (0.42 - 0.5 * cos(w) + 0.08 * cos(2.0 * w));
+      total += weights[tap];
+    }
+    // Round the coefficients, putting any rounding error into the largest
+    // one, so that each phase sums exactly to unity.
+    int sum = 0, largest = 0;
+    for (int tap = 0; tap < RESAMPLE_TAPS; ++tap) {
+      resample_coefs[phase][tap] =
+        (int16_t)lround(weights[tap] / total * (1 << RESAMPLE_COEF_BITS));
+      sum += resample_coefs[phase][tap];
+      if (resample_coefs[phase][tap] > resample_coefs[phase][largest]) {
+        largest = tap;
+      }
+    }
+    resample_coefs[phase][largest] += (1 << RESAMPLE_COEF_BITS) - sum;
+  }
+  resample_coefs_initialized = true;
+}
+
+uint64_t az_resample_step(int output_rate) {
+  assert(output_rate > 0);
+  init_resample_coefs();
+  return ((uint64_t)AZ_AUDIO_RATE << AZ_RESAMPLE_FRAC_BITS) /
+    (uint64_t)output_rate;
+}
+
+// Apply the filter to the input samples around the given position, which
+// must be far enough from either end of the data that all taps are in range.
+static int16_t resample_interior(const int16_t *samples, uint64_t position) {
+  const int16_t *restrict input = samples +
+    (position >> AZ_RESAMPLE_FRAC_BITS) - (RESAMPLE_TAPS / 2 - 1);
+  const int16_t *restrict coefs = resample_coefs[
+      (position >> (AZ_RESAMPLE_FRAC_BITS - RESAMPLE_PHASE_BITS)) &
+      (RESAMPLE_PHASES - 1)];
+  int32_t sum = 0;
+  for (int tap = 0; tap < RESAMPLE_TAPS; ++tap) sum += input[tap] * coefs[tap];
+  sum >>= RESAMPLE_COEF_BITS;
+  return (sum < INT16_MIN ? INT16_MIN : sum > INT16_MAX ? INT16_MAX : sum);
+}
+
+int16_t az_resample_sound_at(const az_sound_data_t *data, uint64_t position) {
+  assert(resample_coefs_initialized);
+  const uint64_t index = position >> AZ_RESAMPLE_FRAC_BITS;
+  if (index >= RESAMPLE_TAPS / 2 - 1 &&
+      index + RESAMPLE_TAPS / 2 < data->num_samples) {
+    return resample_interior(data->samples, position);
+  }
+  // Near the ends of the data, pad with silence.
+  int16_t padded[RESAMPLE_TAPS] = {0};
+  for (int tap = 0; tap < RESAMPLE_TAPS; ++tap) {
+    const int64_t i = (int64_t)index + tap - (RESAMPLE_TAPS / 2 - 1);
+    if (i >= 0 && i < (int64_t)data->num_samples) padded[tap] = data->samples[i];
+  }
+  return resample_interior(padded, (position & ((UINT64_C(1) <<
+      AZ_RESAMPLE_FRAC_BITS) - 1)) + ((uint64_t)(RESAMPLE_TAPS / 2 - 1) <<
+      AZ_RESAMPLE_FRAC_BITS));
+}
+
+int az_resample_sound(const az_sound_data_t *data, uint64_t *position,
+                      uint64_t step, int16_t *output, int num_output) {
+  assert(resample_coefs_initialized);
+  const uint64_t end = (uint64_t)data->num_samples << AZ_RESAMPLE_FRAC_BITS;
+  // The positions at which all taps are within the data:
+  const uint64_t interior_start =
+    (uint64_t)(RESAMPLE_TAPS / 2 - 1) << AZ_RESAMPLE_FRAC_BITS;
+  const uint64_t interior_end = (data->num_samples > RESAMPLE_TAPS / 2 ?
+      (uint64_t)(data->num_samples - RESAMPLE_TAPS / 2) <<
+      AZ_RESAMPLE_FRAC_BITS : 0);
+  uint64_t pos = *position;
+  int count = 0;
+  while (count < num_output && pos < end) {
+    if (pos >= interior_start && pos < interior_end) {
+      output[count] = resample_interior(data->samples, pos);
+    } else {
+      output[count] = az_resample_sound_at(data, pos);
+    }
+    ++count;
+    pos += step;
+  }
+  *position = pos;
+  return count;
+}
+
+/*===========================================================================*/
+
+// How many of the most recently synthesized samples a sound stream holds on
+// to, for the resampler to interpolate between:
+#define STREAM_BUFFER_SIZE 1024
+
+struct az_sound_stream {
+  az_sound_spec_t spec;
+  sfxr_synth_t synth;
+  size_t num_remaining; // samples left before the sound must end
+  bool finished; // true if no more samples will be synthesized
+  // The buffered samples, and the position (relative to the start of the
+  // buffer) of the next output sample:
+  size_t num_buffered;
+  int16_t buffer[STREAM_BUFFER_SIZE];
+  uint64_t position;
+};
+
+az_sound_stream_t *az_new_sound_stream(const az_sound_spec_t *spec) {
+  assert(spec != NULL);
+  az_sound_stream_t *stream = AZ_ALLOC(1, az_sound_stream_t);
+  stream->spec = *spec;
+  stream->num_remaining = start_synth(&stream->synth, spec);
+  stream->finished = (stream->num_remaining == 0);
+  init_resample_coefs();
+  return stream;
+}
+
+void az_delete_sound_stream(az_sound_stream_t *stream) {
+  free(stream);
+}
+
+int az_stream_sound(az_sound_stream_t *stream, uint64_t step,
+                    int16_t *output, int num_output) {
+  assert(stream != NULL);
+  assert(step > 0);
+  int count = 0;
+  while (count < num_output) {
+    // Discard the samples that the filter no longer needs (that is, all but
+    // the last RESAMPLE_TAPS / 2 - 1 before the current position).
+    const size_t index = stream->position >> AZ_RESAMPLE_FRAC_BITS;
+    if (index > RESAMPLE_TAPS / 2 - 1) {
+      const size_t drop = az_imin(index - (RESAMPLE_TAPS / 2 - 1),
+                                  stream->num_buffered);
+      memmove(stream->buffer, stream->buffer + drop,
+              (stream->num_buffered - drop) * sizeof(int16_t));
+      stream->num_buffered -= drop;
+      stream->position -= (uint64_t)drop << AZ_RESAMPLE_FRAC_BITS;
+    }
+    // Synthesize enough samples to fill the buffer back up.
+    if (!stream->finished) {
+      const size_t num_synthesized = synth_samples(
+          &stream->synth, &stream->spec,
+          stream->buffer + stream->num_buffered,
+          az_imin(STREAM_BUFFER_SIZE - stream->num_buffered,
+                  stream->num_remaining));
+      stream->num_buffered += num_synthesized;
+      stream->num_remaining -= num_synthesized;
+      stream->finished =
+        (stream->synth.finished || stream->num_remaining == 0);
+    }
+    // Resample as many output samples as we can from what's in the buffer.
+    // Until the sound is finished, that's only those whose filter taps all
+    // lie within the buffer; after that, everything beyond the buffer is
+    // silence, just as it is beyond the end of a sound's data.
+    int max_output = num_output - count;
+    if (!stream->finished) {
+      assert(stream->num_buffered > RESAMPLE_TAPS / 2);
+      const uint64_t limit = (uint64_t)(stream->num_buffered -
+          RESAMPLE_TAPS / 2) << AZ_RESAMPLE_FRAC_BITS;
+      assert(limit > stream->position);
+      max_output = az_imin(max_output,
+                           (int)((limit - stream->position + step - 1) / step));
+    }
+    const az_sound_data_t data = {
+      .num_samples = stream->num_buffered, .samples = stream->buffer
+    };
+    const int num_resampled = az_resample_sound(
+        &data, &stream->position, step, output + count, max_output);
+    count += num_resampled;
+    if (num_resampled == 0) {
+      assert(stream->finished);
+      break;
+    }
+  }
+  return count;
+}
+
+/*===========================================================================*/
+
+// Change this whenever the synth is changed in a way that affects its output,
+// so that stale sound cache entries won't be used.
+#define SYNTH_VERSION 1
+
+// A sound cache file starts with a header, followed by a table of entries
+// (sorted by hash, for binary search), followed by the sample data for each
+// entry.  All values are stored in native byte order; a cache written on a
+// machine with a different byte order will simply fail to validate.
+#define SOUND_CACHE_MAGIC "AZSNDCCH"
+#define SOUND_CACHE_VERSION 1
+
+typedef struct {
+  char magic[8];
+  uint32_t version;
+  uint32_t num_entries;
+} sound_cache_header_t;
+
+typedef struct {
+  uint64_t hash;
+  uint64_t offset; // offset of the first sample from the start of the file
+  uint64_t num_samples;
+} sound_cache_entry_t;
+
+// FNV-1a (see http://www.isthe.com/chongo/tech/comp/fnv/)
+static uint64_t hash_bytes(uint64_t hash, const void *bytes, size_t size) {
+  const unsigned char *ptr = bytes;
+  for (size_t i = 0; i < size; ++i) {
+    hash ^= ptr[i];
+    hash *= UINT64_C(1099511628211);
+  }
+  return hash;
+}
+
+uint64_t az_hash_sound_spec(const az_sound_spec_t *spec) {
+  assert(spec != NULL);
+  uint64_t hash = UINT64_C(14695981039346656037);
+  const int32_t synth_version = SYNTH_VERSION;
+  hash = hash_bytes(hash, &synth_version, sizeof(synth_version));
+  const int32_t wave_kind = spec->wave_kind;
+  hash = hash_bytes(hash, &wave_kind, sizeof(wave_kind));
+  // Hash each field separately, so that struct padding doesn't matter.
+#define HASH_FIELD(field) hash = hash_bytes(hash, &spec->field, sizeof(float))
+  HASH_FIELD(env_attack); HASH_FIELD(env_sustain);
+  HASH_FIELD(env_punch); HASH_FIELD(env_decay);
+  HASH_FIELD(start_freq); HASH_FIELD(freq_limit);
+  HASH_FIELD(freq_slide); HASH_FIELD(freq_delta_slide);
+  HASH_FIELD(vibrato_depth); HASH_FIELD(vibrato_speed);
+  HASH_FIELD(arp_mod); HASH_FIELD(arp_speed);
+  HASH_FIELD(square_duty); HASH_FIELD(duty_sweep);
+  HASH_FIELD(repeat_speed);
+  HASH_FIELD(phaser_offset); HASH_FIELD(phaser_sweep);
+  HASH_FIELD(lpf_cutoff); HASH_FIELD(lpf_ramp); HASH_FIELD(lpf_resonance);
+  HASH_FIELD(hpf_cutoff); HASH_FIELD(hpf_ramp);
+  HASH_FIELD(volume_adjust);
+#undef HASH_FIELD
+  return hash;
+}
+
+// Comparison function for bsearch.
+static int compare_sound_cache_entries(const void *key_ptr,
+                                       const void *value_ptr) {
+  const uint64_t hash = *(const uint64_t *)key_ptr;
+  const sound_cache_entry_t *entry = value_ptr;
+  return (hash < entry->hash ? -1 : hash > entry->hash ? 1 : 0);
+}
+
+bool az_find_cached_sound_data(const void *cache, size_t cache_size,
+                               const az_sound_spec_t *spec,
+                               az_sound_data_t *data) {
+  assert(spec != NULL);
+  assert(data != NULL);
+  if (cache == NULL || cache_size < sizeof(sound_cache_header_t)) {
+    return false;
+  }
+  const sound_cache_header_t *header = cache;
+  if (memcmp(header->magic, SOUND_CACHE_MAGIC, sizeof(header->magic)) != 0 ||
+      header->version != SOUND_CACHE_VERSION ||
+      header->num_entries > (cache_size - sizeof(sound_cache_header_t)) /
+      sizeof(sound_cache_entry_t)) return false;
+  const uint64_t hash = az_hash_sound_spec(spec);
+  const sound_cache_entry_t *entry =
+    bsearch(&hash, header + 1, header->num_entries,
+            sizeof(sound_cache_entry_t), &compare_sound_cache_entries);
+  if (entry == NULL) return false;
+  // Make sure the entry's samples lie within the cache, so that a truncated
+  // or corrupted file can't make us read out of bounds.
+  if (entry->offset % sizeof(int16_t) != 0 || entry->offset > cache_size ||
+      entry->num_samples > (cache_size - entry->offset) / sizeof(int16_t)) {
+    return false;
+  }
+  AZ_ZERO_OBJECT(data);
+  data->num_samples = entry->num_samples;
+  data->samples = (entry->num_samples == 0 ? NULL :
+                   (const int16_t *)((const char *)cache + entry->offset));
+  data->borrowed = true;
+  return true;
+}
+
+// Replace the file at dest_path (if any) with the one at src_path, in a
+// single step, so that anyone opening dest_path sees either the old file or
+// the new one, and anyone who already has the old one open keeps it.
+static bool replace_file(const char *src_path, const char *dest_path) {
+#ifdef WIN32
+  // Unlike POSIX rename, Windows' rename fails if dest_path already exists.
+  return MoveFileExA(src_path, dest_path, MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+  return rename(src_path, dest_path) == 0;
+#endif
+}
+
+bool az_save_sound_cache_to_path(
+    int num_sounds, const az_sound_spec_t *specs,
+    const az_sound_data_t *datas, const char *filepath) {
+  assert(filepath != NULL);
+  // Another instance of the game may have the old cache mapped into memory,
+  // so rewriting it in place could change (or truncate) its pages out from
+  // under that instance, and crashing partway through would leave a torn
+  // file.  Instead, write the new cache alongside it and then swap it in.
+  char *temp_path = az_strprintf("%s.tmp", filepath);
+  bool ok = false;
+  FILE *file = fopen(temp_path, "wb");
+  if (file != NULL) {
+    const bool written =
+      az_save_sound_cache_to_file(num_sounds, specs, datas, file);
+    ok = (fclose(file) == 0 && written && replace_file(temp_path, filepath));
+    if (!ok) remove(temp_path);
+  }
+  free(temp_path);
+  return ok;
+}
+
+// Comparison function for qsort.
+static int compare_entry_hashes(const void *ptr1, const void *ptr2) {
+  const sound_cache_entry_t *entry1 = ptr1;
+  const sound_cache_entry_t *entry2 = ptr2;
+  return compare_sound_cache_entries(&entry1->hash, entry2);
+}
+
+bool az_save_sound_cache_to_file(
+    int num_sounds, const az_sound_spec_t *specs,
+    const az_sound_data_t *datas, FILE *file) {
+  assert(num_sounds >= 0);
+  assert(file != NULL);
+  // Lay out the sample data in the order given, and then sort the table.  The
+  // table is a multiple of 8 bytes long, so the samples are suitably aligned.
+  sound_cache_entry_t *entries = AZ_ALLOC(num_sounds, sound_cache_entry_t);
+  uint64_t offset = sizeof(sound_cache_header_t) +
+    (uint64_t)num_sounds * sizeof(sound_cache_entry_t);
+  for (int i = 0; i < num_sounds; ++i) {
+    entries[i].hash = az_hash_sound_spec(&specs[i]);
+    entries[i].offset = offset;
+    entries[i].num_samples = datas[i].num_samples;
+    offset += datas[i].num_samples * sizeof(int16_t);
+  }
+  if (num_sounds > 0) {
+    qsort(entries, num_sounds, sizeof(sound_cache_entry_t),
+          &compare_entry_hashes);
+  }
+  sound_cache_header_t header = {
+    .version = SOUND_CACHE_VERSION, .num_entries = (uint32_t)num_sounds
+  };
+  memcpy(header.magic, SOUND_CACHE_MAGIC, sizeof(header.magic));
+  bool ok = (fwrite(&header, sizeof(header), 1, file) == 1 &&
+             fwrite(entries, sizeof(sound_cache_entry_t), num_sounds, file) ==
+             (size_t)num_sounds);
+  free(entries);
+  for (int i = 0; ok && i < num_sounds; ++i) {
+    if (datas[i].num_samples == 0) continue;
+    ok = (fwrite(datas[i].samples, sizeof(int16_t), datas[i].num_samples,
+                 file) == datas[i].num_samples);
+  }
+  return ok && fflush(file) == 0;
+}
+
+/*===========================================================================*/
@@ -21,12 +21,14 @@
 #ifndef AZIMUTH_UTIL_SOUND_H_
 #define AZIMUTH_UTIL_SOUND_H_
 
+#include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
+#include <stdio.h>
 
 /*===========================================================================*/
 
-// Audio samples per second:
+// Audio samples per second of sound data (and, by default, of music):
 #define AZ_AUDIO_RATE 22050
 
 typedef enum {
@@ -54,13 +56,103 @@ typedef struct {
 
 typedef struct {
   size_t num_samples;
-  int16_t *samples;
+  const int16_t *samples;
+  // If true, samples points into memory owned by someone else (such as a
+  // mapped sound cache file; see below), and az_destroy_sound_data won't free
+  // it.
+  bool borrowed;
+  // Hints for the audio system's voice pool, which are zero unless set by the
+  // caller after az_create_sound_data.  When the pool is full, a new sound may
+  // cut off a playing sound of equal or lower priority.  If max_instances is
+  // nonzero, starting a new (non-persisted) instance of this sound when that
+  // many are already playing will cut off the oldest of them.
+  int priority;
+  int max_instances;
 } az_sound_data_t;
 
+// Synthesize the given sound effect into data, overwriting its contents.  This
+// is safe to call from several threads at once, as long as each call is
+// writing to a different az_sound_data_t.  Noise is seeded the same way for
+// every sound, so the result depends only on the spec.
 void az_create_sound_data(const az_sound_spec_t *spec, az_sound_data_t *data);
 
 void az_destroy_sound_data(az_sound_data_t *data);
 
 /*===========================================================================*/
 
+// Sound data is always stored at AZ_AUDIO_RATE, but may be played back at a
+// higher output rate.  Playback positions are then 32.32 fixed-point indices
+// into the data's samples, which advance by az_resample_step(output_rate) per
+// output sample, and the samples in between are interpolated with a short
+// polyphase windowed-sinc filter (which, unlike linear interpolation, also
+// removes the images of the sound above AZ_AUDIO_RATE / 2).
+#define AZ_RESAMPLE_FRAC_BITS 32
+
+// Return the position step per output sample for the given output rate.
+uint64_t az_resample_step(int output_rate);
+
+// Return the interpolated sample of the data at the given position (treating
+// everything outside the data as silence).
+int16_t az_resample_sound_at(const az_sound_data_t *data, uint64_t position);
+
+// Write up to num_output interpolated samples of the data into output,
+// starting at *position and advancing it by step for each sample.  Stops
+// early if the position reaches the end of the data; returns the number of
+// samples written.
+int az_resample_sound(const az_sound_data_t *data, uint64_t *position,
+                      uint64_t step, int16_t *output, int num_output);
+
+/*===========================================================================*/
+
+// A sound stream synthesizes a sound effect a little at a time as it is
+// played, rather than all at once up front, so that it can start playing
+// immediately no matter how long the sound is.  The samples it produces are
+// the same as az_create_sound_data would (resampled just as
+// az_resample_sound would), except that the stream doesn't trim the zeros off
+// the end of the sound, so it may run on a little longer.
+typedef struct az_sound_stream az_sound_stream_t;
+
+az_sound_stream_t *az_new_sound_stream(const az_sound_spec_t *spec);
+
+void az_delete_sound_stream(az_sound_stream_t *stream);
+
+// Write the next num_output samples of the sound into output, at the output
+// rate given by step (see az_resample_step).  If the sound ends first, this
+// writes fewer samples, and returns the number of samples written.  Each
+// call costs time in proportion to the number of samples written, so this is
+// cheap enough to call from an audio callback.
+int az_stream_sound(az_sound_stream_t *stream, uint64_t step,
+                    int16_t *output, int num_output);
+
+/*===========================================================================*/
+
+// A sound cache holds previously synthesized sample data for a number of
+// sound specs, keyed by az_hash_sound_spec, so that it needn't be regenerated
+// every time the program starts.  The cache is laid out so that it can be
+// memory-mapped and used in place.
+
+// Return a hash of the spec (and of the synth version), such that specs with
+// the same hash can be expected to produce the same sound data.
+uint64_t az_hash_sound_spec(const az_sound_spec_t *spec);
+
+// Look up the given spec in the contents of a sound cache.  If a valid entry
+// is found, set data to borrow the cached samples (without copying them) and
+// return true; otherwise, leave data unchanged and return false.  The cache
+// contents must outlive data.
+bool az_find_cached_sound_data(const void *cache, size_t cache_size,
+                               const az_sound_spec_t *spec,
+                               az_sound_data_t *data);
+
+// Attempts to save a sound cache holding the given sounds to the file located
+// at the given path (or to the given file).  Return true on success, or false
+// on failure.
+bool az_save_sound_cache_to_path(
+    int num_sounds, const az_sound_spec_t *specs,
+    const az_sound_data_t *datas, const char *filepath);
+bool az_save_sound_cache_to_file(
+    int num_sounds, const az_sound_spec_t *specs,
+    const az_sound_data_t *datas, FILE *file);
+
+/*===========================================================================*/
+
 #endif // AZIMUTH_UTIL_SOUND_H_
@@ -22,14 +22,14 @@
 #include <assert.h>
 #include <math.h>
 
-#include <SDL_opengl.h>
-
 #include "azimuth/constants.h"
+#include "azimuth/gui/opengl.h"
 #include "azimuth/state/background.h"
 #include "azimuth/util/clock.h"
 #include "azimuth/util/misc.h"
 #include "azimuth/util/random.h"
 #include "azimuth/util/vector.h"
+#include "azimuth/view/shape.h"
 #include "azimuth/view/util.h"
 
 /*===========================================================================*/
@@ -318,9 +318,7 @@ static void draw_half_stone_brick(float width, float height, float rr) {
   } glEnd();
   glBegin(GL_TRIANGLE_FAN); {
     az_gl_color(color1); glVertex2f(rr, -rr); az_gl_color(color2);
-    for (int i = 90; i <= 180; i += 30) {
-      glVertex2d(rr + rr * cos(AZ_DEG2RAD(i)), -rr + rr * sin(AZ_DEG2RAD(i)));
-    }
+    az_shape_arc(rr, -rr, rr, rr, 90, 180, 30);
   } glEnd();
   glBegin(GL_TRIANGLE_FAN); {
     az_gl_color(color1); glVertex2f(rr, -height + rr); az_gl_color(color2);
@@ -363,10 +361,7 @@ static void draw_bubble(double center_x, double center_y, double radius,
       az_gl_color(inner);
       glVertex2f(-0.1 * radius, 0.1 * radius);
       az_gl_color(mid);
-      for (int i = 0; i <= 360; i += 30) {
-        glVertex2d(mid_radius * cos(AZ_DEG2RAD(i)),
-                   mid_radius * sin(AZ_DEG2RAD(i)));
-      }
+      az_shape_circle(mid_radius);
     } glEnd();
     glBegin(GL_TRIANGLE_STRIP); {
       for (int i = 0; i <= 360; i += 30) {
@@ -528,9 +523,7 @@ static void draw_blinkenlight(GLfloat center_x, GLfloat center_y, bool lit) {
       glVertex2f(0, 0);
       if (lit) glColor4f(0.30, 0.30, 0.15, 0);
       else glColor4f(0.15, 0.15, 0.15, 0);
-      for (int i = 0; i <= 360; i += 45) {
-        glVertex2d(4 * cos(AZ_DEG2RAD(i)), 4 * sin(AZ_DEG2RAD(i)));
-      }
+      az_shape_arc(0, 0, 4, 4, 0, 360, 45);
     } glEnd();
   } glPopMatrix();
 }
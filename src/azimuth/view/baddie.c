@@ -23,8 +23,7 @@
 #include <math.h>
 #include <stdbool.h>
 
-#include <SDL_opengl.h>
-
+#include "azimuth/gui/opengl.h"
 #include "azimuth/state/baddie.h"
 #include "azimuth/state/space.h"
 #include "azimuth/util/clock.h"
@@ -48,6 +47,7 @@
 #include "azimuth/view/baddie_vehicle.h"
 #include "azimuth/view/baddie_wyrm.h"
 #include "azimuth/view/baddie_zipper.h"
+#include "azimuth/view/shape.h"
 #include "azimuth/view/util.h"
 
 /*===========================================================================*/
@@ -65,9 +65,7 @@ static void draw_component_outline(const az_component_data_t *component) {
     glBegin(GL_LINE_STRIP); {
       const double radius = component->bounding_radius;
       glVertex2f(0, 0);
-      for (int i = 0; i <= 360; i += 10) {
-        glVertex2d(radius * cos(AZ_DEG2RAD(i)), radius * sin(AZ_DEG2RAD(i)));
-      }
+      az_shape_circle(radius);
     } glEnd();
   }
 }
@@ -88,7 +86,12 @@ static void draw_baddie_outline(const az_baddie_t *baddie, float frozen,
 }
 #endif
 
-static void draw_box(const az_baddie_t *baddie, bool armored, float flare) {
+// The first of two display lists, holding the bodies of an unarmored and an
+// armored box, with their colors modulated by flare.  Boxes don't freeze, so
+// their second variant is the same as the first.
+static GLuint box_display_lists_start;
+
+static void draw_box_body(bool armored, float flare) {
   glBegin(GL_QUADS); {
     if (armored) glColor3f(0.45, 0.45 - 0.3 * flare, 0.65 - 0.3 * flare);
     else glColor3f(0.65, 0.65 - 0.3 * flare, 0.65 - 0.3 * flare); // light gray
@@ -121,6 +124,11 @@ static void draw_box(const az_baddie_t *baddie, bool armored, float flare) {
     glVertex2f(-10, -7); glVertex2f(-16,  -8); glVertex2f(-11, -13);
     glVertex2f( 10, -7); glVertex2f( 11, -13); glVertex2f( 16,  -8);
   } glEnd();
+}
+
+static void draw_box(const az_baddie_t *baddie, bool armored, float flare) {
+  az_gfx_call_list_modulated(box_display_lists_start + (armored ? 1 : 0),
+                             flare, 0);
   const double hurt =
     (baddie->data->max_health - baddie->health) / baddie->data->max_health;
   for (int i = 0; i < 2; ++i) {
@@ -151,13 +159,8 @@ static void draw_eruption_bubble(double max_radius, int frames,
     glVertex2f(0, 0);
     glColor4f(0.5, 0.235, 0.15, 0.85 - 0.3 * mod);
     const double radius = max_radius * mod;
-    for (int i = -90; i < 90; i += 10) {
-      glVertex2d(radius * cos(AZ_DEG2RAD(i)), radius * sin(AZ_DEG2RAD(i)));
-    }
-    for (int i = 90; i <= 270; i += 10) {
-      glVertex2d(0.25 * radius * cos(AZ_DEG2RAD(i)),
-                 radius * sin(AZ_DEG2RAD(i)));
-    }
+    az_shape_arc(0, 0, radius, radius, -90, 80, 10);
+    az_shape_arc(0, 0, 0.25 * radius, radius, 90, 270, 10);
   } glEnd();
 }
 
@@ -313,9 +316,7 @@ static void draw_baddie_internal(const az_baddie_t *baddie, az_clock_t clock) {
       glBegin(GL_POLYGON); {
         glColor3f(0.65 + 0.3 * flare - 0.3 * frozen, 0.65 - 0.3 * flare,
                   0.5 - 0.3 * flare + 0.5 * frozen);
-        for (int i = 0; i <= 360; i += 60) {
-          glVertex2d(8 * cos(AZ_DEG2RAD(i)), 8 * sin(AZ_DEG2RAD(i)));
-        }
+        az_shape_arc(0, 0, 8, 8, 0, 360, 60);
       } glEnd();
       glBegin(GL_QUAD_STRIP); {
         for (int i = 0; i <= 360; i += 60) {
@@ -331,9 +332,7 @@ static void draw_baddie_internal(const az_baddie_t *baddie, az_clock_t clock) {
       else glColor3f(0, 0, 0.5f * frozen);
       glBegin(GL_TRIANGLE_FAN); {
         glVertex2d(0, 0);
-        for (int i = 0; i <= 360; i += 30) {
-          glVertex2d(1.5 * cos(AZ_DEG2RAD(i)), 1.5 * sin(AZ_DEG2RAD(i)));
-        }
+        az_shape_circle(1.5);
       } glEnd();
       for (int j = 60; j < 420; j += 120) {
         glBegin(GL_QUAD_STRIP); {
@@ -432,10 +431,7 @@ static void draw_baddie_internal(const az_baddie_t *baddie, az_clock_t clock) {
           glColor3f(0.6f + 0.4f * blink, 0.6f, 0.6f);
           glVertex2d(-0.15 * radius, 0.2 * radius);
           glColor3f(0.2f + 0.3f * blink, 0.2f, 0.2f);
-          for (int i = 0; i <= 360; i += 15) {
-            glVertex2d(radius * cos(AZ_DEG2RAD(i)),
-                       radius * sin(AZ_DEG2RAD(i)));
-          }
+          az_shape_circle(radius);
         } glEnd();
         const double hurt = (baddie->data->max_health - baddie->health) /
           baddie->data->max_health;
@@ -515,9 +511,7 @@ static void draw_baddie_internal(const az_baddie_t *baddie, az_clock_t clock) {
           glBegin(GL_TRIANGLE_FAN); {
             glColor3f(0.5, 0.5, 0.5); glVertex2d(0, -1);
             glColor3f(0.2, 0.3, 0.3);
-            for (int i = -105; i <= 105; i += 30) {
-              glVertex2d(5 * cos(AZ_DEG2RAD(i)), 7 * sin(AZ_DEG2RAD(i)) - 1);
-            }
+            az_shape_arc(0, -1, 5, 7, -105, 105, 30);
           } glEnd();
           // Knee knob:
           glTranslatef(35, 0, 0);
@@ -525,9 +519,7 @@ static void draw_baddie_internal(const az_baddie_t *baddie, az_clock_t clock) {
             glColor3f(0.5f * flare, 0.6, 0.4 + 0.6f * frozen);
             glVertex2d(0, 0);
             glColor3f(0, 0.25, 0.1);
-            for (int i = -135; i <= 135; i += 30) {
-              glVertex2d(6 * cos(AZ_DEG2RAD(i)), 5 * sin(AZ_DEG2RAD(i)));
-            }
+            az_shape_arc(0, 0, 6, 5, -135, 135, 30);
           } glEnd();
           // Knee spike:
           glBegin(GL_TRIANGLE_FAN); {
@@ -554,9 +546,7 @@ static void draw_baddie_internal(const az_baddie_t *baddie, az_clock_t clock) {
           glColor3f(flare, 0.9, 0.5f + 0.5f * frozen); glVertex2d(-3, 0);
           glColor3f(0.5f * flare, 0.25, 0.1f + 0.9f * frozen);
           glVertex2d(-10, 0);
-          for (int i = -135; i <= 135; i += 30) {
-            glVertex2d(12 * cos(AZ_DEG2RAD(i)), 9 * sin(AZ_DEG2RAD(i)));
-          }
+          az_shape_arc(0, 0, 12, 9, -135, 135, 30);
           glVertex2d(-10, 0);
         } glEnd();
         // Eye:
@@ -614,27 +604,17 @@ static void draw_baddie_internal(const az_baddie_t *baddie, az_clock_t clock) {
     case AZ_BAD_PROXY_MINE:
       draw_mine_arms(15, flare, frozen);
       // Body:
-      glBegin(GL_TRIANGLE_FAN); {
-        glColor3f(0.65 + 0.35 * flare - 0.3 * frozen, 0.65 - 0.3 * flare,
-                  0.65 - 0.3 * flare + 0.35 * frozen);
-        glVertex2f(0, 0);
-        glColor3f(0.35 + 0.3 * flare - 0.15 * frozen, 0.35 - 0.15 * flare,
-                  0.35 - 0.15 * flare + 0.3 * frozen);
-        for (int i = 0; i <= 360; i += 15) {
-          glVertex2d(7 * cos(AZ_DEG2RAD(i)), 7 * sin(AZ_DEG2RAD(i)));
-        }
-      } glEnd();
+      az_shape_draw_glow(7, az_color3f(0.65 + 0.35 * flare - 0.3 * frozen,
+                                       0.65 - 0.3 * flare,
+                                       0.65 - 0.3 * flare + 0.35 * frozen),
+                         az_color3f(0.35 + 0.3 * flare - 0.15 * frozen,
+                                    0.35 - 0.15 * flare,
+                                    0.35 - 0.15 * flare + 0.3 * frozen));
       // Light bulb:
-      glBegin(GL_TRIANGLE_FAN); {
-        if (baddie->state == 1 && az_clock_mod(2, 3, clock)) {
-          glColor3f(1, 0.6, 0.5);
-        } else glColor3f(0.2, 0.2, 0.2);
-        glVertex2f(0, 0);
-        glColor3f(0, 0, 0);
-        for (int i = 0; i <= 360; i += 20) {
-          glVertex2d(3 * cos(AZ_DEG2RAD(i)), 3 * sin(AZ_DEG2RAD(i)));
-        }
-      } glEnd();
+      az_shape_draw_glow(3, (baddie->state == 1 && az_clock_mod(2, 3, clock) ?
+                             az_color3f(1, 0.6, 0.5) :
+                             az_color3f(0.2, 0.2, 0.2)),
+                         az_color3f(0, 0, 0));
       break;
     case AZ_BAD_NIGHTSHADE:
       az_draw_bad_nightshade(baddie, frozen, clock);
@@ -771,6 +751,23 @@ static void draw_baddie_internal(const az_baddie_t *baddie, az_clock_t clock) {
   }
 }
 
+void az_init_baddie_drawing(void) {
+  box_display_lists_start = glGenLists(2);
+  if (box_display_lists_start == 0u) {
+    AZ_FATAL("glGenLists failed.\n");
+  }
+  for (int armored = 0; armored < 2; ++armored) {
+    for (int variant = 0; variant < AZ_GFX_NUM_LIST_VARIANTS; ++variant) {
+      az_gfx_new_list_variant(box_display_lists_start + armored, variant); {
+        draw_box_body(armored, (variant == 1));
+      } glEndList();
+    }
+  }
+  az_init_crawler_drawing();
+  az_init_turret_drawing();
+  az_init_zipper_drawing();
+}
+
 void az_draw_baddie(const az_baddie_t *baddie, az_clock_t clock) {
   assert(baddie->kind != AZ_BAD_NOTHING);
   glPushMatrix(); {
@@ -27,6 +27,11 @@
 
 /*===========================================================================*/
 
+// Call this at program startup to initialize drawing of baddies.  This must be
+// called _after_ az_init_gui, and must be called _before_ any calls to
+// az_draw_baddie.
+void az_init_baddie_drawing(void);
+
 // Draw a single baddie.  The GL matrix should be at the camera position.
 void az_draw_baddie(const az_baddie_t *baddie, az_clock_t clock);
 
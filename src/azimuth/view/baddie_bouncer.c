@@ -23,11 +23,11 @@
 #include <math.h>
 #include <stdbool.h>
 
-#include <SDL_opengl.h>
-
+#include "azimuth/gui/opengl.h"
 #include "azimuth/state/baddie.h"
 #include "azimuth/util/clock.h"
 #include "azimuth/util/color.h"
+#include "azimuth/view/shape.h"
 #include "azimuth/view/util.h"
 
 /*===========================================================================*/
@@ -36,17 +36,12 @@ void az_draw_bad_bouncer(
     const az_baddie_t *baddie, float frozen, az_clock_t clock) {
   assert(baddie->kind == AZ_BAD_BOUNCER);
   const float flare = baddie->armor_flare;
-  glBegin(GL_TRIANGLE_FAN); {
-    const int zig = az_clock_zigzag(15, 1, clock);
-    glColor3f(1 - 0.75 * frozen, 0.25 + 0.01 * zig + 0.5 * flare,
-              0.25 + 0.75 * frozen); // red
-    glVertex2f(0, 0);
-    glColor3f(0.25 + 0.02 * zig - 0.25 * frozen, 0.5 * flare,
-              0.25 * frozen); // dark red
-    for (int i = 0; i <= 360; i += 15) {
-      glVertex2d(15 * cos(AZ_DEG2RAD(i)), 15 * sin(AZ_DEG2RAD(i)));
-    }
-  } glEnd();
+  const int zig = az_clock_zigzag(15, 1, clock);
+  az_shape_draw_glow(15, az_color3f(1 - 0.75 * frozen,
+                                    0.25 + 0.01 * zig + 0.5 * flare,
+                                    0.25 + 0.75 * frozen), // red
+                     az_color3f(0.25 + 0.02 * zig - 0.25 * frozen,
+                                0.5 * flare, 0.25 * frozen)); // dark red
   glBegin(GL_TRIANGLE_FAN); {
     glColor3f(0.5, 0.25, 1);
     glVertex2f(0, 7);
@@ -60,16 +55,12 @@ void az_draw_bad_bouncer_90(
     const az_baddie_t *baddie, float frozen, az_clock_t clock) {
   assert(baddie->kind == AZ_BAD_BOUNCER_90);
   const float flare = baddie->armor_flare;
-  glBegin(GL_TRIANGLE_FAN); {
-    const int zig = az_clock_zigzag(30, 1, clock);
-    glColor3f(0.25f + 0.75f * flare, 1 - frozen, 1 - flare);
-    glVertex2f(0, 0);
-    glColor3f(0.5f * flare + 0.01f * zig, 0.25f + 0.25f * flare,
-              0.25f + 0.25f * frozen);
-    for (int i = 0; i <= 360; i += 15) {
-      glVertex2d(15 * cos(AZ_DEG2RAD(i)), 15 * sin(AZ_DEG2RAD(i)));
-    }
-  } glEnd();
+  const int zig = az_clock_zigzag(30, 1, clock);
+  az_shape_draw_glow(15, az_color3f(0.25f + 0.75f * flare, 1 - frozen,
+                                    1 - flare),
+                     az_color3f(0.5f * flare + 0.01f * zig,
+                                0.25f + 0.25f * flare,
+                                0.25f + 0.25f * frozen));
   glBegin(GL_TRIANGLE_FAN); {
     glColor3f(0.5, 0.25, 1); glVertex2f(0, 7);
     glColor4f(0.5, 0.25, 1, 0);
@@ -82,17 +73,12 @@ void az_draw_bad_fast_bouncer(
     const az_baddie_t *baddie, float frozen, az_clock_t clock) {
   assert(baddie->kind == AZ_BAD_FAST_BOUNCER);
   const float flare = baddie->armor_flare;
-  glBegin(GL_TRIANGLE_FAN); {
-    const int zig = az_clock_zigzag(15, 1, clock);
-    glColor3f(1.0f - 0.75f * frozen, 0.5f + 0.01f * zig + 0.3f * flare,
-              0.25f + 0.75f * frozen);
-    glVertex2f(0, 0);
-    glColor3f(0.25f + 0.02f * zig - 0.25f * frozen, 0.1f + 0.5f * flare,
-              0.25f * frozen);
-    for (int i = 0; i <= 360; i += 15) {
-      glVertex2d(15 * cos(AZ_DEG2RAD(i)), 15 * sin(AZ_DEG2RAD(i)));
-    }
-  } glEnd();
+  const int zig = az_clock_zigzag(15, 1, clock);
+  az_shape_draw_glow(15, az_color3f(1.0f - 0.75f * frozen,
+                                    0.5f + 0.01f * zig + 0.3f * flare,
+                                    0.25f + 0.75f * frozen),
+                     az_color3f(0.25f + 0.02f * zig - 0.25f * frozen,
+                                0.1f + 0.5f * flare, 0.25f * frozen));
   glBegin(GL_TRIANGLE_FAN); {
     glColor3f(0.25, 0.5, 1);
     glVertex2f(0, 7);
@@ -113,10 +99,7 @@ static void draw_electron(double radius, az_vector_t position, double angle) {
       glColor3f(cmult * 0.5, cmult * 0.7, cmult * 0.5); // greenish-gray
       glVertex2d(-1, 1);
       glColor3f(cmult * 0.20, cmult * 0.15, cmult * 0.25); // dark purple-gray
-      for (int i = 0; i <= 360; i += 15) {
-        glVertex2d(radius * rmult * cos(AZ_DEG2RAD(i)),
-                   radius * rmult * sin(AZ_DEG2RAD(i)));
-      }
+      az_shape_circle(radius * rmult);
     } glEnd();
   } glPopMatrix();
 }
@@ -134,9 +117,7 @@ static void draw_atom(const az_baddie_t *baddie, az_color_t inner,
     glVertex2f(-2, 2);
     az_gl_color(outer);
     const double radius = baddie->data->main_body.bounding_radius;
-    for (int i = 0; i <= 360; i += 15) {
-      glVertex2d(radius * cos(AZ_DEG2RAD(i)), radius * sin(AZ_DEG2RAD(i)));
-    }
+    az_shape_circle(radius);
   } glEnd();
   for (int i = 0; i < baddie->data->num_components; ++i) {
     const az_component_t *component = &baddie->components[i];
@@ -23,11 +23,11 @@
 #include <math.h>
 #include <stdbool.h>
 
-#include <SDL_opengl.h>
-
+#include "azimuth/gui/opengl.h"
 #include "azimuth/state/baddie.h"
 #include "azimuth/util/clock.h"
 #include "azimuth/util/color.h"
+#include "azimuth/view/shape.h"
 #include "azimuth/view/util.h"
 
 /*===========================================================================*/
@@ -42,9 +42,7 @@ void az_draw_bad_clam(
     glColor3f(0.25 - 0.25 * frozen, 0.5 * flare,
               0.25 * frozen + 0.5 * flare); // dark red
     const double radius = baddie->data->main_body.bounding_radius;
-    for (int i = 0; i <= 360; i += 15) {
-      glVertex2d(radius * cos(AZ_DEG2RAD(i)), radius * sin(AZ_DEG2RAD(i)));
-    }
+    az_shape_circle(radius);
   } glEnd();
   for (int i = 0; i < baddie->data->num_components; ++i) {
     glPushMatrix(); {
@@ -105,9 +103,7 @@ void az_draw_bad_grabber_plant(
     glTranslatef(length, 0, 0);
     glBegin(GL_TRIANGLE_FAN); {
       az_gl_color(inner); glVertex2f(0, 0); az_gl_color(outer);
-      for (int i = -135; i <= 135; i += 15) {
-        glVertex2d(6 * cos(AZ_DEG2RAD(i)), 4 * sin(AZ_DEG2RAD(i)));
-      }
+      az_shape_arc(0, 0, 6, 4, -135, 135, 15);
     } glEnd();
   } glPopMatrix();
   // Core:
@@ -22,11 +22,11 @@
 #include <assert.h>
 #include <math.h>
 
-#include <SDL_opengl.h>
-
+#include "azimuth/gui/opengl.h"
 #include "azimuth/state/baddie.h"
 #include "azimuth/util/clock.h"
 #include "azimuth/util/color.h"
+#include "azimuth/view/shape.h"
 #include "azimuth/view/util.h"
 
 /*===========================================================================*/
@@ -57,12 +57,7 @@ static void draw_gear(const az_baddie_t *baddie, az_vector_t position,
       }
     } glPopMatrix();
     // Hub:
-    glBegin(GL_TRIANGLE_FAN); {
-      az_gl_color(inner); glVertex2f(0, 0); az_gl_color(outer);
-      for (int i = 0; i <= 360; i += 30) {
-        glVertex2d(9 * cos(AZ_DEG2RAD(i)), 9 * sin(AZ_DEG2RAD(i)));
-      }
-    } glEnd();
+    az_shape_draw_glow(9, inner, outer);
     // Teeth:
     glPushMatrix(); {
       const int num_teeth = (int)round(radius * AZ_TWO_PI / 20);
@@ -210,9 +205,7 @@ void az_draw_bad_zenith_core(const az_baddie_t *baddie, az_clock_t clock) {
   // Central hub:
   glBegin(GL_TRIANGLE_FAN); {
     az_gl_color(inner); glVertex2f(0, 0); az_gl_color(outer);
-    for (int i = 0; i <= 360; i += 45) {
-      glVertex2d(16 * cos(AZ_DEG2RAD(i)), 16 * sin(AZ_DEG2RAD(i)));
-    }
+    az_shape_arc(0, 0, 16, 16, 0, 360, 45);
   } glEnd();
 
   // Armor plating:
@@ -265,9 +258,7 @@ static void draw_band(double radius, az_color_t color, bool lit) {
   } else {
     glBegin(GL_LINE_LOOP); {
       glColor4f(0, 0, 0, 0.15);
-      for (int i = 0; i < 360; i += 45) {
-        glVertex2d(radius * cos(AZ_DEG2RAD(i)), radius * sin(AZ_DEG2RAD(i)));
-      }
+      az_shape_arc(0, 0, radius, radius, 0, 315, 45);
     } glEnd();
   }
 }
@@ -22,11 +22,11 @@
 #include <assert.h>
 #include <math.h>
 
-#include <SDL_opengl.h>
-
+#include "azimuth/gui/opengl.h"
 #include "azimuth/state/baddie.h"
 #include "azimuth/util/clock.h"
 #include "azimuth/util/color.h"
+#include "azimuth/view/shape.h"
 #include "azimuth/view/util.h"
 
 /*===========================================================================*/
@@ -67,8 +67,103 @@ static void draw_spine(float flare, float frozen) {
   } glEnd();
 }
 
+// Parts of crawlers that are rigid (although they may be translated as a
+// whole as the crawler walks).
+typedef enum {
+  SPINED_CRAWLER_BODY,
+  SPINED_CRAWLER_CURLED_BODY,
+  CRAB_CRAWLER_SHELL,
+  JUNGLE_CRAWLER_SPINES,
+  NUM_CRAWLER_PARTS
+} crawler_part_t;
+
+// The first of NUM_CRAWLER_PARTS display lists, holding each crawler part, with
+// its colors modulated by flare and frozen.
+static GLuint crawler_display_lists_start;
+
+static void draw_crawler_part(crawler_part_t part, float flare,
+                              float frozen) {
+  switch (part) {
+    case SPINED_CRAWLER_BODY:
+    case SPINED_CRAWLER_CURLED_BODY:
+      for (int i = -82; i <= 82; i += 41) {
+        glPushMatrix(); {
+          glTranslatef(-12, 0, 0);
+          glScalef(1, 0.85, 1);
+          glRotatef(i, 0, 0, 1);
+          glTranslatef((part == SPINED_CRAWLER_CURLED_BODY ? 21 : 18), 0, 0);
+          glScalef(0.7, 1, 1);
+          draw_spine(flare, frozen);
+        } glPopMatrix();
+      }
+      glBegin(GL_TRIANGLE_FAN); {
+        glColor3f(0.2f + 0.8f * flare, 0.6f - 0.3f * flare,
+                  0.4f + 0.6f * frozen);
+        glVertex2f(-13, 0);
+        glColor3f(0.06 + 0.5f * flare, 0.24f - 0.1f * flare,
+                  0.12f + 0.5f * frozen);
+        glVertex2f(-15, 0);
+        az_shape_arc(-7, 0, 13, 16, -120, 120, 30);
+        glVertex2f(-15, 0);
+      } glEnd();
+      break;
+    case CRAB_CRAWLER_SHELL: {
+      const az_color_t inner =
+        az_color3f(0.6f + 0.4f * flare - 0.4f * frozen, 0.4f - 0.2f * flare,
+                   0.2f + 0.8f * frozen);
+      const az_color_t outer =
+        az_color3f(0.24f + 0.4f * flare - 0.15f * frozen,
+                   0.12f - 0.05f * flare, 0.06f + 0.5f * frozen);
+      // Antennae:
+      glBegin(GL_LINE_STRIP); {
+        az_gl_color(outer);
+        glVertex2f(7, -9); glVertex2f(-3, 0); glVertex2f(7, 9);
+      } glEnd();
+      // Shell:
+      glBegin(GL_TRIANGLE_FAN); {
+        az_gl_color(inner); glVertex2f(-13, 0); az_gl_color(outer);
+        glVertex2f(-15, 0);
+        az_shape_arc(-7, 0, 11, 16, -120, 120, 30);
+        glVertex2f(-15, 0);
+      } glEnd();
+    } break;
+    case JUNGLE_CRAWLER_SPINES:
+      for (int i = -100; i <= 100; i += 20) {
+        glPushMatrix(); {
+          glTranslatef(-6, 0, 0);
+          glRotatef(i, 0, 0, 1);
+          glTranslatef(17, 0, 0);
+          draw_spine(flare, frozen);
+        } glPopMatrix();
+      }
+      break;
+    case NUM_CRAWLER_PARTS: AZ_ASSERT_UNREACHABLE();
+  }
+}
+
+static void call_crawler_part(crawler_part_t part, float flare,
+                              float frozen) {
+  az_gfx_call_list_modulated(crawler_display_lists_start + part, flare,
+                             frozen);
+}
+
 /*===========================================================================*/
 
+void az_init_crawler_drawing(void) {
+  crawler_display_lists_start = glGenLists(NUM_CRAWLER_PARTS);
+  if (crawler_display_lists_start == 0u) {
+    AZ_FATAL("glGenLists failed.\n");
+  }
+  for (int part = 0; part < NUM_CRAWLER_PARTS; ++part) {
+    for (int variant = 0; variant < AZ_GFX_NUM_LIST_VARIANTS; ++variant) {
+      az_gfx_new_list_variant(crawler_display_lists_start + part, variant); {
+        draw_crawler_part((crawler_part_t)part, (variant == 1),
+                          (variant == 2));
+      } glEndList();
+    }
+  }
+}
+
 void az_draw_bad_cave_crawler(
     const az_baddie_t *baddie, float frozen, az_clock_t clock) {
   assert(baddie->kind == AZ_BAD_CAVE_CRAWLER);
@@ -105,28 +200,8 @@ void az_draw_bad_spined_crawler(
   glPushMatrix(); {
     glTranslatef((baddie->state == 3 ? -2.5f :
                   -0.5f * az_clock_zigzag(5, 5, clock)), 0, 0);
-    for (int i = -82; i <= 82; i += 41) {
-      glPushMatrix(); {
-        glTranslatef(-12, 0, 0);
-        glScalef(1, 0.85, 1);
-        glRotatef(i, 0, 0, 1);
-        glTranslatef((baddie->state == 3 ? 21 : 18), 0, 0);
-        glScalef(0.7, 1, 1);
-        draw_spine(flare, frozen);
-      } glPopMatrix();
-    }
-    glBegin(GL_TRIANGLE_FAN); {
-      glColor3f(0.2f + 0.8f * flare, 0.6f - 0.3f * flare,
-                0.4f + 0.6f * frozen);
-      glVertex2f(-13, 0);
-      glColor3f(0.06 + 0.5f * flare, 0.24f - 0.1f * flare,
-                0.12f + 0.5f * frozen);
-      glVertex2f(-15, 0);
-      for (int i = -120; i <= 120; i += 30) {
-        glVertex2d(13 * cos(AZ_DEG2RAD(i)) - 7, 16 * sin(AZ_DEG2RAD(i)));
-      }
-      glVertex2f(-15, 0);
-    } glEnd();
+    call_crawler_part((baddie->state == 3 ? SPINED_CRAWLER_CURLED_BODY :
+                       SPINED_CRAWLER_BODY), flare, frozen);
   } glPopMatrix();
 }
 
@@ -139,26 +214,7 @@ void az_draw_bad_crab_crawler(
   glPushMatrix(); {
     glTranslatef((baddie->state == 3 ? -2.5f :
                   -0.25f * az_clock_zigzag(5, 5, clock)), 0, 0);
-    const az_color_t inner =
-      az_color3f(0.6f + 0.4f * flare - 0.4f * frozen, 0.4f - 0.2f * flare,
-                 0.2f + 0.8f * frozen);
-    const az_color_t outer =
-      az_color3f(0.24f + 0.4f * flare - 0.15f * frozen, 0.12f - 0.05f * flare,
-                 0.06f + 0.5f * frozen);
-    // Antennae:
-    glBegin(GL_LINE_STRIP); {
-      az_gl_color(outer);
-      glVertex2f(7, -9); glVertex2f(-3, 0); glVertex2f(7, 9);
-    } glEnd();
-    // Shell:
-    glBegin(GL_TRIANGLE_FAN); {
-      az_gl_color(inner); glVertex2f(-13, 0); az_gl_color(outer);
-      glVertex2f(-15, 0);
-      for (int i = -120; i <= 120; i += 30) {
-        glVertex2d(11 * cos(AZ_DEG2RAD(i)) - 7, 16 * sin(AZ_DEG2RAD(i)));
-      }
-      glVertex2f(-15, 0);
-    } glEnd();
+    call_crawler_part(CRAB_CRAWLER_SHELL, flare, frozen);
   } glPopMatrix();
   // Claws:
   for (int i = 0; i < 2; ++i) {
@@ -193,9 +249,7 @@ void az_draw_bad_ice_crawler(
       glColor3f(0.5f + 0.5f * flare, 0.2, 0.4);
       glVertex2f(-15, 0);
       glColor3f(0.4f + 0.6f * flare, 0, 0.2);
-      for (int i = -135; i <= 135; i += 5) {
-        glVertex2d(13 * cos(AZ_DEG2RAD(i)) - 4, 14 * sin(AZ_DEG2RAD(i)));
-      }
+      az_shape_arc(-4, 0, 13, 14, -135, 135, 5);
     } glEnd();
     // Ice shell:
     glBegin(GL_TRIANGLE_FAN); {
@@ -224,9 +278,7 @@ void az_draw_bad_fire_crawler(
       glColor3f(0.5f + 0.5f * flare, 0.2, 0.4);
       glVertex2f(-15, 0);
       glColor3f(0.4f + 0.6f * flare, 0, 0.2);
-      for (int i = -135; i <= 135; i += 5) {
-        glVertex2d(9 * cos(AZ_DEG2RAD(i)) - 4, 12 * sin(AZ_DEG2RAD(i)));
-      }
+      az_shape_arc(-4, 0, 9, 12, -135, 135, 5);
     } glEnd();
     // Flames:
     glBegin(GL_TRIANGLE_FAN); {
@@ -249,10 +301,7 @@ void az_draw_bad_fire_crawler(
       glVertex2f(-9, 0);
       glColor4f(1.0f, 0.9f, 0, 0);
       const double rr = 0.9 + 0.06 * az_clock_zigzag(6, 8, clock);
-      for (int i = 0; i <= 360; i += 15) {
-        glVertex2d(11.0 * rr * cos(AZ_DEG2RAD(i)) - 3,
-                   14.0 * rr * sin(AZ_DEG2RAD(i)));
-      }
+      az_shape_ellipse(-3, 0, 11.0 * rr, 14.0 * rr);
     } glEnd();
   } glPopMatrix();
 }
@@ -265,14 +314,7 @@ void az_draw_bad_jungle_crawler(
   // Body:
   glPushMatrix(); {
     glTranslatef(-0.5f * az_clock_zigzag(5, 5, clock), 0, 0);
-    for (int i = -100; i <= 100; i += 20) {
-      glPushMatrix(); {
-        glTranslatef(-6, 0, 0);
-        glRotatef(i, 0, 0, 1);
-        glTranslatef(17, 0, 0);
-        draw_spine(flare, frozen);
-      } glPopMatrix();
-    }
+    call_crawler_part(JUNGLE_CRAWLER_SPINES, flare, frozen);
     glBegin(GL_TRIANGLE_FAN); {
       glColor3f(0.4f + 0.6f * flare, 0.2f, 0.2f + 0.6f * frozen);
       glVertex2f(-15.0f, az_clock_zigzag(9, 3, clock) - 4.0f);
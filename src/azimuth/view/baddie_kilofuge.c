@@ -22,11 +22,11 @@
 #include <assert.h>
 #include <math.h>
 
-#include <SDL_opengl.h>
-
+#include "azimuth/gui/opengl.h"
 #include "azimuth/state/baddie.h"
 #include "azimuth/util/clock.h"
 #include "azimuth/util/color.h"
+#include "azimuth/view/shape.h"
 #include "azimuth/view/util.h"
 
 /*===========================================================================*/
@@ -43,18 +43,13 @@ static void draw_eyeball(az_vector_t position, double angle, double radius,
       glVertex2f(0, 0);
       glColor3f(0.5f, (0.5f - 0.3f * hurt) * (1.0f - 0.8f * flare),
                   (0.5f - 0.4f * hurt) * (1.0f - 0.8f * flare));
-      for (int j = 0; j <= 360; j += 20) {
-        glVertex2d(radius * cos(AZ_DEG2RAD(j)), radius * sin(AZ_DEG2RAD(j)));
-      }
+      az_shape_circle(radius);
     } glEnd();
     // Pupil:
     glBegin(GL_TRIANGLE_FAN); {
       glColor3f(0, 0, 0); glVertex2d(0.7 * radius, 0);
       glColor4f(0, 0, 0, 0.7f);
-      for (int j = 0; j <= 360; j += 30) {
-        glVertex2d(0.2 * radius * cos(AZ_DEG2RAD(j)) + 0.7 * radius,
-                   0.3 * radius * sin(AZ_DEG2RAD(j)));
-      }
+      az_shape_ellipse(0.7 * radius, 0, 0.2 * radius, 0.3 * radius);
     } glEnd();
   } glPopMatrix();
 }
@@ -23,11 +23,11 @@
 #include <math.h>
 #include <stdbool.h>
 
-#include <SDL_opengl.h>
-
+#include "azimuth/gui/opengl.h"
 #include "azimuth/state/baddie.h"
 #include "azimuth/util/clock.h"
 #include "azimuth/util/color.h"
+#include "azimuth/view/shape.h"
 #include "azimuth/view/util.h"
 
 /*===========================================================================*/
@@ -35,16 +35,9 @@
 static void draw_sensor_lamp(GLfloat x_offset, bool lit) {
   glPushMatrix(); {
     glTranslatef(x_offset, 0, 0);
-    glBegin(GL_TRIANGLE_FAN); {
-      if (lit) {
-        glColor3f(1, 0.2, 0.1);
-      } else glColor3f(0.3, 0.3, 0.3);
-      glVertex2f(0, 0);
-      glColor3f(0.1, 0.1, 0.1);
-      for (int i = 0; i <= 360; i += 20) {
-        glVertex2d(4 * cos(AZ_DEG2RAD(i)), 4 * sin(AZ_DEG2RAD(i)));
-      }
-    } glEnd();
+    az_shape_draw_glow(4, (lit ? az_color3f(1, 0.2, 0.1) :
+                           az_color3f(0.3, 0.3, 0.3)),
+                       az_color3f(0.1, 0.1, 0.1));
     glBegin(GL_QUAD_STRIP); {
       for (int i = 0; i <= 360; i += 20) {
         glColor3f(0.2, 0.2, 0.2);
@@ -255,23 +248,10 @@ static void draw_ray(
   } glEnd();
   glPushMatrix(); {
     glTranslatef(2, -7, 0);
-    glBegin(GL_TRIANGLE_FAN); {
-      if (lamp) glColor3f(1, 0.2, 0.1);
-      else glColor3f(0.3, 0.3, 0.3);
-      glVertex2f(0, 0);
-      glColor3f(0.1, 0.1, 0.1);
-      for (int i = 0; i <= 360; i += 20) {
-        glVertex2d(5 * cos(AZ_DEG2RAD(i)), 5 * sin(AZ_DEG2RAD(i)));
-      }
-    } glEnd();
-    glBegin(GL_QUAD_STRIP); {
-      for (int i = 0; i <= 360; i += 20) {
-        az_gl_color(dark);
-        glVertex2d(7 * cos(AZ_DEG2RAD(i)), 7 * sin(AZ_DEG2RAD(i)));
-        az_gl_color(medium);
-        glVertex2d(4 * cos(AZ_DEG2RAD(i)), 4 * sin(AZ_DEG2RAD(i)));
-      }
-    } glEnd();
+    az_shape_draw_glow(5, (lamp ? az_color3f(1, 0.2, 0.1) :
+                           az_color3f(0.3, 0.3, 0.3)),
+                       az_color3f(0.1, 0.1, 0.1));
+    az_shape_draw_ring(4, medium, 7, dark);
   } glPopMatrix();
 }
 
@@ -308,9 +288,7 @@ static void draw_eye_and_eyelids(const az_baddie_t *baddie, float flare) {
     glVertex2f(8, 8);
     glColor3f(0.8f, 0.4f - 0.3f * flare, 0.1f);
     const double radius = baddie->data->components[0].bounding_radius;
-    for (int i = 0; i <= 360; i += 10) {
-      glVertex2d(radius * cos(AZ_DEG2RAD(i)), radius * sin(AZ_DEG2RAD(i)));
-    }
+    az_shape_circle(radius);
   } glEnd();
   glPushMatrix(); {
     az_gl_rotated(baddie->components[0].angle);
@@ -319,9 +297,7 @@ static void draw_eye_and_eyelids(const az_baddie_t *baddie, float flare) {
       glColor4f(baddie->param, 0, 0.25, 1);
       glVertex2f(0, 0);
       glColor4f(baddie->param, 0, 0.25, 0.6);
-      for (int i = 0; i <= 360; i += 10) {
-        glVertex2d(2.5 * cos(AZ_DEG2RAD(i)), 4 * sin(AZ_DEG2RAD(i)));
-      }
+      az_shape_ellipse(0, 0, 2.5, 4);
     } glEnd();
   } glPopMatrix();
   // Eyelids:
@@ -23,12 +23,12 @@
 #include <math.h>
 #include <stdlib.h>
 
-#include <SDL_opengl.h>
-
+#include "azimuth/gui/opengl.h"
 #include "azimuth/state/baddie.h"
 #include "azimuth/util/clock.h"
 #include "azimuth/util/color.h"
 #include "azimuth/util/misc.h"
+#include "azimuth/view/shape.h"
 #include "azimuth/view/util.h"
 
 /*===========================================================================*/
@@ -68,27 +68,19 @@ static void draw_magbeest_leg(const az_baddie_t *baddie, int leg_index) {
       glBegin(GL_TRIANGLE_FAN); {
         glColor3f(0.3, 0.35, 0.35); glVertex2f(0, 0);
         glColor3f(0.2, 0.2, 0.2);
-        for (int i = -90; i <= 90; i += 15) {
-          glVertex2d(-5 * cos(AZ_DEG2RAD(i)), 10 * sin(AZ_DEG2RAD(i)));
-        }
+        az_shape_arc(0, 0, -5, 10, -90, 90, 15);
       } glEnd();
     } else {
       // Knee:
       glBegin(GL_TRIANGLE_FAN); {
         glColor3f(0.3, 0.3, 0.3);
         glVertex2f(length - 10, 10); glVertex2f(length - 10, -10);
-        for (int i = -90; i <= 90; i += 15) {
-          glVertex2d(10 * cos(AZ_DEG2RAD(i)) + length,
-                     10 * sin(AZ_DEG2RAD(i)));
-        }
+        az_shape_arc(length, 0, 10, 10, -90, 90, 15);
       } glEnd();
       // Screw:
       glBegin(GL_TRIANGLE_FAN); {
         glColor3f(0.35, 0.4, 0.4);
-        for (int i = 0; i < 360; i += 30) {
-          glVertex2d(5 * cos(AZ_DEG2RAD(i)) + length,
-                     5 * sin(AZ_DEG2RAD(i)));
-        }
+        az_shape_arc(length, 0, 5, 5, 0, 330, 30);
       } glEnd();
       glBegin(GL_LINES); {
         glColor3f(0.2, 0.2, 0.2);
@@ -125,10 +117,7 @@ static void draw_magbeest_legs_base(const az_baddie_t *baddie) {
     const double y = -25 + 50 * j;
     glBegin(GL_TRIANGLE_FAN); {
       glColor3f(0.35, 0.4, 0.4);
-      for (int i = 0; i < 360; i += 30) {
-        glVertex2d(5 * cos(AZ_DEG2RAD(i)) - 20,
-                   5 * sin(AZ_DEG2RAD(i)) + y);
-      }
+      az_shape_arc(-20, y, 5, 5, 0, 330, 30);
     } glEnd();
     glBegin(GL_LINES); {
       glColor3f(0.2, 0.2, 0.2);
@@ -177,19 +166,10 @@ void az_draw_bad_magbeest_head(const az_baddie_t *baddie, az_clock_t clock) {
     assert(!az_vnonzero(eye->position));
     az_gl_rotated(eye->angle);
     const double radius = baddie->data->components[10].bounding_radius;
-    glBegin(GL_TRIANGLE_FAN); {
-      glColor3f(0.25f + 0.75f * flare, 0.25f, 0.25f); glVertex2f(0, 0);
-      glColor3f(0.07f + 0.3f * flare, 0.07f, 0.07f);
-      for (int i = 0; i <= 360; i += 20) {
-        glVertex2d(radius * cos(AZ_DEG2RAD(i)), radius * sin(AZ_DEG2RAD(i)));
-      }
-    } glEnd();
-    glBegin(GL_TRIANGLE_FAN); {
-      glColor3f(1, 0.3, 0); glVertex2f(15, 0); glColor4f(1, 0.3, 0, 0);
-      for (int i = 0; i <= 360; i += 30) {
-        glVertex2d(15 + 4 * cos(AZ_DEG2RAD(i)), 6 * sin(AZ_DEG2RAD(i)));
-      }
-    } glEnd();
+    az_shape_draw_glow(radius, az_color3f(0.25f + 0.75f * flare, 0.25f, 0.25f),
+                       az_color3f(0.07f + 0.3f * flare, 0.07f, 0.07f));
+    az_shape_draw_ellipse_glow(15, 0, 4, 6, az_color3f(1, 0.3, 0),
+                               az_color4f(1, 0.3, 0, 0));
     const az_color_t cracks_color = {128, 64, 0, 64};
     for (int i = 0; i < 4; ++i) {
       const double angle = -AZ_DEG2RAD(50) + i * AZ_DEG2RAD(80) +
@@ -248,16 +228,12 @@ void az_draw_bad_magbeest_legs_l(const az_baddie_t *baddie, az_clock_t clock) {
     glBegin(GL_TRIANGLE_FAN); {
       glColor3f(1, 1, 1); glVertex2f(0, 0);
       glColor3f(0.25, 0.25, 0.25);
-      for (int i = 30; i <= 330; i += 30) {
-        glVertex2d(7 * cos(AZ_DEG2RAD(i)), 7 * sin(AZ_DEG2RAD(i)));
-      }
+      az_shape_arc(0, 0, 7, 7, 30, 330, 30);
     } glEnd();
     // Screw:
     glBegin(GL_TRIANGLE_FAN); {
       glColor3f(0.35, 0.4, 0.4);
-      for (int i = 0; i < 360; i += 30) {
-        glVertex2d(4 * cos(AZ_DEG2RAD(i)), 4 * sin(AZ_DEG2RAD(i)));
-      }
+      az_shape_arc(0, 0, 4, 4, 0, 330, 30);
     } glEnd();
     glBegin(GL_LINES); {
       glColor3f(0.2, 0.2, 0.2);
@@ -341,13 +317,8 @@ void az_draw_bad_magma_bomb(const az_baddie_t *baddie, az_clock_t clock) {
   const bool blink = (baddie->cooldown < 1.5 &&
                       0 != (int)(4 * baddie->cooldown) % 2);
   const double radius = baddie->data->main_body.bounding_radius;
-  glBegin(GL_TRIANGLE_FAN); {
-    glColor3f(0.35f + 0.6f * flare, 0.35f, 0.35f); glVertex2f(0, 0);
-    glColor3f(0.1f + 0.4f * flare, 0.1f, 0.1f);
-    for (int i = 0; i <= 360; i += 20) {
-      glVertex2d(radius * cos(AZ_DEG2RAD(i)), radius * sin(AZ_DEG2RAD(i)));
-    }
-  } glEnd();
+  az_shape_draw_glow(radius, az_color3f(0.35f + 0.6f * flare, 0.35f, 0.35f),
+                     az_color3f(0.1f + 0.4f * flare, 0.1f, 0.1f));
   glBegin(GL_LINE_STRIP); {
     if (blink) glColor3f(0.8, 0.6, 0.6);
     else glColor3f(0.3, 0.1, 0.1);
@@ -22,11 +22,11 @@
 #include <assert.h>
 #include <math.h>
 
-#include <SDL_opengl.h>
-
+#include "azimuth/gui/opengl.h"
 #include "azimuth/state/baddie.h"
 #include "azimuth/util/clock.h"
 #include "azimuth/util/color.h"
+#include "azimuth/view/shape.h"
 #include "azimuth/view/util.h"
 
 /*===========================================================================*/
@@ -62,9 +62,7 @@ static void draw_nightbug_body(GLfloat green, double invis, float flare,
     glColor4f(0.8, 0.4, 0.1 + 0.9 * frozen, invis); // light red-brown
     glVertex2f(10, 0);
     glColor4f(0.5, 0.2, frozen, invis * invis); // reddish-brown
-    for (int i = -90; i <= 90; i += 30) {
-      glVertex2d(10 + 7 * cos(AZ_DEG2RAD(i)), 5 * sin(AZ_DEG2RAD(i)));
-    }
+    az_shape_arc(10, 0, 7, 5, -90, 90, 30);
   } glEnd();
   // Body:
   glPushMatrix(); {
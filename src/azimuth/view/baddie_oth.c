@@ -22,14 +22,14 @@
 #include <assert.h>
 #include <math.h>
 
-#include <SDL_opengl.h>
-
+#include "azimuth/gui/opengl.h"
 #include "azimuth/state/baddie.h"
 #include "azimuth/state/baddie_oth.h"
 #include "azimuth/util/bezier.h"
 #include "azimuth/util/clock.h"
 #include "azimuth/util/misc.h"
 #include "azimuth/view/particle.h"
+#include "azimuth/view/shape.h"
 #include "azimuth/view/util.h"
 
 /*===========================================================================*/
@@ -342,9 +342,7 @@ static void draw_tractor_beam(const az_baddie_t *baddie,
       glBegin(GL_TRIANGLE_FAN); {
         glColor4f(redblue, 1, redblue, 0.5); glVertex2d(0, 0);
         glColor4f(redblue, 1, redblue, 0);
-        for (int i = 90; i <= 270; i += 20) {
-          glVertex2d(thick * cos(AZ_DEG2RAD(i)), thick * sin(AZ_DEG2RAD(i)));
-        }
+        az_shape_arc(0, 0, thick, thick, 90, 270, 20);
       } glEnd();
       glBegin(GL_TRIANGLE_STRIP); {
         glColor4f(redblue, 1, redblue, 0);
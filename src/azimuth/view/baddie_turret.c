@@ -22,11 +22,11 @@
 #include <assert.h>
 #include <math.h>
 
-#include <SDL_opengl.h>
-
+#include "azimuth/gui/opengl.h"
 #include "azimuth/state/baddie.h"
 #include "azimuth/util/clock.h"
 #include "azimuth/util/color.h"
+#include "azimuth/view/shape.h"
 #include "azimuth/view/util.h"
 
 /*===========================================================================*/
@@ -62,145 +62,288 @@ static void draw_crawling_turret_legs(float flare, float frozen,
   } glEnd();
 }
 
-static void draw_turret_body_outer_edge(
-    const az_baddie_t *baddie, az_color_t far_edge, az_color_t mid_edge) {
-  glBegin(GL_QUAD_STRIP); {
-    for (int i = 0; i <= 360; i += 60) {
-      az_gl_color(mid_edge);
-      glVertex2d(18 * cos(AZ_DEG2RAD(i)), 18 * sin(AZ_DEG2RAD(i)));
-      az_gl_color(far_edge);
-      glVertex2d(20 * cos(AZ_DEG2RAD(i)), 20 * sin(AZ_DEG2RAD(i)));
-    }
-  } glEnd();
+// The different color schemes (and gun shapes) used by turret-like baddies.
+typedef enum {
+  NORMAL_TURRET,
+  ARMORED_TURRET,
+  BEAM_TURRET,
+  BROKEN_TURRET,
+  HEAVY_TURRET,
+  ROCKET_TURRET,
+  CRAWLING_MORTAR,
+  SECURITY_DRONE,
+  NUM_TURRET_STYLES
+} turret_style_t;
+
+// The parts of a turret that are rigid: the base is drawn first, then the gun
+// (rotated by the turret's gun angle), and then the center on top.
+typedef enum {
+  TURRET_BASE,
+  TURRET_GUN,
+  TURRET_CENTER,
+  NUM_TURRET_PARTS
+} turret_part_t;
+
+typedef struct {
+  az_color_t far_edge, mid_edge, near_edge, center, gun_edge, gun_middle;
+} turret_colors_t;
+
+// The first of NUM_TURRET_STYLES * NUM_TURRET_PARTS display lists, holding each
+// part of each turret style, with its colors modulated by flare and frozen.
+static GLuint turret_display_lists_start;
+
+static turret_colors_t get_turret_colors(turret_style_t style, float flare,
+                                         float frozen) {
+  switch (style) {
+    case NORMAL_TURRET:
+    case SECURITY_DRONE:
+      return (turret_colors_t){
+        .far_edge = az_color3f(0.25 + 0.1 * flare - 0.1 * frozen,
+                               0.25 - 0.1 * flare - 0.1 * frozen,
+                               0.25 - 0.1 * flare + 0.1 * frozen),
+        .mid_edge = az_color3f(0.35 + 0.15 * flare - 0.15 * frozen,
+                               0.35 - 0.15 * flare - 0.15 * frozen,
+                               0.35 - 0.15 * flare + 0.15 * frozen),
+        .near_edge = az_color3f(0.5 + 0.25 * flare - 0.25 * frozen,
+                                0.5 - 0.25 * flare - 0.25 * frozen,
+                                0.5 - 0.25 * flare + 0.25 * frozen),
+        .center = az_color3f(0.6 + 0.4 * flare - 0.3 * frozen,
+                             0.6 - 0.3 * flare - 0.3 * frozen,
+                             0.6 - 0.3 * flare + 0.4 * frozen),
+        .gun_edge = az_color3f(0.25 + 0.25 * flare, 0.25,
+                               0.25 + 0.25 * frozen),
+        .gun_middle = az_color3f(0.75 + 0.25 * flare, 0.75,
+                                 0.75 + 0.25 * frozen)
+      };
+    case ARMORED_TURRET:
+    case HEAVY_TURRET:
+      return (turret_colors_t){
+        .far_edge = az_color3f(0.20 + 0.1 * flare - 0.1 * frozen,
+                               0.20 - 0.1 * flare - 0.1 * frozen,
+                               0.25 - 0.1 * flare + 0.1 * frozen),
+        .mid_edge = az_color3f(0.30 + 0.15 * flare - 0.15 * frozen,
+                               0.30 - 0.15 * flare - 0.15 * frozen,
+                               0.35 - 0.15 * flare + 0.15 * frozen),
+        .near_edge = az_color3f(0.4 + 0.25 * flare - 0.25 * frozen,
+                                0.4 - 0.20 * flare - 0.20 * frozen,
+                                0.5 - 0.25 * flare + 0.25 * frozen),
+        .center = az_color3f(0.5 + 0.4 * flare - 0.3 * frozen,
+                             0.5 - 0.2 * flare - 0.2 * frozen,
+                             0.6 - 0.3 * flare + 0.4 * frozen),
+        .gun_edge = az_color3f(0.2 + 0.25 * flare, 0.2, 0.25 + 0.25 * frozen),
+        .gun_middle = az_color3f(0.6 + 0.25 * flare, 0.6,
+                                 0.75 + 0.25 * frozen)
+      };
+    case BEAM_TURRET:
+      return (turret_colors_t){
+        .far_edge = az_color3f(0.20 + 0.1 * flare - 0.1 * frozen,
+                               0.25 - 0.1 * flare - 0.1 * frozen,
+                               0.20 - 0.1 * flare + 0.1 * frozen),
+        .mid_edge = az_color3f(0.30 + 0.15 * flare - 0.15 * frozen,
+                               0.35 - 0.15 * flare - 0.15 * frozen,
+                               0.30 - 0.15 * flare + 0.15 * frozen),
+        .near_edge = az_color3f(0.4 + 0.25 * flare - 0.25 * frozen,
+                                0.5 - 0.20 * flare - 0.20 * frozen,
+                                0.4 - 0.25 * flare + 0.25 * frozen),
+        .center = az_color3f(0.5 + 0.4 * flare - 0.3 * frozen,
+                             0.6 - 0.2 * flare - 0.2 * frozen,
+                             0.5 - 0.3 * flare + 0.4 * frozen),
+        .gun_edge = az_color3f(0.2 + 0.25 * flare, 0.25, 0.2 + 0.25 * frozen),
+        .gun_middle = az_color3f(0.6 + 0.25 * flare, 0.75,
+                                 0.6 + 0.25 * frozen)
+      };
+    case BROKEN_TURRET:
+      return (turret_colors_t){
+        .far_edge = az_color3f(0.30 + 0.1 * flare - 0.1 * frozen,
+                               0.25 - 0.1 * flare - 0.1 * frozen,
+                               0.20 - 0.1 * flare + 0.1 * frozen),
+        .mid_edge = az_color3f(0.40 + 0.15 * flare - 0.15 * frozen,
+                               0.35 - 0.15 * flare - 0.15 * frozen,
+                               0.30 - 0.15 * flare + 0.15 * frozen),
+        .near_edge = az_color3f(0.55 + 0.25 * flare - 0.25 * frozen,
+                                0.50 - 0.25 * flare - 0.25 * frozen,
+                                0.45 - 0.25 * flare + 0.25 * frozen),
+        .center = az_color3f(0.60 + 0.40 * flare - 0.30 * frozen,
+                             0.55 - 0.25 * flare - 0.25 * frozen,
+                             0.50 - 0.30 * flare + 0.40 * frozen),
+        .gun_edge = az_color3f(0.30 + 0.25 * flare, 0.25,
+                               0.20 + 0.25 * frozen),
+        .gun_middle = az_color3f(0.75 + 0.25 * flare, 0.75,
+                                 0.75 + 0.25 * frozen)
+      };
+    case ROCKET_TURRET:
+      return (turret_colors_t){
+        .far_edge = az_color3f(0.20 + 0.1 * flare - 0.1 * frozen,
+                               0.15 - 0.1 * flare - 0.1 * frozen,
+                               0.15 - 0.1 * flare + 0.1 * frozen),
+        .mid_edge = az_color3f(0.30 + 0.15 * flare - 0.15 * frozen,
+                               0.25 - 0.15 * flare - 0.15 * frozen,
+                               0.25 - 0.15 * flare + 0.15 * frozen),
+        .near_edge = az_color3f(0.4 + 0.25 * flare - 0.25 * frozen,
+                                0.3 - 0.20 * flare - 0.20 * frozen,
+                                0.3 - 0.25 * flare + 0.25 * frozen),
+        .center = az_color3f(0.5 + 0.4 * flare - 0.3 * frozen,
+                             0.4 - 0.2 * flare - 0.2 * frozen,
+                             0.4 - 0.3 * flare + 0.4 * frozen),
+        .gun_edge = az_color3f(0.2 + 0.25 * flare, 0.15,
+                               0.15 + 0.25 * frozen),
+        .gun_middle = az_color3f(0.65 + 0.25 * flare, 0.5,
+                                 0.5 + 0.25 * frozen)
+      };
+    case CRAWLING_MORTAR:
+      return (turret_colors_t){
+        .far_edge = az_color3f(0.1 + 0.1 * flare - 0.1 * frozen,
+                               0.1 - 0.05 * flare,
+                               0.1 - 0.1 * flare + 0.1 * frozen),
+        .mid_edge = az_color3f(0.2 + 0.15 * flare - 0.15 * frozen,
+                               0.2 - 0.1 * flare,
+                               0.2 - 0.15 * flare + 0.15 * frozen),
+        .near_edge = az_color3f(0.3 + 0.25 * flare - 0.25 * frozen,
+                                0.3 - 0.15 * flare,
+                                0.3 - 0.25 * flare + 0.25 * frozen),
+        .center = az_color3f(0.4 + 0.4 * flare - 0.3 * frozen,
+                             0.4 - 0.2 * flare,
+                             0.4 - 0.3 * flare + 0.4 * frozen),
+        .gun_edge = az_color3f(0.1 + 0.25 * flare, 0.1, 0.1 + 0.25 * frozen),
+        .gun_middle = az_color3f(0.5 + 0.25 * flare, 0.5, 0.5 + 0.25 * frozen)
+      };
+    case NUM_TURRET_STYLES: break;
+  }
+  AZ_ASSERT_UNREACHABLE();
 }
 
-static void draw_turret_body_center(
-    const az_baddie_t *baddie, az_color_t mid_edge, az_color_t near_edge,
-    az_color_t center) {
-  az_gl_color(center);
-  glBegin(GL_POLYGON); {
-    for (int i = 0; i < 360; i += 60) {
-      glVertex2d(15 * cos(AZ_DEG2RAD(i)), 15 * sin(AZ_DEG2RAD(i)));
-    }
-  } glEnd();
-  glBegin(GL_QUAD_STRIP); {
-    for (int i = 0; i <= 360; i += 60) {
-      az_gl_color(near_edge);
-      glVertex2d(15 * cos(AZ_DEG2RAD(i)), 15 * sin(AZ_DEG2RAD(i)));
-      az_gl_color(mid_edge);
-      glVertex2d(18 * cos(AZ_DEG2RAD(i)), 18 * sin(AZ_DEG2RAD(i)));
-    }
-  } glEnd();
+static void draw_turret_part(turret_style_t style, turret_part_t part,
+                             float flare, float frozen) {
+  const turret_colors_t colors = get_turret_colors(style, flare, frozen);
+  switch (part) {
+    case TURRET_BASE:
+      glBegin(GL_QUAD_STRIP); {
+        for (int i = 0; i <= 360; i += 60) {
+          az_gl_color(colors.mid_edge);
+          glVertex2d(18 * cos(AZ_DEG2RAD(i)), 18 * sin(AZ_DEG2RAD(i)));
+          az_gl_color(colors.far_edge);
+          glVertex2d(20 * cos(AZ_DEG2RAD(i)), 20 * sin(AZ_DEG2RAD(i)));
+        }
+      } glEnd();
+      break;
+    case TURRET_GUN:
+      if (style == HEAVY_TURRET || style == SECURITY_DRONE) {
+        for (int i = -1; i <= 1; i += 2) {
+          glBegin(GL_QUAD_STRIP); {
+            az_gl_color(colors.gun_edge);
+            glVertex2f(0,  2 * i); glVertex2f(30,  2 * i);
+            az_gl_color(colors.gun_middle);
+            glVertex2f(0,  6 * i); glVertex2f(30,  6 * i);
+            az_gl_color(colors.gun_edge);
+            glVertex2f(0, 10 * i); glVertex2f(30, 10 * i);
+          } glEnd();
+        }
+        if (style == SECURITY_DRONE) {
+          // Counterweight:
+          glBegin(GL_TRIANGLE_FAN); {
+            az_gl_color(colors.far_edge);
+            glVertex2f(0, 0);
+            glVertex2f(-16, 15); glVertex2f(-24, 0); glVertex2f(-16, -15);
+          } glEnd();
+        }
+      } else {
+        glBegin(GL_QUAD_STRIP); {
+          az_gl_color(colors.gun_edge);
+          glVertex2f( 0,  5); glVertex2f(30,  5);
+          az_gl_color(colors.gun_middle);
+          glVertex2f( 0,  0); glVertex2f(30,  0);
+          az_gl_color(colors.gun_edge);
+          glVertex2f( 0, -5); glVertex2f(30, -5);
+        } glEnd();
+      }
+      break;
+    case TURRET_CENTER:
+      az_gl_color(colors.center);
+      glBegin(GL_POLYGON); {
+        az_shape_arc(0, 0, 15, 15, 0, 300, 60);
+      } glEnd();
+      glBegin(GL_QUAD_STRIP); {
+        for (int i = 0; i <= 360; i += 60) {
+          az_gl_color(colors.near_edge);
+          glVertex2d(15 * cos(AZ_DEG2RAD(i)), 15 * sin(AZ_DEG2RAD(i)));
+          az_gl_color(colors.mid_edge);
+          glVertex2d(18 * cos(AZ_DEG2RAD(i)), 18 * sin(AZ_DEG2RAD(i)));
+        }
+      } glEnd();
+      break;
+    case NUM_TURRET_PARTS: AZ_ASSERT_UNREACHABLE();
+  }
 }
 
-static void draw_turret(const az_baddie_t *baddie,
-                        az_color_t far_edge, az_color_t mid_edge,
-                        az_color_t near_edge, az_color_t center,
-                        az_color_t gun_edge, az_color_t gun_middle) {
-  draw_turret_body_outer_edge(baddie, far_edge, mid_edge);
+static void call_turret_part(turret_style_t style, turret_part_t part,
+                             float flare, float frozen) {
+  az_gfx_call_list_modulated(
+      turret_display_lists_start + style * NUM_TURRET_PARTS + part,
+      flare, frozen);
+}
+
+static void draw_turret(const az_baddie_t *baddie, turret_style_t style,
+                        float frozen) {
+  const float flare = baddie->armor_flare;
+  call_turret_part(style, TURRET_BASE, flare, frozen);
   glPushMatrix(); {
     glRotated(AZ_RAD2DEG(baddie->components[0].angle), 0, 0, 1);
-    glBegin(GL_QUAD_STRIP); {
-      az_gl_color(gun_edge);
-      glVertex2f( 0,  5); glVertex2f(30,  5);
-      az_gl_color(gun_middle);
-      glVertex2f( 0,  0); glVertex2f(30,  0);
-      az_gl_color(gun_edge);
-      glVertex2f( 0, -5); glVertex2f(30, -5);
-    } glEnd();
-    const double hurt =
-      (baddie->data->max_health - baddie->health) / baddie->data->max_health;
-    az_draw_cracks((az_vector_t){30, 0}, AZ_PI, 2.0 * hurt);
+    call_turret_part(style, TURRET_GUN, flare, frozen);
+    if (style != HEAVY_TURRET && style != SECURITY_DRONE) {
+      const double hurt = (baddie->data->max_health - baddie->health) /
+        baddie->data->max_health;
+      az_draw_cracks((az_vector_t){30, 0}, AZ_PI, 2.0 * hurt);
+    }
   } glPopMatrix();
-  draw_turret_body_center(baddie, mid_edge, near_edge, center);
+  call_turret_part(style, TURRET_CENTER, flare, frozen);
 }
 
 /*===========================================================================*/
 
+void az_init_turret_drawing(void) {
+  turret_display_lists_start =
+    glGenLists(NUM_TURRET_STYLES * NUM_TURRET_PARTS);
+  if (turret_display_lists_start == 0u) {
+    AZ_FATAL("glGenLists failed.\n");
+  }
+  for (int style = 0; style < NUM_TURRET_STYLES; ++style) {
+    for (int part = 0; part < NUM_TURRET_PARTS; ++part) {
+      const GLuint list =
+        turret_display_lists_start + style * NUM_TURRET_PARTS + part;
+      for (int variant = 0; variant < AZ_GFX_NUM_LIST_VARIANTS; ++variant) {
+        az_gfx_new_list_variant(list, variant); {
+          draw_turret_part((turret_style_t)style, (turret_part_t)part,
+                           (variant == 1), (variant == 2));
+        } glEndList();
+      }
+    }
+  }
+}
+
 void az_draw_bad_normal_turret(
     const az_baddie_t *baddie, float frozen, az_clock_t clock) {
-  const float flare = baddie->armor_flare;
-  draw_turret(baddie,
-              az_color3f(0.25 + 0.1 * flare - 0.1 * frozen,
-                         0.25 - 0.1 * flare - 0.1 * frozen,
-                         0.25 - 0.1 * flare + 0.1 * frozen),
-              az_color3f(0.35 + 0.15 * flare - 0.15 * frozen,
-                         0.35 - 0.15 * flare - 0.15 * frozen,
-                         0.35 - 0.15 * flare + 0.15 * frozen),
-              az_color3f(0.5 + 0.25 * flare - 0.25 * frozen,
-                         0.5 - 0.25 * flare - 0.25 * frozen,
-                         0.5 - 0.25 * flare + 0.25 * frozen),
-              az_color3f(0.6 + 0.4 * flare - 0.3 * frozen,
-                         0.6 - 0.3 * flare - 0.3 * frozen,
-                         0.6 - 0.3 * flare + 0.4 * frozen),
-              az_color3f(0.25 + 0.25 * flare, 0.25, 0.25 + 0.25 * frozen),
-              az_color3f(0.75 + 0.25 * flare, 0.75, 0.75 + 0.25 * frozen));
+  draw_turret(baddie, NORMAL_TURRET, frozen);
   draw_normal_turret_cracks(baddie);
 }
 
 void az_draw_bad_armored_turret(
     const az_baddie_t *baddie, float frozen, az_clock_t clock) {
   assert(baddie->kind == AZ_BAD_ARMORED_TURRET);
-  const float flare = baddie->armor_flare;
-  draw_turret(baddie,
-              az_color3f(0.20 + 0.1 * flare - 0.1 * frozen,
-                         0.20 - 0.1 * flare - 0.1 * frozen,
-                         0.25 - 0.1 * flare + 0.1 * frozen),
-              az_color3f(0.30 + 0.15 * flare - 0.15 * frozen,
-                         0.30 - 0.15 * flare - 0.15 * frozen,
-                         0.35 - 0.15 * flare + 0.15 * frozen),
-              az_color3f(0.4 + 0.25 * flare - 0.25 * frozen,
-                         0.4 - 0.20 * flare - 0.20 * frozen,
-                         0.5 - 0.25 * flare + 0.25 * frozen),
-              az_color3f(0.5 + 0.4 * flare - 0.3 * frozen,
-                         0.5 - 0.2 * flare - 0.2 * frozen,
-                         0.6 - 0.3 * flare + 0.4 * frozen),
-              az_color3f(0.2 + 0.25 * flare, 0.2, 0.25 + 0.25 * frozen),
-              az_color3f(0.6 + 0.25 * flare, 0.6, 0.75 + 0.25 * frozen));
+  draw_turret(baddie, ARMORED_TURRET, frozen);
   draw_normal_turret_cracks(baddie);
 }
 
 void az_draw_bad_beam_turret(
     const az_baddie_t *baddie, float frozen, az_clock_t clock) {
   assert(baddie->kind == AZ_BAD_BEAM_TURRET);
-  const float flare = baddie->armor_flare;
-  draw_turret(baddie,
-              az_color3f(0.20 + 0.1 * flare - 0.1 * frozen,
-                         0.25 - 0.1 * flare - 0.1 * frozen,
-                         0.20 - 0.1 * flare + 0.1 * frozen),
-              az_color3f(0.30 + 0.15 * flare - 0.15 * frozen,
-                         0.35 - 0.15 * flare - 0.15 * frozen,
-                         0.30 - 0.15 * flare + 0.15 * frozen),
-              az_color3f(0.4 + 0.25 * flare - 0.25 * frozen,
-                         0.5 - 0.20 * flare - 0.20 * frozen,
-                         0.4 - 0.25 * flare + 0.25 * frozen),
-              az_color3f(0.5 + 0.4 * flare - 0.3 * frozen,
-                         0.6 - 0.2 * flare - 0.2 * frozen,
-                         0.5 - 0.3 * flare + 0.4 * frozen),
-              az_color3f(0.2 + 0.25 * flare, 0.25, 0.2 + 0.25 * frozen),
-              az_color3f(0.6 + 0.25 * flare, 0.75, 0.6 + 0.25 * frozen));
+  draw_turret(baddie, BEAM_TURRET, frozen);
   draw_normal_turret_cracks(baddie);
 }
 
 void az_draw_bad_broken_turret(
     const az_baddie_t *baddie, float frozen, az_clock_t clock) {
   assert(baddie->kind == AZ_BAD_BROKEN_TURRET);
-  const float flare = baddie->armor_flare;
-  draw_turret(baddie,
-              az_color3f(0.30 + 0.1 * flare - 0.1 * frozen,
-                         0.25 - 0.1 * flare - 0.1 * frozen,
-                         0.20 - 0.1 * flare + 0.1 * frozen),
-              az_color3f(0.40 + 0.15 * flare - 0.15 * frozen,
-                         0.35 - 0.15 * flare - 0.15 * frozen,
-                         0.30 - 0.15 * flare + 0.15 * frozen),
-              az_color3f(0.55 + 0.25 * flare - 0.25 * frozen,
-                         0.50 - 0.25 * flare - 0.25 * frozen,
-                         0.45 - 0.25 * flare + 0.25 * frozen),
-              az_color3f(0.60 + 0.40 * flare - 0.30 * frozen,
-                         0.55 - 0.25 * flare - 0.25 * frozen,
-                         0.50 - 0.30 * flare + 0.40 * frozen),
-              az_color3f(0.30 + 0.25 * flare, 0.25, 0.20 + 0.25 * frozen),
-              az_color3f(0.75 + 0.25 * flare, 0.75, 0.75 + 0.25 * frozen));
+  draw_turret(baddie, BROKEN_TURRET, frozen);
   const double hurt =
     (baddie->data->max_health - baddie->health) / baddie->data->max_health;
   draw_turret_cracks(baddie, 3.0 + 3.0 * hurt);
@@ -209,64 +352,14 @@ void az_draw_bad_broken_turret(
 void az_draw_bad_heavy_turret(
     const az_baddie_t *baddie, float frozen, az_clock_t clock) {
   assert(baddie->kind == AZ_BAD_HEAVY_TURRET);
-  const float flare = baddie->armor_flare;
-  const az_color_t far_edge = az_color3f(
-      0.20 + 0.1 * flare - 0.1 * frozen,
-      0.20 - 0.1 * flare - 0.1 * frozen,
-      0.25 - 0.1 * flare + 0.1 * frozen);
-  const az_color_t mid_edge = az_color3f(
-      0.30 + 0.15 * flare - 0.15 * frozen,
-      0.30 - 0.15 * flare - 0.15 * frozen,
-      0.35 - 0.15 * flare + 0.15 * frozen);
-  const az_color_t near_edge = az_color3f(
-      0.4 + 0.25 * flare - 0.25 * frozen,
-      0.4 - 0.20 * flare - 0.20 * frozen,
-      0.5 - 0.25 * flare + 0.25 * frozen);
-  const az_color_t center = az_color3f(
-      0.5 + 0.4 * flare - 0.3 * frozen,
-      0.5 - 0.2 * flare - 0.2 * frozen,
-      0.6 - 0.3 * flare + 0.4 * frozen);
-  const az_color_t gun_edge =
-    az_color3f(0.2 + 0.25 * flare, 0.2, 0.25 + 0.25 * frozen);
-  const az_color_t gun_middle =
-    az_color3f(0.6 + 0.25 * flare, 0.6, 0.75 + 0.25 * frozen);
-  draw_turret_body_outer_edge(baddie, far_edge, mid_edge);
-  glPushMatrix(); {
-    glRotated(AZ_RAD2DEG(baddie->components[0].angle), 0, 0, 1);
-    for (int i = -1; i <= 1; i += 2) {
-      glBegin(GL_QUAD_STRIP); {
-        az_gl_color(gun_edge);
-        glVertex2f(0,  2 * i); glVertex2f(30,  2 * i);
-        az_gl_color(gun_middle);
-        glVertex2f(0,  6 * i); glVertex2f(30,  6 * i);
-        az_gl_color(gun_edge);
-        glVertex2f(0, 10 * i); glVertex2f(30, 10 * i);
-      } glEnd();
-    }
-  } glPopMatrix();
-  draw_turret_body_center(baddie, mid_edge, near_edge, center);
+  draw_turret(baddie, HEAVY_TURRET, frozen);
   draw_normal_turret_cracks(baddie);
 }
 
 void az_draw_bad_rocket_turret(
     const az_baddie_t *baddie, float frozen, az_clock_t clock) {
   assert(baddie->kind == AZ_BAD_ROCKET_TURRET);
-  const float flare = baddie->armor_flare;
-  draw_turret(baddie,
-              az_color3f(0.20 + 0.1 * flare - 0.1 * frozen,
-                         0.15 - 0.1 * flare - 0.1 * frozen,
-                         0.15 - 0.1 * flare + 0.1 * frozen),
-              az_color3f(0.30 + 0.15 * flare - 0.15 * frozen,
-                         0.25 - 0.15 * flare - 0.15 * frozen,
-                         0.25 - 0.15 * flare + 0.15 * frozen),
-              az_color3f(0.4 + 0.25 * flare - 0.25 * frozen,
-                         0.3 - 0.20 * flare - 0.20 * frozen,
-                         0.3 - 0.25 * flare + 0.25 * frozen),
-              az_color3f(0.5 + 0.4 * flare - 0.3 * frozen,
-                         0.4 - 0.2 * flare - 0.2 * frozen,
-                         0.4 - 0.3 * flare + 0.4 * frozen),
-              az_color3f(0.2 + 0.25 * flare, 0.15, 0.15 + 0.25 * frozen),
-              az_color3f(0.65 + 0.25 * flare, 0.5, 0.5 + 0.25 * frozen));
+  draw_turret(baddie, ROCKET_TURRET, frozen);
   draw_normal_turret_cracks(baddie);
 }
 
@@ -280,72 +373,15 @@ void az_draw_bad_crawling_turret(
 void az_draw_bad_crawling_mortar(
     const az_baddie_t *baddie, float frozen, az_clock_t clock) {
   assert(baddie->kind == AZ_BAD_CRAWLING_MORTAR);
-  const float flare = baddie->armor_flare;
-  draw_crawling_turret_legs(flare, frozen, clock);
-  draw_turret(baddie,
-              az_color3f(0.1 + 0.1 * flare - 0.1 * frozen, 0.1 - 0.05 * flare,
-                         0.1 - 0.1 * flare + 0.1 * frozen),
-              az_color3f(0.2 + 0.15 * flare - 0.15 * frozen, 0.2 - 0.1 * flare,
-                         0.2 - 0.15 * flare + 0.15 * frozen),
-              az_color3f(0.3 + 0.25 * flare - 0.25 * frozen,
-                         0.3 - 0.15 * flare,
-                         0.3 - 0.25 * flare + 0.25 * frozen),
-              az_color3f(0.4 + 0.4 * flare - 0.3 * frozen, 0.4 - 0.2 * flare,
-                         0.4 - 0.3 * flare + 0.4 * frozen),
-              az_color3f(0.1 + 0.25 * flare, 0.1, 0.1 + 0.25 * frozen),
-              az_color3f(0.5 + 0.25 * flare, 0.5, 0.5 + 0.25 * frozen));
+  draw_crawling_turret_legs(baddie->armor_flare, frozen, clock);
+  draw_turret(baddie, CRAWLING_MORTAR, frozen);
   draw_normal_turret_cracks(baddie);
 }
 
 void az_draw_bad_security_drone(
     const az_baddie_t *baddie, float frozen, az_clock_t clock) {
   assert(baddie->kind == AZ_BAD_SECURITY_DRONE);
-  const float flare = baddie->armor_flare;
-  draw_turret_body_outer_edge(
-      baddie,
-      az_color3f(0.25 + 0.1 * flare - 0.1 * frozen,
-                 0.25 - 0.1 * flare - 0.1 * frozen,
-                 0.25 - 0.1 * flare + 0.1 * frozen),
-      az_color3f(0.35 + 0.15 * flare - 0.15 * frozen,
-                 0.35 - 0.15 * flare - 0.15 * frozen,
-                 0.35 - 0.15 * flare + 0.15 * frozen));
-  glPushMatrix(); {
-    glRotated(AZ_RAD2DEG(baddie->components[0].angle), 0, 0, 1);
-    // Gun barrels:
-    const az_color_t gun_edge =
-      az_color3f(0.25 + 0.25 * flare, 0.25, 0.25 + 0.25 * frozen);
-    const az_color_t gun_middle =
-      az_color3f(0.75 + 0.25 * flare, 0.75, 0.75 + 0.25 * frozen);
-    for (int i = -1; i <= 1; i += 2) {
-      glBegin(GL_QUAD_STRIP); {
-        az_gl_color(gun_edge);
-        glVertex2f( 0,  2 * i); glVertex2f(30,  2 * i);
-        az_gl_color(gun_middle);
-        glVertex2f( 0,  6 * i); glVertex2f(30,  6 * i);
-        az_gl_color(gun_edge);
-        glVertex2f( 0, 10 * i); glVertex2f(30, 10 * i);
-      } glEnd();
-    }
-    // Counterweight:
-    glBegin(GL_TRIANGLE_FAN); {
-      glColor3f(0.25 + 0.1 * flare - 0.1 * frozen,
-                0.25 - 0.1 * flare - 0.1 * frozen,
-                0.25 - 0.1 * flare + 0.1 * frozen);
-      glVertex2f(0, 0);
-      glVertex2f(-16, 15); glVertex2f(-24, 0); glVertex2f(-16, -15);
-    } glEnd();
-  } glPopMatrix();
-  draw_turret_body_center(
-      baddie,
-      az_color3f(0.35 + 0.15 * flare - 0.15 * frozen,
-                 0.35 - 0.15 * flare - 0.15 * frozen,
-                 0.35 - 0.15 * flare + 0.15 * frozen),
-      az_color3f(0.5 + 0.25 * flare - 0.25 * frozen,
-                 0.5 - 0.25 * flare - 0.25 * frozen,
-                 0.5 - 0.25 * flare + 0.25 * frozen),
-      az_color3f(0.6 + 0.4 * flare - 0.3 * frozen,
-                 0.6 - 0.3 * flare - 0.3 * frozen,
-                 0.6 - 0.3 * flare + 0.4 * frozen));
+  draw_turret(baddie, SECURITY_DRONE, frozen);
   draw_normal_turret_cracks(baddie);
 }
 
@@ -358,15 +394,7 @@ void az_draw_bad_pop_open_turret(
   const az_color_t outer =
     az_color3f(0.2f + 0.25f * flare, 0.2f, 0.2f + 0.25f * frozen);
   // Center:
-  glBegin(GL_TRIANGLE_FAN); {
-    az_gl_color(inner);
-    glVertex2f(0, 0);
-    az_gl_color(outer);
-    const double radius = baddie->data->main_body.bounding_radius;
-    for (int i = 0; i <= 360; i += 10) {
-      glVertex2d(radius * cos(AZ_DEG2RAD(i)), radius * sin(AZ_DEG2RAD(i)));
-    }
-  } glEnd();
+  az_shape_draw_glow(baddie->data->main_body.bounding_radius, inner, outer);
   // Barrel:
   glPushMatrix(); {
     glRotated(AZ_RAD2DEG(baddie->components[0].angle), 0, 0, 1);
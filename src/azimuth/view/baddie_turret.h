@@ -26,6 +26,10 @@
 
 /*===========================================================================*/
 
+// Compile display lists for the rigid parts of these baddies.  This is called
+// by az_init_baddie_drawing.
+void az_init_turret_drawing(void);
+
 void az_draw_bad_normal_turret(
     const az_baddie_t *baddie, float frozen, az_clock_t clock);
 void az_draw_bad_armored_turret(
@@ -21,10 +21,10 @@
 
 #include <math.h>
 
-#include <SDL_opengl.h>
-
+#include "azimuth/gui/opengl.h"
 #include "azimuth/state/baddie.h"
 #include "azimuth/util/clock.h"
+#include "azimuth/view/shape.h"
 #include "azimuth/view/util.h"
 
 /*===========================================================================*/
@@ -78,15 +78,9 @@ void az_draw_bad_rockwyrm(const az_baddie_t *baddie) {
     draw_rockwyrm_segment(baddie, i);
   }
   // Head:
-  glBegin(GL_TRIANGLE_FAN); {
-    glColor3f(1, 0.5f - 0.5f * flare, 0.1);
-    glVertex2f(0, 0);
-    glColor3f(0.5f, 0.25f - 0.25f * flare, 0.05);
-    const double radius = baddie->data->main_body.bounding_radius;
-    for (int i = 0; i <= 360; i += 30) {
-      glVertex2d(radius * cos(AZ_DEG2RAD(i)), radius * sin(AZ_DEG2RAD(i)));
-    }
-  } glEnd();
+  az_shape_draw_glow(baddie->data->main_body.bounding_radius,
+                     az_color3f(1, 0.5f - 0.5f * flare, 0.1),
+                     az_color3f(0.5f, 0.25f - 0.25f * flare, 0.05));
   // Jaws:
   for (int i = 0; i < 2; ++i) {
     const az_component_t *component = &baddie->components[i];
@@ -122,24 +116,16 @@ void az_draw_bad_wyrm_egg(
     } else glColor3f(0, 1, 0.25);
     glVertex2d(0.35 * radius, 0);
     glColor3f(0.3f, 0.4f - 0.2f * flare - 0.2f * frozen, 0.4f - 0.2f * flare);
-    for (int i = 0; i <= 360; i += 15) {
-      glVertex2d(radius * cos(AZ_DEG2RAD(i)), radius * sin(AZ_DEG2RAD(i)));
-    }
+    az_shape_circle(radius);
   } glEnd();
 }
 
 void az_draw_bad_wyrmling(const az_baddie_t *baddie, float frozen) {
   const float flare = baddie->armor_flare;
   // Head:
-  glBegin(GL_TRIANGLE_FAN); {
-    glColor3f(1, 0.5f - 0.5f * flare, 0.1);
-    glVertex2f(0, 0);
-    glColor3f(0.5f, 0.25f - 0.25f * flare, 0.05);
-    const double radius = baddie->data->main_body.bounding_radius;
-    for (int i = 0; i <= 360; i += 30) {
-      glVertex2d(radius * cos(AZ_DEG2RAD(i)), radius * sin(AZ_DEG2RAD(i)));
-    }
-  } glEnd();
+  az_shape_draw_glow(baddie->data->main_body.bounding_radius,
+                     az_color3f(1, 0.5f - 0.5f * flare, 0.1),
+                     az_color3f(0.5f, 0.25f - 0.25f * flare, 0.05));
   // Neck/tail:
   for (int i = baddie->data->num_components - 1; i >= 0; --i) {
     const bool last = i == baddie->data->num_components - 1;
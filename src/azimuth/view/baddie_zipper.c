@@ -17,12 +17,11 @@
 | with Azimuth.  If not, see <http://www.gnu.org/licenses/>.                  |
 =============================================================================*/
 
-#include "azimuth/view/baddie_turret.h"
+#include "azimuth/view/baddie_zipper.h"
 
 #include <math.h>
 
-#include <SDL_opengl.h>
-
+#include "azimuth/gui/opengl.h"
 #include "azimuth/state/baddie.h"
 #include "azimuth/util/clock.h"
 #include "azimuth/util/color.h"
@@ -80,32 +79,133 @@ static void draw_zipper_wings(
   }
 }
 
-static void draw_zipper(
-    az_color_t inner1, az_color_t inner2, az_color_t outer,
-    float flare, float frozen, az_clock_t clock) {
-  draw_zipper_body(inner1, inner2, outer, 6.0);
-  draw_zipper_wings(10, 1.8, 3.8, flare, frozen, clock);
+// The different kinds of zipper-like baddies, which differ in their bodies.
+typedef enum {
+  ZIPPER,
+  ARMORED_ZIPPER,
+  FIRE_ZIPPER,
+  MOSQUITO,
+  GNAT,
+  DRAGONFLY,
+  HORNET,
+  SUPER_HORNET,
+  NUM_ZIPPER_STYLES
+} zipper_style_t;
+
+// The first of NUM_ZIPPER_STYLES display lists, holding the body of each
+// zipper style, with its colors modulated by flare and frozen.
+static GLuint zipper_display_lists_start;
+
+// Draw the parts of a zipper-like baddie other than its wings (which flap).
+static void draw_zipper_style_body(zipper_style_t style, float flare,
+                                   float frozen) {
+  switch (style) {
+    case ZIPPER:
+      draw_zipper_body(
+          az_color3f(0.5 + 0.5 * flare - 0.5 * frozen, 1 - flare, frozen),
+          az_color3f(0.4 - 0.4 * frozen, 0.4, frozen),
+          az_color3f(0.4 * flare, 0.5, frozen), 6.0);
+      break;
+    case ARMORED_ZIPPER:
+      draw_zipper_body(az_color3f(0.7f + 0.25f * flare - 0.5f * frozen,
+                                  0.75f - 0.75f * flare,
+                                  0.7f + 0.3f * frozen),
+                       az_color3f(0, 0.4f, 0.4f + 0.6f * frozen),
+                       az_color3f(0.2f + 0.4f * flare, 0.3f,
+                                  0.2f + 0.8f * frozen), 6.0);
+      break;
+    case FIRE_ZIPPER:
+      draw_zipper_body(az_color3f(0.5f + 0.5f * flare - 0.5f * frozen,
+                                  0.5f * frozen, 1.0f - flare),
+                       az_color3f(0.6f - 0.6f * frozen, 0.4f, frozen),
+                       az_color3f(0.25f + 0.25f * flare, 0.25f * frozen,
+                                  0.5f - 0.5f * flare), 6.0);
+      break;
+    case MOSQUITO:
+      draw_zipper_antennae(az_color3f(0.5, 0.25, 0.25));
+      draw_zipper_body(az_color3f(1 - frozen, 0.5 - 0.5 * flare, frozen),
+                       az_color3f(1 - frozen, 0.25, frozen),
+                       az_color3f(0.4 + 0.4 * flare, 0, frozen), 8);
+      break;
+    case GNAT:
+      draw_zipper_antennae(az_color3f(0.5, 0.25, 0.25));
+      draw_zipper_body(az_color3f(0.5f + 0.5f * flare, 0.25f, 1.0f - flare),
+                       az_color3f(0.25f + 0.75f * flare, 0, 1.0f - flare),
+                       az_color3f(0.4 + 0.4 * flare, 0, frozen), 8);
+      break;
+    case DRAGONFLY:
+      draw_zipper_antennae(az_color3f(0.5, 0.25, 0.25));
+      draw_zipper_body(az_color3f(1 - frozen, 0.5 - 0.5 * flare, frozen),
+                       az_color3f(1 - frozen, 0.25, frozen),
+                       az_color3f(0.4 + 0.4 * flare, 0, frozen), 4);
+      break;
+    case HORNET:
+      draw_zipper_antennae(az_color3f(0.5, 0.5, 0.25));
+      draw_zipper_body(az_color3f(1 - frozen, 1 - flare, frozen),
+                       az_color3f(1 - frozen, 0.5, frozen),
+                       az_color3f(0.4 + 0.4 * flare, 0.4, frozen), 4);
+      break;
+    case SUPER_HORNET:
+      draw_zipper_antennae(az_color3f(0.25, 0.5, 0.12));
+      for (int y = -1; y <= 1; y += 2) {
+        for (int i = -3; i <= 4; ++i) {
+          glPushMatrix(); {
+            glScaled(1, y, 1);
+            const double x = 4 * i;
+            glTranslated(x, 4 * (1 - pow(0.05 * x, 4) + 0.025 * x), 0);
+            glBegin(GL_TRIANGLE_STRIP); {
+              glColor3f(0.1, 0.3, 0); glVertex2f(2, -2);
+              glColor3f(0.6, 0.9, 0.3); glVertex2f(i - 1, 2);
+              glColor3f(0.5, 0.8, 0); glVertex2f(0, -3);
+              glColor3f(0.1, 0.3, 0); glVertex2f(-2, -2);
+            } glEnd();
+          } glPopMatrix();
+        }
+      }
+      draw_zipper_body(az_color3f(0.6f - 0.6f * frozen, 0.5f - 0.5f * flare,
+                                  frozen),
+                       az_color3f(0, 1.0f - 0.5f * frozen, frozen),
+                       az_color3f(0.2 + 0.6 * flare, 0.4, frozen), 4);
+      break;
+    case NUM_ZIPPER_STYLES: AZ_ASSERT_UNREACHABLE();
+  }
+}
+
+// Draw a zipper-like baddie, taking its body from a display list.
+static void draw_zipper(zipper_style_t style, GLfloat wing_xcenter,
+                        double theta1, double theta2, float flare,
+                        float frozen, az_clock_t clock) {
+  az_gfx_call_list_modulated(zipper_display_lists_start + style, flare,
+                             frozen);
+  draw_zipper_wings(wing_xcenter, theta1, theta2, flare, frozen, clock);
 }
 
 /*===========================================================================*/
 
+void az_init_zipper_drawing(void) {
+  zipper_display_lists_start = glGenLists(NUM_ZIPPER_STYLES);
+  if (zipper_display_lists_start == 0u) {
+    AZ_FATAL("glGenLists failed.\n");
+  }
+  for (int style = 0; style < NUM_ZIPPER_STYLES; ++style) {
+    for (int variant = 0; variant < AZ_GFX_NUM_LIST_VARIANTS; ++variant) {
+      az_gfx_new_list_variant(zipper_display_lists_start + style, variant); {
+        draw_zipper_style_body((zipper_style_t)style, (variant == 1),
+                               (variant == 2));
+      } glEndList();
+    }
+  }
+}
+
 void az_draw_bad_zipper(
     const az_baddie_t *baddie, float frozen, az_clock_t clock) {
-  const float flare = baddie->armor_flare;
-  draw_zipper(az_color3f(0.5 + 0.5 * flare - 0.5 * frozen, 1 - flare, frozen),
-              az_color3f(0.4 - 0.4 * frozen, 0.4, frozen),
-              az_color3f(0.4 * flare, 0.5, frozen), flare, frozen, clock);
+  draw_zipper(ZIPPER, 10, 1.8, 3.8, baddie->armor_flare, frozen, clock);
 }
 
 void az_draw_bad_armored_zipper(
     const az_baddie_t *baddie, float frozen, az_clock_t clock) {
-  const float flare = baddie->armor_flare;
-  draw_zipper(az_color3f(0.7f + 0.25f * flare - 0.5f * frozen,
-                         0.75f - 0.75f * flare,
-                         0.7f + 0.3f * frozen),
-              az_color3f(0, 0.4f, 0.4f + 0.6f * frozen),
-              az_color3f(0.2f + 0.4f * flare, 0.3f, 0.2f + 0.8f * frozen),
-              flare, frozen, clock);
+  draw_zipper(ARMORED_ZIPPER, 10, 1.8, 3.8, baddie->armor_flare, frozen,
+              clock);
 }
 
 void az_draw_bad_mini_armored_zipper(
@@ -118,85 +218,38 @@ void az_draw_bad_mini_armored_zipper(
 
 void az_draw_bad_fire_zipper(
     const az_baddie_t *baddie, float frozen, az_clock_t clock) {
-  const float flare = baddie->armor_flare;
-  draw_zipper(az_color3f(0.5f + 0.5f * flare - 0.5f * frozen, 0.5f * frozen,
-                         1.0f - flare),
-              az_color3f(0.6f - 0.6f * frozen, 0.4f, frozen),
-              az_color3f(0.25f + 0.25f * flare, 0.25f * frozen,
-                         0.5f - 0.5f * flare),
-              flare, frozen, clock);
+  draw_zipper(FIRE_ZIPPER, 10, 1.8, 3.8, baddie->armor_flare, frozen, clock);
 }
 
 void az_draw_bad_mosquito(
     const az_baddie_t *baddie, float frozen, az_clock_t clock) {
-  const float flare = baddie->armor_flare;
   glPushMatrix(); {
     glScalef(0.7, 0.7, 1);
-    draw_zipper_antennae(az_color3f(0.5, 0.25, 0.25));
-    draw_zipper_body(az_color3f(1 - frozen, 0.5 - 0.5 * flare, frozen),
-                     az_color3f(1 - frozen, 0.25, frozen),
-                     az_color3f(0.4 + 0.4 * flare, 0, frozen), 8);
-    draw_zipper_wings(5, -1.1, 1.9, flare, frozen, clock);
+    draw_zipper(MOSQUITO, 5, -1.1, 1.9, baddie->armor_flare, frozen, clock);
   } glPopMatrix();
 }
 
 void az_draw_bad_gnat(
     const az_baddie_t *baddie, float frozen, az_clock_t clock) {
-  const float flare = baddie->armor_flare;
   glPushMatrix(); {
     glScalef(0.5, 0.5, 1);
-    draw_zipper_antennae(az_color3f(0.5, 0.25, 0.25));
-    draw_zipper_body(az_color3f(0.5f + 0.5f * flare, 0.25f, 1.0f - flare),
-                     az_color3f(0.25f + 0.75f * flare, 0, 1.0f - flare),
-                     az_color3f(0.4 + 0.4 * flare, 0, frozen), 8);
-    draw_zipper_wings(5, -1.1, 1.9, flare, frozen, clock);
+    draw_zipper(GNAT, 5, -1.1, 1.9, baddie->armor_flare, frozen, clock);
   } glPopMatrix();
 }
 
 void az_draw_bad_dragonfly(
     const az_baddie_t *baddie, float frozen, az_clock_t clock) {
-  const float flare = baddie->armor_flare;
-  draw_zipper_antennae(az_color3f(0.5, 0.25, 0.25));
-  draw_zipper_body(az_color3f(1 - frozen, 0.5 - 0.5 * flare, frozen),
-                   az_color3f(1 - frozen, 0.25, frozen),
-                   az_color3f(0.4 + 0.4 * flare, 0, frozen), 4);
-  draw_zipper_wings(5, -1.1, 1.9, flare, frozen, clock);
+  draw_zipper(DRAGONFLY, 5, -1.1, 1.9, baddie->armor_flare, frozen, clock);
 }
 
 void az_draw_bad_hornet(
     const az_baddie_t *baddie, float frozen, az_clock_t clock) {
-  const float flare = baddie->armor_flare;
-  draw_zipper_antennae(az_color3f(0.5, 0.5, 0.25));
-  draw_zipper_body(az_color3f(1 - frozen, 1 - flare, frozen),
-                   az_color3f(1 - frozen, 0.5, frozen),
-                   az_color3f(0.4 + 0.4 * flare, 0.4, frozen), 4);
-  draw_zipper_wings(5, -1.1, 1.9, flare, frozen, clock);
+  draw_zipper(HORNET, 5, -1.1, 1.9, baddie->armor_flare, frozen, clock);
 }
 
 void az_draw_bad_super_hornet(
     const az_baddie_t *baddie, float frozen, az_clock_t clock) {
-  const float flare = baddie->armor_flare;
-  draw_zipper_antennae(az_color3f(0.25, 0.5, 0.12));
-  for (int y = -1; y <= 1; y += 2) {
-    for (int i = -3; i <= 4; ++i) {
-      glPushMatrix(); {
-        glScaled(1, y, 1);
-        const double x = 4 * i;
-        glTranslated(x, 4 * (1 - pow(0.05 * x, 4) + 0.025 * x), 0);
-        glBegin(GL_TRIANGLE_STRIP); {
-          glColor3f(0.1, 0.3, 0); glVertex2f(2, -2);
-          glColor3f(0.6, 0.9, 0.3); glVertex2f(i - 1, 2);
-          glColor3f(0.5, 0.8, 0); glVertex2f(0, -3);
-          glColor3f(0.1, 0.3, 0); glVertex2f(-2, -2);
-        } glEnd();
-      } glPopMatrix();
-    }
-  }
-  draw_zipper_body(az_color3f(0.6f - 0.6f * frozen, 0.5f - 0.5f * flare,
-                              frozen),
-                   az_color3f(0, 1.0f - 0.5f * frozen, frozen),
-                   az_color3f(0.2 + 0.6 * flare, 0.4, frozen), 4);
-  draw_zipper_wings(5, -1.1, 1.9, flare, frozen, clock);
+  draw_zipper(SUPER_HORNET, 5, -1.1, 1.9, baddie->armor_flare, frozen, clock);
 }
 
 void az_draw_bad_switcher(
@@ -21,9 +21,8 @@
 
 #include <math.h>
 
-#include <SDL_opengl.h>
-
 #include "azimuth/gui/event.h"
+#include "azimuth/gui/opengl.h"
 #include "azimuth/state/sound.h"
 #include "azimuth/util/clock.h"
 #include "azimuth/util/misc.h"
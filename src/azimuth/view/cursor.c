@@ -19,9 +19,8 @@
 
 #include "azimuth/view/cursor.h"
 
-#include <SDL_opengl.h>
-
 #include "azimuth/gui/event.h" // for az_get_mouse_position
+#include "azimuth/gui/opengl.h"
 
 /*===========================================================================*/
 
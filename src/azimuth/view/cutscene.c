@@ -22,10 +22,11 @@
 #include <assert.h>
 #include <math.h>
 #include <stdbool.h>
-
-#include <SDL_opengl.h>
+#include <stdlib.h>
 
 #include "azimuth/constants.h"
+#include "azimuth/gui/gfx.h"
+#include "azimuth/gui/opengl.h"
 #include "azimuth/state/ship.h"
 #include "azimuth/state/space.h"
 #include "azimuth/util/clock.h"
@@ -33,6 +34,7 @@
 #include "azimuth/util/random.h"
 #include "azimuth/util/vector.h"
 #include "azimuth/view/particle.h"
+#include "azimuth/view/shape.h"
 #include "azimuth/view/ship.h"
 #include "azimuth/view/string.h"
 #include "azimuth/view/util.h"
@@ -46,28 +48,99 @@ static az_color_t scale_color(float r, float g, float b, az_color_t color) {
   return color;
 }
 
+// Draw a flashing Oth portal centered on the origin.
+static void draw_portal(double radius, az_clock_t clock) {
+  const GLfloat r = (az_clock_mod(6, 1, clock)     < 3 ? 1.0f : 0.25f);
+  const GLfloat g = (az_clock_mod(6, 1, clock + 2) < 3 ? 1.0f : 0.25f);
+  const GLfloat b = (az_clock_mod(6, 1, clock + 4) < 3 ? 1.0f : 0.25f);
+  az_shape_draw_ellipse_glow(0, 0, radius, 0.8 * radius,
+                             az_color4f(r, g, b, 1), az_color4f(r, g, b, 0));
+}
+
 /*===========================================================================*/
 
-static void draw_moving_stars_layer(
-    double spacing, double scale, double speed, double total_time,
-    GLfloat gray) {
-  const double modulus = AZ_SCREEN_WIDTH + spacing;
-  const double scroll = fmod(total_time * speed, modulus);
-  az_random_seed_t seed = {1, 1};
+// The star and debris fields below are generated from a fixed random seed the
+// first time they're drawn, and then cached, so that drawing them each frame
+// doesn't need to rerun the RNG.  With the core backend, the starfields are
+// also uploaded into static vertex buffers, and scrolled and twinkled on the
+// GPU; with the legacy backend, they're drawn from the cache on the CPU.
+
+static void draw_stars(int num_stars, const az_gfx_star_t *stars,
+                       const az_gfx_starfield_style_t *style,
+                       az_clock_t clock) {
   glBegin(GL_LINES); {
+    for (int i = 0; i < num_stars; ++i) {
+      double x = stars[i].x + style->scroll;
+      if (style->wrap > 0 && x >= style->wrap) x -= style->wrap;
+      GLfloat gray = stars[i].gray;
+      if (style->twinkle_gray != 0) {
+        gray += style->twinkle_gray *
+          az_clock_zigzag(style->twinkle_modulus, style->twinkle_slowdown,
+                          clock + (az_clock_t)stars[i].phase);
+      }
+      glColor3f(gray, gray, gray);
+      glVertex2d(x, stars[i].y);
+      gray *= style->tail_gray;
+      glColor3f(gray, gray, gray);
+      glVertex2d(x - style->tail_length, stars[i].y);
+    }
+  } glEnd();
+}
+
+static const struct {
+  double spacing, speed;
+  GLfloat gray;
+} moving_star_layers[] = {
+  {30,  450, 0.15f},
+  {45,  600, 0.25f},
+  {80,  900, 0.40f},
+  {95, 1200, 0.50f}
+};
+
+static struct {
+  int num_stars;
+  az_gfx_star_t *stars; // x is in [0, AZ_SCREEN_WIDTH + spacing)
+  GLuint starfield; // 0 if not using the core backend
+} moving_star_caches[AZ_ARRAY_SIZE(moving_star_layers)];
+
+static void draw_moving_stars_layer(int layer, double scale, double total_time) {
+  const double spacing = moving_star_layers[layer].spacing;
+  const double modulus = AZ_SCREEN_WIDTH + spacing;
+  if (moving_star_caches[layer].stars == NULL) {
+    int num_stars = 0;
+    for (double xoff = 0.0; xoff < modulus; xoff += spacing) {
+      for (double yoff = 0.0; yoff < modulus; yoff += spacing) ++num_stars;
+    }
+    az_gfx_star_t *stars = AZ_ALLOC(num_stars, az_gfx_star_t);
+    az_random_seed_t seed = {1, 1};
+    int i = 0;
     for (double xoff = 0.0; xoff < modulus; xoff += spacing) {
       for (double yoff = 0.0; yoff < modulus; yoff += spacing) {
-        const double x =
-          fmod(xoff + 3.0 * spacing * az_rand_udouble(&seed) + scroll,
-               modulus);
-        const double y = yoff + 3.0 * spacing * az_rand_udouble(&seed);
-        glColor3f(gray, gray, gray);
-        glVertex2d(x, y);
-        glColor3f(0, 0, 0);
-        glVertex2d(x - spacing * scale, y);
+        stars[i].x = fmod(xoff + 3.0 * spacing * az_rand_udouble(&seed),
+                          modulus);
+        stars[i].y = yoff + 3.0 * spacing * az_rand_udouble(&seed);
+        stars[i].gray = moving_star_layers[layer].gray;
+        ++i;
       }
     }
-  } glEnd();
+    moving_star_caches[layer].num_stars = num_stars;
+    moving_star_caches[layer].stars = stars;
+    if (az_gfx_backend() == AZ_GFX_CORE) {
+      moving_star_caches[layer].starfield =
+        az_gfx_gen_starfield(num_stars, stars);
+    }
+  }
+  const az_gfx_starfield_style_t style = {
+    .scroll = fmod(total_time * moving_star_layers[layer].speed, modulus),
+    .wrap = modulus, .tail_length = spacing * scale, .tail_gray = 0
+  };
+  if (moving_star_caches[layer].starfield != 0u) {
+    az_gfx_draw_starfield(moving_star_caches[layer].starfield,
+                          moving_star_caches[layer].num_stars, &style, 0);
+  } else {
+    draw_stars(moving_star_caches[layer].num_stars,
+               moving_star_caches[layer].stars, &style, 0);
+  }
 }
 
 void az_draw_moving_starfield(double time, double speed, double scale) {
@@ -78,31 +151,73 @@ void az_draw_moving_starfield(double time, double speed, double scale) {
       speed = -speed;
     }
     time *= speed;
-    draw_moving_stars_layer(30, scale,  450, time, 0.15f);
-    draw_moving_stars_layer(45, scale,  600, time, 0.25f);
-    draw_moving_stars_layer(80, scale,  900, time, 0.40f);
-    draw_moving_stars_layer(95, scale, 1200, time, 0.50f);
+    for (int i = 0; i < AZ_ARRAY_SIZE(moving_star_layers); ++i) {
+      draw_moving_stars_layer(i, scale, time);
+    }
   } glPopMatrix();
 }
 
+#define PLANET_STAR_SPACING 12
+
+// The planet starfield is generated column by column, so the stars for a
+// narrower field are always a prefix of those for a wider one; the cache only
+// needs to be regenerated when a wider field is requested.
+static struct {
+  int width, num_stars;
+  az_gfx_star_t *stars;
+  GLuint starfield; // 0 if not using the core backend
+} planet_star_cache;
+
 static void draw_planet_starfield_internal(int width, az_clock_t clock) {
-  const int star_spacing = 12;
-  az_random_seed_t seed = {1, 1};
-  glBegin(GL_LINES); {
+  if (width > planet_star_cache.width) {
+    int num_stars = 0;
+    for (int xoff = 0; xoff < width; xoff += PLANET_STAR_SPACING) {
+      for (int yoff = 0; yoff < AZ_SCREEN_HEIGHT;
+           yoff += PLANET_STAR_SPACING) ++num_stars;
+    }
+    az_gfx_star_t *stars = AZ_ALLOC(num_stars, az_gfx_star_t);
+    az_random_seed_t seed = {1, 1};
     int i = 0;
-    for (int xoff = 0; xoff < width; xoff += star_spacing) {
-      for (int yoff = 0; yoff < AZ_SCREEN_HEIGHT; yoff += star_spacing) {
-        const int twinkle = az_clock_zigzag(10, 4, clock + i);
-        const GLfloat gray = (twinkle * 0.02) + 0.3 * az_rand_udouble(&seed);
-        glColor3f(gray, gray, gray);
-        const double x = xoff + 3 * star_spacing * az_rand_udouble(&seed);
-        const double y = yoff + 3 * star_spacing * az_rand_udouble(&seed);
-        glVertex2d(x, y);
-        glVertex2d(x + 1, y);
+    for (int xoff = 0; xoff < width; xoff += PLANET_STAR_SPACING) {
+      for (int yoff = 0; yoff < AZ_SCREEN_HEIGHT;
+           yoff += PLANET_STAR_SPACING) {
+        stars[i].gray = 0.3 * az_rand_udouble(&seed);
+        stars[i].x = xoff + 3 * PLANET_STAR_SPACING * az_rand_udouble(&seed);
+        stars[i].y = yoff + 3 * PLANET_STAR_SPACING * az_rand_udouble(&seed);
+        // Each star twinkles with its own phase, given by its index.
+        stars[i].phase = i;
         ++i;
       }
     }
-  } glEnd();
+    free(planet_star_cache.stars);
+    planet_star_cache.width = width;
+    planet_star_cache.num_stars = num_stars;
+    planet_star_cache.stars = stars;
+    if (az_gfx_backend() == AZ_GFX_CORE) {
+      if (planet_star_cache.starfield != 0u) {
+        az_gfx_delete_starfield(planet_star_cache.starfield);
+      }
+      planet_star_cache.starfield = az_gfx_gen_starfield(num_stars, stars);
+    }
+  }
+  const int num_columns =
+    (width + PLANET_STAR_SPACING - 1) / PLANET_STAR_SPACING;
+  const int num_rows =
+    (AZ_SCREEN_HEIGHT + PLANET_STAR_SPACING - 1) / PLANET_STAR_SPACING;
+  const int num_stars = num_columns * num_rows;
+  assert(num_stars <= planet_star_cache.num_stars);
+  // Each star is a one-pixel-long line, drawn rightwards.
+  const az_gfx_starfield_style_t style = {
+    .tail_length = -1, .tail_gray = 1,
+    .twinkle_gray = 0.02, .twinkle_modulus = 10, .twinkle_slowdown = 4
+  };
+  if (planet_star_cache.starfield != 0u) {
+    // The stars twinkle out of phase with each other, so on the GPU, as with
+    // draw_stars, some star changes on every tick.
+    az_clock_note_change(1, clock);
+    az_gfx_draw_starfield(planet_star_cache.starfield, num_stars, &style,
+                          clock);
+  } else draw_stars(num_stars, planet_star_cache.stars, &style, clock);
 }
 
 void az_draw_planet_starfield(az_clock_t clock) {
@@ -197,20 +312,8 @@ static void draw_zenith_planet_internal(double blacken, double create,
       }
 
       // Draw portal:
-      glBegin(GL_TRIANGLE_FAN); {
-        const GLfloat r = (az_clock_mod(6, 1, clock)     < 3 ? 1.0f : 0.25f);
-        const GLfloat g = (az_clock_mod(6, 1, clock + 2) < 3 ? 1.0f : 0.25f);
-        const GLfloat b = (az_clock_mod(6, 1, clock + 4) < 3 ? 1.0f : 0.25f);
-        glColor4f(r, g, b, 1);
-        glVertex2f(0, 0);
-        glColor4f(r, g, b, 0);
-        const double radius =
-          blacken * (30 + 0.15 * az_clock_zigzag(90, 1, clock));
-        for (int i = 0; i <= 360; i += 10) {
-          glVertex2d(radius * cos(AZ_DEG2RAD(i)),
-                     radius * sin(AZ_DEG2RAD(i)) * 0.8);
-        }
-      } glEnd();
+      draw_portal(blacken * (30 + 0.15 * az_clock_zigzag(90, 1, clock)),
+                  clock);
     }
 
     // Draw the planet itself:
@@ -275,20 +378,8 @@ static void draw_zenith_planet_internal(double blacken, double create,
       }
 
       // Draw portal:
-      glBegin(GL_TRIANGLE_FAN); {
-        const GLfloat r = (az_clock_mod(6, 1, clock)     < 3 ? 1.0f : 0.25f);
-        const GLfloat g = (az_clock_mod(6, 1, clock + 2) < 3 ? 1.0f : 0.25f);
-        const GLfloat b = (az_clock_mod(6, 1, clock + 4) < 3 ? 1.0f : 0.25f);
-        glColor4f(r, g, b, 1);
-        glVertex2f(0, 0);
-        glColor4f(r, g, b, 0);
-        const double radius = 2 * (1 - deform - pow(1 - deform, 4)) *
-          (60 + 0.15 * az_clock_zigzag(30, 1, clock));
-        for (int i = 0; i <= 360; i += 10) {
-          glVertex2d(radius * cos(AZ_DEG2RAD(i)),
-                     radius * sin(AZ_DEG2RAD(i)) * 0.8);
-        }
-      } glEnd();
+      draw_portal(2 * (1 - deform - pow(1 - deform, 4)) *
+                  (60 + 0.15 * az_clock_zigzag(30, 1, clock)), clock);
     }
   } glPopMatrix();
 }
@@ -302,25 +393,38 @@ void az_draw_zenith_planet_formation(double blacken, double create,
   draw_zenith_planet_internal(blacken, create, 0.0, clock);
 }
 
+#define NUM_PLANET_DEBRIS 25
+
+static struct {
+  bool initialized;
+  struct { double cx, cy, size, angle, spin; } rocks[NUM_PLANET_DEBRIS];
+} planet_debris_cache;
+
 void az_draw_planet_debris(az_clock_t clock) {
+  if (!planet_debris_cache.initialized) {
+    az_random_seed_t seed = {1, 1};
+    AZ_ARRAY_LOOP(rock, planet_debris_cache.rocks) {
+      rock->cx = 320 + 300 * az_rand_sdouble(&seed);
+      rock->cy = 240 + 200 * az_rand_sdouble(&seed);
+      rock->size = 2 + 2 * az_rand_udouble(&seed);
+      rock->angle = AZ_PI * az_rand_sdouble(&seed);
+      rock->spin = AZ_DEG2RAD(30) * az_rand_sdouble(&seed);
+    }
+    planet_debris_cache.initialized = true;
+  }
   const az_color_t color = az_color3f(0.5, 0.35, 0.45);
-  az_random_seed_t seed = {1, 1};
-  for (int i = 0; i < 25; ++i) {
-    const double cx = 320 + 300 * az_rand_sdouble(&seed);
-    const double cy = 240 + 200 * az_rand_sdouble(&seed);
-    const double size = 2 + 2 * az_rand_udouble(&seed);
-    const double angle = AZ_PI * az_rand_sdouble(&seed);
-    const double spin = AZ_DEG2RAD(30) * az_rand_sdouble(&seed);
+  AZ_ARRAY_LOOP(rock, planet_debris_cache.rocks) {
     const az_particle_t particle = {
       .kind = AZ_PAR_ROCK,
       .color = color,
       .age = 0.5,
       .lifetime = 1,
-      .param1 = size
+      .param1 = rock->size
     };
     glPushMatrix(); {
-      glTranslated(cx, cy, 0);
-      az_gl_rotated(angle + spin * (clock / 60.0));
+      glTranslated(rock->cx, rock->cy, 0);
+      az_clock_note_change(1, clock);
+      az_gl_rotated(rock->angle + rock->spin * (clock / 60.0));
       az_draw_particle(&particle, clock);
     } glPopMatrix();
   }
@@ -567,20 +671,8 @@ static void draw_oth_scene(const az_cutscene_state_t *cutscene,
       }
     }
     // Draw portal:
-    glBegin(GL_TRIANGLE_FAN); {
-      const GLfloat r = (az_clock_mod(6, 1, clock)     < 3 ? 1.0f : 0.25f);
-      const GLfloat g = (az_clock_mod(6, 1, clock + 2) < 3 ? 1.0f : 0.25f);
-      const GLfloat b = (az_clock_mod(6, 1, clock + 4) < 3 ? 1.0f : 0.25f);
-      glColor4f(r, g, b, 1);
-      glVertex2f(0, 0);
-      glColor4f(r, g, b, 0);
-      const double radius =
-        progress * (80 + 0.25 * az_clock_zigzag(90, 1, clock));
-      for (int i = 0; i <= 360; i += 10) {
-        glVertex2d(radius * cos(AZ_DEG2RAD(i)),
-                   radius * sin(AZ_DEG2RAD(i)) * 0.8);
-      }
-    } glEnd();
+    draw_portal(progress * (80 + 0.25 * az_clock_zigzag(90, 1, clock)),
+                clock);
   } glPopMatrix();
   draw_fg_particles(cutscene, clock);
 }
@@ -597,28 +689,11 @@ static void draw_sapiais_scene(
     const double radius1 = 10;
     const double radius2 = 40;
     const double radius3 = 300 + 10 * glow;
-    glBegin(GL_TRIANGLE_FAN); {
-      glColor3f(1, 1, 1); glVertex2d(0, 0);
-      for (int i = 0; i <= 360; i += 3) {
-        glVertex2d(radius1 * cos(AZ_DEG2RAD(i)), radius1 * sin(AZ_DEG2RAD(i)));
-      }
-    } glEnd();
-    glBegin(GL_TRIANGLE_STRIP); {
-      for (int i = 0; i <= 360; i += 3) {
-        glColor3f(1, 1, 1);
-        glVertex2d(radius1 * cos(AZ_DEG2RAD(i)), radius1 * sin(AZ_DEG2RAD(i)));
-        glColor4f(1, 1, 1, 0.7);
-        glVertex2d(radius2 * cos(AZ_DEG2RAD(i)), radius2 * sin(AZ_DEG2RAD(i)));
-      }
-    } glEnd();
-    glBegin(GL_TRIANGLE_STRIP); {
-      for (int i = 0; i <= 360; i += 3) {
-        glColor4f(1, 1, 1, 0.7);
-        glVertex2d(radius2 * cos(AZ_DEG2RAD(i)), radius2 * sin(AZ_DEG2RAD(i)));
-        glColor4f(1, 1, 1, 0);
-        glVertex2d(radius3 * cos(AZ_DEG2RAD(i)), radius3 * sin(AZ_DEG2RAD(i)));
-      }
-    } glEnd();
+    az_shape_draw_glow(radius1, AZ_WHITE, AZ_WHITE);
+    az_shape_draw_ring(radius1, AZ_WHITE,
+                       radius2, az_color4f(1, 1, 1, 0.7));
+    az_shape_draw_ring(radius2, az_color4f(1, 1, 1, 0.7),
+                       radius3, az_color4f(1, 1, 1, 0));
   } glPopMatrix();
   // Small planet:
   const az_vector_t small_planet_position = {200, 150};
@@ -628,9 +703,7 @@ static void draw_sapiais_scene(
     glBegin(GL_TRIANGLE_FAN); {
       glColor3f(0.5, 0.5, 0.55); glVertex2d(40, -40);
       glColor3f(0.3, 0.3, 0.35);
-      for (int i = 0; i <= 360; i += 3) {
-        glVertex2d(radius * cos(AZ_DEG2RAD(i)), radius * sin(AZ_DEG2RAD(i)));
-      }
+      az_shape_circle(radius);
     } glEnd();
     draw_sapiai_planet_atmosphere(radius, 10 + 5 * glow,
                                   (az_color_t){192, 192, 255, 128});
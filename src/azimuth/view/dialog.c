@@ -23,8 +23,7 @@
 #include <math.h>
 #include <stdbool.h>
 
-#include <SDL_opengl.h>
-
+#include "azimuth/gui/opengl.h"
 #include "azimuth/state/dialog.h"
 #include "azimuth/util/clock.h"
 #include "azimuth/util/color.h"
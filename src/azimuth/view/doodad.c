@@ -21,13 +21,19 @@
 
 #include <assert.h>
 #include <math.h>
+#include <stdbool.h>
 
-#include <SDL_opengl.h>
-
+#include "azimuth/gui/opengl.h"
 #include "azimuth/state/node.h"
+#include "azimuth/util/misc.h"
+#include "azimuth/view/shape.h"
 
 /*===========================================================================*/
 
+// The first of AZ_NUM_DOODAD_KINDS display lists, one per doodad kind, holding
+// the static part of each doodad.
+static GLuint doodad_display_lists_start;
+
 static void gl_gray(GLfloat gray) {
   glColor3f(gray, gray, gray);
 }
@@ -51,13 +57,17 @@ static void draw_drill_spikes(double angle_offset, az_clock_t clock) {
   }
 }
 
-static void draw_drill_shaft(az_clock_t clock) {
-  draw_drill_spikes(AZ_HALF_PI, clock);
+static void draw_drill_shaft_body(void) {
   glBegin(GL_QUAD_STRIP); {
     glColor3f(0.1, 0.1, 0.1); glVertex2d(-50,  30); glVertex2d(50,  30);
     glColor3f(0.4, 0.4, 0.4); glVertex2d(-50,   0); glVertex2d(50,   0);
     glColor3f(0.1, 0.1, 0.1); glVertex2d(-50, -30); glVertex2d(50, -30);
   } glEnd();
+}
+
+static void draw_drill_shaft(az_clock_t clock) {
+  draw_drill_spikes(AZ_HALF_PI, clock);
+  draw_drill_shaft_body();
   draw_drill_spikes(-AZ_HALF_PI, clock);
 }
 
@@ -100,38 +110,31 @@ static void draw_chain_link_pair(void) {
   } glEnd();
 }
 
-void az_draw_doodad(az_doodad_kind_t doodad_kind, az_clock_t clock) {
-  assert(0 <= (int)doodad_kind && (int)doodad_kind < AZ_NUM_DOODAD_KINDS);
+// Draw the parts of a doodad that don't depend on the clock.  This gets
+// compiled into a display list for each doodad kind; az_draw_doodad then draws
+// the animated parts (if any) on top of it.
+static void draw_doodad_static(az_doodad_kind_t doodad_kind) {
   switch (doodad_kind) {
     case AZ_DOOD_WARNING_LIGHT:
-      glPushMatrix(); {
-        glRotatef(-4.0f * az_clock_mod(90, 1, clock), 0, 0, 1);
+      az_shape_draw_glow(4, az_color3f(0.75, 0.75, 0.75),
+                         az_color3f(0.25, 0.25, 0.25));
+      for (int offset = 0; offset <= 180; offset += 180) {
         glBegin(GL_TRIANGLE_FAN); {
-          glColor3f(0.75, 0.75, 0.75);
+          glColor3f(1, 0, 0);
           glVertex2f(0, 0);
-          glColor3f(0.25, 0.25, 0.25);
-          for (int i = 0; i <= 360; i += 30) {
-            glVertex2d(4 * cos(AZ_DEG2RAD(i)), 4 * sin(AZ_DEG2RAD(i)));
+          for (int i = offset - 30; i <= offset + 30; i += 30) {
+            glVertex2d(3 * cos(AZ_DEG2RAD(i)), 3 * sin(AZ_DEG2RAD(i)));
           }
         } glEnd();
-        for (int offset = 0; offset <= 180; offset += 180) {
-          glBegin(GL_TRIANGLE_FAN); {
-            glColor3f(1, 0, 0);
-            glVertex2f(0, 0);
-            for (int i = offset - 30; i <= offset + 30; i += 30) {
-              glVertex2d(3 * cos(AZ_DEG2RAD(i)), 3 * sin(AZ_DEG2RAD(i)));
-            }
-          } glEnd();
-        }
-        glBegin(GL_TRIANGLES); {
-          glColor4f(1, 0, 0, 0);
-          glVertex2f(69, -40); glVertex2f(69, 40);
-          glColor4f(1, 0, 0, 0.5);
-          glVertex2f(0, 0); glVertex2f(0, 0);
-          glColor4f(1, 0, 0, 0);
-          glVertex2f(-69, -40); glVertex2f(-69, 40);
-        } glEnd();
-      } glPopMatrix();
+      }
+      glBegin(GL_TRIANGLES); {
+        glColor4f(1, 0, 0, 0);
+        glVertex2f(69, -40); glVertex2f(69, 40);
+        glColor4f(1, 0, 0, 0.5);
+        glVertex2f(0, 0); glVertex2f(0, 0);
+        glColor4f(1, 0, 0, 0);
+        glVertex2f(-69, -40); glVertex2f(-69, 40);
+      } glEnd();
       break;
     case AZ_DOOD_PIPE_STRAIGHT:
       glBegin(GL_QUAD_STRIP); {
@@ -390,22 +393,8 @@ void az_draw_doodad(az_doodad_kind_t doodad_kind, az_clock_t clock) {
       } glEnd();
       glColor3f(0.15, 0.15, 0.15);
       glBegin(GL_POLYGON); {
-        for (int i = 0; i < 360; i += 15) {
-          glVertex2d(28 * cos(AZ_DEG2RAD(i)), 28 * sin(AZ_DEG2RAD(i)));
-        }
+        az_shape_arc(0, 0, 28, 28, 0, 345, 15);
       } glEnd();
-      glPushMatrix(); {
-        glRotatef(5.0f * az_clock_mod(72, 1, clock), 0, 0, 1);
-        for (int i = 0; i < 5; ++i) {
-          glRotatef(72, 0, 0, 1);
-          glBegin(GL_TRIANGLES); {
-            glColor3f(0.4, 0.4, 0.4);
-            glVertex2f(0, 0); glVertex2f(28, 0);
-            glColor3f(0.2, 0.2, 0.2);
-            glVertex2f(19, 19);
-          } glEnd();
-        }
-      } glPopMatrix();
       break;
     case AZ_DOOD_YELLOW_TUBE_INSIDE:
       glBegin(GL_QUAD_STRIP); {
@@ -440,36 +429,11 @@ void az_draw_doodad(az_doodad_kind_t doodad_kind, az_clock_t clock) {
         glVertex2f(-25, -25); glVertex2f(25, -25); glVertex2f(33, -17);
         glVertex2f(33, 17); glVertex2f(25, 25); glVertex2f(-25, 25);
       } glEnd();
-      // Pistons:
-      for (int i = 0; i < 2; ++i) {
-        glBegin(GL_QUAD_STRIP); {
-          const double pump = (1.0 / 60) * az_clock_mod(60, 1, clock + 30 * i);
-          const GLfloat x = (pump < 0.9 ? pump * 30.0 : (1.0 - pump) * 270.0);
-          const GLfloat y = 20 * i - 10;
-          glColor3f(0.2, 0.2, 0.2);
-          glVertex2f(37, y + 6); glVertex2f(36 + x, y + 6);
-          glColor3f(0.6, 0.6, 0.6); glVertex2f(36, y); glVertex2f(36 + x, y);
-          glColor3f(0.2, 0.2, 0.2);
-          glVertex2f(37, y - 6); glVertex2f(36 + x, y - 6);
-        } glEnd();
-      }
-      // Lights:
+      // Light rims:
       for (int i = -1; i <= 1; i += 2) {
         for (int j = -1; j <= 1; j += 2) {
           glPushMatrix(); {
             glTranslatef(14 * i, 14 * j, 0);
-            // Light bulb:
-            glBegin(GL_TRIANGLE_FAN); {
-              if ((i * j < 0) ^ (az_clock_mod(2, 37, clock) == 0)) {
-                glColor3f(1, 0.25, 0);
-              } else glColor3f(0.2, 0.2, 0.2);
-              glVertex2f(0, 0);
-              glColor3f(0, 0, 0);
-              for (int k = 0; k <= 360; k += 20) {
-                glVertex2d(4 * cos(AZ_DEG2RAD(k)), 4 * sin(AZ_DEG2RAD(k)));
-              }
-            } glEnd();
-            // Rim:
             glBegin(GL_QUAD_STRIP); {
               for (int k = 0; k <= 360; k += 20) {
                 glColor3f(0.45, 0.45, 0.45);
@@ -484,15 +448,7 @@ void az_draw_doodad(az_doodad_kind_t doodad_kind, az_clock_t clock) {
       // Spinner:
       glBegin(GL_TRIANGLE_FAN); {
         glColor3f(0.3, 0.3, 0.3); glVertex2f(0, 0); glColor3f(0, 0, 0);
-        for (int k = 0; k <= 360; k += 90) {
-          glVertex2d(7 * cos(AZ_DEG2RAD(k)), 7 * sin(AZ_DEG2RAD(k)));
-        }
-      } glEnd();
-      glBegin(GL_TRIANGLES); {
-        const int k = -90 * az_clock_mod(8, 14, clock);
-        glColor3f(0.7, 0.7, 0); glVertex2d(0, 0); glColor3f(0.4, 0.4, 0);
-        glVertex2d(6 * cos(AZ_DEG2RAD(k)), 6 * sin(AZ_DEG2RAD(k)));
-        glVertex2d(6 * cos(AZ_DEG2RAD(k + 90)), 6 * sin(AZ_DEG2RAD(k + 90)));
+        az_shape_arc(0, 0, 7, 7, 0, 360, 90);
       } glEnd();
       glBegin(GL_QUAD_STRIP); {
         for (int k = 0; k <= 360; k += 90) {
@@ -513,7 +469,7 @@ void az_draw_doodad(az_doodad_kind_t doodad_kind, az_clock_t clock) {
       draw_drill_shaft(3);
       break;
     case AZ_DOOD_DRILL_SHAFT_SPIN:
-      draw_drill_shaft(clock);
+      draw_drill_shaft_body();
       break;
     case AZ_DOOD_GRASS_TUFT_1:
       glBegin(GL_TRIANGLE_STRIP); {
@@ -710,9 +666,7 @@ void az_draw_doodad(az_doodad_kind_t doodad_kind, az_clock_t clock) {
       glColor4f(0, 0, 0, 0.65);
       glBegin(GL_TRIANGLE_FAN); {
         glVertex2d(0, 0);
-        for (int i = 0; i <= 360; i += 30) {
-          glVertex2d(2.5 * cos(AZ_DEG2RAD(i)), 2.5 * sin(AZ_DEG2RAD(i)));
-        }
+        az_shape_circle(2.5);
       } glEnd();
       for (int j = 60; j < 420; j += 120) {
         glBegin(GL_TRIANGLE_STRIP); {
@@ -740,26 +694,8 @@ void az_draw_doodad(az_doodad_kind_t doodad_kind, az_clock_t clock) {
       } glEnd();
       glBegin(GL_TRIANGLE_FAN); {
         glColor3f(0.3, 0.5, 0); glVertex2f(30, 0); glColor3f(0.1, 0.25, 0);
-        for (int i = -90; i <= 90; i += 30) {
-          glVertex2d(30 + 5 * cos(AZ_DEG2RAD(i)), 3 * sin(AZ_DEG2RAD(i)));
-        }
+        az_shape_arc(30, 0, 5, 3, -90, 90, 30);
       } glEnd();
-      glPushMatrix(); {
-        glTranslatef(-26, 0, 0);
-        for (int i = 0; i < 8; ++i) {
-          glBegin(GL_TRIANGLE_FAN); {
-            glColor3f(0.4, 0.6, 0); glVertex2f(0, 5); glColor3f(0.2, 0.4, 0);
-            glVertex2f(0, 0); glVertex2f(3, 2); glVertex2f(5, 7);
-            glVertex2f(5 + (i % 3) +
-                       0.1 * az_clock_zigzag(15, 2, clock + 4 * i),
-                       15 + ((i + 1) % 3));
-            glVertex2f(-2, 11); glVertex2f(-3, 7);
-            glVertex2f(-1, 2); glVertex2f(0, 0);
-          } glEnd();
-          glTranslatef(6.6 + (i % 2), (i % 3) - 1, 0);
-          glScalef(1, -1, 1);
-        }
-      } glPopMatrix();
       break;
     case AZ_DOOD_RED_TUBE_WINDOW_BEND:
       // Glass:
@@ -864,4 +800,120 @@ void az_draw_doodad(az_doodad_kind_t doodad_kind, az_clock_t clock) {
   }
 }
 
+static void draw_fan_blades(az_clock_t clock) {
+  glPushMatrix(); {
+    glRotatef(5.0f * az_clock_mod(72, 1, clock), 0, 0, 1);
+    for (int i = 0; i < 5; ++i) {
+      glRotatef(72, 0, 0, 1);
+      glBegin(GL_TRIANGLES); {
+        glColor3f(0.4, 0.4, 0.4);
+        glVertex2f(0, 0); glVertex2f(28, 0);
+        glColor3f(0.2, 0.2, 0.2);
+        glVertex2f(19, 19);
+      } glEnd();
+    }
+  } glPopMatrix();
+}
+
+static void draw_nps_engine_moving_parts(az_clock_t clock) {
+  // Pistons:
+  for (int i = 0; i < 2; ++i) {
+    glBegin(GL_QUAD_STRIP); {
+      const double pump = (1.0 / 60) * az_clock_mod(60, 1, clock + 30 * i);
+      const GLfloat x = (pump < 0.9 ? pump * 30.0 : (1.0 - pump) * 270.0);
+      const GLfloat y = 20 * i - 10;
+      glColor3f(0.2, 0.2, 0.2);
+      glVertex2f(37, y + 6); glVertex2f(36 + x, y + 6);
+      glColor3f(0.6, 0.6, 0.6); glVertex2f(36, y); glVertex2f(36 + x, y);
+      glColor3f(0.2, 0.2, 0.2);
+      glVertex2f(37, y - 6); glVertex2f(36 + x, y - 6);
+    } glEnd();
+  }
+  // Light bulbs:
+  for (int i = -1; i <= 1; i += 2) {
+    for (int j = -1; j <= 1; j += 2) {
+      glPushMatrix(); {
+        glTranslatef(14 * i, 14 * j, 0);
+        const bool lit = (i * j < 0) ^ (az_clock_mod(2, 37, clock) == 0);
+        az_shape_draw_glow(4, (lit ? az_color3f(1, 0.25, 0) :
+                               az_color3f(0.2, 0.2, 0.2)),
+                           az_color3f(0, 0, 0));
+      } glPopMatrix();
+    }
+  }
+  // Spinner:
+  glBegin(GL_TRIANGLES); {
+    const int k = -90 * az_clock_mod(8, 14, clock);
+    glColor3f(0.7, 0.7, 0); glVertex2d(0, 0); glColor3f(0.4, 0.4, 0);
+    glVertex2d(6 * cos(AZ_DEG2RAD(k)), 6 * sin(AZ_DEG2RAD(k)));
+    glVertex2d(6 * cos(AZ_DEG2RAD(k + 90)), 6 * sin(AZ_DEG2RAD(k + 90)));
+  } glEnd();
+}
+
+static void draw_vine_leaves(az_clock_t clock) {
+  glPushMatrix(); {
+    glTranslatef(-26, 0, 0);
+    for (int i = 0; i < 8; ++i) {
+      glBegin(GL_TRIANGLE_FAN); {
+        glColor3f(0.4, 0.6, 0); glVertex2f(0, 5); glColor3f(0.2, 0.4, 0);
+        glVertex2f(0, 0); glVertex2f(3, 2); glVertex2f(5, 7);
+        glVertex2f(5 + (i % 3) +
+                   0.1 * az_clock_zigzag(15, 2, clock + 4 * i),
+                   15 + ((i + 1) % 3));
+        glVertex2f(-2, 11); glVertex2f(-3, 7);
+        glVertex2f(-1, 2); glVertex2f(0, 0);
+      } glEnd();
+      glTranslatef(6.6 + (i % 2), (i % 3) - 1, 0);
+      glScalef(1, -1, 1);
+    }
+  } glPopMatrix();
+}
+
+/*===========================================================================*/
+
+void az_init_doodad_drawing(void) {
+  doodad_display_lists_start = glGenLists(AZ_NUM_DOODAD_KINDS);
+  if (doodad_display_lists_start == 0u) {
+    AZ_FATAL("glGenLists failed.\n");
+  }
+  for (int i = 0; i < AZ_NUM_DOODAD_KINDS; ++i) {
+    glNewList(doodad_display_lists_start + i, GL_COMPILE); {
+      draw_doodad_static((az_doodad_kind_t)i);
+    } glEndList();
+  }
+}
+
+void az_draw_doodad(az_doodad_kind_t doodad_kind, az_clock_t clock) {
+  assert(0 <= (int)doodad_kind && (int)doodad_kind < AZ_NUM_DOODAD_KINDS);
+  const GLuint display_list = doodad_display_lists_start + doodad_kind;
+  switch (doodad_kind) {
+    case AZ_DOOD_WARNING_LIGHT:
+      glPushMatrix(); {
+        glRotatef(-4.0f * az_clock_mod(90, 1, clock), 0, 0, 1);
+        glCallList(display_list);
+      } glPopMatrix();
+      break;
+    case AZ_DOOD_MACHINE_FAN:
+      glCallList(display_list);
+      draw_fan_blades(clock);
+      break;
+    case AZ_DOOD_NPS_ENGINE:
+      glCallList(display_list);
+      draw_nps_engine_moving_parts(clock);
+      break;
+    case AZ_DOOD_DRILL_SHAFT_SPIN:
+      draw_drill_spikes(AZ_HALF_PI, clock);
+      glCallList(display_list);
+      draw_drill_spikes(-AZ_HALF_PI, clock);
+      break;
+    case AZ_DOOD_HANGING_VINE:
+      glCallList(display_list);
+      draw_vine_leaves(clock);
+      break;
+    default:
+      glCallList(display_list);
+      break;
+  }
+}
+
 /*===========================================================================*/
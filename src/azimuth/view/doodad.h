@@ -26,6 +26,11 @@
 
 /*===========================================================================*/
 
+// Call this at program startup to initialize drawing of doodads.  This must be
+// called _after_ az_init_gui, and must be called _before_ any calls to
+// az_draw_doodad.
+void az_init_doodad_drawing(void);
+
 // Draw a single doodad.  The GL matrix should be at the doodad's position.
 void az_draw_doodad(az_doodad_kind_t doodad_kind, az_clock_t clock);
 
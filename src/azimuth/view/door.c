@@ -23,14 +23,14 @@
 #include <math.h>
 #include <stdbool.h>
 
-#include <SDL_opengl.h>
-
+#include "azimuth/gui/opengl.h"
 #include "azimuth/state/door.h"
 #include "azimuth/state/space.h"
 #include "azimuth/util/clock.h"
 #include "azimuth/util/color.h"
 #include "azimuth/util/misc.h"
 #include "azimuth/util/vector.h"
+#include "azimuth/view/shape.h"
 #include "azimuth/view/util.h"
 
 /*===========================================================================*/
@@ -129,10 +129,7 @@ static void draw_door_pipe(GLfloat alpha, az_color_t light_color,
         az_gl_color(light_color);
         glVertex2d(16, yc);
         az_gl_color(dim_color);
-        for (int j = 0; j <= 360; j += 30) {
-          glVertex2d(16 + xr * cos(AZ_DEG2RAD(j)),
-                     yc + yr * sin(AZ_DEG2RAD(j)));
-        }
+        az_shape_ellipse(16, yc, xr, yr);
       } glEnd();
     } else {
       glBegin(GL_LINES); {
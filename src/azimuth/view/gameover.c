@@ -24,9 +24,8 @@
 #include <stdbool.h>
 #include <string.h>
 
-#include <SDL_opengl.h>
-
 #include "azimuth/constants.h"
+#include "azimuth/gui/opengl.h"
 #include "azimuth/state/sound.h"
 #include "azimuth/util/audio.h"
 #include "azimuth/util/clock.h"
@@ -22,13 +22,13 @@
 #include <assert.h>
 #include <math.h>
 
-#include <SDL_opengl.h>
-
+#include "azimuth/gui/opengl.h"
 #include "azimuth/state/gravfield.h"
 #include "azimuth/state/space.h"
 #include "azimuth/util/misc.h"
 #include "azimuth/util/random.h"
 #include "azimuth/util/vector.h"
+#include "azimuth/view/shape.h"
 #include "azimuth/view/util.h"
 
 /*===========================================================================*/
@@ -142,13 +142,8 @@ static void draw_lava_bubble(double max_radius, double duration, double period,
     glVertex2f(0, 0);
     glColor4f(0.5, 0.3, 0.2, 0.5 - 0.3 * mod);
     const double radius = max_radius * mod;
-    for (int i = -90; i < 90; i += 10) {
-      glVertex2d(radius * cos(AZ_DEG2RAD(i)), radius * sin(AZ_DEG2RAD(i)));
-    }
-    for (int i = 90; i <= 270; i += 10) {
-      glVertex2d(0.25 * radius * cos(AZ_DEG2RAD(i)),
-                 radius * sin(AZ_DEG2RAD(i)));
-    }
+    az_shape_arc(0, 0, radius, radius, -90, 80, 10);
+    az_shape_arc(0, 0, 0.25 * radius, radius, 90, 270, 10);
   } glEnd();
 }
 
@@ -23,9 +23,8 @@
 #include <math.h>
 #include <string.h>
 
-#include <SDL_opengl.h>
-
 #include "azimuth/constants.h"
+#include "azimuth/gui/opengl.h"
 #include "azimuth/gui/screen.h"
 #include "azimuth/state/dialog.h"
 #include "azimuth/state/ship.h"
@@ -216,32 +215,28 @@ static void draw_minimap_rooms(const az_space_state_t *state) {
       }
     } glEnd();
   }
-  // Draw explored rooms:
+  // Draw explored rooms, skipping any room that is definitely not within the
+  // rectangle of the minimap view:
+  bool rooms_in_view[AZ_MAX_NUM_ROOMS];
   for (int i = 0; i < planet->num_rooms; ++i) {
-    const az_room_t *room = &planet->rooms[i];
-
-    // If the room isn't on our map yet, don't draw it.
-    if (!az_test_room_mapped(player, i, room)) continue;
-    const az_camera_bounds_t *bounds = &room->camera_bounds;
-
-    // If the room is definitely not within the rectangle of the minimap view,
-    // don't bother drawing it.
+    const az_camera_bounds_t *bounds = &planet->rooms[i].camera_bounds;
     const double min_r = bounds->min_r - AZ_SCREEN_HEIGHT/2;
     const double max_r = min_r + bounds->r_span + AZ_SCREEN_HEIGHT;
     if (min_r > camera_rho + MINIMAP_HEIGHT * MINIMAP_ZOOM ||
-        max_r < camera_rho - MINIMAP_HEIGHT * MINIMAP_ZOOM) continue;
+        max_r < camera_rho - MINIMAP_HEIGHT * MINIMAP_ZOOM) {
+      rooms_in_view[i] = false;
+      continue;
+    }
     const double extra_theta_span = camera_theta_span +
       (bounds->min_r <= AZ_SCREEN_RADIUS ? AZ_TWO_PI :
        2.0 * asin(AZ_SCREEN_RADIUS / bounds->min_r));
-    if (az_mod2pi_nonneg(camera_theta -
-                         (bounds->min_theta - 0.5 * extra_theta_span)) >
-        bounds->theta_span + extra_theta_span) continue;
-
-    const bool visited = az_test_room_visited(player, i);
-    az_draw_minimap_room(planet, room, visited, i == player->current_room &&
-                         az_clock_mod(2, 8, state->clock),
-                         state->camera.center);
+    rooms_in_view[i] =
+      (az_mod2pi_nonneg(camera_theta -
+                        (bounds->min_theta - 0.5 * extra_theta_span)) <=
+       bounds->theta_span + extra_theta_span);
   }
+  az_draw_minimap_rooms(planet, player, az_clock_mod(2, 8, state->clock),
+                        state->camera.center, rooms_in_view);
 }
 
 static void draw_map_markers(const az_space_state_t *state) {
@@ -19,11 +19,15 @@
 
 #include "azimuth/view/minimap.h"
 
+#include <assert.h>
 #include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
 
-#include <SDL_opengl.h>
-
+#include "azimuth/constants.h"
+#include "azimuth/gui/opengl.h"
 #include "azimuth/state/planet.h"
+#include "azimuth/state/player.h"
 #include "azimuth/state/room.h"
 #include "azimuth/util/misc.h"
 #include "azimuth/util/vector.h"
@@ -31,10 +35,34 @@
 
 /*===========================================================================*/
 
-void az_draw_minimap_room(
-    const az_planet_t *planet, const az_room_t *room, bool visited, bool blink,
-    az_vector_t camera_center) {
-  const az_camera_bounds_t *bounds = &room->camera_bounds;
+// Each room gets three display lists: its fill in its zone's dimmed color
+// (for rooms that are mapped but not yet visited), its fill in its zone's full
+// color (for visited rooms), and its outline.
+#define DIM_FILL_LIST 0
+#define LIT_FILL_LIST 1
+#define OUTLINE_LIST 2
+#define LISTS_PER_ROOM 3
+
+static const az_planet_t *minimap_planet = NULL;
+static GLuint minimap_display_lists_start = 0u;
+
+// The sequence of display lists to call to draw all mapped rooms, in room
+// order, along with the player map_generation that it was computed from; the
+// sequence only needs to be rebuilt when a room gets visited or a zone gets
+// mapped.
+static struct {
+  bool valid;
+  uint64_t map_generation;
+  int num_lists;
+  GLuint lists[2 * AZ_MAX_NUM_ROOMS];
+  // For each pair of lists in the above array, the room that it draws.
+  az_room_key_t rooms[AZ_MAX_NUM_ROOMS];
+  // For each room, the index into the above array of its fill list, or -1 if
+  // the room is not mapped.
+  int first_list_index[AZ_MAX_NUM_ROOMS];
+} minimap_calls;
+
+static void draw_room_fill(const az_camera_bounds_t *bounds) {
   const double min_r = bounds->min_r - AZ_SCREEN_HEIGHT/2;
   const double max_r = min_r + bounds->r_span + AZ_SCREEN_HEIGHT;
   const double min_theta = bounds->min_theta;
@@ -44,12 +72,6 @@ void az_draw_minimap_room(
   const az_vector_t offset2 =
     az_vpolar(AZ_SCREEN_WIDTH/2, max_theta + AZ_HALF_PI);
   const double step = fmax(AZ_DEG2RAD(0.1), bounds->theta_span * 0.05);
-
-  // Fill room with color:
-  const az_color_t zone_color = planet->zones[room->zone_key].color;
-  if (!visited) {
-    glColor3ub(zone_color.r / 4, zone_color.g / 4, zone_color.b / 4);
-  } else glColor3ub(zone_color.r, zone_color.g, zone_color.b);
   if (bounds->theta_span >= 6.28) {
     glBegin(GL_POLYGON); {
       for (double theta = 0.0; theta < AZ_TWO_PI; theta += step) {
@@ -72,23 +94,18 @@ void az_draw_minimap_room(
                  max_r * sin(max_theta) + offset2.y);
     } glEnd();
   }
+}
 
-  // Blink camera rect:
-  if (blink) {
-    glPushMatrix(); {
-      az_gl_translated(camera_center);
-      az_gl_rotated(az_vtheta(camera_center) + AZ_HALF_PI);
-      glBegin(GL_TRIANGLE_FAN); {
-        glColor3f(0.75, 0.75, 0.75);
-        glVertex2i( AZ_SCREEN_WIDTH/2,  AZ_SCREEN_HEIGHT/2);
-        glVertex2i(-AZ_SCREEN_WIDTH/2,  AZ_SCREEN_HEIGHT/2);
-        glVertex2i(-AZ_SCREEN_WIDTH/2, -AZ_SCREEN_HEIGHT/2);
-        glVertex2i( AZ_SCREEN_WIDTH/2, -AZ_SCREEN_HEIGHT/2);
-      } glEnd();
-    } glPopMatrix();
-  }
-
-  // Draw outline:
+static void draw_room_outline(const az_camera_bounds_t *bounds) {
+  const double min_r = bounds->min_r - AZ_SCREEN_HEIGHT/2;
+  const double max_r = min_r + bounds->r_span + AZ_SCREEN_HEIGHT;
+  const double min_theta = bounds->min_theta;
+  const double max_theta = min_theta + bounds->theta_span;
+  const az_vector_t offset1 =
+    az_vpolar(AZ_SCREEN_WIDTH/2, min_theta - AZ_HALF_PI);
+  const az_vector_t offset2 =
+    az_vpolar(AZ_SCREEN_WIDTH/2, max_theta + AZ_HALF_PI);
+  const double step = fmax(AZ_DEG2RAD(0.1), bounds->theta_span * 0.05);
   glColor3f(0.9, 0.9, 0.9); // white
   glBegin(GL_LINE_LOOP); {
     if (bounds->theta_span >= 6.28) {
@@ -114,6 +131,124 @@ void az_draw_minimap_room(
   }
 }
 
+static void compile_minimap_rooms(const az_planet_t *planet) {
+  assert(minimap_display_lists_start == 0u);
+  minimap_display_lists_start =
+    glGenLists(LISTS_PER_ROOM * planet->num_rooms);
+  if (minimap_display_lists_start == 0u) {
+    AZ_FATAL("glGenLists failed.\n");
+  }
+  for (int i = 0; i < planet->num_rooms; ++i) {
+    const az_room_t *room = &planet->rooms[i];
+    const GLuint first_list = minimap_display_lists_start + LISTS_PER_ROOM * i;
+    const az_color_t zone_color = planet->zones[room->zone_key].color;
+    glNewList(first_list + DIM_FILL_LIST, GL_COMPILE); {
+      glColor3ub(zone_color.r / 4, zone_color.g / 4, zone_color.b / 4);
+      draw_room_fill(&room->camera_bounds);
+    } glEndList();
+    glNewList(first_list + LIT_FILL_LIST, GL_COMPILE); {
+      glColor3ub(zone_color.r, zone_color.g, zone_color.b);
+      draw_room_fill(&room->camera_bounds);
+    } glEndList();
+    glNewList(first_list + OUTLINE_LIST, GL_COMPILE); {
+      draw_room_outline(&room->camera_bounds);
+    } glEndList();
+  }
+  minimap_planet = planet;
+  minimap_calls.valid = false;
+}
+
+static void update_minimap_calls(const az_planet_t *planet,
+                                 const az_player_t *player) {
+  if (minimap_calls.valid &&
+      minimap_calls.map_generation == player->map_generation) return;
+  minimap_calls.map_generation = player->map_generation;
+  minimap_calls.num_lists = 0;
+  for (int i = 0; i < planet->num_rooms; ++i) {
+    const az_room_t *room = &planet->rooms[i];
+    if (!az_test_room_mapped(player, i, room)) {
+      minimap_calls.first_list_index[i] = -1;
+      continue;
+    }
+    const GLuint first_list = minimap_display_lists_start + LISTS_PER_ROOM * i;
+    minimap_calls.first_list_index[i] = minimap_calls.num_lists;
+    minimap_calls.rooms[minimap_calls.num_lists / 2] = i;
+    minimap_calls.lists[minimap_calls.num_lists++] = first_list +
+      (az_test_room_visited(player, i) ? LIT_FILL_LIST : DIM_FILL_LIST);
+    minimap_calls.lists[minimap_calls.num_lists++] = first_list + OUTLINE_LIST;
+  }
+  minimap_calls.valid = true;
+}
+
+static void delete_minimap_rooms(void) {
+  if (minimap_display_lists_start != 0u) {
+    glDeleteLists(minimap_display_lists_start,
+                  LISTS_PER_ROOM * minimap_planet->num_rooms);
+    minimap_display_lists_start = 0u;
+  }
+  minimap_planet = NULL;
+  minimap_calls.valid = false;
+}
+
+void az_init_minimap_drawing(void) {
+  // This is called again (with the same GL context) whenever we switch
+  // to/from fullscreen, so delete the old display lists (if any); they'll be
+  // recompiled on the next call to az_draw_minimap_rooms.
+  delete_minimap_rooms();
+}
+
+void az_draw_minimap_rooms(
+    const az_planet_t *planet, const az_player_t *player, bool blink,
+    az_vector_t camera_center, const bool *rooms_in_view) {
+  assert(planet->num_rooms <= AZ_MAX_NUM_ROOMS);
+  if (minimap_planet != planet) {
+    delete_minimap_rooms();
+    compile_minimap_rooms(planet);
+  }
+  update_minimap_calls(planet, player);
+
+  // If some rooms are out of view, gather the calls for just the others.
+  int num_lists = minimap_calls.num_lists;
+  const GLuint *lists = minimap_calls.lists;
+  int split = (blink ? minimap_calls.first_list_index[
+      player->current_room] : -1);
+  GLuint lists_in_view[2 * AZ_MAX_NUM_ROOMS];
+  if (rooms_in_view != NULL) {
+    num_lists = 0;
+    for (int i = 0; i < minimap_calls.num_lists; i += 2) {
+      const az_room_key_t room = minimap_calls.rooms[i / 2];
+      if (!rooms_in_view[room]) {
+        if (i == split) split = -1;
+        continue;
+      }
+      if (i == split) split = num_lists;
+      lists_in_view[num_lists++] = minimap_calls.lists[i];
+      lists_in_view[num_lists++] = minimap_calls.lists[i + 1];
+    }
+    lists = lists_in_view;
+  }
+
+  // If the current room should blink, we need to draw the camera rect between
+  // that room's fill and its outline, so split the calls around it.
+  if (split < 0) {
+    glCallLists(num_lists, GL_UNSIGNED_INT, lists);
+    return;
+  }
+  glCallLists(split + 1, GL_UNSIGNED_INT, lists);
+  glPushMatrix(); {
+    az_gl_translated(camera_center);
+    az_gl_rotated(az_vtheta(camera_center) + AZ_HALF_PI);
+    glBegin(GL_TRIANGLE_FAN); {
+      glColor3f(0.75, 0.75, 0.75);
+      glVertex2i( AZ_SCREEN_WIDTH/2,  AZ_SCREEN_HEIGHT/2);
+      glVertex2i(-AZ_SCREEN_WIDTH/2,  AZ_SCREEN_HEIGHT/2);
+      glVertex2i(-AZ_SCREEN_WIDTH/2, -AZ_SCREEN_HEIGHT/2);
+      glVertex2i( AZ_SCREEN_WIDTH/2, -AZ_SCREEN_HEIGHT/2);
+    } glEnd();
+  } glPopMatrix();
+  glCallLists(num_lists - (split + 1), GL_UNSIGNED_INT, lists + split + 1);
+}
+
 /*===========================================================================*/
 
 void az_draw_map_marker(az_vector_t center, az_clock_t clock) {
@@ -24,14 +24,28 @@
 #include <stdbool.h>
 
 #include "azimuth/state/planet.h"
-#include "azimuth/state/room.h"
+#include "azimuth/state/player.h"
 #include "azimuth/util/clock.h"
 #include "azimuth/util/vector.h"
 
 /*===========================================================================*/
 
-void az_draw_minimap_room(const az_planet_t *planet, const az_room_t *room,
-                          bool visited, bool blink, az_vector_t camera_center);
+// Delete any compiled minimap geometry.  This must be registered with
+// az_register_gl_init_func, so that the geometry is recompiled whenever the
+// GL state is reset.
+void az_init_minimap_drawing(void);
+
+// Draw every room on the planet that is mapped for the given player.  Room
+// geometry is compiled into display lists the first time this is called for a
+// given planet, and the set of lists to draw is only recomputed when a room
+// gets visited or a zone gets mapped (i.e. when the player's map_generation
+// changes).  If blink is true, also highlight the camera rect within the
+// player's current room.  If rooms_in_view is non-NULL, it is indexed by room
+// key, and rooms for which it is false are skipped.
+void az_draw_minimap_rooms(const az_planet_t *planet,
+                           const az_player_t *player, bool blink,
+                           az_vector_t camera_center,
+                           const bool *rooms_in_view);
 
 void az_draw_map_marker(az_vector_t center, az_clock_t clock);
 
@@ -23,56 +23,201 @@
 #include <math.h>
 #include <stdbool.h>
 
-#include <SDL_opengl.h>
-
+#include "azimuth/gui/opengl.h"
 #include "azimuth/state/node.h"
 #include "azimuth/state/space.h"
 #include "azimuth/state/upgrade.h"
 #include "azimuth/util/misc.h"
 #include "azimuth/view/doodad.h"
+#include "azimuth/view/shape.h"
 #include "azimuth/view/string.h"
 #include "azimuth/view/util.h"
 #include "azimuth/view/wall.h"
 
+// Display lists for the static parts of console, tractor and upgrade nodes,
+// relative to node_display_lists_start.
+#define COMM_PLATFORM_LIST 0
+#define COMM_BODY_LIST 1
+#define REFILL_FRAME_LIST 2
+#define REFILL_ACTIVE_PIPES_LIST 3
+#define REFILL_IDLE_PIPES_LIST 4
+#define SAVE_BASE_LIST 5
+#define SAVE_ARMS_LIST 6
+#define TRACTOR_BASE_LIST 7
+#define EXPLOSIVES_CASING_LIST 8
+#define ARMOR_LIST 9
+#define TANK_LIST 10
+#define NUM_NODE_DISPLAY_LISTS 11
+
+static GLuint node_display_lists_start;
+
 /*===========================================================================*/
 // Consoles:
 
+static void draw_comm_console_platform(void) {
+  glBegin(GL_POLYGON); {
+    glColor3f(0.1, 0.1, 0.1);
+    glVertex2f(26, 16); glVertex2f(26, -16);
+    glVertex2f(-17, -16); glVertex2f(-20, -13);
+    glVertex2f(-20, 13); glVertex2f(-17, 16);
+  } glEnd();
+}
+
+static void draw_comm_console_body(void) {
+  // Port:
+  glBegin(GL_QUAD_STRIP); {
+    glColor3f(0.05, 0.15, 0.05);
+    glVertex2f(26, 3.5); glVertex2f(15, 1.5);
+    glColor3f(0.325, 0.4, 0.325);
+    glVertex2f(26, 0); glVertex2f(15, 0);
+    glColor3f(0.05, 0.15, 0.05);
+    glVertex2f(26, -3.5); glVertex2f(15, -1.5);
+  } glEnd();
+  // Box:
+  glBegin(GL_QUADS); {
+    glColor3f(0.4, 0.4, 0.4);
+    glVertex2f(29, 18); glVertex2f(29, -19);
+    glVertex2f(48, -19); glVertex2f(48, 18);
+  } glEnd();
+  // Siding:
+  glBegin(GL_QUAD_STRIP); {
+    glColor3f(0.4, 0.4, 0.4); glVertex2f(29,  18);
+    glColor3f(0.2, 0.2, 0.2); glVertex2f(26,  21);
+    glColor3f(0.4, 0.4, 0.4); glVertex2f(29, -19);
+    glColor3f(0.2, 0.2, 0.2); glVertex2f(26, -22);
+    glColor3f(0.4, 0.4, 0.4); glVertex2f(48, -19);
+    glColor3f(0.2, 0.2, 0.2); glVertex2f(51, -22);
+    glColor3f(0.4, 0.4, 0.4); glVertex2f(48,  18);
+    glColor3f(0.2, 0.2, 0.2); glVertex2f(51,  21);
+    glColor3f(0.4, 0.4, 0.4); glVertex2f(29,  18);
+    glColor3f(0.2, 0.2, 0.2); glVertex2f(26,  21);
+  } glEnd();
+}
+
+static void draw_refill_console_frame(void) {
+  glBegin(GL_QUAD_STRIP); {
+    glColor3f(0.5, 0.5, 0.5); glVertex2f(25, -20);
+    glColor3f(0.25, 0.25, 0.25); glVertex2f(29, -24);
+    glColor3f(0.5, 0.5, 0.5); glVertex2f(30, 0);
+    glColor3f(0.25, 0.25, 0.25); glVertex2f(35, 0);
+    glColor3f(0.5, 0.5, 0.5); glVertex2f(25, 20);
+    glColor3f(0.25, 0.25, 0.25); glVertex2f(29, 24);
+    glColor3f(0.5, 0.5, 0.5); glVertex2f(-20, 20);
+    glColor3f(0.25, 0.25, 0.25); glVertex2f(-24, 24);
+    glColor3f(0.5, 0.5, 0.5); glVertex2f(-20, -20);
+    glColor3f(0.25, 0.25, 0.25); glVertex2f(-24, -24);
+    glColor3f(0.5, 0.5, 0.5); glVertex2f(25, -20);
+    glColor3f(0.25, 0.25, 0.25); glVertex2f(29, -24);
+  } glEnd();
+}
+
+static void draw_refill_console_pipes(bool active) {
+  for (int i = -1; i <= 1; i += 2) {
+    const int port_inner = (active ? 12 : 15);
+    const int port_outer = port_inner + 12;
+    // Port:
+    glBegin(GL_QUAD_STRIP); {
+      glColor3f(0.05, 0.15, 0.05);
+      glVertex2f(1.5, i * port_outer); glVertex2f(-0.5, i * port_inner);
+      glColor3f(0.325, 0.4, 0.325);
+      glVertex2f(-3, i * port_outer); glVertex2f(-3, i * port_inner);
+      glColor3f(0.05, 0.15, 0.05);
+      glVertex2f(-7.5, i * port_outer); glVertex2f(-5.5, i * port_inner);
+    } glEnd();
+    // Pipe:
+    glBegin(GL_QUAD_STRIP); {
+      glColor3f(0.05, 0.15, 0.05);
+      glVertex2f(1.5, i * port_outer); glVertex2f(1.5, i * 30);
+      glColor3f(0.325, 0.4, 0.325);
+      glVertex2f(-3, i * port_outer); glVertex2f(-3, i * 30);
+      glColor3f(0.05, 0.15, 0.05);
+      glVertex2f(-7.5, i * port_outer); glVertex2f(-7.5, i * 30);
+    } glEnd();
+    // Sub-coupling:
+    glBegin(GL_QUAD_STRIP); {
+      glColor3f(0.1, 0.175, 0.1);
+      glVertex2f(2, i * port_outer); glVertex2f(2, i * (port_outer + 2));
+      glColor3f(0.375, 0.425, 0.375);
+      glVertex2f(-3, i * port_outer); glVertex2f(-3, i * (port_outer + 2));
+      glColor3f(0.1, 0.175, 0.1);
+      glVertex2f(-8, i * port_outer); glVertex2f(-8, i * (port_outer + 2));
+    } glEnd();
+    // Coupling:
+    glBegin(GL_QUAD_STRIP); {
+      glColor3f(0.1, 0.175, 0.1);
+      glVertex2f(3, i * 36); glVertex2f(3, i * 30);
+      glColor3f(0.375, 0.425, 0.375);
+      glVertex2f(-3, i * 36); glVertex2f(-3, i * 30);
+      glColor3f(0.1, 0.175, 0.1);
+      glVertex2f(-9, i * 36); glVertex2f(-9, i * 30);
+    } glEnd();
+  }
+}
+
+static void draw_save_console_base(void) {
+  // Pipe:
+  glBegin(GL_QUAD_STRIP); {
+    glColor3f(0.05, 0.2, 0.05);
+    glVertex2f(-40, 5); glVertex2f(-30, 5);
+    glColor3f(0.325, 0.45, 0.325);
+    glVertex2f(-40, 0); glVertex2f(-30, 0);
+    glColor3f(0.05, 0.2, 0.05);
+    glVertex2f(-40, -5); glVertex2f(-30, -5);
+  } glEnd();
+  // Coupling:
+  glBegin(GL_QUAD_STRIP); {
+    glColor3f(0.1, 0.175, 0.1);
+    glVertex2f(-46, 6); glVertex2f(-40, 6);
+    glColor3f(0.375, 0.425, 0.375);
+    glVertex2f(-46, 0); glVertex2f(-40, 0);
+    glColor3f(0.1, 0.175, 0.1);
+    glVertex2f(-46, -6); glVertex2f(-40, -6);
+  } glEnd();
+  // Port:
+  glBegin(GL_QUAD_STRIP); {
+    glColor3f(0.05, 0.15, 0.05);
+    glVertex2f(-24, 4.5); glVertex2f(-12, 2.5);
+    glColor3f(0.325, 0.4, 0.325);
+    glVertex2f(-24, 0); glVertex2f(-12, 0);
+    glColor3f(0.05, 0.15, 0.05);
+    glVertex2f(-24, -4.5); glVertex2f(-12, -2.5);
+  } glEnd();
+  // Connecting strut:
+  glBegin(GL_QUADS); {
+    glColor3f(0.35, 0.35, 0.35);
+    glVertex2f(-24, 21); glVertex2f(-30, 21);
+    glVertex2f(-30, -21); glVertex2f(-24, -21);
+  } glEnd();
+}
+
+static void draw_save_console_arms(void) {
+  glBegin(GL_QUADS); {
+    // Top arm:
+    glColor3f(0.25, 0.25, 0.25);
+    glVertex2f(-25, 30); glVertex2f(25, 30);
+    glColor3f(0.75, 0.75, 0.75);
+    glVertex2f(35, 20); glVertex2f(-35, 20);
+    // Bottom arm:
+    glVertex2f(35, -20); glVertex2f(-35, -20);
+    glColor3f(0.25, 0.25, 0.25);
+    glVertex2f(-25, -30); glVertex2f(25, -30);
+  } glEnd();
+}
+
 static void draw_console(const az_node_t *node, az_clock_t clock) {
   assert(node->kind == AZ_NODE_CONSOLE);
   switch (node->subkind.console) {
     case AZ_CONS_COMM:
-      // Platform:
-      glBegin(GL_POLYGON); {
-        glColor3f(0.1, 0.1, 0.1);
-        glVertex2f(26, 16); glVertex2f(26, -16);
-        glVertex2f(-17, -16); glVertex2f(-20, -13);
-        glVertex2f(-20, 13); glVertex2f(-17, 16);
-      } glEnd();
+      glCallList(node_display_lists_start + COMM_PLATFORM_LIST);
       // Glow:
-      glBegin(GL_TRIANGLE_FAN); {
-        if (node->status == AZ_NS_READY) glColor4f(1, 1, 0.5, 0.3);
-        else glColor4f(1, 1, 1, 0.1);
-        glVertex2f(0, 0);
-        glColor4f(1, 1, 1, 0);
-        const double radius = 10 + az_clock_zigzag(6, 6, clock);
-        for (int i = 0; i <= 360; i += 30) {
-          glVertex2d(radius * cos(AZ_DEG2RAD(i)), radius * sin(AZ_DEG2RAD(i)));
-        }
-      } glEnd();
-      // Port:
-      glBegin(GL_QUAD_STRIP); {
-        glColor3f(0.05, 0.15, 0.05);
-        glVertex2f(26, 3.5); glVertex2f(15, 1.5);
-        glColor3f(0.325, 0.4, 0.325);
-        glVertex2f(26, 0); glVertex2f(15, 0);
-        glColor3f(0.05, 0.15, 0.05);
-        glVertex2f(26, -3.5); glVertex2f(15, -1.5);
-      } glEnd();
-      // Box:
+      az_shape_draw_glow(10 + az_clock_zigzag(6, 6, clock),
+                         (node->status == AZ_NS_READY ?
+                          az_color4f(1, 1, 0.5, 0.3) :
+                          az_color4f(1, 1, 1, 0.1)),
+                         az_color4f(1, 1, 1, 0));
+      glCallList(node_display_lists_start + COMM_BODY_LIST);
+      // Lights:
       glBegin(GL_QUADS); {
-        glColor3f(0.4, 0.4, 0.4);
-        glVertex2f(29, 18); glVertex2f(29, -19);
-        glVertex2f(48, -19); glVertex2f(48, 18);
         const int slowdown = (node->status == AZ_NS_ACTIVE ? 6 : 16);
         for (int i = 0; i < 3; ++i) {
           const int size = 5;
@@ -92,36 +237,9 @@ static void draw_console(const az_node_t *node, az_clock_t clock) {
           }
         }
       } glEnd();
-      // Siding:
-      glBegin(GL_QUAD_STRIP); {
-        glColor3f(0.4, 0.4, 0.4); glVertex2f(29,  18);
-        glColor3f(0.2, 0.2, 0.2); glVertex2f(26,  21);
-        glColor3f(0.4, 0.4, 0.4); glVertex2f(29, -19);
-        glColor3f(0.2, 0.2, 0.2); glVertex2f(26, -22);
-        glColor3f(0.4, 0.4, 0.4); glVertex2f(48, -19);
-        glColor3f(0.2, 0.2, 0.2); glVertex2f(51, -22);
-        glColor3f(0.4, 0.4, 0.4); glVertex2f(48,  18);
-        glColor3f(0.2, 0.2, 0.2); glVertex2f(51,  21);
-        glColor3f(0.4, 0.4, 0.4); glVertex2f(29,  18);
-        glColor3f(0.2, 0.2, 0.2); glVertex2f(26,  21);
-      } glEnd();
       break;
     case AZ_CONS_REFILL:
-      // Frame:
-      glBegin(GL_QUAD_STRIP); {
-        glColor3f(0.5, 0.5, 0.5); glVertex2f(25, -20);
-        glColor3f(0.25, 0.25, 0.25); glVertex2f(29, -24);
-        glColor3f(0.5, 0.5, 0.5); glVertex2f(30, 0);
-        glColor3f(0.25, 0.25, 0.25); glVertex2f(35, 0);
-        glColor3f(0.5, 0.5, 0.5); glVertex2f(25, 20);
-        glColor3f(0.25, 0.25, 0.25); glVertex2f(29, 24);
-        glColor3f(0.5, 0.5, 0.5); glVertex2f(-20, 20);
-        glColor3f(0.25, 0.25, 0.25); glVertex2f(-24, 24);
-        glColor3f(0.5, 0.5, 0.5); glVertex2f(-20, -20);
-        glColor3f(0.25, 0.25, 0.25); glVertex2f(-24, -24);
-        glColor3f(0.5, 0.5, 0.5); glVertex2f(25, -20);
-        glColor3f(0.25, 0.25, 0.25); glVertex2f(29, -24);
-      } glEnd();
+      glCallList(node_display_lists_start + REFILL_FRAME_LIST);
       // Glow:
       if (node->status == AZ_NS_ACTIVE) {
         glColor4f(1, 1, 0, 0.1f + 0.03f * az_clock_zigzag(6, 3, clock));
@@ -155,81 +273,14 @@ static void draw_console(const az_node_t *node, az_clock_t clock) {
         } glEnd();
       }
       // Pipes:
-      for (int i = -1; i <= 1; i += 2) {
-        const int port_inner = (node->status == AZ_NS_ACTIVE ? 12 : 15);
-        const int port_outer = port_inner + 12;
-        // Port:
-        glBegin(GL_QUAD_STRIP); {
-          glColor3f(0.05, 0.15, 0.05);
-          glVertex2f(1.5, i * port_outer); glVertex2f(-0.5, i * port_inner);
-          glColor3f(0.325, 0.4, 0.325);
-          glVertex2f(-3, i * port_outer); glVertex2f(-3, i * port_inner);
-          glColor3f(0.05, 0.15, 0.05);
-          glVertex2f(-7.5, i * port_outer); glVertex2f(-5.5, i * port_inner);
-        } glEnd();
-        // Pipe:
-        glBegin(GL_QUAD_STRIP); {
-          glColor3f(0.05, 0.15, 0.05);
-          glVertex2f(1.5, i * port_outer); glVertex2f(1.5, i * 30);
-          glColor3f(0.325, 0.4, 0.325);
-          glVertex2f(-3, i * port_outer); glVertex2f(-3, i * 30);
-          glColor3f(0.05, 0.15, 0.05);
-          glVertex2f(-7.5, i * port_outer); glVertex2f(-7.5, i * 30);
-        } glEnd();
-        // Sub-coupling:
-        glBegin(GL_QUAD_STRIP); {
-          glColor3f(0.1, 0.175, 0.1);
-          glVertex2f(2, i * port_outer); glVertex2f(2, i * (port_outer + 2));
-          glColor3f(0.375, 0.425, 0.375);
-          glVertex2f(-3, i * port_outer); glVertex2f(-3, i * (port_outer + 2));
-          glColor3f(0.1, 0.175, 0.1);
-          glVertex2f(-8, i * port_outer); glVertex2f(-8, i * (port_outer + 2));
-        } glEnd();
-        // Coupling:
-        glBegin(GL_QUAD_STRIP); {
-          glColor3f(0.1, 0.175, 0.1);
-          glVertex2f(3, i * 36); glVertex2f(3, i * 30);
-          glColor3f(0.375, 0.425, 0.375);
-          glVertex2f(-3, i * 36); glVertex2f(-3, i * 30);
-          glColor3f(0.1, 0.175, 0.1);
-          glVertex2f(-9, i * 36); glVertex2f(-9, i * 30);
-        } glEnd();
-      }
+      glCallList(node_display_lists_start +
+                 (node->status == AZ_NS_ACTIVE ? REFILL_ACTIVE_PIPES_LIST :
+                  REFILL_IDLE_PIPES_LIST));
       break;
     case AZ_CONS_SAVE:
-      // Pipe:
-      glBegin(GL_QUAD_STRIP); {
-        glColor3f(0.05, 0.2, 0.05);
-        glVertex2f(-40, 5); glVertex2f(-30, 5);
-        glColor3f(0.325, 0.45, 0.325);
-        glVertex2f(-40, 0); glVertex2f(-30, 0);
-        glColor3f(0.05, 0.2, 0.05);
-        glVertex2f(-40, -5); glVertex2f(-30, -5);
-      } glEnd();
-      // Coupling:
-      glBegin(GL_QUAD_STRIP); {
-        glColor3f(0.1, 0.175, 0.1);
-        glVertex2f(-46, 6); glVertex2f(-40, 6);
-        glColor3f(0.375, 0.425, 0.375);
-        glVertex2f(-46, 0); glVertex2f(-40, 0);
-        glColor3f(0.1, 0.175, 0.1);
-        glVertex2f(-46, -6); glVertex2f(-40, -6);
-      } glEnd();
-      // Port:
-      glBegin(GL_QUAD_STRIP); {
-        glColor3f(0.05, 0.15, 0.05);
-        glVertex2f(-24, 4.5); glVertex2f(-12, 2.5);
-        glColor3f(0.325, 0.4, 0.325);
-        glVertex2f(-24, 0); glVertex2f(-12, 0);
-        glColor3f(0.05, 0.15, 0.05);
-        glVertex2f(-24, -4.5); glVertex2f(-12, -2.5);
-      } glEnd();
+      glCallList(node_display_lists_start + SAVE_BASE_LIST);
+      // Glow:
       glBegin(GL_QUADS); {
-        // Connecting strut:
-        glColor3f(0.35, 0.35, 0.35);
-        glVertex2f(-24, 21); glVertex2f(-30, 21);
-        glVertex2f(-30, -21); glVertex2f(-24, -21);
-        // Glow:
         if (node->status == AZ_NS_ACTIVE) {
           if (az_clock_mod(2, 5, clock)) glColor4f(1, 1, 0.5, 0.5);
           else glColor4f(0.5, 1, 1, 0.5);
@@ -246,16 +297,8 @@ static void draw_console(const az_node_t *node, az_clock_t clock) {
           glColor4f(1, 1, 1, 0);
           glVertex2f(35, -20 + ampl); glVertex2f(-35, -20 + ampl);
         }
-        // Top arm:
-        glColor3f(0.25, 0.25, 0.25);
-        glVertex2f(-25, 30); glVertex2f(25, 30);
-        glColor3f(0.75, 0.75, 0.75);
-        glVertex2f(35, 20); glVertex2f(-35, 20);
-        // Bottom arm:
-        glVertex2f(35, -20); glVertex2f(-35, -20);
-        glColor3f(0.25, 0.25, 0.25);
-        glVertex2f(-25, -30); glVertex2f(25, -30);
       } glEnd();
+      glCallList(node_display_lists_start + SAVE_ARMS_LIST);
       break;
   }
 }
@@ -263,7 +306,7 @@ static void draw_console(const az_node_t *node, az_clock_t clock) {
 /*===========================================================================*/
 // Tractor nodes:
 
-static void draw_tractor_node(az_node_status_t status, az_clock_t clock) {
+static void draw_tractor_node_base(void) {
   for (int i = 0; i < 3; ++i) {
     glBegin(GL_QUAD_STRIP); {
       glColor3f(0.25, 0.25, 0.25);
@@ -277,14 +320,12 @@ static void draw_tractor_node(az_node_status_t status, az_clock_t clock) {
     } glEnd();
     glRotatef(120, 0, 0, 1);
   }
-  glBegin(GL_TRIANGLE_FAN); {
-    glColor3f(0.75, 0.75, 0.75);
-    glVertex2f(0, 0);
-    glColor3f(0.35, 0.35, 0.35);
-    for (int i = 0; i <= 360; i += 30) {
-      glVertex2d(6 * cos(AZ_DEG2RAD(i)), 6 * sin(AZ_DEG2RAD(i)));
-    }
-  } glEnd();
+  az_shape_draw_glow(6, az_color3f(0.75, 0.75, 0.75),
+                     az_color3f(0.35, 0.35, 0.35));
+}
+
+static void draw_tractor_node(az_node_status_t status, az_clock_t clock) {
+  glCallList(node_display_lists_start + TRACTOR_BASE_LIST);
   glBegin(GL_TRIANGLE_FAN); {
     switch (status) {
       case AZ_NS_FAR: glColor3f(0, 0, 0); break;
@@ -297,17 +338,14 @@ static void draw_tractor_node(az_node_status_t status, az_clock_t clock) {
     }
     glVertex2f(0, 0);
     glColor4f(0, 0, 0, 0);
-    for (int i = 0; i <= 360; i += 30) {
-      glVertex2d(4 * cos(AZ_DEG2RAD(i)), 4 * sin(AZ_DEG2RAD(i)));
-    }
+    az_shape_circle(4);
   } glEnd();
 }
 
 /*===========================================================================*/
 // Upgrades:
 
-// Helper function for drawing upgrade icons for explosives upgrades.
-static void draw_explosives_casing(void) {
+static void draw_explosives_casing_geometry(void) {
   glBegin(GL_QUAD_STRIP); {
     glColor3f(0.25, 0.2, 0.2);
     glVertex2f(-6, 10); glVertex2f(-6, -10);
@@ -325,8 +363,7 @@ static void draw_explosives_casing(void) {
   } glEnd();
 }
 
-// Helper function for drawing upgrade icons for armor upgrades.
-static void draw_armor(void) {
+static void draw_armor_geometry(void) {
   glBegin(GL_TRIANGLE_FAN); {
     glColor3f(0.75, 0.75, 0.75);
     glVertex2f(0, 0);
@@ -337,9 +374,7 @@ static void draw_armor(void) {
   } glEnd();
 }
 
-// Helper function for drawing upgrade icons for capacitors and shield
-// batteries.
-static void draw_tank(void) {
+static void draw_tank_geometry(void) {
   glBegin(GL_QUAD_STRIP); {
     glColor3f(0.2, 0.2, 0.2);
     glVertex2f(-7, 9); glVertex2f(7, 9);
@@ -360,6 +395,22 @@ static void draw_tank(void) {
   }
 }
 
+// Helper function for drawing upgrade icons for explosives upgrades.
+static void draw_explosives_casing(void) {
+  glCallList(node_display_lists_start + EXPLOSIVES_CASING_LIST);
+}
+
+// Helper function for drawing upgrade icons for armor upgrades.
+static void draw_armor(void) {
+  glCallList(node_display_lists_start + ARMOR_LIST);
+}
+
+// Helper function for drawing upgrade icons for capacitors and shield
+// batteries.
+static void draw_tank(void) {
+  glCallList(node_display_lists_start + TANK_LIST);
+}
+
 void az_draw_upgrade_icon(az_upgrade_t upgrade, az_clock_t clock) {
   const int frame = az_clock_mod(4, 10, clock);
   switch (upgrade) {
@@ -446,10 +497,7 @@ void az_draw_upgrade_icon(az_upgrade_t upgrade, az_clock_t clock) {
         glVertex2d(-10, -10);
         glColor3f(1, 1, 0.5);
         const double radius = 10.0 + 4.5 * frame;
-        for (int i = 15; i <= 75; i += 15) {
-          glVertex2d(radius * cos(AZ_DEG2RAD(i)) - 12,
-                     radius * sin(AZ_DEG2RAD(i)) - 12);
-        }
+        az_shape_arc(-12, -12, radius, radius, 15, 75, 15);
       } glEnd();
       break;
     case AZ_UPG_GUN_BURST:
@@ -569,14 +617,8 @@ void az_draw_upgrade_icon(az_upgrade_t upgrade, az_clock_t clock) {
       break;
     case AZ_UPG_ATTUNED_EXPLOSIVES:
       draw_explosives_casing();
-      glBegin(GL_TRIANGLE_FAN); {
-        glColor3f(1, 1, 1); glVertex2f(0, 0);
-        const double radius = 6 + 0.95 * (frame == 3 ? 1 : frame);
-        glColor4f(0, 0.5, 1, 0.5);
-        for (int i = 0; i <= 360; i += 10) {
-          glVertex2d(radius * cos(AZ_DEG2RAD(i)), radius * sin(AZ_DEG2RAD(i)));
-        }
-      } glEnd();
+      az_shape_draw_glow(6 + 0.95 * (frame == 3 ? 1 : frame), AZ_WHITE,
+                         az_color4f(0, 0.5, 1, 0.5));
       break;
     case AZ_UPG_RETRO_THRUSTERS:
       glBegin(GL_TRIANGLE_FAN); {
@@ -620,16 +662,10 @@ void az_draw_upgrade_icon(az_upgrade_t upgrade, az_clock_t clock) {
       glPushMatrix(); {
         glTranslatef(3, -3, 0);
         glRotatef(-45, 0, 0, 1);
-        glBegin(GL_TRIANGLE_FAN); {
-          glColor4f(0.5, 0.75, 1, 0.3);
-          glVertex2f(0, 0);
-          glColor4f(1, 1, 1, 0.7);
-          const double radius = 2.5 * (frame + 1);
-          for (int i = 0; i <= 360; i += 20) {
-            glVertex2d(radius * cos(AZ_DEG2RAD(i)),
-                       0.7 * radius * sin(AZ_DEG2RAD(i)));
-          }
-        } glEnd();
+        const double radius = 2.5 * (frame + 1);
+        az_shape_draw_ellipse_glow(0, 0, radius, 0.7 * radius,
+                                   az_color4f(0.5, 0.75, 1, 0.3),
+                                   az_color4f(1, 1, 1, 0.7));
       } glPopMatrix();
       break;
     case AZ_UPG_HARDENED_ARMOR:
@@ -677,33 +713,19 @@ void az_draw_upgrade_icon(az_upgrade_t upgrade, az_clock_t clock) {
         glRotatef(215.0f + 22.5f * frame, 0, 0, 1);
         glColor4f(1, 1, 1, 0.5);
         glBegin(GL_LINE_STRIP); {
-          for (int i = 0; i <= 180; i += 20) {
-            glVertex2d(12 * cos(AZ_DEG2RAD(i)), spin1 * sin(AZ_DEG2RAD(i)));
-          }
+          az_shape_arc(0, 0, 12, spin1, 0, 180, 20);
         } glEnd();
         glBegin(GL_LINE_STRIP); {
-          for (int i = -90; i <= 90; i += 20) {
-            glVertex2d(spin2 * cos(AZ_DEG2RAD(i)), 12 * sin(AZ_DEG2RAD(i)));
-          }
-        } glEnd();
-        glBegin(GL_TRIANGLE_FAN); {
-          glColor3f(1, 0.25, 0);
-          glVertex2f(0, 0);
-          glColor3f(0.3, 0.07, 0);
-          for (int i = 0; i <= 360; i += 20) {
-            glVertex2d(5.5 * cos(AZ_DEG2RAD(i)), 5.5 * sin(AZ_DEG2RAD(i)));
-          }
+          az_shape_arc(0, 0, spin2, 12, -90, 90, 20);
         } glEnd();
+        az_shape_draw_glow(5.5, az_color3f(1, 0.25, 0),
+                           az_color3f(0.3, 0.07, 0));
         glColor4f(1, 1, 1, 0.5);
         glBegin(GL_LINE_STRIP); {
-          for (int i = 180; i <= 360; i += 20) {
-            glVertex2d(12 * cos(AZ_DEG2RAD(i)), spin1 * sin(AZ_DEG2RAD(i)));
-          }
+          az_shape_arc(0, 0, 12, spin1, 180, 360, 20);
         } glEnd();
         glBegin(GL_LINE_STRIP); {
-          for (int i = 90; i <= 270; i += 20) {
-            glVertex2d(spin2 * cos(AZ_DEG2RAD(i)), 12 * sin(AZ_DEG2RAD(i)));
-          }
+          az_shape_arc(0, 0, spin2, 12, 90, 270, 20);
         } glEnd();
       } glPopMatrix();
       break;
@@ -753,15 +775,11 @@ void az_draw_upgrade_icon(az_upgrade_t upgrade, az_clock_t clock) {
         glColor4f(0.5, 0, 1, 0.75);
         glVertex2f(0, 0);
         glColor4f(0.5, 0, 1, 0.1);
-        for (int i = 0; i <= 360; i += 60) {
-          glVertex2d(r * cos(AZ_DEG2RAD(i)), r * sin(AZ_DEG2RAD(i)));
-        }
+        az_shape_arc(0, 0, r, r, 0, 360, 60);
       } glEnd();
       glBegin(GL_LINE_LOOP); {
         glColor4f(0.5, 0, 1, 0.9);
-        for (int i = 0; i < 360; i += 60) {
-          glVertex2d(r * cos(AZ_DEG2RAD(i)), r * sin(AZ_DEG2RAD(i)));
-        }
+        az_shape_arc(0, 0, r, r, 0, 300, 60);
       } glEnd();
     } break;
     case AZ_UPG_INFRASCANNER:
@@ -787,16 +805,11 @@ void az_draw_upgrade_icon(az_upgrade_t upgrade, az_clock_t clock) {
         glVertex2f(outer, 0);
       } glEnd();
       break;
-    case AZ_UPG_MAGNET_SWEEP:
-      glBegin(GL_TRIANGLE_FAN); {
-        const double scale = 1 - (0.33 * (frame == 3 ? 1 : frame));
-        glColor4f(1, 1, 0.5, 0.5); glVertex2f(0, 8);
-        glColor4f(1, 1, 0.5, 0);
-        for (int i = 0; i <= 360; i += 30) {
-          glVertex2d(8 * scale * cos(AZ_DEG2RAD(i)),
-                     5 * scale * sin(AZ_DEG2RAD(i)) + 8);
-        }
-      } glEnd();
+    case AZ_UPG_MAGNET_SWEEP: {
+      const double scale = 1 - (0.33 * (frame == 3 ? 1 : frame));
+      az_shape_draw_ellipse_glow(0, 8, 8 * scale, 5 * scale,
+                                 az_color4f(1, 1, 0.5, 0.5),
+                                 az_color4f(1, 1, 0.5, 0));
       glBegin(GL_TRIANGLE_STRIP); {
         for (int i = -200; i <= 20; i += 20) {
           const double c = cos(AZ_DEG2RAD(i)), s = sin(AZ_DEG2RAD(i));
@@ -814,16 +827,10 @@ void az_draw_upgrade_icon(az_upgrade_t upgrade, az_clock_t clock) {
           glVertex2f(i * 3.9, -2.3);
         }
       } glEnd();
-      break;
+    } break;
     case AZ_UPG_MILLIWAVE_RADAR:
-      glBegin(GL_TRIANGLE_FAN); {
-        glColor3f(1, 1, 1); glVertex2f(0, 0);
-        glColor4f(1, (frame < 2 ? 0.5f : 0.0f), 0, 0);
-        const double radius = (frame < 2 ? 5 : 4);
-        for (int i = 0; i <= 360; i += 30) {
-          glVertex2d(radius * cos(AZ_DEG2RAD(i)), radius * sin(AZ_DEG2RAD(i)));
-        }
-      } glEnd();
+      az_shape_draw_glow((frame < 2 ? 5 : 4), AZ_WHITE,
+                         az_color4f(1, (frame < 2 ? 0.5f : 0.0f), 0, 0));
       glPushMatrix(); {
         for (int i = 0; i < 8; ++i) {
           const bool bright = (i % 4 == frame);
@@ -993,6 +1000,49 @@ static void draw_upgrade(az_upgrade_t upgrade, az_clock_t clock) {
 
 /*===========================================================================*/
 
+void az_init_node_drawing(void) {
+  node_display_lists_start = glGenLists(NUM_NODE_DISPLAY_LISTS);
+  if (node_display_lists_start == 0u) {
+    AZ_FATAL("glGenLists failed.\n");
+  }
+  glNewList(node_display_lists_start + COMM_PLATFORM_LIST, GL_COMPILE); {
+    draw_comm_console_platform();
+  } glEndList();
+  glNewList(node_display_lists_start + COMM_BODY_LIST, GL_COMPILE); {
+    draw_comm_console_body();
+  } glEndList();
+  glNewList(node_display_lists_start + REFILL_FRAME_LIST, GL_COMPILE); {
+    draw_refill_console_frame();
+  } glEndList();
+  glNewList(node_display_lists_start + REFILL_ACTIVE_PIPES_LIST,
+            GL_COMPILE); {
+    draw_refill_console_pipes(true);
+  } glEndList();
+  glNewList(node_display_lists_start + REFILL_IDLE_PIPES_LIST, GL_COMPILE); {
+    draw_refill_console_pipes(false);
+  } glEndList();
+  glNewList(node_display_lists_start + SAVE_BASE_LIST, GL_COMPILE); {
+    draw_save_console_base();
+  } glEndList();
+  glNewList(node_display_lists_start + SAVE_ARMS_LIST, GL_COMPILE); {
+    draw_save_console_arms();
+  } glEndList();
+  glNewList(node_display_lists_start + TRACTOR_BASE_LIST, GL_COMPILE); {
+    draw_tractor_node_base();
+  } glEndList();
+  glNewList(node_display_lists_start + EXPLOSIVES_CASING_LIST, GL_COMPILE); {
+    draw_explosives_casing_geometry();
+  } glEndList();
+  glNewList(node_display_lists_start + ARMOR_LIST, GL_COMPILE); {
+    draw_armor_geometry();
+  } glEndList();
+  glNewList(node_display_lists_start + TANK_LIST, GL_COMPILE); {
+    draw_tank_geometry();
+  } glEndList();
+}
+
+/*===========================================================================*/
+
 static void draw_node_internal(const az_node_t *node, az_clock_t clock) {
   switch (node->kind) {
     case AZ_NODE_NOTHING: AZ_ASSERT_UNREACHABLE();
@@ -27,6 +27,11 @@
 
 /*===========================================================================*/
 
+// Call this at program startup to initialize drawing of nodes.  This must be
+// called _after_ az_init_gui, and must be called _before_ any calls to
+// az_draw_node, az_draw_upgrade_icon, or the az_draw_*_nodes functions.
+void az_init_node_drawing(void);
+
 void az_draw_upgrade_icon(const az_upgrade_t upgrade, az_clock_t clock);
 
 // Draw a single node.  The GL matrix should be at the camera position.
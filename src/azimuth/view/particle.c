@@ -24,8 +24,8 @@
 #include <stdbool.h>
 #include <stdint.h>
 
-#include <SDL_opengl.h>
-
+#include "azimuth/gui/gfx.h"
+#include "azimuth/gui/opengl.h"
 #include "azimuth/state/particle.h"
 #include "azimuth/state/space.h"
 #include "azimuth/util/clock.h"
@@ -33,24 +33,24 @@
 #include "azimuth/util/random.h"
 #include "azimuth/util/vector.h"
 #include "azimuth/view/baddie_oth.h"
+#include "azimuth/view/shape.h"
 #include "azimuth/view/util.h"
 
 /*===========================================================================*/
 
+static az_color_t scale_alpha(az_color_t color, double alpha_factor) {
+  color.a *= alpha_factor;
+  return color;
+}
+
 static void with_color_alpha(az_color_t color, double alpha_factor) {
-  glColor4ub(color.r, color.g, color.b, color.a * alpha_factor);
+  az_gl_color(scale_alpha(color, alpha_factor));
 }
 
 static void draw_bolt_glowball(az_color_t color, double cx, az_clock_t clock) {
-  glBegin(GL_TRIANGLE_FAN); {
-    glColor4f(1, 1, 1, 0.75);
-    glVertex2d(cx, 0);
-    with_color_alpha(color, 0);
-    const double rad = 8 + az_clock_zigzag(5, 8, clock);
-    for (int i = 0; i <= 360; i += 30) {
-      glVertex2d(rad * cos(AZ_DEG2RAD(i)) + cx, rad * sin(AZ_DEG2RAD(i)));
-    }
-  } glEnd();
+  const double rad = 8 + az_clock_zigzag(5, 8, clock);
+  az_shape_draw_ellipse_glow(cx, 0, rad, rad, az_color4f(1, 1, 1, 0.75),
+                             scale_alpha(color, 0));
 }
 
 /*===========================================================================*/
@@ -91,11 +91,8 @@ void az_draw_particle(const az_particle_t *particle, az_clock_t clock) {
         with_color_alpha(particle->color, alpha);
         glVertex2d(particle->param1, 0);
         with_color_alpha(particle->color, 0);
-        for (int i = -90; i <= 90; i += 30) {
-          glVertex2d(particle->param1 +
-                     particle->param2 * cos(AZ_DEG2RAD(i)) * 0.75,
-                     particle->param2 * sin(AZ_DEG2RAD(i)));
-        }
+        az_shape_arc(particle->param1, 0, 0.75 * particle->param2,
+                     particle->param2, -90, 90, 30);
       } glEnd();
     } break;
     case AZ_PAR_CHARGED_BOOM: {
@@ -124,16 +121,9 @@ void az_draw_particle(const az_particle_t *particle, az_clock_t clock) {
       } glEnd();
     } break;
     case AZ_PAR_EMBER:
-      glBegin(GL_TRIANGLE_FAN); {
-        with_color_alpha(particle->color, 1);
-        glVertex2f(0, 0);
-        with_color_alpha(particle->color, 0);
-        const double radius =
-          particle->param1 * (1.0 - particle->age / particle->lifetime);
-        for (int i = 0; i <= 360; i += 30) {
-          glVertex2d(radius * cos(AZ_DEG2RAD(i)), radius * sin(AZ_DEG2RAD(i)));
-        }
-      } glEnd();
+      az_shape_draw_glow(
+          particle->param1 * (1.0 - particle->age / particle->lifetime),
+          particle->color, scale_alpha(particle->color, 0));
       break;
     case AZ_PAR_EXPLOSION:
       glBegin(GL_QUAD_STRIP); {
@@ -178,15 +168,8 @@ void az_draw_particle(const az_particle_t *particle, az_clock_t clock) {
     case AZ_PAR_ICE_BOOM: {
       const double t0 = particle->age / particle->lifetime;
       const double t1 = 1.0 - t0;
-      glBegin(GL_TRIANGLE_FAN); {
-        with_color_alpha(particle->color, 0);
-        glVertex2f(0, 0);
-        with_color_alpha(particle->color, t1 * t1 * t1);
-        for (int i = 0; i <= 360; i += 6) {
-          glVertex2d(particle->param1 * cos(AZ_DEG2RAD(i)),
-                     particle->param1 * sin(AZ_DEG2RAD(i)));
-        }
-      } glEnd();
+      az_shape_draw_glow(particle->param1, scale_alpha(particle->color, 0),
+                         scale_alpha(particle->color, t1 * t1 * t1));
       glPushMatrix(); {
         const double rx = 0.65 * particle->param1;
         const double ry = sqrt(3.0) * rx / 3.0;
@@ -208,6 +191,7 @@ void az_draw_particle(const az_particle_t *particle, az_clock_t clock) {
       if (particle->age >= particle->param2) {
         const int num_steps = az_imax(2, round(particle->param1 / 10.0));
         const double step = particle->param1 / num_steps;
+        az_clock_note_change(5, clock);
         az_random_seed_t seed = { clock / 5, 194821.0 * particle->angle };
         az_vector_t prev = {0, 0};
         for (int i = 1; i <= num_steps; ++i) {
@@ -275,18 +259,11 @@ void az_draw_particle(const az_particle_t *particle, az_clock_t clock) {
                             1.0f, clock);
       }
       // Portal:
-      glBegin(GL_TRIANGLE_FAN); {
-        const GLfloat r = (az_clock_mod(6, 1, clock)     < 3 ? 1.0f : 0.25f);
-        const GLfloat g = (az_clock_mod(6, 1, clock + 2) < 3 ? 1.0f : 0.25f);
-        const GLfloat b = (az_clock_mod(6, 1, clock + 4) < 3 ? 1.0f : 0.75f);
-        glColor4f(r, g, b, 1.0f);
-        glVertex2f(0, 0);
-        glColor4f(r, g, b, 0.15f);
-        const double radius = particle->param1 * scale;
-        for (int i = 0; i <= 360; i += 10) {
-          glVertex2d(radius * cos(AZ_DEG2RAD(i)), radius * sin(AZ_DEG2RAD(i)));
-        }
-      } glEnd();
+      const GLfloat r = (az_clock_mod(6, 1, clock)     < 3 ? 1.0f : 0.25f);
+      const GLfloat g = (az_clock_mod(6, 1, clock + 2) < 3 ? 1.0f : 0.25f);
+      const GLfloat b = (az_clock_mod(6, 1, clock + 4) < 3 ? 1.0f : 0.75f);
+      az_shape_draw_glow(particle->param1 * scale, az_color4f(r, g, b, 1.0f),
+                         az_color4f(r, g, b, 0.15f));
     } break;
     case AZ_PAR_ROCK:
       glScaled(particle->param1, particle->param1, 1);
@@ -370,15 +347,108 @@ void az_draw_particle(const az_particle_t *particle, az_clock_t clock) {
   }
 }
 
-void az_draw_particles(const az_space_state_t *state) {
-  AZ_ARRAY_LOOP(particle, state->particles) {
+// With the core graphics backend, the particle kinds that are just a radial
+// gradient (which make up most of the particles in a big explosion) are drawn
+// as instanced glows, with the falloff computed in a shader.
+static bool is_glow_particle(const az_particle_t *particle) {
+  switch (particle->kind) {
+    case AZ_PAR_BOOM:
+    case AZ_PAR_CHARGED_BOOM:
+    case AZ_PAR_EMBER:
+    case AZ_PAR_EXPLOSION:
+      return true;
+    default: return false;
+  }
+}
+
+static void set_glow_ring(az_gfx_glow_t *glow, int index, double radius,
+                          double alpha) {
+  glow->radius[index] = radius;
+  glow->alpha[index] = alpha * glow->alpha[index];
+}
+
+// Fill in the glow equivalent to what az_draw_particle draws for the given
+// particle, which must satisfy is_glow_particle.
+static void particle_glow(const az_particle_t *particle, az_gfx_glow_t *glow) {
+  assert(is_glow_particle(particle));
+  const az_color_t color = particle->color;
+  const GLfloat alpha = color.a / 255.0f;
+  *glow = (az_gfx_glow_t){
+    .x = particle->position.x, .y = particle->position.y,
+    .color = {color.r / 255.0f, color.g / 255.0f, color.b / 255.0f},
+    .alpha = {alpha, alpha, alpha}
+  };
+  const double factor = particle->age / particle->lifetime;
+  switch (particle->kind) {
+    case AZ_PAR_BOOM: {
+      const double radius = particle->param1 * factor;
+      set_glow_ring(glow, 0, 0, 0);
+      set_glow_ring(glow, 1, radius, 1 - factor * factor);
+      set_glow_ring(glow, 2, radius, 1 - factor * factor);
+    } break;
+    case AZ_PAR_CHARGED_BOOM: {
+      const double major = sqrt(factor) * particle->param1;
+      const double minor = (1 - factor) * particle->param2;
+      const double outer_alpha = 1 - factor;
+      const double inner_alpha = (minor <= 0.0 ? 0.0 :
+                                  outer_alpha * (1 - fmin(major, minor) /
+                                                 minor));
+      set_glow_ring(glow, 0, fmax(0, major - minor), inner_alpha);
+      set_glow_ring(glow, 1, major, outer_alpha);
+      set_glow_ring(glow, 2, major + minor, 0);
+    } break;
+    case AZ_PAR_EMBER: {
+      const double radius = particle->param1 * (1.0 - factor);
+      set_glow_ring(glow, 0, 0, 1);
+      set_glow_ring(glow, 1, radius, 0);
+      set_glow_ring(glow, 2, radius, 0);
+    } break;
+    case AZ_PAR_EXPLOSION: {
+      const double tt = 1.0 - factor;
+      set_glow_ring(glow, 0, particle->param1 * (1.0 - tt * tt * tt), tt * tt);
+      set_glow_ring(glow, 1, particle->param1, tt);
+      set_glow_ring(glow, 2, particle->param1, tt);
+    } break;
+    default: AZ_ASSERT_UNREACHABLE();
+  }
+}
+
+static void draw_glow_particles(int num_particles,
+                                const az_particle_t *particles) {
+  az_gfx_glow_t glows[128];
+  int num_glows = 0;
+  for (int i = 0; i < num_particles; ++i) {
+    const az_particle_t *particle = &particles[i];
     if (particle->kind == AZ_PAR_NOTHING) continue;
+    if (!is_glow_particle(particle)) continue;
+    particle_glow(particle, &glows[num_glows++]);
+    if (num_glows == (int)AZ_ARRAY_SIZE(glows)) {
+      az_gfx_draw_glows(num_glows, glows);
+      num_glows = 0;
+    }
+  }
+  az_gfx_draw_glows(num_glows, glows);
+}
+
+void az_draw_particle_array(int num_particles, const az_particle_t *particles,
+                            az_clock_t clock) {
+  const bool use_glows = (az_gfx_backend() == AZ_GFX_CORE);
+  if (use_glows) draw_glow_particles(num_particles, particles);
+  for (int i = 0; i < num_particles; ++i) {
+    const az_particle_t *particle = &particles[i];
+    if (particle->kind == AZ_PAR_NOTHING) continue;
+    if (use_glows && is_glow_particle(particle)) continue;
     glPushMatrix(); {
       az_gl_translated(particle->position);
       az_gl_rotated(particle->angle);
-      az_draw_particle(particle, state->clock);
+      az_draw_particle(particle, clock);
     } glPopMatrix();
   }
 }
 
+void az_draw_particles(const az_space_state_t *state) {
+  az_draw_particle_array(AZ_ARRAY_SIZE(state->particles), state->particles,
+                         state->clock);
+}
+
 /*===========================================================================*/
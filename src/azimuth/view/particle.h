@@ -29,6 +29,12 @@
 
 void az_draw_particle(const az_particle_t *particle, az_clock_t clock);
 
+// Draw all the present particles in the array.  Depending on the graphics
+// backend, some kinds of particles may be batched together, so the particles
+// are not necessarily drawn in array order.
+void az_draw_particle_array(int num_particles, const az_particle_t *particles,
+                            az_clock_t clock);
+
 void az_draw_particles(const az_space_state_t *state);
 
 /*===========================================================================*/
@@ -24,10 +24,9 @@
 #include <stdbool.h>
 #include <string.h>
 
-#include <SDL_opengl.h>
-
 #include "azimuth/constants.h"
 #include "azimuth/gui/event.h"
+#include "azimuth/gui/opengl.h"
 #include "azimuth/gui/screen.h"
 #include "azimuth/state/camera.h"
 #include "azimuth/state/planet.h"
@@ -42,6 +41,7 @@
 #include "azimuth/view/minimap.h"
 #include "azimuth/view/node.h"
 #include "azimuth/view/prefs.h"
+#include "azimuth/view/shape.h"
 #include "azimuth/view/ship.h"
 #include "azimuth/view/string.h"
 #include "azimuth/view/util.h"
@@ -183,10 +183,7 @@ static void draw_minimap_rooms(const az_paused_state_t *state,
   // Draw planet surface outline:
   glColor3f(1, 1, 0); // yellow
   glBegin(GL_LINE_STRIP); {
-    for (int i = 45; i <= 135; i += 3) {
-      glVertex2d(AZ_PLANETOID_RADIUS * cos(AZ_DEG2RAD(i)),
-                 AZ_PLANETOID_RADIUS * sin(AZ_DEG2RAD(i)));
-    }
+    az_shape_arc(0, 0, AZ_PLANETOID_RADIUS, AZ_PLANETOID_RADIUS, 45, 135, 3);
   } glEnd();
 
   const az_planet_t *planet = state->planet;
@@ -194,11 +191,11 @@ static void draw_minimap_rooms(const az_paused_state_t *state,
   const az_player_t *player = &ship->player;
 
   // Draw rooms that are mapped or explored:
+  az_draw_minimap_rooms(planet, player, false, AZ_VZERO, NULL);
   for (int i = 0; i < planet->num_rooms; ++i) {
     const az_room_t *room = &planet->rooms[i];
     if (!az_test_room_mapped(player, i, room)) continue;
     const bool visited = az_test_room_visited(player, i);
-    az_draw_minimap_room(planet, room, visited, false, AZ_VZERO);
     *room_flags_out |= room->properties & AZ_ROOMF_WITH_SAVE;
     if (visited) {
       *room_flags_out |= room->properties & (AZ_ROOMF_WITH_COMM |
@@ -489,10 +486,7 @@ static void draw_schematic_line(az_clock_t clock, const az_vector_t *vertices,
     const az_vector_t center = vertices[num_vertices - 1];
     az_gl_vertex(center);
     const double radius = 3.0;
-    for (int i = 0; i <= 360; i += 30) {
-      glVertex2d(center.x + radius * cos(AZ_DEG2RAD(i)),
-                 center.y + radius * sin(AZ_DEG2RAD(i)));
-    }
+    az_shape_ellipse(center.x, center.y, radius, radius);
   } glEnd();
 }
 
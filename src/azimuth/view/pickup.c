@@ -22,8 +22,7 @@
 #include <math.h>
 #include <stdbool.h>
 
-#include <SDL_opengl.h>
-
+#include "azimuth/gui/opengl.h"
 #include "azimuth/state/pickup.h"
 #include "azimuth/state/space.h"
 #include "azimuth/util/clock.h"
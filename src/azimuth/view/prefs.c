@@ -22,9 +22,8 @@
 #include <assert.h>
 #include <math.h>
 
-#include <SDL_opengl.h>
-
 #include "azimuth/gui/event.h"
+#include "azimuth/gui/opengl.h"
 #include "azimuth/state/sound.h"
 #include "azimuth/util/clock.h"
 #include "azimuth/util/misc.h"
@@ -21,13 +21,13 @@
 
 #include <math.h>
 
-#include <SDL_opengl.h>
-
+#include "azimuth/gui/opengl.h"
 #include "azimuth/state/projectile.h"
 #include "azimuth/state/space.h"
 #include "azimuth/util/misc.h"
 #include "azimuth/util/vector.h"
 #include "azimuth/view/gravfield.h"
+#include "azimuth/view/shape.h"
 #include "azimuth/view/util.h"
 
 /*===========================================================================*/
@@ -196,9 +196,7 @@ void az_draw_projectile(const az_projectile_t *proj, az_clock_t clock) {
       else glColor3f(1, 0, 1);
       glBegin(GL_TRIANGLE_FAN); {
         glVertex2f(0, 0);
-        for (int i = -90; i <= 90; i += 30) {
-          glVertex2d(4 * cos(AZ_DEG2RAD(i)), 4 * sin(AZ_DEG2RAD(i)));
-        }
+        az_shape_arc(0, 0, 4, 4, -90, 90, 30);
       } glEnd();
       glBegin(GL_TRIANGLE_STRIP); {
         glVertex2f(0, -4); glVertex2f(0, 4);
@@ -271,16 +269,12 @@ void az_draw_projectile(const az_projectile_t *proj, az_clock_t clock) {
       } glEnd();
       break;
     case AZ_PROJ_GUN_CHARGED_BEAM:
-      glBegin(GL_TRIANGLE_FAN); {
+      {
         const double ratio = proj->age / proj->data->lifetime;
-        const double radius = proj->data->splash_radius * ratio;
-        glColor4f(1, 0, 0, 0);
-        glVertex2f(0, 0);
-        glColor4f(1, 0, 0, 1 - ratio);
-        for (int i = 0; i <= 360; i += 15) {
-          glVertex2d(radius * cos(AZ_DEG2RAD(i)), radius * sin(AZ_DEG2RAD(i)));
-        }
-      } glEnd();
+        az_shape_draw_glow(proj->data->splash_radius * ratio,
+                           az_color4f(1, 0, 0, 0),
+                           az_color4f(1, 0, 0, 1 - ratio));
+      }
       break;
     case AZ_PROJ_ROCKET:
       draw_rocket(clock, (az_color_t){128, 0, 0, 255});
@@ -377,22 +371,17 @@ void az_draw_projectile(const az_projectile_t *proj, az_clock_t clock) {
     case AZ_PROJ_ERUPTION:
     case AZ_PROJ_FIREBALL_FAST:
     case AZ_PROJ_FIREBALL_SLOW:
-    case AZ_PROJ_ORBITAL_TORPEDO:
-      glBegin(GL_TRIANGLE_FAN); {
-        const bool blink = az_clock_mod(2, 2, clock);
-        if (blink) glColor3f(1, 0.75, 0.5); // orange
-        else glColor3f(1, 0.25, 0.25); // red
-        glVertex2i(0, 0);
-        if (blink) glColor4f(0.5, 0.375, 0.25, 0); // orange
-        else glColor4f(0.5, 0.125, 0.125, 0); // red
-        const double radius = (proj->kind == AZ_PROJ_BOUNCING_FIREBALL ||
-                               proj->kind == AZ_PROJ_ORBITAL_TORPEDO ||
-                               proj->kind == AZ_PROJ_ERUPTION ? 18.0 : 6.0);
-        for (int i = 0; i <= 360; i += 30) {
-          glVertex2d(radius * cos(AZ_DEG2RAD(i)), radius * sin(AZ_DEG2RAD(i)));
-        }
-      } glEnd();
-      break;
+    case AZ_PROJ_ORBITAL_TORPEDO: {
+      const bool blink = az_clock_mod(2, 2, clock);
+      const double radius = (proj->kind == AZ_PROJ_BOUNCING_FIREBALL ||
+                             proj->kind == AZ_PROJ_ORBITAL_TORPEDO ||
+                             proj->kind == AZ_PROJ_ERUPTION ? 18.0 : 6.0);
+      az_shape_draw_glow(radius,
+                         (blink ? az_color3f(1, 0.75, 0.5) : // orange
+                          az_color3f(1, 0.25, 0.25)), // red
+                         (blink ? az_color4f(0.5, 0.375, 0.25, 0) : // orange
+                          az_color4f(0.5, 0.125, 0.125, 0))); // red
+    } break;
     case AZ_PROJ_FORCE_WAVE:
       glBegin(GL_QUADS); {
         const GLfloat factor = fmin(1.0, 2.0 * proj->age);
@@ -482,23 +471,18 @@ void az_draw_projectile(const az_projectile_t *proj, az_clock_t clock) {
         glColor3f(0.6, 0.9, 0.75);
         glVertex2d(0.25 * radius, 0);
         glColor3f(0.1, 0.3, 0.15);
-        for (int i = 0; i <= 360; i += 15) {
-          glVertex2d(radius * cos(AZ_DEG2RAD(i)), radius * sin(AZ_DEG2RAD(i)));
-        }
+        az_shape_circle(radius);
       } glEnd();
       break;
     case AZ_PROJ_NUCLEAR_EXPLOSION: break; // invisible
     case AZ_PROJ_OTH_BARRAGE: break; // invisible
     case AZ_PROJ_OTH_CHARGED_BEAM:
-      glBegin(GL_TRIANGLE_FAN); {
+      {
         const double ratio = proj->age / proj->data->lifetime;
-        const double radius = proj->data->splash_radius * ratio;
-        glColor4f(0.85, 1, 0.5, 0); glVertex2f(0, 0);
-        glColor4f(0.85, 1, 0.5, 1 - ratio);
-        for (int i = 0; i <= 360; i += 15) {
-          glVertex2d(radius * cos(AZ_DEG2RAD(i)), radius * sin(AZ_DEG2RAD(i)));
-        }
-      } glEnd();
+        az_shape_draw_glow(proj->data->splash_radius * ratio,
+                           az_color4f(0.85, 1, 0.5, 0),
+                           az_color4f(0.85, 1, 0.5, 1 - ratio));
+      }
       break;
     case AZ_PROJ_OTH_CHARGED_PHASE:
       draw_oth_projectile(proj, 7.0, clock);
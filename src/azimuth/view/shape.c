@@ -0,0 +1,242 @@
+/*=============================================================================
+| Copyright 2012 Matthew D. Steele <mdsteele@alum.mit.edu>                    |
+|                                                                             |
+| This file is part of Azimuth.                                               |
+|                                                                             |
+| Azimuth is free software: you can redistribute it and/or modify it under    |
+| the terms of the GNU General Public License as published by the Free        |
+| Software Foundation, either version 3 of the License, or (at your option)   |
+| any later version.                                                          |
+|                                                                             |
+| Azimuth is distributed in the hope that it will be useful, but WITHOUT      |
+| ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       |
+| FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for   |
+| more details.                                                               |
+|                                                                             |
+| You should have received a copy of the GNU General Public License along     |
+| with Azimuth.  If not, see <http://www.gnu.org/licenses/>.                  |
+=============================================================================*/
+
+
+#include "azimuth/view/shape.h"
+
+#include <assert.h>
+#include <math.h>
+#include <stdbool.h>
+
+#include "azimuth/gui/gfx.h"
+#include "azimuth/gui/opengl.h"
+#include "azimuth/util/color.h"
+#include "azimuth/util/misc.h"
+#include "azimuth/util/vector.h"
+#include "azimuth/view/util.h"
+
+/*===========================================================================*/
+
+// Tessellation steps, in degrees, from coarsest to finest.  Each evenly
+// divides 360.
+static const int tessellation_steps[] = {60, 45, 30, 20, 15, 10, 5, 3};
+#define NUM_LEVELS AZ_ARRAY_SIZE(tessellation_steps)
+#define FINEST_STEP 3
+
+// The longest edge, in pixels, that we're willing to draw along the perimeter
+// of a circle before switching to a finer tessellation step.
+#define MAX_EDGE_LENGTH 6.0
+
+typedef struct { GLfloat x, y; } unit_vertex_t;
+
+// For each tessellation level, the unit-circle vertices from 0 to 360 degrees
+// (inclusive, so the last is the same as the first).
+static unit_vertex_t level_vertices[NUM_LEVELS][360 / FINEST_STEP + 1];
+// The unit-circle vertex at every whole number of degrees in [0, 360), for
+// arcs whose step or endpoints don't line up with any level.
+static unit_vertex_t degree_vertices[360];
+static bool tables_initialized = false;
+
+// For each tessellation level, a display list drawing a GL_TRIANGLE_FAN glow
+// over the unit circle.  Each is compiled in three variants (all transparent
+// black, white center only, and white edge only), so that
+// az_gfx_call_list_modulated_rgba can draw it with any center and edge colors.
+static GLuint glow_display_lists_start = 0u;
+
+static void init_tables(void) {
+  for (int i = 0; i < 360; ++i) {
+    degree_vertices[i].x = cos(AZ_DEG2RAD(i));
+    degree_vertices[i].y = sin(AZ_DEG2RAD(i));
+  }
+  for (int level = 0; level < NUM_LEVELS; ++level) {
+    const int step = tessellation_steps[level];
+    assert(step >= FINEST_STEP && 360 % step == 0);
+    for (int i = 0; i * step <= 360; ++i) {
+      level_vertices[level][i] = degree_vertices[(i * step) % 360];
+    }
+  }
+  tables_initialized = true;
+}
+
+static int level_for_radius(double radius, bool on_screen) {
+  const double screen_radius =
+    fabs(radius) * (on_screen ? 1.0 : az_gfx_modelview_scale());
+  for (int level = 0; level < NUM_LEVELS - 1; ++level) {
+    if (screen_radius * AZ_DEG2RAD(tessellation_steps[level]) <=
+        MAX_EDGE_LENGTH) return level;
+  }
+  return NUM_LEVELS - 1;
+}
+
+static int num_level_vertices(int level) {
+  return 360 / tessellation_steps[level] + 1;
+}
+
+static void emit_level(int level, double cx, double cy, double rx,
+                       double ry) {
+  const unit_vertex_t *vertices = level_vertices[level];
+  for (int i = 0, n = num_level_vertices(level); i < n; ++i) {
+    glVertex2d(cx + rx * vertices[i].x, cy + ry * vertices[i].y);
+  }
+}
+
+static void arc_vertex(double cx, double cy, double rx, double ry,
+                       int degrees) {
+  int index = degrees % 360;
+  if (index < 0) index += 360;
+  glVertex2d(cx + rx * degree_vertices[index].x,
+             cy + ry * degree_vertices[index].y);
+}
+
+static void emit_ring(int level, double inner_radius, az_color_t inner_color,
+                      double outer_radius, az_color_t outer_color) {
+  const unit_vertex_t *vertices = level_vertices[level];
+  for (int i = 0, n = num_level_vertices(level); i < n; ++i) {
+    az_gl_color(inner_color);
+    glVertex2d(inner_radius * vertices[i].x, inner_radius * vertices[i].y);
+    az_gl_color(outer_color);
+    glVertex2d(outer_radius * vertices[i].x, outer_radius * vertices[i].y);
+  }
+}
+
+static void set_color_weights(az_color_t color, GLfloat weights[4]) {
+  weights[0] = color.r / 255.0f;
+  weights[1] = color.g / 255.0f;
+  weights[2] = color.b / 255.0f;
+  weights[3] = color.a / 255.0f;
+}
+
+/*===========================================================================*/
+
+void az_init_shape_drawing(void) {
+  if (!tables_initialized) init_tables();
+  // This is called again (with the same GL context) whenever we switch
+  // to/from fullscreen, so delete the old display lists first.
+  if (glow_display_lists_start != 0u) {
+    glDeleteLists(glow_display_lists_start, NUM_LEVELS);
+  }
+  glow_display_lists_start = glGenLists(NUM_LEVELS);
+  if (glow_display_lists_start == 0u) {
+    AZ_FATAL("glGenLists failed.\n");
+  }
+  for (int level = 0; level < NUM_LEVELS; ++level) {
+    for (int variant = 0; variant < AZ_GFX_NUM_LIST_VARIANTS; ++variant) {
+      az_gfx_new_list_variant(glow_display_lists_start + level, variant); {
+        glBegin(GL_TRIANGLE_FAN); {
+          if (variant == 1) glColor4f(1, 1, 1, 1);
+          else glColor4f(0, 0, 0, 0);
+          glVertex2f(0, 0);
+          if (variant == 2) glColor4f(1, 1, 1, 1);
+          else glColor4f(0, 0, 0, 0);
+          emit_level(level, 0, 0, 1, 1);
+        } glEnd();
+      } glEndList();
+    }
+  }
+}
+
+int az_shape_step(double screen_radius) {
+  return tessellation_steps[level_for_radius(screen_radius, true)];
+}
+
+void az_shape_draw_glow(double radius, az_color_t center_color,
+                        az_color_t edge_color) {
+  az_shape_draw_ellipse_glow(0, 0, radius, radius, center_color, edge_color);
+}
+
+void az_shape_draw_ellipse_glow(double cx, double cy, double rx, double ry,
+                                az_color_t center_color,
+                                az_color_t edge_color) {
+  if (!tables_initialized) init_tables();
+  const int level = level_for_radius(fmax(fabs(rx), fabs(ry)), false);
+  glPushMatrix(); {
+    glTranslated(cx, cy, 0);
+    glScaled(rx, ry, 1);
+    // A display list call would stop an enclosing display list from being
+    // baked on the core backend, so emit the vertices instead in that case.
+    if (glow_display_lists_start == 0u || az_gfx_compiling_list()) {
+      glBegin(GL_TRIANGLE_FAN); {
+        az_gl_color(center_color);
+        glVertex2f(0, 0);
+        az_gl_color(edge_color);
+        emit_level(level, 0, 0, 1, 1);
+      } glEnd();
+    } else {
+      GLfloat center_weights[4], edge_weights[4];
+      set_color_weights(center_color, center_weights);
+      set_color_weights(edge_color, edge_weights);
+      az_gfx_call_list_modulated_rgba(glow_display_lists_start + level,
+                                      center_weights, edge_weights);
+    }
+  } glPopMatrix();
+}
+
+void az_shape_draw_ring(double inner_radius, az_color_t inner_color,
+                        double outer_radius, az_color_t outer_color) {
+  if (!tables_initialized) init_tables();
+  // Pick the level before scaling, since the scale isn't tracked while a
+  // display list is being compiled.
+  const int level = level_for_radius(
+      fmax(fabs(inner_radius), fabs(outer_radius)), false);
+  glPushMatrix(); {
+    glScaled(outer_radius, outer_radius, 1);
+    glBegin(GL_TRIANGLE_STRIP); {
+      emit_ring(level, (outer_radius == 0.0 ? 0.0 :
+                        inner_radius / outer_radius),
+                inner_color, 1.0, outer_color);
+    } glEnd();
+  } glPopMatrix();
+}
+
+/*===========================================================================*/
+
+void az_shape_circle(double radius) {
+  az_shape_ellipse(0, 0, radius, radius);
+}
+
+void az_shape_ellipse(double cx, double cy, double rx, double ry) {
+  if (!tables_initialized) init_tables();
+  emit_level(level_for_radius(fmax(fabs(rx), fabs(ry)), false),
+             cx, cy, rx, ry);
+}
+
+void az_shape_arc(double cx, double cy, double rx, double ry,
+                  int start_degrees, int end_degrees, int step_degrees) {
+  assert(start_degrees <= end_degrees);
+  assert(step_degrees >= 0);
+  if (!tables_initialized) init_tables();
+  if (step_degrees == 0) {
+    step_degrees = tessellation_steps[
+        level_for_radius(fmax(fabs(rx), fabs(ry)), false)];
+  }
+  for (int i = start_degrees; i < end_degrees; i += step_degrees) {
+    arc_vertex(cx, cy, rx, ry, i);
+  }
+  arc_vertex(cx, cy, rx, ry, end_degrees);
+}
+
+void az_shape_ring(double inner_radius, az_color_t inner_color,
+                   double outer_radius, az_color_t outer_color) {
+  if (!tables_initialized) init_tables();
+  emit_ring(level_for_radius(fmax(fabs(inner_radius), fabs(outer_radius)),
+                             false),
+            inner_radius, inner_color, outer_radius, outer_color);
+}
+
+/*===========================================================================*/
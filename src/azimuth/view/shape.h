@@ -0,0 +1,89 @@
+/*=============================================================================
+| Copyright 2012 Matthew D. Steele <mdsteele@alum.mit.edu>                    |
+|                                                                             |
+| This file is part of Azimuth.                                               |
+|                                                                             |
+| Azimuth is free software: you can redistribute it and/or modify it under    |
+| the terms of the GNU General Public License as published by the Free        |
+| Software Foundation, either version 3 of the License, or (at your option)   |
+| any later version.                                                          |
+|                                                                             |
+| Azimuth is distributed in the hope that it will be useful, but WITHOUT      |
+| ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       |
+| FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for   |
+| more details.                                                               |
+|                                                                             |
+| You should have received a copy of the GNU General Public License along     |
+| with Azimuth.  If not, see <http://www.gnu.org/licenses/>.                  |
+=============================================================================*/
+
+
+#pragma once
+#ifndef AZIMUTH_VIEW_SHAPE_H_
+#define AZIMUTH_VIEW_SHAPE_H_
+
+#include "azimuth/util/color.h"
+
+/*===========================================================================*/
+
+// These functions draw circles, arcs, rings and glows from precomputed
+// unit-circle vertex tables, one for each tessellation level.  Radii are in
+// current modelview units, which for most view code are screen pixels; the
+// level is picked from the on-screen size (see az_gfx_modelview_scale), so
+// that tiny glows use fewer vertices.
+
+// Compile the glow display lists.  This must be registered with
+// az_register_gl_init_func.
+void az_init_shape_drawing(void);
+
+// Return the tessellation step, in degrees, to use for a circle whose radius
+// on screen is the given number of pixels.  Smaller circles get coarser steps;
+// the result always evenly divides 360.
+int az_shape_step(double screen_radius);
+
+// The az_shape_draw_* functions draw a whole shape under a single
+// scale/translate, so prefer them where the shape is drawn on its own.
+
+// Draw a filled disc of the given radius centered on the origin, fading from
+// center_color at the center to edge_color at the edge.
+void az_shape_draw_glow(double radius, az_color_t center_color,
+                        az_color_t edge_color);
+
+// Draw a filled ellipse centered on (cx, cy) with the given radii, fading from
+// center_color at the center to edge_color at the edge.
+void az_shape_draw_ellipse_glow(double cx, double cy, double rx, double ry,
+                                az_color_t center_color,
+                                az_color_t edge_color);
+
+// Draw a filled ring centered on the origin, with the given colors at the
+// inner and outer edges.
+void az_shape_draw_ring(double inner_radius, az_color_t inner_color,
+                        double outer_radius, az_color_t outer_color);
+
+// The remaining functions only call glVertex (and, for az_shape_ring,
+// glColor), for shapes that share a glBegin/glEnd with other vertices or need
+// their own colors set; the caller is free to set colors before calling them.
+
+// Emit vertices around the full circle of the given radius, centered on the
+// origin, starting and ending at zero degrees.
+void az_shape_circle(double radius);
+
+// Emit vertices around the full ellipse centered on (cx, cy) with the given
+// radii, starting and ending at zero degrees.
+void az_shape_ellipse(double cx, double cy, double rx, double ry);
+
+// Emit vertices along the given elliptical arc, from start_degrees to
+// end_degrees (inclusive) in steps of step_degrees.  The last vertex is always
+// placed exactly at end_degrees, even if step_degrees doesn't evenly divide
+// the arc.  A step of zero picks one from az_shape_step.
+void az_shape_arc(double cx, double cy, double rx, double ry,
+                  int start_degrees, int end_degrees, int step_degrees);
+
+// Emit GL_TRIANGLE_STRIP vertex pairs around a full ring centered on the
+// origin, with the given colors at the inner and outer edges.
+void az_shape_ring(double inner_radius, az_color_t inner_color,
+                   double outer_radius, az_color_t outer_color);
+
+/*===========================================================================*/
+
+#endif // AZIMUTH_VIEW_SHAPE_H_
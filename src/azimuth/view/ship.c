@@ -23,9 +23,8 @@
 #include <math.h>
 #include <stdbool.h>
 
-#include <SDL_opengl.h>
-
 #include "azimuth/constants.h"
+#include "azimuth/gui/opengl.h"
 #include "azimuth/state/node.h"
 #include "azimuth/state/pickup.h"
 #include "azimuth/state/player.h"
@@ -22,9 +22,8 @@
 #include <assert.h>
 #include <math.h>
 
-#include <SDL_opengl.h>
-
 #include "azimuth/constants.h"
+#include "azimuth/gui/opengl.h"
 #include "azimuth/state/player.h"
 #include "azimuth/state/space.h"
 #include "azimuth/util/misc.h" // for AZ_ASSERT_UNREACHABLE
@@ -39,6 +38,7 @@
 #include "azimuth/view/particle.h"
 #include "azimuth/view/pickup.h"
 #include "azimuth/view/projectile.h"
+#include "azimuth/view/shape.h"
 #include "azimuth/view/ship.h"
 #include "azimuth/view/speck.h"
 #include "azimuth/view/util.h"
@@ -139,9 +139,7 @@ static void draw_darkness(az_space_state_t *state) {
       glColor4f(0, 0, blue, 0);
       glVertex2f(0, 0);
       glColor4f(0, 0, blue, alpha);
-      for (int i = 90; i <= 270; i += 10) {
-        glVertex2d(radius * cos(AZ_DEG2RAD(i)), radius * sin(AZ_DEG2RAD(i)));
-      }
+      az_shape_arc(0, 0, radius, radius, 90, 270, 10);
     } glEnd();
     glBegin(GL_TRIANGLE_STRIP); {
       glColor4f(0, 0, blue, alpha);
@@ -169,14 +167,8 @@ static void draw_darkness(az_space_state_t *state) {
     } glEnd();
   } else {
     const double radius = 80.0;
-    glBegin(GL_TRIANGLE_FAN); {
-      glColor4f(0, 0, blue, 0);
-      glVertex2f(0, 0);
-      glColor4f(0, 0, blue, alpha);
-      for (int i = 0; i <= 360; i += 10) {
-        glVertex2d(radius * cos(AZ_DEG2RAD(i)), radius * sin(AZ_DEG2RAD(i)));
-      }
-    } glEnd();
+    az_shape_draw_glow(radius, az_color4f(0, 0, blue, 0),
+                       az_color4f(0, 0, blue, alpha));
     glBegin(GL_TRIANGLE_STRIP); {
       for (int i = 0; i <= 360; i += 10) {
         const double c = cos(AZ_DEG2RAD(i)), s = sin(AZ_DEG2RAD(i));
@@ -21,8 +21,7 @@
 
 #include <assert.h>
 
-#include <SDL_opengl.h>
-
+#include "azimuth/gui/opengl.h"
 #include "azimuth/state/particle.h"
 #include "azimuth/state/space.h"
 #include "azimuth/util/misc.h"
@@ -25,8 +25,7 @@
 #include <stdio.h>
 #include <string.h>
 
-#include <SDL_opengl.h>
-
+#include "azimuth/gui/opengl.h"
 #include "azimuth/state/dialog.h"
 #include "azimuth/util/key.h"
 #include "azimuth/util/misc.h"
@@ -24,10 +24,9 @@
 #include <stdbool.h>
 #include <string.h>
 
-#include <SDL_opengl.h>
-
 #include "azimuth/constants.h"
 #include "azimuth/gui/event.h"
+#include "azimuth/gui/opengl.h"
 #include "azimuth/state/player.h"
 #include "azimuth/state/save.h"
 #include "azimuth/util/misc.h"
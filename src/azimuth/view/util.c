@@ -21,8 +21,7 @@
 
 #include <math.h>
 
-#include <SDL_opengl.h>
-
+#include "azimuth/gui/opengl.h"
 #include "azimuth/util/color.h"
 #include "azimuth/util/vector.h"
 
@@ -23,9 +23,8 @@
 #include <math.h>
 #include <stdbool.h>
 
-#include <SDL_opengl.h>
-
 #include "azimuth/constants.h"
+#include "azimuth/gui/opengl.h"
 #include "azimuth/state/save.h"
 #include "azimuth/util/audio.h"
 #include "azimuth/util/color.h"
@@ -111,14 +110,8 @@ static void draw_baddies(const az_victory_state_t *state, bool background) {
 }
 
 static void draw_particles(const az_victory_state_t *state) {
-  AZ_ARRAY_LOOP(particle, state->particles) {
-    if (particle->kind == AZ_PAR_NOTHING) continue;
-    glPushMatrix(); {
-      az_gl_translated(particle->position);
-      az_gl_rotated(particle->angle);
-      az_draw_particle(particle, state->clock);
-    } glPopMatrix();
-  }
+  az_draw_particle_array(AZ_ARRAY_SIZE(state->particles), state->particles,
+                         state->clock);
 }
 
 static void draw_projectiles(const az_victory_state_t *state) {
@@ -23,8 +23,7 @@
 #include <math.h>
 #include <stdbool.h>
 
-#include <SDL_opengl.h>
-
+#include "azimuth/gui/opengl.h"
 #include "azimuth/state/space.h"
 #include "azimuth/state/wall.h"
 #include "azimuth/util/clock.h"
@@ -0,0 +1,59 @@
+/*=============================================================================
+| Copyright 2012 Matthew D. Steele <mdsteele@alum.mit.edu>                    |
+|                                                                             |
+| This file is part of Azimuth.                                               |
+|                                                                             |
+| Azimuth is free software: you can redistribute it and/or modify it under    |
+| the terms of the GNU General Public License as published by the Free        |
+| Software Foundation, either version 3 of the License, or (at your option)   |
+| any later version.                                                          |
+|                                                                             |
+| Azimuth is distributed in the hope that it will be useful, but WITHOUT      |
+| ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       |
+| FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for   |
+| more details.                                                               |
+|                                                                             |
+| You should have received a copy of the GNU General Public License along     |
+| with Azimuth.  If not, see <http://www.gnu.org/licenses/>.                  |
+=============================================================================*/
+
+
+#include "bench/gui.h"
+
+#include <stdbool.h>
+
+#include "azimuth/gui/event.h"
+#include "azimuth/gui/opengl.h"
+#include "azimuth/gui/screen.h"
+#include "azimuth/util/key.h"
+
+/*===========================================================================*/
+
+static float pixel_scale = 1.0f;
+
+void az_bench_set_pixel_scale(float scale) {
+  pixel_scale = scale;
+}
+
+void az_gl_scissor(int x, int y, int width, int height) {
+  glScissor(pixel_scale * x, pixel_scale * y,
+            pixel_scale * width, pixel_scale * height);
+}
+
+bool az_get_mouse_position(int *x, int *y) {
+  return false;
+}
+
+bool az_is_mouse_held(void) {
+  return false;
+}
+
+bool az_is_key_held(az_key_id_t key) {
+  return false;
+}
+
+bool az_is_shift_key_held(void) {
+  return false;
+}
+
+/*===========================================================================*/
@@ -0,0 +1,39 @@
+/*=============================================================================
+| Copyright 2012 Matthew D. Steele <mdsteele@alum.mit.edu>                    |
+|                                                                             |
+| This file is part of Azimuth.                                               |
+|                                                                             |
+| Azimuth is free software: you can redistribute it and/or modify it under    |
+| the terms of the GNU General Public License as published by the Free        |
+| Software Foundation, either version 3 of the License, or (at your option)   |
+| any later version.                                                          |
+|                                                                             |
+| Azimuth is distributed in the hope that it will be useful, but WITHOUT      |
+| ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       |
+| FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for   |
+| more details.                                                               |
+|                                                                             |
+| You should have received a copy of the GNU General Public License along     |
+| with Azimuth.  If not, see <http://www.gnu.org/licenses/>.                  |
+=============================================================================*/
+
+
+#pragma once
+#ifndef BENCH_GUI_H_
+#define BENCH_GUI_H_
+
+/*===========================================================================*/
+
+// The benchmark draws with the view code, but has no window or input devices,
+// so gui.c provides headless stand-ins for the parts of azimuth/gui/event.h
+// and azimuth/gui/screen.h that the view code uses: the mouse is never in the
+// window, no keys are ever held, and az_gl_scissor scales by the pixel scale
+// given here (rather than by the window's letterboxing).
+
+// Set the number of framebuffer pixels per virtual (AZ_SCREEN_WIDTH by
+// AZ_SCREEN_HEIGHT) pixel.  The default is 1.
+void az_bench_set_pixel_scale(float scale);
+
+/*===========================================================================*/
+
+#endif // BENCH_GUI_H_
@@ -0,0 +1,478 @@
+/*=============================================================================
+| Copyright 2012 Matthew D. Steele <mdsteele@alum.mit.edu>                    |
+|                                                                             |
+| This file is part of Azimuth.                                               |
+|                                                                             |
+| Azimuth is free software: you can redistribute it and/or modify it under    |
+| the terms of the GNU General Public License as published by the Free        |
+| Software Foundation, either version 3 of the License, or (at your option)   |
+| any later version.                                                          |
+|                                                                             |
+| Azimuth is distributed in the hope that it will be useful, but WITHOUT      |
+| ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       |
+| FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for   |
+| more details.                                                               |
+|                                                                             |
+| You should have received a copy of the GNU General Public License along     |
+| with Azimuth.  If not, see <http://www.gnu.org/licenses/>.                  |
+=============================================================================*/
+
+
+// A headless benchmark for the drawing code.  It sets up an offscreen GL
+// context through EGL (preferring Mesa's surfaceless platform, so that it can
+// run with a software rasterizer on a machine with no display or GPU), then
+// draws a number of frames of the space view, the HUD, and the pause screen
+// map for each requested room, reporting how long they took and how many GL
+// calls they made.  Alternatively, it can benchmark the music synthesizer
+// (which needs no GL context at all).
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <SDL.h>
+
+#include "azimuth/constants.h"
+#include "azimuth/gui/gfx.h"
+#include "azimuth/gui/opengl.h"
+#include "azimuth/state/baddie.h" // for az_init_baddie_datas
+#include "azimuth/state/music.h" // for az_init_music_datas
+#include "azimuth/state/planet.h"
+#include "azimuth/state/save.h"
+#include "azimuth/state/sound.h" // for az_init_sound_datas
+#include "azimuth/state/space.h"
+#include "azimuth/state/wall.h" // for az_init_wall_datas
+#include "azimuth/system/parallel.h"
+#include "azimuth/system/resource.h"
+#include "azimuth/tick/space.h"
+#include "azimuth/util/misc.h"
+#include "azimuth/util/prefs.h"
+#include "azimuth/view/baddie.h" // for az_init_baddie_drawing
+#include "azimuth/view/dialog.h" // for az_init_portrait_drawing
+#include "azimuth/view/doodad.h" // for az_init_doodad_drawing
+#include "azimuth/view/hud.h"
+#include "azimuth/view/minimap.h" // for az_init_minimap_drawing
+#include "azimuth/view/node.h" // for az_init_node_drawing
+#include "azimuth/view/paused.h"
+#include "azimuth/view/shape.h" // for az_init_shape_drawing
+#include "azimuth/view/space.h"
+#include "azimuth/view/wall.h" // for az_init_wall_drawing
+#include "bench/gui.h"
+#include "bench/png.h"
+
+/*===========================================================================*/
+
+static const char usage[] =
+  "Usage: %s [<option>...]\n"
+  "  -c              draw with the core (GL 3.3) graphics backend\n"
+  "  -a <mode>       antialias as for the aa preference (default 0): 0 for\n"
+  "                  none, 1-3 for 2x/4x/8x MSAA, or 4 to post-process\n"
+  "                  (which requires -c)\n"
+  "  -n <frames>     frames to draw of each view (default 60)\n"
+  "  -r <room>       benchmark the given room (may be repeated)\n"
+  "  -g <file> <n>   benchmark the room of saved game slot n in the file\n"
+  "  -s <scale>      framebuffer pixels per screen pixel (default 1)\n"
+  "  -p <dir>        write the last frame of each view to a PNG in dir\n"
+  "  -m <seconds>    instead of drawing, synthesize each music track for\n"
+  "                  the given number of seconds\n"
+  "With no -r or -g options, the planet's starting room is used.\n";
+
+#define MAX_SCENES 64
+
+// A scene to benchmark: either a room visited by a fresh player who has
+// explored the whole planet (so that the map is fully drawn), or a saved game.
+typedef struct {
+  az_room_key_t room;
+  const az_player_t *saved_player; // NULL if not from a saved game
+} az_bench_scene_t;
+
+static struct {
+  bool core;
+  az_antialiasing_t antialiasing;
+  int num_frames;
+  float pixel_scale;
+  const char *png_dir;
+  double music_seconds; // zero if not benchmarking music
+  int num_scenes;
+  az_bench_scene_t scenes[MAX_SCENES];
+} options = {.num_frames = 60, .pixel_scale = 1.0f};
+
+static az_planet_t planet;
+static az_saved_games_t saved_games[MAX_SCENES];
+static az_preferences_t prefs;
+static az_space_state_t space_state;
+static az_paused_state_t paused_state;
+
+/*===========================================================================*/
+
+static bool parse_args(int argc, char **argv) {
+  for (int i = 1; i < argc; ++i) {
+    const char *arg = argv[i];
+    const int num_params = (strcmp(arg, "-c") == 0 ? 0 :
+                            strcmp(arg, "-g") == 0 ? 2 : 1);
+    if (i + num_params >= argc) return false;
+    if (strcmp(arg, "-c") == 0) {
+      options.core = true;
+    } else if (strcmp(arg, "-a") == 0) {
+      int mode;
+      if (sscanf(argv[++i], "%d", &mode) < 1 || mode < 0 ||
+          mode >= AZ_NUM_ANTIALIASING_MODES) return false;
+      options.antialiasing = (az_antialiasing_t)mode;
+    } else if (strcmp(arg, "-n") == 0) {
+      if (sscanf(argv[++i], "%d", &options.num_frames) < 1 ||
+          options.num_frames < 1) return false;
+    } else if (strcmp(arg, "-s") == 0) {
+      if (sscanf(argv[++i], "%f", &options.pixel_scale) < 1 ||
+          options.pixel_scale <= 0.0f) return false;
+    } else if (strcmp(arg, "-p") == 0) {
+      options.png_dir = argv[++i];
+    } else if (strcmp(arg, "-m") == 0) {
+      if (sscanf(argv[++i], "%lf", &options.music_seconds) < 1 ||
+          options.music_seconds <= 0.0) return false;
+    } else if (strcmp(arg, "-r") == 0 || strcmp(arg, "-g") == 0) {
+      if (options.num_scenes >= MAX_SCENES) return false;
+      az_bench_scene_t *scene = &options.scenes[options.num_scenes];
+      if (strcmp(arg, "-r") == 0) {
+        int room;
+        if (sscanf(argv[++i], "%d", &room) < 1 || room < 0 ||
+            room >= planet.num_rooms) return false;
+        scene->room = room;
+      } else {
+        az_saved_games_t *games = &saved_games[options.num_scenes];
+        const char *path = argv[++i];
+        int slot;
+        if (sscanf(argv[++i], "%d", &slot) < 1 || slot < 0 ||
+            slot >= AZ_NUM_SAVED_GAME_SLOTS) return false;
+        if (!az_load_games_from_path(&planet, path, games) ||
+            !games->games[slot].present) {
+          fprintf(stderr, "ERROR: no saved game in slot %d of %s\n",
+                  slot, path);
+          return false;
+        }
+        scene->saved_player = &games->games[slot].player;
+        scene->room = scene->saved_player->current_room;
+      }
+      ++options.num_scenes;
+    } else return false;
+  }
+  if (options.antialiasing == AZ_AA_POST_PROCESS && !options.core) {
+    return false;
+  }
+  if (options.num_scenes == 0) {
+    options.scenes[0].room = planet.start_room;
+    options.num_scenes = 1;
+  }
+  return true;
+}
+
+/*===========================================================================*/
+
+static void *get_egl_proc_address(const char *name) {
+  // ISO C doesn't allow casting a function pointer to a void*, so copy the
+  // bits instead.
+  void (*proc)(void) = eglGetProcAddress(name);
+  void *ptr;
+  memcpy(&ptr, &proc, sizeof(ptr));
+  return ptr;
+}
+
+// Create a GL context and a pbuffer to draw into, and make them current.
+static bool init_egl(int width, int height) {
+  EGLDisplay display = EGL_NO_DISPLAY;
+  PFNEGLGETPLATFORMDISPLAYEXTPROC get_platform_display;
+  void *proc = get_egl_proc_address("eglGetPlatformDisplayEXT");
+  memcpy(&get_platform_display, &proc, sizeof(proc));
+  if (get_platform_display != NULL) {
+    display = get_platform_display(EGL_PLATFORM_SURFACELESS_MESA,
+                                   EGL_DEFAULT_DISPLAY, NULL);
+  }
+  if (display == EGL_NO_DISPLAY) display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+  if (display == EGL_NO_DISPLAY || !eglInitialize(display, NULL, NULL)) {
+    fprintf(stderr, "ERROR: failed to initialize EGL\n");
+    return false;
+  }
+  if (!eglBindAPI(EGL_OPENGL_API)) {
+    fprintf(stderr, "ERROR: EGL doesn't support desktop OpenGL\n");
+    return false;
+  }
+  const EGLint samples = (options.antialiasing == AZ_AA_MSAA_2X ? 2 :
+                          options.antialiasing == AZ_AA_MSAA_4X ? 4 :
+                          options.antialiasing == AZ_AA_MSAA_8X ? 8 : 0);
+  const EGLint config_attribs[] = {
+    EGL_SURFACE_TYPE, EGL_PBUFFER_BIT, EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+    EGL_RED_SIZE, 8, EGL_GREEN_SIZE, 8, EGL_BLUE_SIZE, 8,
+    EGL_SAMPLE_BUFFERS, (samples > 0 ? 1 : 0), EGL_SAMPLES, samples, EGL_NONE
+  };
+  EGLConfig config;
+  EGLint num_configs = 0;
+  if (!eglChooseConfig(display, config_attribs, &config, 1, &num_configs) ||
+      num_configs < 1) {
+    fprintf(stderr, "ERROR: no suitable EGL config%s\n",
+            (samples > 0 ? " with that many samples" : ""));
+    return false;
+  }
+  const EGLint surface_attribs[] = {EGL_WIDTH, width, EGL_HEIGHT, height,
+                                    EGL_NONE};
+  const EGLSurface surface =
+    eglCreatePbufferSurface(display, config, surface_attribs);
+  const EGLint core_attribs[] = {
+    EGL_CONTEXT_MAJOR_VERSION, 3, EGL_CONTEXT_MINOR_VERSION, 3,
+    EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+    EGL_NONE
+  };
+  const EGLContext context = eglCreateContext(
+      display, config, EGL_NO_CONTEXT, (options.core ? core_attribs : NULL));
+  if (surface == EGL_NO_SURFACE || context == EGL_NO_CONTEXT ||
+      !eglMakeCurrent(display, surface, surface, context)) {
+    fprintf(stderr, "ERROR: failed to create GL context (0x%x)\n",
+            (unsigned int)eglGetError());
+    return false;
+  }
+  return true;
+}
+
+// Set up the same GL state that az_set_fullscreen does.
+static bool init_drawing(void) {
+  az_gfx_set_proc_loader(get_egl_proc_address);
+  if (!az_gfx_init(options.core ? AZ_GFX_CORE : AZ_GFX_LEGACY)) {
+    fprintf(stderr, "ERROR: failed to initialize graphics backend\n");
+    return false;
+  }
+  // These aren't managed through azimuth/gui/gfx.h:
+  glDepthMask(GL_FALSE);
+  glClearColor(0, 0, 0, 0);
+  glDisable(GL_DEPTH_TEST);
+  glEnable(GL_BLEND);
+  glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+  glMatrixMode(GL_PROJECTION);
+  glLoadIdentity();
+  glOrtho(0, AZ_SCREEN_WIDTH, AZ_SCREEN_HEIGHT, 0, 1, -1);
+  glMatrixMode(GL_MODELVIEW);
+  glLoadIdentity();
+  az_bench_set_pixel_scale(options.pixel_scale);
+  az_init_baddie_drawing();
+  az_init_doodad_drawing();
+  az_init_minimap_drawing();
+  az_init_node_drawing();
+  az_init_portrait_drawing();
+  az_init_shape_drawing();
+  az_init_wall_drawing();
+  return true;
+}
+
+/*===========================================================================*/
+
+static void init_space_state(const az_bench_scene_t *scene) {
+  AZ_ZERO_OBJECT(&space_state);
+  space_state.planet = &planet;
+  space_state.prefs = &prefs;
+  space_state.mode = AZ_MODE_NORMAL;
+  az_player_t *player = &space_state.ship.player;
+  if (scene->saved_player != NULL) {
+    *player = *scene->saved_player;
+  } else {
+    az_init_player(player);
+    player->current_room = scene->room;
+    for (int i = 0; i < planet.num_rooms; ++i) az_set_room_visited(player, i);
+    for (int i = 0; i < planet.num_zones; ++i) az_set_zone_mapped(player, i);
+  }
+  const az_room_t *room = &planet.rooms[player->current_room];
+  az_enter_room(&space_state, room);
+  space_state.ship.position = az_bounds_center(&room->camera_bounds);
+  space_state.camera.center = space_state.ship.position;
+  az_after_entering_room(&space_state);
+}
+
+static void tick_space(void) {
+  az_tick_space_state(&space_state, AZ_FRAME_TIME_SECONDS);
+  // Nothing plays the sounds, so discard them, as az_tick_audio would.
+  AZ_ZERO_OBJECT(&space_state.soundboard);
+}
+
+static void draw_space(void) {
+  az_space_draw_screen(&space_state);
+}
+
+static void draw_hud(void) {
+  az_draw_hud(&space_state);
+}
+
+static void tick_map(void) {
+  az_tick_paused_state(&paused_state, AZ_FRAME_TIME_SECONDS);
+}
+
+static void draw_map(void) {
+  az_paused_draw_screen(&paused_state);
+}
+
+static const struct {
+  const char *name;
+  void (*tick)(void);
+  void (*draw)(void);
+} views[] = {
+  {"space", tick_space, draw_space},
+  {"hud", tick_space, draw_hud},
+  {"map", tick_map, draw_map},
+};
+
+static double nanoseconds_per_count;
+
+static double elapsed_ms(uint64_t start, uint64_t end) {
+  return (end - start) * nanoseconds_per_count / 1000000.0;
+}
+
+static bool write_png(const char *name, int room, int width, int height) {
+  uint8_t *pixels = AZ_ALLOC(3 * width * height, uint8_t);
+  uint8_t *flipped = AZ_ALLOC(3 * width * height, uint8_t);
+  glPixelStorei(GL_PACK_ALIGNMENT, 1);
+  glReadPixels(0, 0, width, height, GL_RGB, GL_UNSIGNED_BYTE, pixels);
+  // GL's rows go from the bottom up, but PNG's go from the top down.
+  for (int y = 0; y < height; ++y) {
+    memcpy(&flipped[3 * width * y], &pixels[3 * width * (height - 1 - y)],
+           3 * width);
+  }
+  char path[1024];
+  snprintf(path, sizeof(path), "%s/room%03d-%s.png", options.png_dir, room,
+           name);
+  const bool ok = az_write_png_file(path, width, height, flipped);
+  if (!ok) fprintf(stderr, "ERROR: failed to write %s\n", path);
+  free(flipped);
+  free(pixels);
+  return ok;
+}
+
+// Draw each view of the scene options.num_frames times, and print the
+// average time and call counts per frame.  Submit time is how long it takes
+// to make the GL calls, and frame time also includes waiting for GL to
+// finish drawing.  With post-process antialiasing, each frame is drawn
+// offscreen and then smoothed, as az_start_screen_redraw and
+// az_finish_screen_redraw do.  Returns false if a PNG couldn't be written.
+static bool run_scene(const az_bench_scene_t *scene, int width, int height) {
+  bool ok = true;
+  init_space_state(scene);
+  AZ_ARRAY_LOOP(view, views) {
+    if (view->draw == draw_map) {
+      az_init_paused_state(&paused_state, &planet, &prefs,
+                           &space_state.ship);
+    }
+    double total_submit_ms = 0.0, total_frame_ms = 0.0, max_frame_ms = 0.0;
+    az_gfx_stats_t total_stats = {0};
+    for (int frame = 0; frame < options.num_frames; ++frame) {
+      view->tick();
+      az_gfx_reset_stats();
+      const uint64_t start = SDL_GetPerformanceCounter();
+      glClear(GL_COLOR_BUFFER_BIT);
+      glLoadIdentity();
+      glLineWidth(options.pixel_scale);
+      glViewport(0, 0, width, height);
+      if (options.antialiasing == AZ_AA_POST_PROCESS) {
+        az_gfx_begin_offscreen(width, height, 0, true);
+        glClear(GL_COLOR_BUFFER_BIT);
+      }
+      view->draw();
+      if (options.antialiasing == AZ_AA_POST_PROCESS) {
+        az_gfx_end_offscreen(0, 0, width, height);
+      }
+      az_gfx_flush();
+      const uint64_t submitted = SDL_GetPerformanceCounter();
+      glFinish();
+      const uint64_t finished = SDL_GetPerformanceCounter();
+      const az_gfx_stats_t stats = az_gfx_get_stats();
+      total_stats.api_calls += stats.api_calls;
+      total_stats.draw_calls += stats.draw_calls;
+      total_stats.vertices += stats.vertices;
+      total_submit_ms += elapsed_ms(start, submitted);
+      const double frame_ms = elapsed_ms(start, finished);
+      total_frame_ms += frame_ms;
+      if (frame_ms > max_frame_ms) max_frame_ms = frame_ms;
+    }
+    const int n = options.num_frames;
+    printf("room %3d %-5s  submit %7.3f ms  frame %7.3f ms (max %7.3f)  "
+           "%6d calls  %5d draws  %6d verts\n", scene->room, view->name,
+           total_submit_ms / n, total_frame_ms / n, max_frame_ms,
+           total_stats.api_calls / n, total_stats.draw_calls / n,
+           total_stats.vertices / n);
+    if (options.png_dir != NULL) {
+      ok &= write_png(view->name, scene->room, width, height);
+    }
+  }
+  return ok;
+}
+
+// Synthesize options.music_seconds of each music track, a buffer at a time as
+// the audio system does, and print how many times faster than real time that
+// was.
+static void run_music(void) {
+  const int buffer_size = 1024;
+  const int num_samples = (int)(options.music_seconds * AZ_AUDIO_RATE);
+  int16_t *samples = AZ_ALLOC(buffer_size, int16_t);
+  static az_music_synth_t synth;
+  printf("music synthesis, %g seconds per track\n", options.music_seconds);
+  double total_ms = 0.0;
+  for (int key = 1; key <= AZ_NUM_MUSIC_KEYS; ++key) {
+    az_reset_music_synth(&synth, az_get_music_data(key), 0);
+    const uint64_t start = SDL_GetPerformanceCounter();
+    for (int done = 0; done < num_samples; done += buffer_size) {
+      az_synthesize_music(&synth, samples,
+                          az_imin(buffer_size, num_samples - done));
+    }
+    const double ms = elapsed_ms(start, SDL_GetPerformanceCounter());
+    total_ms += ms;
+    const char *title = az_get_music_title(key);
+    printf("music %2d  %9.3f ms  %8.1fx real time  %s\n", key, ms,
+           1000.0 * options.music_seconds / ms, (title ? title : ""));
+  }
+  printf("total     %9.3f ms  %8.1fx real time\n", total_ms,
+         1000.0 * AZ_NUM_MUSIC_KEYS * options.music_seconds / total_ms);
+  free(samples);
+}
+
+// Load the planet the same way that the game does.
+static bool load_planet(void) {
+  void *image;
+  size_t image_size;
+  if (az_system_resource_writable_contents("rooms/planet.img", &image,
+                                           &image_size) &&
+      az_load_planet_image(image, image_size, &planet)) return true;
+  return az_read_planet(&az_system_resource_reader, &planet);
+}
+
+int main(int argc, char **argv) {
+  az_init_sound_datas(NULL, 0, &az_system_parallel_for);
+  az_init_baddie_datas();
+  az_init_wall_datas();
+  if (!az_init_music_datas(&az_system_resource_reader,
+                           &az_system_parallel_for) ||
+      !load_planet()) {
+    fprintf(stderr, "ERROR: failed to load scenario\n");
+    return EXIT_FAILURE;
+  }
+  if (!parse_args(argc, argv)) {
+    fprintf(stderr, usage, argv[0]);
+    return EXIT_FAILURE;
+  }
+  az_reset_prefs_to_defaults(&prefs);
+  nanoseconds_per_count = 1000000000 / (double)SDL_GetPerformanceFrequency();
+  if (options.music_seconds > 0.0) {
+    run_music();
+    return EXIT_SUCCESS;
+  }
+
+  const int width = options.pixel_scale * AZ_SCREEN_WIDTH;
+  const int height = options.pixel_scale * AZ_SCREEN_HEIGHT;
+  if (!init_egl(width, height) || !init_drawing()) return EXIT_FAILURE;
+  printf("%s (%s backend), %dx%d, aa mode %d, %d frames per view\n",
+         glGetString(GL_RENDERER), (options.core ? "core" : "legacy"),
+         width, height, (int)options.antialiasing, options.num_frames);
+  bool ok = true;
+  for (int i = 0; i < options.num_scenes; ++i) {
+    ok &= run_scene(&options.scenes[i], width, height);
+  }
+  return (ok ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+
+/*===========================================================================*/
@@ -0,0 +1,134 @@
+/*=============================================================================
+| Copyright 2012 Matthew D. Steele <mdsteele@alum.mit.edu>                    |
+|                                                                             |
+| This file is part of Azimuth.                                               |
+|                                                                             |
+| Azimuth is free software: you can redistribute it and/or modify it under    |
+| the terms of the GNU General Public License as published by the Free        |
+| Software Foundation, either version 3 of the License, or (at your option)   |
+| any later version.                                                          |
+|                                                                             |
+| Azimuth is distributed in the hope that it will be useful, but WITHOUT      |
+| ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       |
+| FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for   |
+| more details.                                                               |
+|                                                                             |
+| You should have received a copy of the GNU General Public License along     |
+| with Azimuth.  If not, see <http://www.gnu.org/licenses/>.                  |
+=============================================================================*/
+
+
+#include "bench/png.h"
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/*===========================================================================*/
+
+static uint32_t crc_table[256];
+
+static uint32_t update_crc(uint32_t crc, const uint8_t *bytes, size_t size) {
+  if (crc_table[1] == 0u) {
+    for (uint32_t n = 0u; n < 256u; ++n) {
+      uint32_t c = n;
+      for (int k = 0; k < 8; ++k) {
+        c = (c & 1u ? 0xedb88320u ^ (c >> 1) : c >> 1);
+      }
+      crc_table[n] = c;
+    }
+  }
+  for (size_t i = 0; i < size; ++i) {
+    crc = crc_table[(crc ^ bytes[i]) & 0xffu] ^ (crc >> 8);
+  }
+  return crc;
+}
+
+// A PNG chunk is written in pieces, since the image data chunk is too big to
+// want to buffer in full; the CRC covers the type and all of the data.
+typedef struct {
+  FILE *file;
+  uint32_t crc;
+  uint32_t adler_a, adler_b; // running Adler-32 checksum of the image data
+} png_writer_t;
+
+static void write_u32(png_writer_t *writer, uint32_t value) {
+  const uint8_t bytes[4] = {value >> 24, value >> 16, value >> 8, value};
+  fwrite(bytes, 1, 4, writer->file);
+  writer->crc = update_crc(writer->crc, bytes, 4);
+}
+
+static void write_bytes(png_writer_t *writer, const void *bytes,
+                        size_t size) {
+  fwrite(bytes, 1, size, writer->file);
+  writer->crc = update_crc(writer->crc, bytes, size);
+}
+
+static void begin_chunk(png_writer_t *writer, const char *type,
+                        uint32_t size) {
+  write_u32(writer, size);
+  writer->crc = 0xffffffffu;
+  write_bytes(writer, type, 4);
+}
+
+static void end_chunk(png_writer_t *writer) {
+  const uint32_t crc = writer->crc ^ 0xffffffffu;
+  write_u32(writer, crc);
+}
+
+// Write image bytes into a stored (uncompressed) deflate block, updating the
+// Adler-32 checksum that zlib requires at the end of the stream.
+static void write_image_bytes(png_writer_t *writer, const uint8_t *bytes,
+                              size_t size) {
+  for (size_t i = 0; i < size; ++i) {
+    writer->adler_a = (writer->adler_a + bytes[i]) % 65521u;
+    writer->adler_b = (writer->adler_b + writer->adler_a) % 65521u;
+  }
+  write_bytes(writer, bytes, size);
+}
+
+bool az_write_png_file(const char *path, int width, int height,
+                       const uint8_t *rgb) {
+  assert(width > 0);
+  assert(height > 0);
+  // Each row of the image data is a filter-type byte followed by the pixels.
+  // Stored deflate blocks hold at most 65535 bytes, so use one block per row
+  // (which is plenty for any reasonable width).
+  const uint32_t row_size = 1 + 3 * (uint32_t)width;
+  if (row_size > 65535u) return false;
+  FILE *file = fopen(path, "wb");
+  if (file == NULL) return false;
+  png_writer_t writer = {.file = file, .adler_a = 1u};
+  static const uint8_t signature[8] = {137, 'P', 'N', 'G', '\r', '\n', 26,
+                                       '\n'};
+  fwrite(signature, 1, sizeof(signature), file);
+  begin_chunk(&writer, "IHDR", 13); {
+    write_u32(&writer, width);
+    write_u32(&writer, height);
+    // 8 bits per channel, RGB, default compression/filter, no interlace:
+    const uint8_t format[5] = {8, 2, 0, 0, 0};
+    write_bytes(&writer, format, sizeof(format));
+  } end_chunk(&writer);
+  begin_chunk(&writer, "IDAT", 2 + height * (5 + row_size) + 4); {
+    const uint8_t zlib_header[2] = {0x78, 0x01};
+    write_bytes(&writer, zlib_header, sizeof(zlib_header));
+    for (int y = 0; y < height; ++y) {
+      const uint8_t block_header[5] = {
+        (y == height - 1 ? 1 : 0), row_size, row_size >> 8,
+        ~row_size, ~row_size >> 8
+      };
+      write_bytes(&writer, block_header, sizeof(block_header));
+      const uint8_t filter_type = 0;
+      write_image_bytes(&writer, &filter_type, 1);
+      write_image_bytes(&writer, &rgb[(size_t)y * 3 * width], 3 * width);
+    }
+    write_u32(&writer, (writer.adler_b << 16) | writer.adler_a);
+  } end_chunk(&writer);
+  begin_chunk(&writer, "IEND", 0);
+  end_chunk(&writer);
+  const bool ok = !ferror(file);
+  return (fclose(file) == 0 && ok);
+}
+
+/*===========================================================================*/
@@ -0,0 +1,38 @@
+/*=============================================================================
+| Copyright 2012 Matthew D. Steele <mdsteele@alum.mit.edu>                    |
+|                                                                             |
+| This file is part of Azimuth.                                               |
+|                                                                             |
+| Azimuth is free software: you can redistribute it and/or modify it under    |
+| the terms of the GNU General Public License as published by the Free        |
+| Software Foundation, either version 3 of the License, or (at your option)   |
+| any later version.                                                          |
+|                                                                             |
+| Azimuth is distributed in the hope that it will be useful, but WITHOUT      |
+| ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       |
+| FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for   |
+| more details.                                                               |
+|                                                                             |
+| You should have received a copy of the GNU General Public License along     |
+| with Azimuth.  If not, see <http://www.gnu.org/licenses/>.                  |
+=============================================================================*/
+
+
+#pragma once
+#ifndef BENCH_PNG_H_
+#define BENCH_PNG_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*===========================================================================*/
+
+// Write an 8-bit RGB image to a PNG file at the given path, returning true on
+// success.  The pixels are given row by row, from the top of the image down.
+// The image data is stored uncompressed, which is simple and fast, if large.
+bool az_write_png_file(const char *path, int width, int height,
+                       const uint8_t *rgb);
+
+/*===========================================================================*/
+
+#endif // BENCH_PNG_H_
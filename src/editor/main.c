@@ -37,6 +37,10 @@
 #include "azimuth/state/upgrade.h"
 #include "azimuth/state/wall.h" // for az_init_wall_datas
 #include "azimuth/util/misc.h"
+#include "azimuth/view/baddie.h" // for az_init_baddie_drawing
+#include "azimuth/view/doodad.h" // for az_init_doodad_drawing
+#include "azimuth/view/node.h" // for az_init_node_drawing
+#include "azimuth/view/shape.h" // for az_init_shape_drawing
 #include "azimuth/view/wall.h" // for az_init_wall_drawing
 #include "editor/list.h"
 #include "editor/state.h"
@@ -1794,12 +1798,16 @@ static void event_loop(void) {
 int main(int argc, char **argv) {
   az_init_baddie_datas();
   az_init_wall_datas();
+  az_register_gl_init_func(az_init_baddie_drawing);
+  az_register_gl_init_func(az_init_doodad_drawing);
+  az_register_gl_init_func(az_init_node_drawing);
+  az_register_gl_init_func(az_init_shape_drawing);
   az_register_gl_init_func(az_init_wall_drawing);
   if (!az_load_editor_state(&state)) {
     printf("Failed to load scenario.\n");
     return EXIT_FAILURE;
   }
-  az_init_gui(false, false);
+  az_init_gui(false, AZ_GFX_LEGACY, AZ_AA_MSAA_2X, false, false);
 
   event_loop();
   az_destroy_editor_state(&state);
@@ -22,10 +22,9 @@
 #include <assert.h>
 #include <math.h>
 
-#include <SDL_opengl.h>
-
 #include "azimuth/constants.h"
 #include "azimuth/gui/event.h" // for az_get_mouse_position
+#include "azimuth/gui/opengl.h"
 #include "azimuth/state/baddie.h"
 #include "azimuth/util/misc.h"
 #include "azimuth/util/vector.h"
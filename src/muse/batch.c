@@ -0,0 +1,208 @@
+/*=============================================================================
+| Copyright 2012 Matthew D. Steele <mdsteele@alum.mit.edu>                    |
+|                                                                             |
+| This file is part of Azimuth.                                               |
+|                                                                             |
+| Azimuth is free software: you can redistribute it and/or modify it under    |
+| the terms of the GNU General Public License as published by the Free        |
+| Software Foundation, either version 3 of the License, or (at your option)   |
+| any later version.                                                          |
+|                                                                             |
+| Azimuth is distributed in the hope that it will be useful, but WITHOUT      |
+| ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       |
+| FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for   |
+| more details.                                                               |
+|                                                                             |
+| You should have received a copy of the GNU General Public License along     |
+| with Azimuth.  If not, see <http://www.gnu.org/licenses/>.                  |
+=============================================================================*/
+
+
+#include "muse/batch.h"
+
+#include <assert.h>
+#include <dirent.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <SDL_timer.h>
+
+#include "azimuth/state/music.h"
+#include "azimuth/system/parallel.h"
+#include "azimuth/util/misc.h"
+#include "azimuth/util/music.h"
+#include "azimuth/util/rw.h"
+#include "azimuth/util/sound.h"
+#include "azimuth/util/string.h"
+#include "muse/wave.h"
+
+/*===========================================================================*/
+
+typedef struct {
+  char *name; // filename, without directory
+  bool loaded;
+  az_music_t music;
+} track_t;
+
+typedef struct {
+  const track_t *track;
+  int flag;
+  char *out_path;
+  // Filled in by the job:
+  bool success;
+  double seconds; // wall-clock time taken to render
+} render_job_t;
+
+typedef struct {
+  double duration;
+  render_job_t *jobs;
+} batch_t;
+
+static bool has_suffix(const char *str, const char *suffix) {
+  const size_t length = strlen(str), suffix_length = strlen(suffix);
+  return (length > suffix_length &&
+          strcmp(str + length - suffix_length, suffix) == 0);
+}
+
+// Comparison function for qsort.
+static int compare_tracks(const void *ptr1, const void *ptr2) {
+  return strcmp(((const track_t *)ptr1)->name, ((const track_t *)ptr2)->name);
+}
+
+// Find all music files in the given directory, sorted by name.
+static bool list_tracks(const char *music_dir, int *num_tracks_out,
+                        track_t **tracks_out) {
+  DIR *dir = opendir(music_dir);
+  if (dir == NULL) return false;
+  int num_tracks = 0, max_tracks = 0;
+  track_t *tracks = NULL;
+  struct dirent *entry;
+  while ((entry = readdir(dir)) != NULL) {
+    if (!has_suffix(entry->d_name, ".txt")) continue;
+    if (num_tracks == max_tracks) {
+      max_tracks = (max_tracks == 0 ? 16 : 2 * max_tracks);
+      tracks = realloc(tracks, max_tracks * sizeof(track_t));
+      if (tracks == NULL) AZ_FATAL("realloc failed.\n");
+    }
+    track_t *track = &tracks[num_tracks++];
+    AZ_ZERO_OBJECT(track);
+    track->name = az_strdup(entry->d_name);
+  }
+  closedir(dir);
+  if (num_tracks > 0) {
+    qsort(tracks, num_tracks, sizeof(track_t), &compare_tracks);
+  }
+  *num_tracks_out = num_tracks;
+  *tracks_out = tracks;
+  return true;
+}
+
+static void render_job(void *userdata, int index) {
+  const batch_t *batch = userdata;
+  render_job_t *job = &batch->jobs[index];
+  const Uint64 start = SDL_GetPerformanceCounter();
+  FILE *file = fopen(job->out_path, "wb");
+  if (file == NULL) return;
+  // Each job gets its own synth, but the parsed music is shared (read-only)
+  // between all jobs for the same track.
+  az_music_synth_t *synth = AZ_ALLOC(1, az_music_synth_t);
+  az_reset_music_synth(synth, &job->track->music, job->flag);
+  az_write_music_to_wav_file(file, synth, batch->duration);
+  free(synth);
+  job->success = (fclose(file) == 0);
+  job->seconds = (double)(SDL_GetPerformanceCounter() - start) /
+    (double)SDL_GetPerformanceFrequency();
+}
+
+bool az_render_music_batch(const char *music_dir, const char *out_dir,
+                           double duration, int num_flags, const int *flags) {
+  assert(duration > 0.0);
+  assert(num_flags > 0);
+  int num_tracks = 0;
+  track_t *tracks = NULL;
+  if (!list_tracks(music_dir, &num_tracks, &tracks)) {
+    fprintf(stderr, "ERROR: could not read directory %s\n", music_dir);
+    return false;
+  }
+
+  // Load all of the music up front, so that the render jobs need only read it.
+  int num_drums = 0;
+  const az_sound_data_t *drums = NULL;
+  az_get_drum_kit(&num_drums, &drums);
+  bool success = true;
+  for (int i = 0; i < num_tracks; ++i) {
+    track_t *track = &tracks[i];
+    char *path = az_strprintf("%s/%s", music_dir, track->name);
+    az_reader_t reader;
+    if (!az_file_reader(path, &reader)) {
+      fprintf(stderr, "ERROR: could not open %s\n", path);
+      success = false;
+    } else {
+      track->loaded = az_read_music(&reader, num_drums, drums, &track->music);
+      az_rclose(&reader);
+      if (!track->loaded) {
+        fprintf(stderr, "ERROR: failed to parse %s\n", path);
+        success = false;
+      }
+    }
+    free(path);
+  }
+
+  // Make one job for each combination of track and flag:
+  batch_t batch = {
+    .duration = duration,
+    .jobs = AZ_ALLOC(num_tracks * num_flags, render_job_t)
+  };
+  int num_jobs = 0;
+  for (int i = 0; i < num_tracks; ++i) {
+    if (!tracks[i].loaded) continue;
+    const size_t name_length = strlen(tracks[i].name) - strlen(".txt");
+    for (int j = 0; j < num_flags; ++j) {
+      render_job_t *job = &batch.jobs[num_jobs++];
+      job->track = &tracks[i];
+      job->flag = flags[j];
+      job->out_path = az_strprintf("%s/%.*s-flag%d.wav", out_dir,
+                                   (int)name_length, tracks[i].name, flags[j]);
+    }
+  }
+
+  const Uint64 start = SDL_GetPerformanceCounter();
+  // The jobs reset their synths concurrently, so set up the shared wavetables
+  // before fanning out, rather than letting the first job to get there do it.
+  az_init_music_synth_tables();
+  az_system_parallel_for(num_jobs, render_job, &batch);
+  const double total_seconds = (double)(SDL_GetPerformanceCounter() - start) /
+    (double)SDL_GetPerformanceFrequency();
+
+  double job_seconds = 0.0;
+  for (int i = 0; i < num_jobs; ++i) {
+    const render_job_t *job = &batch.jobs[i];
+    if (job->success) {
+      fprintf(stderr, "%-16s flag=%-3d %8.3f s  %8.1fx real time\n",
+              job->track->name, job->flag, job->seconds,
+              duration / job->seconds);
+      job_seconds += job->seconds;
+    } else {
+      fprintf(stderr, "ERROR: failed to write %s\n", job->out_path);
+      success = false;
+    }
+    free(job->out_path);
+  }
+  fprintf(stderr, "Rendered %d files (%.1f s of audio) in %.3f s: "
+          "%.1fx real time overall (%.1fx per job)\n",
+          num_jobs, num_jobs * duration, total_seconds,
+          num_jobs * duration / total_seconds,
+          (job_seconds > 0.0 ? num_jobs * duration / job_seconds : 0.0));
+
+  free(batch.jobs);
+  for (int i = 0; i < num_tracks; ++i) {
+    if (tracks[i].loaded) az_destroy_music(&tracks[i].music);
+    free(tracks[i].name);
+  }
+  free(tracks);
+  return success;
+}
+
+/*===========================================================================*/
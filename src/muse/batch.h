@@ -0,0 +1,38 @@
+/*=============================================================================
+| Copyright 2012 Matthew D. Steele <mdsteele@alum.mit.edu>                    |
+|                                                                             |
+| This file is part of Azimuth.                                               |
+|                                                                             |
+| Azimuth is free software: you can redistribute it and/or modify it under    |
+| the terms of the GNU General Public License as published by the Free        |
+| Software Foundation, either version 3 of the License, or (at your option)   |
+| any later version.                                                          |
+|                                                                             |
+| Azimuth is distributed in the hope that it will be useful, but WITHOUT      |
+| ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       |
+| FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for   |
+| more details.                                                               |
+|                                                                             |
+| You should have received a copy of the GNU General Public License along     |
+| with Azimuth.  If not, see <http://www.gnu.org/licenses/>.                  |
+=============================================================================*/
+
+
+#pragma once
+#ifndef MUSE_BATCH_H_
+#define MUSE_BATCH_H_
+
+#include <stdbool.h>
+
+/*===========================================================================*/
+
+// Render every combination of a music file in music_dir (i.e. each *.txt
+// file) and one of the given flag values to a WAV file of the given duration
+// (in seconds) in out_dir, spreading the work across all CPUs, and report the
+// real-time factor for each.  Returns false if anything failed.
+bool az_render_music_batch(const char *music_dir, const char *out_dir,
+                           double duration, int num_flags, const int *flags);
+
+/*===========================================================================*/
+
+#endif // MUSE_BATCH_H_
@@ -18,13 +18,17 @@
 =============================================================================*/
 
 #include <assert.h>
+#include <stdbool.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include <SDL.h>
 
 #include "azimuth/state/music.h"
+#include "azimuth/util/misc.h"
 #include "azimuth/util/music.h"
 #include "azimuth/util/sound.h"
+#include "muse/batch.h"
 #include "muse/wave.h"
 
 /*===========================================================================*/
@@ -43,9 +47,34 @@ static void destroy_music(void) {
   az_destroy_music(&music);
 }
 
+// Handle "muse -b <music-dir> <out-dir> <duration> [<flag>...]".
+static int batch_main(int argc, char **argv) {
+  double duration = 0.0;
+  if (sscanf(argv[4], "%lf", &duration) < 1 || duration <= 0.0) {
+    fprintf(stderr, "Invalid WAV duration: %s\n", argv[4]);
+    return EXIT_FAILURE;
+  }
+  const int num_flags = (argc > 5 ? argc - 5 : 1);
+  int *flags = AZ_ALLOC(num_flags, int);
+  for (int i = 5; i < argc; ++i) {
+    if (sscanf(argv[i], "%d", &flags[i - 5]) < 1) {
+      fprintf(stderr, "Invalid flag value: %s\n", argv[i]);
+      free(flags);
+      return EXIT_FAILURE;
+    }
+  }
+  const bool success =
+    az_render_music_batch(argv[2], argv[3], duration, num_flags, flags);
+  free(flags);
+  return (success ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+
 int main(int argc, char **argv) {
+  if (argc >= 5 && strcmp(argv[1], "-b") == 0) return batch_main(argc, argv);
   if (argc < 2 || argc > 4) {
-    fprintf(stderr, "Usage: %s <filename> [<flag>] [<duration>]\n", argv[0]);
+    fprintf(stderr, "Usage: %s <filename> [<flag>] [<duration>]\n"
+            "       %s -b <music-dir> <out-dir> <duration> [<flag>...]\n",
+            argv[0], argv[0]);
     return EXIT_FAILURE;
   }
   int music_flag = 0;
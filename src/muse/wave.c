@@ -51,7 +51,7 @@ void az_write_music_to_wav_file(FILE *file, az_music_synth_t *synth,
   const int data_size = num_samples * bytes_per_sample;
   // Header:
   fputs("RIFF", file);
-  write_int32(file, 36 * data_size);
+  write_int32(file, 36 + data_size);
   fputs("WAVE", file);
   // Format:
   fputs("fmt ", file);
@@ -66,13 +66,18 @@ void az_write_music_to_wav_file(FILE *file, az_music_synth_t *synth,
   fputs("data", file);
   write_int32(file, data_size);
   int16_t buffer[1024];
+  uint8_t bytes[2 * AZ_ARRAY_SIZE(buffer)];
   int samples_remaining = num_samples;
   while (samples_remaining > 0) {
     int samples_written = az_imin(samples_remaining, AZ_ARRAY_SIZE(buffer));
     az_synthesize_music(synth, buffer, samples_written);
+    // Convert to little-endian a block at a time, rather than writing each
+    // sample with its own pair of fputc calls.
     for (int i = 0; i < samples_written; ++i) {
-      write_int16(file, buffer[i]);
+      bytes[2 * i] = (uint16_t)buffer[i] & 0xff;
+      bytes[2 * i + 1] = ((uint16_t)buffer[i] >> 8) & 0xff;
     }
+    fwrite(bytes, 2, samples_written, file);
     samples_remaining -= samples_written;
   }
 }
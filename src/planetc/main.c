@@ -0,0 +1,67 @@
+/*=============================================================================
+| Copyright 2012 Matthew D. Steele <mdsteele@alum.mit.edu>                    |
+|                                                                             |
+| This file is part of Azimuth.                                               |
+|                                                                             |
+| Azimuth is free software: you can redistribute it and/or modify it under    |
+| the terms of the GNU General Public License as published by the Free        |
+| Software Foundation, either version 3 of the License, or (at your option)   |
+| any later version.                                                          |
+|                                                                             |
+| Azimuth is distributed in the hope that it will be useful, but WITHOUT      |
+| ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       |
+| FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for   |
+| more details.                                                               |
+|                                                                             |
+| You should have received a copy of the GNU General Public License along     |
+| with Azimuth.  If not, see <http://www.gnu.org/licenses/>.                  |
+=============================================================================*/
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "azimuth/state/planet.h"
+#include "azimuth/state/wall.h" // for az_init_wall_datas
+#include "azimuth/util/rw.h"
+#include "azimuth/util/string.h"
+
+/*===========================================================================*/
+
+// Compiles the scenario's text files (which remain the source of truth, and
+// are what the editor reads and writes) into a planet image for the game to
+// load.  This is run as part of the build, so it must be built for the same
+// machine as the game.
+
+static const char *data_dir;
+
+static bool resource_reader(const char *name, az_reader_t *reader) {
+  char *path = az_strprintf("%s/%s", data_dir, name);
+  const bool success = az_file_reader(path, reader);
+  free(path);
+  return success;
+}
+
+int main(int argc, char **argv) {
+  if (argc != 3) {
+    fprintf(stderr, "Usage: %s <data-dir> <out-file>\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+  data_dir = argv[1];
+  az_init_wall_datas();
+  az_planet_t planet;
+  if (!az_read_planet(&resource_reader, &planet)) {
+    fprintf(stderr, "Failed to read planet from %s\n", data_dir);
+    return EXIT_FAILURE;
+  }
+  const bool success = az_save_planet_image_to_path(&planet, argv[2]);
+  az_destroy_planet(&planet);
+  if (!success) {
+    fprintf(stderr, "Failed to write planet image to %s\n", argv[2]);
+    remove(argv[2]);
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
+
+/*===========================================================================*/
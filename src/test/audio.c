@@ -17,12 +17,18 @@
 | with Azimuth.  If not, see <http://www.gnu.org/licenses/>.                  |
 =============================================================================*/
 
+#include <math.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 
 #include "azimuth/util/audio.h"
+#include "azimuth/util/misc.h"
 #include "azimuth/util/music.h"
+#include "azimuth/util/parallel.h"
 #include "azimuth/util/rw.h"
 #include "azimuth/util/sound.h"
+#include "azimuth/util/vector.h"
 #include "test/test.h"
 
 /*===========================================================================*/
@@ -42,6 +48,179 @@ void test_create_sound_data(void) {
   EXPECT_TRUE(data.samples == NULL);
 }
 
+void test_sound_cache(void) {
+  az_sound_spec_t specs[2] = {
+    { .wave_kind = AZ_SINE_WAVE, .env_decay = 0.125, .start_freq = 0.5 },
+    { .wave_kind = AZ_NOISE_WAVE, .env_decay = 0.1, .start_freq = 0.3 }
+  };
+  az_sound_data_t datas[2];
+  az_create_sound_data(&specs[0], &datas[0]);
+  az_create_sound_data(&specs[1], &datas[1]);
+  // Save the sounds to a cache, and read the whole cache back into memory.
+  char *cache = NULL;
+  long cache_size = 0;
+  {
+    FILE *file = tmpfile();
+    ASSERT_TRUE(file != NULL);
+    EXPECT_TRUE(az_save_sound_cache_to_file(2, specs, datas, file));
+    cache_size = ftell(file);
+    rewind(file);
+    cache = malloc(cache_size);
+    EXPECT_TRUE(fread(cache, 1, cache_size, file) == (size_t)cache_size);
+    fclose(file);
+  }
+  RETURN_IF_FAILED();
+  // Each sound should be found in the cache, with the same samples.
+  for (int i = 0; i < 2; ++i) {
+    az_sound_data_t cached;
+    ASSERT_TRUE(az_find_cached_sound_data(cache, cache_size, &specs[i],
+                                          &cached));
+    EXPECT_TRUE(cached.borrowed);
+    EXPECT_INT_EQ(datas[i].num_samples, cached.num_samples);
+    EXPECT_TRUE(memcmp(datas[i].samples, cached.samples,
+                       datas[i].num_samples * sizeof(int16_t)) == 0);
+    // Destroying borrowed sound data shouldn't free the cache.
+    az_destroy_sound_data(&cached);
+  }
+  // A sound whose spec has changed should not be found.
+  az_sound_spec_t changed_spec = specs[0];
+  changed_spec.env_decay = 0.25;
+  az_sound_data_t cached = { .num_samples = 0 };
+  EXPECT_FALSE(az_find_cached_sound_data(cache, cache_size, &changed_spec,
+                                         &cached));
+  // Nor should anything whose samples were cut off by truncating the file.
+  EXPECT_FALSE(az_find_cached_sound_data(cache, cache_size - 2, &specs[1],
+                                         &cached));
+  EXPECT_FALSE(az_find_cached_sound_data(cache, 8, &specs[0], &cached));
+  EXPECT_FALSE(az_find_cached_sound_data(NULL, 0, &specs[0], &cached));
+  EXPECT_INT_EQ(0, cached.num_samples);
+  free(cache);
+  az_destroy_sound_data(&datas[0]);
+  az_destroy_sound_data(&datas[1]);
+}
+
+void test_resample_sound(void) {
+  int16_t samples[64];
+  for (int i = 0; i < 64; ++i) samples[i] = (i % 2 ? 1000 : -1000) + 5000;
+  const az_sound_data_t data = { .num_samples = 64, .samples = samples };
+  // Resampling at the data's own rate should just copy the samples.
+  const uint64_t one = UINT64_C(1) << AZ_RESAMPLE_FRAC_BITS;
+  EXPECT_TRUE(az_resample_step(AZ_AUDIO_RATE) == one);
+  int16_t output[256];
+  uint64_t position = 0;
+  EXPECT_INT_EQ(64, az_resample_sound(&data, &position, one, output, 256));
+  EXPECT_TRUE(position == 64 * one);
+  EXPECT_TRUE(memcmp(samples, output, sizeof(samples)) == 0);
+  // Upsampling should produce proportionally more samples, starting at the
+  // given position.  Away from the ends of the data, the alternating part of
+  // the signal (which is at the data's Nyquist frequency) should be filtered
+  // out, leaving just the constant part.
+  const uint64_t step = az_resample_step(44100);
+  EXPECT_TRUE(step == one / 2);
+  position = 8 * one;
+  EXPECT_INT_EQ(100, az_resample_sound(&data, &position, step, output, 100));
+  EXPECT_TRUE(position == 58 * one);
+  for (int i = 1; i < 100; i += 2) EXPECT_WITHIN(5000, output[i], 2);
+  position = 0;
+  EXPECT_INT_EQ(128, az_resample_sound(&data, &position, step, output, 256));
+  // Past the end of the data, there is only silence.
+  EXPECT_INT_EQ(0, az_resample_sound_at(&data, 70 * one));
+}
+
+void test_sound_stream(void) {
+  const az_sound_spec_t spec = {
+    .wave_kind = AZ_SQUARE_WAVE, .env_sustain = 0.3, .env_decay = 0.4,
+    .start_freq = 0.3, .repeat_speed = 0.6, .phaser_offset = 0.2,
+    .phaser_sweep = -0.1
+  };
+  az_sound_data_t data;
+  az_create_sound_data(&spec, &data);
+  ASSERT_TRUE(data.num_samples > 4096);
+  const int rates[] = {AZ_AUDIO_RATE, 44100, 48000};
+  for (int r = 0; r < 3; ++r) {
+    const uint64_t step = az_resample_step(rates[r]);
+    // Stream the sound a chunk at a time, and resample the complete data the
+    // same way; they should match exactly, except that the stream may run on
+    // a little longer (since it doesn't trim trailing zeros).
+    const int max_output = (int)((data.num_samples + 4096) *
+                                 (uint64_t)rates[r] / AZ_AUDIO_RATE);
+    int16_t *streamed = AZ_ALLOC(max_output, int16_t);
+    int16_t *resampled = AZ_ALLOC(max_output, int16_t);
+    az_sound_stream_t *stream = az_new_sound_stream(&spec);
+    int num_streamed = 0;
+    while (true) {
+      const int chunk = az_imin(333, max_output - num_streamed);
+      const int count =
+        az_stream_sound(stream, step, streamed + num_streamed, chunk);
+      num_streamed += count;
+      if (count < chunk) break;
+    }
+    az_delete_sound_stream(stream);
+    uint64_t position = 0;
+    const int num_resampled =
+      az_resample_sound(&data, &position, step, resampled, max_output);
+    EXPECT_TRUE(num_streamed >= num_resampled);
+    EXPECT_TRUE(num_streamed < max_output);
+    EXPECT_TRUE(memcmp(streamed, resampled,
+                       num_resampled * sizeof(int16_t)) == 0);
+    free(streamed);
+    free(resampled);
+  }
+  az_destroy_sound_data(&data);
+}
+
+static const az_sound_spec_t parallel_sound_specs[] = {
+  { .wave_kind = AZ_NOISE_WAVE, .env_decay = 0.2, .start_freq = 0.4 },
+  { .wave_kind = AZ_SQUARE_WAVE, .env_sustain = 0.1, .env_decay = 0.3,
+    .start_freq = 0.3, .square_duty = 0.4, .repeat_speed = 0.6 },
+  { .wave_kind = AZ_NOISE_WAVE, .env_decay = 0.2, .start_freq = 0.4 },
+  { .wave_kind = AZ_SINE_WAVE, .env_decay = 0.15, .start_freq = 0.5,
+    .freq_slide = -0.2, .phaser_offset = 0.2, .phaser_sweep = -0.1 },
+  { .wave_kind = AZ_NOISE_WAVE, .env_sustain = 0.2, .env_decay = 0.1,
+    .start_freq = 0.2, .repeat_speed = 0.5 }
+};
+
+// The job that az_init_sound_datas hands to its parallel_for, but writing
+// into the given array rather than the global sound data.
+static void create_parallel_sound_job(void *userdata, int index) {
+  az_sound_data_t *datas = userdata;
+  az_create_sound_data(&parallel_sound_specs[index], &datas[index]);
+}
+
+// A stand-in for a thread pool, which may finish jobs in any order: this runs
+// the jobs back to front.
+static void reverse_for(int num_jobs, az_parallel_job_fn_t job,
+                        void *userdata) {
+  for (int i = num_jobs - 1; i >= 0; --i) job(userdata, i);
+}
+
+void test_parallel_sound_datas(void) {
+  // Each sound reseeds the noise generator, so generating the sounds out of
+  // order (as az_init_sound_datas does when given az_system_parallel_for)
+  // should give exactly the same samples as generating them in order.
+  const int num_sounds = AZ_ARRAY_SIZE(parallel_sound_specs);
+  az_sound_data_t serial[AZ_ARRAY_SIZE(parallel_sound_specs)];
+  az_sound_data_t reversed[AZ_ARRAY_SIZE(parallel_sound_specs)];
+  az_serial_for(num_sounds, create_parallel_sound_job, serial);
+  reverse_for(num_sounds, create_parallel_sound_job, reversed);
+  for (int i = 0; i < num_sounds; ++i) {
+    EXPECT_TRUE(serial[i].num_samples > 0);
+    EXPECT_INT_EQ(serial[i].num_samples, reversed[i].num_samples);
+    if (serial[i].num_samples != reversed[i].num_samples) continue;
+    EXPECT_TRUE(memcmp(serial[i].samples, reversed[i].samples,
+                       serial[i].num_samples * sizeof(int16_t)) == 0);
+  }
+  // Likewise, the same noise spec should give the same samples no matter
+  // what was generated before it.
+  ASSERT_INT_EQ(serial[0].num_samples, serial[2].num_samples);
+  EXPECT_TRUE(memcmp(serial[0].samples, serial[2].samples,
+                     serial[0].num_samples * sizeof(int16_t)) == 0);
+  for (int i = 0; i < num_sounds; ++i) {
+    az_destroy_sound_data(&serial[i]);
+    az_destroy_sound_data(&reversed[i]);
+  }
+}
+
 void test_persist_sound(void) {
   az_soundboard_t soundboard = { .num_persists = 0 };
   const az_sound_data_t sound1, sound2, sound3, sound4;
@@ -181,4 +360,240 @@ void test_parse_music_instructions(void) {
   az_destroy_music(&music);
 }
 
+// A PCM lookup for test_cached_music_part, which renders each part (with
+// each set of entry settings) the first time it's asked for.
+typedef struct {
+  int sample_rate;
+  int num_pcms;
+  az_music_part_pcm_t pcms[8];
+} test_pcm_cache_t;
+
+static const az_music_part_pcm_t *test_pcm_lookup(
+    void *userdata, const az_music_t *music, int part_index,
+    const az_music_voice_settings_t entry_settings[AZ_MUSIC_NUM_TRACKS]) {
+  test_pcm_cache_t *cache = userdata;
+  for (int i = 0; i < cache->num_pcms; ++i) {
+    const az_music_part_pcm_t *pcm = &cache->pcms[i];
+    if (pcm->part_index == part_index &&
+        memcmp(pcm->entry_settings, entry_settings,
+               sizeof(pcm->entry_settings)) == 0) return pcm;
+  }
+  if (cache->num_pcms == AZ_ARRAY_SIZE(cache->pcms)) return NULL;
+  az_music_part_pcm_t *pcm = &cache->pcms[cache->num_pcms++];
+  az_render_music_part(music, part_index, entry_settings, cache->sample_rate,
+                       pcm);
+  return pcm;
+}
+
+// How far (in sample units) music played from pre-rendered parts may stray
+// from the same music synthesized live.  Each part starts every voice at
+// phase zero either way, and the song below has no noise voices (whose bits
+// the pre-rendered parts don't carry over), so the two should match exactly.
+#define MAX_CACHED_MUSIC_ERROR 0
+
+void test_cached_music_part(void) {
+  // Part B changes the voice settings that part A starts with, so A is
+  // rendered more than once.
+  const char *music_string =
+    "@M \"A|AB\"\n"
+    "=tempo 240\n"
+    "!Part A\n"
+    "1 Wp25 L30 E5,25 D+10,10\n"
+    "2 Wt50 L20 V5,8\n"
+    "1| c4q d e f |\n"
+    "2| c3h g2h |\n"
+    "!Part B\n"
+    "1 Wt30 E0,50\n"
+    "2 Wp50 L40\n"
+    "1| g4e f e d c4h |\n"
+    "2| c3w |\n";
+  az_music_t music;
+  PARSE_MUSIC_FROM_STRING(music_string, &music);
+  az_init_music_synth_tables();
+  const int rates[] = {AZ_AUDIO_RATE, 48000};
+  for (int r = 0; r < 2; ++r) {
+    // Play the music live, and again from pre-rendered parts, for long
+    // enough to go around the AB loop several times.
+    const int num_samples = 10 * rates[r];
+    int16_t *live = AZ_ALLOC(num_samples, int16_t);
+    int16_t *cached = AZ_ALLOC(num_samples, int16_t);
+    az_music_synth_t synth;
+    AZ_ZERO_OBJECT(&synth);
+    az_set_music_sample_rate(&synth, rates[r]);
+    az_reset_music_synth(&synth, &music, 0);
+    az_synthesize_music(&synth, live, num_samples);
+    test_pcm_cache_t cache = { .sample_rate = rates[r] };
+    az_set_music_pcm_lookup(&synth, test_pcm_lookup, &cache);
+    az_reset_music_synth(&synth, &music, 0);
+    // Synthesize in chunks, so that parts end partway through a chunk.
+    for (int start = 0; start < num_samples; start += 1000) {
+      az_synthesize_music(&synth, cached + start,
+                          az_imin(1000, num_samples - start));
+    }
+    EXPECT_TRUE(cache.num_pcms >= 3);
+    int max_error = 0, num_nonzero = 0;
+    for (int i = 0; i < num_samples; ++i) {
+      max_error = az_imax(max_error, abs(live[i] - cached[i]));
+      if (live[i] != 0) ++num_nonzero;
+    }
+    EXPECT_TRUE(max_error <= MAX_CACHED_MUSIC_ERROR);
+    EXPECT_TRUE(num_nonzero > num_samples / 2);
+    for (int i = 0; i < cache.num_pcms; ++i) {
+      az_destroy_music_part_pcm(&cache.pcms[i]);
+    }
+    free(live);
+    free(cached);
+  }
+  az_destroy_music(&music);
+}
+
+// The band-limited oscillators in the music synth should sound like ideal
+// ones: over the test song below, the overall RMS level of the synth's output
+// should be within MAX_SYNTH_LEVEL_ERROR (as a fraction) of that of a
+// heavily supersampled reference, and the RMS level over each
+// SYNTH_WINDOW_SECONDS window should on average be within
+// MAX_SYNTH_ENVELOPE_ERROR (as a fraction of the overall level) of the
+// reference's.
+#define MAX_SYNTH_LEVEL_ERROR 0.032
+#define MAX_SYNTH_ENVELOPE_ERROR 0.06
+#define SYNTH_WINDOW_SECONDS 0.1
+
+// The wave amplitude produced by an L100 note (as in azimuth/util/music.c):
+#define REFERENCE_BASE_LOUDNESS 6500.0
+#define REFERENCE_SUPERSAMPLES 32
+
+// Return the naive (aliased) value of the given wave at the given phase (from
+// 0 to 1).
+static double reference_wave(az_sound_wave_kind_t kind, double duty,
+                             double phase) {
+  switch (kind) {
+    case AZ_SINE_WAVE: return sin(phase * AZ_TWO_PI);
+    case AZ_SQUARE_WAVE: return (phase < duty ? 1.0 : -1.0);
+    case AZ_TRIANGLE_WAVE:
+      return (phase < duty ? 2.0 * (phase / duty) - 1.0 :
+              1.0 - 2.0 * ((phase - duty) / (1.0 - duty)));
+    default: AZ_ASSERT_UNREACHABLE();
+  }
+}
+
+// Add the given track (which must have no drums, noise, or duty modulation)
+// into the output, synthesizing it by averaging the naive wave over
+// REFERENCE_SUPERSAMPLES points per sample.  The notes are timed and
+// enveloped just as the synth does.
+static void render_reference_track(const az_music_track_t *track,
+                                   int sample_rate, double *output,
+                                   int num_samples) {
+  az_sound_wave_kind_t waveform = AZ_SQUARE_WAVE;
+  double duty = 0.5, loudness = REFERENCE_BASE_LOUDNESS;
+  double attack_time = 0.0, decay_fraction = 0.0;
+  double vibrato_depth = 0.0, vibrato_speed = 0.0;
+  int note_index = 0;
+  double time = 0.0, phase = 0.0;
+  for (int i = 0; i < num_samples; ++i) {
+    const az_music_note_t *note = NULL;
+    for (; note_index < track->num_notes; ++note_index) {
+      note = &track->notes[note_index];
+      if (note->type == AZ_NOTE_REST || note->type == AZ_NOTE_TONE) {
+        const double duration = (note->type == AZ_NOTE_REST ?
+                                 note->attributes.rest.duration :
+                                 note->attributes.tone.duration);
+        if (time < duration) break;
+        time -= duration;
+      } else if (note->type == AZ_NOTE_ENVELOPE) {
+        attack_time = note->attributes.envelope.attack_time;
+        decay_fraction = note->attributes.envelope.decay_fraction;
+      } else if (note->type == AZ_NOTE_LOUDNESS) {
+        loudness = REFERENCE_BASE_LOUDNESS * note->attributes.loudness.volume;
+      } else if (note->type == AZ_NOTE_VIBRATO) {
+        vibrato_depth = note->attributes.vibrato.depth;
+        vibrato_speed = note->attributes.vibrato.speed;
+      } else if (note->type == AZ_NOTE_WAVEFORM) {
+        waveform = note->attributes.waveform.kind;
+        duty = note->attributes.waveform.duty;
+      } else AZ_ASSERT_UNREACHABLE();
+    }
+    if (note_index >= track->num_notes) return;
+    if (note->type == AZ_NOTE_TONE) {
+      const double step = note->attributes.tone.frequency *
+        (1.0 + vibrato_depth * sin(time * vibrato_speed)) / sample_rate;
+      double sum = 0.0;
+      for (int j = 1; j <= REFERENCE_SUPERSAMPLES; ++j) {
+        const double p = phase + step * j / REFERENCE_SUPERSAMPLES;
+        sum += reference_wave(waveform, duty, p - floor(p));
+      }
+      phase += step;
+      phase -= floor(phase);
+      const double duration = note->attributes.tone.duration;
+      const double decay_time = duration * decay_fraction;
+      const double envelope =
+        (time < attack_time ? time / attack_time : 1.0) *
+        (duration - time < decay_time ? (duration - time) / decay_time : 1.0);
+      output[i] += sum / REFERENCE_SUPERSAMPLES * envelope * loudness;
+    }
+    time += 1.0 / sample_rate;
+  }
+}
+
+static double rms_level(const double *samples, int num_samples) {
+  double sum = 0.0;
+  for (int i = 0; i < num_samples; ++i) sum += samples[i] * samples[i];
+  return sqrt(sum / num_samples);
+}
+
+void test_music_synth_accuracy(void) {
+  // A song with high and low notes in every tone waveform, including narrow
+  // pulses (which alias the worst) and vibrato.
+  const char *music_string =
+    "@M \"A\"\n"
+    "=tempo 150\n"
+    "!Part A\n"
+    "1 Wp12 L40 E5,20\n"
+    "2 Ws L50 E20,30 V2,30\n"
+    "3 Wt50 L60\n"
+    "1| c6e g b c7 d e g c8 | c5q e g c6 |\n"
+    "2| c4h g | c5h c6 |\n"
+    "3| c2q g c3 g | c2w |\n";
+  az_music_t music;
+  PARSE_MUSIC_FROM_STRING(music_string, &music);
+  ASSERT_INT_EQ(1, music.num_parts);
+  const int rates[] = {AZ_AUDIO_RATE, 48000};
+  for (int r = 0; r < 2; ++r) {
+    const int rate = rates[r];
+    const int num_samples = 4 * rate;
+    double *reference = AZ_ALLOC(num_samples, double);
+    double *output = AZ_ALLOC(num_samples, double);
+    for (int t = 0; t < AZ_MUSIC_NUM_TRACKS; ++t) {
+      render_reference_track(&music.parts[0].tracks[t], rate, reference,
+                             num_samples);
+    }
+    int16_t *samples = AZ_ALLOC(num_samples, int16_t);
+    az_music_synth_t synth;
+    AZ_ZERO_OBJECT(&synth);
+    az_set_music_sample_rate(&synth, rate);
+    az_reset_music_synth(&synth, &music, 0);
+    az_synthesize_music(&synth, samples, num_samples);
+    for (int i = 0; i < num_samples; ++i) {
+      reference[i] = fmin(fmax(INT16_MIN, reference[i]), INT16_MAX);
+      output[i] = samples[i];
+    }
+    free(samples);
+    const double level = rms_level(reference, num_samples);
+    ASSERT_TRUE(level > 1000.0);
+    EXPECT_WITHIN(level, rms_level(output, num_samples),
+                  MAX_SYNTH_LEVEL_ERROR * level);
+    const int window = (int)(SYNTH_WINDOW_SECONDS * rate);
+    const int num_windows = num_samples / window;
+    double total_deviation = 0.0;
+    for (int w = 0; w < num_windows; ++w) {
+      total_deviation += fabs(rms_level(output + w * window, window) -
+                              rms_level(reference + w * window, window));
+    }
+    EXPECT_WITHIN(0.0, total_deviation / num_windows,
+                  MAX_SYNTH_ENVELOPE_ERROR * level);
+    free(reference);
+    free(output);
+  }
+  az_destroy_music(&music);
+}
+
 /*===========================================================================*/
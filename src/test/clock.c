@@ -47,6 +47,30 @@ void test_clock_mod(void) {
   EXPECT_TRUE(az_clock_mod(5, 3, 21) == 2);
 }
 
+void test_clock_tracking(void) {
+  // Nothing noted means nothing will change:
+  az_start_clock_tracking();
+  EXPECT_TRUE(az_stop_clock_tracking() == 0);
+  // Constant results don't count:
+  az_start_clock_tracking();
+  EXPECT_TRUE(az_clock_mod(1, 3, 7) == 0);
+  EXPECT_TRUE(az_stop_clock_tracking() == 0);
+  // The soonest change wins:
+  az_start_clock_tracking();
+  EXPECT_TRUE(az_clock_mod(5, 3, 7) == 2); // changes at 9
+  EXPECT_TRUE(az_clock_zigzag(5, 10, 14) == 1); // changes at 20
+  EXPECT_TRUE(az_stop_clock_tracking() == 2);
+  az_start_clock_tracking();
+  az_clock_note_change(10, 14);
+  EXPECT_TRUE(az_clock_zigzag(5, 3, 12) == 4); // changes at 15
+  az_clock_note_change(1, 100);
+  EXPECT_TRUE(az_stop_clock_tracking() == 1);
+  // Calls made while not tracking are ignored:
+  az_clock_note_change(1, 0);
+  az_start_clock_tracking();
+  EXPECT_TRUE(az_stop_clock_tracking() == 0);
+}
+
 void test_clock_zigzag(void) {
   EXPECT_TRUE(az_clock_zigzag(5, 3,  0) == 0);
   EXPECT_TRUE(az_clock_zigzag(5, 3,  1) == 0);
@@ -35,6 +35,7 @@ int main(int argc, char **argv) {
   RUN_TEST(test_arc_ray_hits_polygon);
   RUN_TEST(test_arc_ray_hits_polygon_trans);
   RUN_TEST(test_array_size);
+  RUN_TEST(test_cached_music_part);
   RUN_TEST(test_circle_hits_arc);
   RUN_TEST(test_circle_hits_circle);
   RUN_TEST(test_circle_hits_line);
@@ -47,6 +48,7 @@ int main(int argc, char **argv) {
   RUN_TEST(test_circle_touches_polygon);
   RUN_TEST(test_circle_touches_polygon_trans);
   RUN_TEST(test_clock_mod);
+  RUN_TEST(test_clock_tracking);
   RUN_TEST(test_clock_zigzag);
   RUN_TEST(test_color3f);
   RUN_TEST(test_create_sound_data);
@@ -61,13 +63,18 @@ int main(int argc, char **argv) {
   RUN_TEST(test_lead_target);
   RUN_TEST(test_modulo);
   RUN_TEST(test_mod2pi);
+  RUN_TEST(test_music_synth_accuracy);
   RUN_TEST(test_paragraph_length);
   RUN_TEST(test_paragraph_read);
+  RUN_TEST(test_parallel_sound_datas);
   RUN_TEST(test_parse_music);
   RUN_TEST(test_parse_music_instructions);
   RUN_TEST(test_persist_sound);
+  RUN_TEST(test_planet_image);
+  RUN_TEST(test_planet_lazy_rooms);
   RUN_TEST(test_player_flags);
   RUN_TEST(test_player_give_upgrade);
+  RUN_TEST(test_player_map_generation);
   RUN_TEST(test_player_set_room_visited);
   RUN_TEST(test_player_set_zone_mapped);
   RUN_TEST(test_polygon_contains);
@@ -84,11 +91,14 @@ int main(int argc, char **argv) {
   RUN_TEST(test_ray_hits_line_segment);
   RUN_TEST(test_ray_hits_polygon);
   RUN_TEST(test_ray_hits_polygon_trans);
+  RUN_TEST(test_resample_sound);
   RUN_TEST(test_script_clone);
   RUN_TEST(test_script_print);
   RUN_TEST(test_script_scan);
   RUN_TEST(test_select_gun);
   RUN_TEST(test_signmod);
+  RUN_TEST(test_sound_cache);
+  RUN_TEST(test_sound_stream);
   RUN_TEST(test_sound_volume);
   RUN_TEST(test_strdup);
   RUN_TEST(test_strprintf);
@@ -17,8 +17,15 @@
 | with Azimuth.  If not, see <http://www.gnu.org/licenses/>.                  |
 =============================================================================*/
 
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
 #include "azimuth/state/planet.h"
 #include "azimuth/state/player.h"
+#include "azimuth/util/misc.h"
+#include "azimuth/util/string.h"
 #include "test/test.h"
 
 /*===========================================================================*/
@@ -101,3 +108,249 @@ void test_hint_matches(void) {
 }
 
 /*===========================================================================*/
+
+static az_script_t *scan_script(const char *string) {
+  return az_sscan_script(string, strlen(string));
+}
+
+void test_planet_image(void) {
+  // Build a small planet (without walls, since those need the wall datas to
+  // be initialized).
+  az_planet_t planet = {
+    .start_room = 1, .on_start = scan_script("push3,set2;"),
+    .num_paragraphs = 2, .paragraphs = AZ_ALLOC(2, char*),
+    .num_zones = 1, .zones = AZ_ALLOC(1, az_zone_t),
+    .num_hints = 1, .hints = AZ_ALLOC(1, az_hint_t),
+    .num_rooms = 2, .rooms = AZ_ALLOC(2, az_room_t)
+  };
+  planet.paragraphs[0] = az_strdup("Hello, world!");
+  planet.paragraphs[1] = az_strdup("");
+  planet.zones[0].name = az_strdup("Zone");
+  planet.zones[0].entering_message = az_strdup("Entering: Zone");
+  planet.zones[0].color = (az_color_t){12, 34, 56, 255};
+  planet.hints[0] = (az_hint_t){
+    .properties = AZ_HINTF_OP2_IS_AND, .prereq2 = AZ_UPG_GUN_CHARGE,
+    .result = AZ_UPG_GUN_FREEZE, .target_room = 1
+  };
+  az_room_t *room = &planet.rooms[1];
+  room->on_start = scan_script("nop;");
+  room->num_baddies = 2;
+  room->baddies = AZ_ALLOC(2, az_baddie_spec_t);
+  room->baddies[0].position = (az_vector_t){100, -200};
+  room->baddies[1].on_kill = scan_script("push-23.5,set5;");
+  room->baddies[1].uuid_slot = 7;
+  room->num_doors = 1;
+  room->doors = AZ_ALLOC(1, az_door_spec_t);
+  room->doors[0].destination = 0;
+  room->doors[0].on_open = scan_script("push1;");
+  room->num_nodes = 1;
+  room->nodes = AZ_ALLOC(1, az_node_spec_t);
+  room->nodes[0].kind = AZ_NODE_UPGRADE;
+  room->nodes[0].subkind.upgrade = AZ_UPG_GUN_FREEZE;
+  room->nodes[0].angle = 1.5;
+
+  // Save the planet as an image, and read the whole image back into suitably
+  // aligned memory.
+  char *buffer = NULL, *image = NULL;
+  long image_size = 0;
+  {
+    FILE *file = tmpfile();
+    ASSERT_TRUE(file != NULL);
+    EXPECT_TRUE(az_save_planet_image_to_file(&planet, file));
+    image_size = ftell(file);
+    rewind(file);
+    buffer = malloc(image_size + AZ_PLANET_IMAGE_ALIGN);
+    image = buffer + (AZ_PLANET_IMAGE_ALIGN - (uintptr_t)buffer %
+                      AZ_PLANET_IMAGE_ALIGN);
+    EXPECT_TRUE(fread(image, 1, image_size, file) == (size_t)image_size);
+    fclose(file);
+  }
+  RETURN_IF_FAILED();
+
+  // A misaligned image should be rejected (before it is touched).
+  az_planet_t loaded;
+  EXPECT_FALSE(az_load_planet_image(image + 8, image_size, &loaded));
+
+  // The loaded planet should be the same, but its arrays should point into the
+  // image itself, rather than into a copy.
+  ASSERT_TRUE(az_load_planet_image(image, image_size, &loaded));
+  EXPECT_TRUE(loaded.image == image);
+  EXPECT_TRUE((char *)loaded.rooms > image &&
+              (char *)loaded.rooms < image + image_size);
+  EXPECT_INT_EQ(1, loaded.start_room);
+  ASSERT_TRUE(loaded.on_start != NULL);
+  EXPECT_INT_EQ(2, loaded.on_start->num_instructions);
+  EXPECT_INT_EQ(AZ_OP_SET, loaded.on_start->instructions[1].opcode);
+  ASSERT_INT_EQ(2, loaded.num_paragraphs);
+  EXPECT_STRING_EQ("Hello, world!", loaded.paragraphs[0]);
+  EXPECT_STRING_EQ("", loaded.paragraphs[1]);
+  ASSERT_INT_EQ(1, loaded.num_zones);
+  EXPECT_STRING_EQ("Zone", loaded.zones[0].name);
+  EXPECT_STRING_EQ("Entering: Zone", loaded.zones[0].entering_message);
+  EXPECT_INT_EQ(34, loaded.zones[0].color.g);
+  ASSERT_INT_EQ(1, loaded.num_hints);
+  EXPECT_INT_EQ(AZ_UPG_GUN_CHARGE, loaded.hints[0].prereq2);
+  ASSERT_INT_EQ(2, loaded.num_rooms);
+  EXPECT_TRUE(loaded.rooms[0].on_start == NULL);
+  EXPECT_INT_EQ(0, loaded.rooms[0].num_baddies);
+  EXPECT_TRUE(loaded.rooms[0].baddies == NULL);
+  const az_room_t *loaded_room = &loaded.rooms[1];
+  ASSERT_TRUE(loaded_room->on_start != NULL);
+  EXPECT_INT_EQ(AZ_OP_NOP, loaded_room->on_start->instructions[0].opcode);
+  ASSERT_INT_EQ(2, loaded_room->num_baddies);
+  EXPECT_VAPPROX(((az_vector_t){100, -200}), loaded_room->baddies[0].position);
+  EXPECT_TRUE(loaded_room->baddies[0].on_kill == NULL);
+  ASSERT_TRUE(loaded_room->baddies[1].on_kill != NULL);
+  EXPECT_APPROX(-23.5,
+                loaded_room->baddies[1].on_kill->instructions[0].immediate);
+  EXPECT_INT_EQ(7, loaded_room->baddies[1].uuid_slot);
+  ASSERT_INT_EQ(1, loaded_room->num_doors);
+  ASSERT_TRUE(loaded_room->doors[0].on_open != NULL);
+  EXPECT_INT_EQ(1, loaded_room->doors[0].on_open->num_instructions);
+  EXPECT_INT_EQ(0, loaded_room->num_gravfields);
+  ASSERT_INT_EQ(1, loaded_room->num_nodes);
+  EXPECT_INT_EQ(AZ_NODE_UPGRADE, loaded_room->nodes[0].kind);
+  EXPECT_INT_EQ(AZ_UPG_GUN_FREEZE, loaded_room->nodes[0].subkind.upgrade);
+  EXPECT_APPROX(1.5, loaded_room->nodes[0].angle);
+  az_destroy_planet(&loaded);
+
+  // A truncated or mislabelled image should be rejected.
+  EXPECT_FALSE(az_load_planet_image(image, image_size - 16, &loaded));
+  EXPECT_TRUE(loaded.rooms == NULL);
+  image[0] = 'X';
+  EXPECT_FALSE(az_load_planet_image(image, image_size, &loaded));
+
+  free(buffer);
+  az_destroy_planet(&planet);
+}
+
+/*===========================================================================*/
+
+static const char *const lazy_planet_resources[][2] = {
+  {"rooms/planet.txt", "@P z1 h0 r3 t0 s0\n$s:nop;\n!Z\"Zone\" c(1,2,3)\n"},
+  {"rooms/room000.txt",
+   "@R z0 p0 k0 b1 d1 g0 n1 w0\n  c(100.00,50.00,0.000000,1.000000)\n"
+   "$s:push1;\n!B1 x1.00 y2.00 a0.000000 u0\n$k:push2;\n"
+   "!D1 x3.00 y4.00 a0.000000 r1 u0\n$o:push3;\n"
+   "!N1/2 x5.00 y6.00 a0.000000 u0\n$u:push4;\n"},
+  {"rooms/room001.txt",
+   "@R z0 p0 k0 b2 d1 g0 n1 w0\n  c(200.00,50.00,0.000000,1.000000)\n"
+   "!B1 x1.00 y2.00 a0.000000 u0\n!B1 x3.00 y4.00 a0.000000 u0\n"
+   "!D1 x5.00 y6.00 a0.000000 r0 u0\n!N2 x7.00 y8.00 a0.000000 u0\n"},
+  {"rooms/room002.txt",
+   "@R z0 p0 k0 b0 d1 g0 n0 w0\n  c(300.00,50.00,0.000000,1.000000)\n"
+   "$s:push5;\n!D1 x1.00 y2.00 a0.000000 r0 u0\n"}
+};
+
+static bool lazy_planet_reader(const char *name, az_reader_t *reader) {
+  AZ_ARRAY_LOOP(resource, lazy_planet_resources) {
+    if (strcmp((*resource)[0], name) == 0) {
+      az_cstring_reader((*resource)[1], reader);
+      return true;
+    }
+  }
+  return false;
+}
+
+void test_planet_lazy_rooms(void) {
+  // With a tiny cap, only the header and doors of each room should be read
+  // up front.
+  az_planet_t planet;
+  ASSERT_TRUE(az_read_planet_lazily(lazy_planet_reader, 1, &planet));
+  EXPECT_TRUE(planet.room_cache != NULL);
+  ASSERT_INT_EQ(3, planet.num_rooms);
+  const az_room_t *room0 = &planet.rooms[0];
+  EXPECT_FALSE(az_room_contents_loaded(&planet, 0));
+  EXPECT_TRUE(room0->properties & AZ_ROOMF_WITH_SAVE);
+  EXPECT_APPROX(100, room0->camera_bounds.min_r);
+  EXPECT_TRUE(room0->on_start == NULL);
+  EXPECT_INT_EQ(0, room0->num_baddies);
+  EXPECT_INT_EQ(0, room0->num_nodes);
+  ASSERT_INT_EQ(1, room0->num_doors);
+  EXPECT_INT_EQ(1, room0->doors[0].destination);
+  EXPECT_TRUE(room0->doors[0].on_open != NULL);
+  EXPECT_FALSE(planet.rooms[1].properties & AZ_ROOMF_WITH_SAVE);
+
+  // Loading a room should fill in the rest of it.
+  az_load_room_contents(&planet, 0, 0, NULL);
+  EXPECT_TRUE(az_room_contents_loaded(&planet, 0));
+  ASSERT_TRUE(room0->on_start != NULL);
+  EXPECT_INT_EQ(AZ_OP_PUSH, room0->on_start->instructions[0].opcode);
+  ASSERT_INT_EQ(1, room0->num_baddies);
+  EXPECT_TRUE(room0->baddies[0].on_kill != NULL);
+  ASSERT_INT_EQ(1, room0->num_nodes);
+  EXPECT_INT_EQ(AZ_NODE_CONSOLE, room0->nodes[0].kind);
+  EXPECT_INT_EQ(1, room0->num_doors);
+  EXPECT_TRUE(room0->properties & AZ_ROOMF_WITH_SAVE);
+
+  // A room that owns a running script shouldn't be evicted, even when that
+  // leaves us over the cap.
+  const az_script_t *running_scripts[] = {room0->on_start};
+  az_load_room_contents(&planet, 1, 1, running_scripts);
+  EXPECT_TRUE(az_room_contents_loaded(&planet, 0));
+  EXPECT_TRUE(az_room_contents_loaded(&planet, 1));
+  EXPECT_INT_EQ(2, planet.rooms[1].num_baddies);
+
+  // But otherwise, other rooms' contents should be freed (leaving their
+  // headers and doors alone) to get back under the cap.
+  az_load_room_contents(&planet, 2, 0, NULL);
+  EXPECT_TRUE(az_room_contents_loaded(&planet, 2));
+  EXPECT_FALSE(az_room_contents_loaded(&planet, 0));
+  EXPECT_FALSE(az_room_contents_loaded(&planet, 1));
+  EXPECT_TRUE(room0->on_start == NULL);
+  EXPECT_INT_EQ(0, room0->num_baddies);
+  EXPECT_INT_EQ(1, room0->num_doors);
+
+  // Prefetched contents should be adopted, and then rooms evicted to get back
+  // under the cap, sparing the current room and any room that owns a running
+  // script.
+  az_room_t contents;
+  ASSERT_TRUE(az_read_room_contents(&planet, 0, &contents));
+  running_scripts[0] = contents.on_start;
+  az_adopt_room_contents(&planet, 0, &contents, 2, 1, running_scripts);
+  EXPECT_TRUE(az_room_contents_loaded(&planet, 0));
+  EXPECT_TRUE(az_room_contents_loaded(&planet, 2));
+  EXPECT_INT_EQ(1, room0->num_baddies);
+  EXPECT_INT_EQ(1, room0->num_doors);
+  // With nothing else to evict, even the adopted room itself goes.
+  ASSERT_TRUE(az_read_room_contents(&planet, 1, &contents));
+  az_adopt_room_contents(&planet, 1, &contents, 2, 1, running_scripts);
+  EXPECT_FALSE(az_room_contents_loaded(&planet, 1));
+  EXPECT_TRUE(az_room_contents_loaded(&planet, 0));
+  EXPECT_TRUE(az_room_contents_loaded(&planet, 2));
+  EXPECT_INT_EQ(0, planet.rooms[1].num_baddies);
+  // Once the script is done, adopting contents evicts the older rooms first.
+  ASSERT_TRUE(az_read_room_contents(&planet, 1, &contents));
+  az_adopt_room_contents(&planet, 1, &contents, 1, 0, NULL);
+  EXPECT_TRUE(az_room_contents_loaded(&planet, 1));
+  EXPECT_FALSE(az_room_contents_loaded(&planet, 0));
+  EXPECT_FALSE(az_room_contents_loaded(&planet, 2));
+  EXPECT_INT_EQ(2, planet.rooms[1].num_baddies);
+  EXPECT_INT_EQ(1, planet.rooms[1].num_doors);
+  // A room that was loaded in the meantime keeps its contents, and the
+  // adopted copy is destroyed.
+  ASSERT_TRUE(az_read_room_contents(&planet, 1, &contents));
+  az_adopt_room_contents(&planet, 1, &contents, 1, 0, NULL);
+  EXPECT_INT_EQ(2, planet.rooms[1].num_baddies);
+  az_destroy_planet(&planet);
+
+  // With a generous cap, nothing should be evicted.
+  ASSERT_TRUE(az_read_planet_lazily(lazy_planet_reader, 1 << 20, &planet));
+  az_load_room_contents(&planet, 0, 0, NULL);
+  az_load_room_contents(&planet, 1, 0, NULL);
+  az_load_room_contents(&planet, 2, 0, NULL);
+  EXPECT_TRUE(az_room_contents_loaded(&planet, 0));
+  EXPECT_TRUE(az_room_contents_loaded(&planet, 1));
+  az_destroy_planet(&planet);
+
+  // A planet read all at once has every room loaded already.
+  ASSERT_TRUE(az_read_planet(lazy_planet_reader, &planet));
+  EXPECT_TRUE(planet.room_cache == NULL);
+  EXPECT_TRUE(az_room_contents_loaded(&planet, 0));
+  EXPECT_INT_EQ(1, planet.rooms[0].num_baddies);
+  az_load_room_contents(&planet, 0, 0, NULL);
+  EXPECT_INT_EQ(1, planet.rooms[0].num_baddies);
+  az_destroy_planet(&planet);
+}
+
+/*===========================================================================*/
@@ -110,6 +110,30 @@ void test_player_set_zone_mapped(void) {
   EXPECT_TRUE(az_test_zone_mapped(&player, 3));
 }
 
+void test_player_map_generation(void) {
+  az_player_t player1, player2;
+  az_init_player(&player1);
+  az_init_player(&player2);
+  EXPECT_TRUE(player1.map_generation != player2.map_generation);
+
+  const uint64_t generation = player1.map_generation;
+  az_set_flag(&player1, 6);
+  EXPECT_TRUE(player1.map_generation == generation);
+  az_set_room_visited(&player1, 38);
+  EXPECT_TRUE(player1.map_generation != generation);
+  EXPECT_TRUE(player1.map_generation != player2.map_generation);
+
+  // Setting bits that are already set doesn't count as a change.
+  const uint64_t generation2 = player1.map_generation;
+  az_set_room_visited(&player1, 38);
+  EXPECT_TRUE(player1.map_generation == generation2);
+  az_set_zone_mapped(&player1, 2);
+  EXPECT_TRUE(player1.map_generation != generation2);
+  const uint64_t generation3 = player1.map_generation;
+  az_set_zone_mapped(&player1, 2);
+  EXPECT_TRUE(player1.map_generation == generation3);
+}
+
 void test_player_flags(void) {
   az_player_t player = {.max_shields = 100};
   EXPECT_FALSE(az_test_flag(&player, 6));
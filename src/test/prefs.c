@@ -66,6 +66,9 @@ void test_prefs_save_load(void) {
   const az_preferences_t expected_prefs = {
     .music_volume = 0.125f, .sound_volume = 0.75f,
     .fullscreen_on_startup = false, .speedrun_timer = true,
+    .gfx_backend = AZ_GFX_CORE, .antialiasing = AZ_AA_POST_PROCESS,
+    .render_scale = 0.5f, .dynamic_render_scale = true, .render_thread = true,
+    .room_cache_kb = 300,
     .key_for_control = {
       [AZ_CONTROL_UP]      = AZ_KEY_M,
       [AZ_CONTROL_DOWN]    = AZ_KEY_A,
@@ -102,6 +105,13 @@ void test_prefs_save_load(void) {
   EXPECT_TRUE(actual_prefs.fullscreen_on_startup ==
               expected_prefs.fullscreen_on_startup);
   EXPECT_TRUE(actual_prefs.speedrun_timer == expected_prefs.speedrun_timer);
+  EXPECT_INT_EQ(expected_prefs.gfx_backend, actual_prefs.gfx_backend);
+  EXPECT_INT_EQ(expected_prefs.antialiasing, actual_prefs.antialiasing);
+  EXPECT_TRUE(actual_prefs.render_scale == expected_prefs.render_scale);
+  EXPECT_TRUE(actual_prefs.dynamic_render_scale ==
+              expected_prefs.dynamic_render_scale);
+  EXPECT_TRUE(actual_prefs.render_thread == expected_prefs.render_thread);
+  EXPECT_INT_EQ(expected_prefs.room_cache_kb, actual_prefs.room_cache_kb);
   expect_valid_controls(actual_prefs.key_for_control);
   expect_unique_keys_for_controls(actual_prefs.key_for_control);
   expect_controls_to_match(&actual_prefs, &expected_prefs);
@@ -115,7 +125,7 @@ void test_prefs_missing_values(void) {
   {
     FILE *file = tmpfile();
     ASSERT_TRUE(file != NULL);
-    EXPECT_TRUE(fputs("@F st=1   sv=-1 \n mv=1.5", file) >= 0);
+    EXPECT_TRUE(fputs("@F st=1   sv=-1 \n mv=1.5 rs=0.1", file) >= 0);
     rewind(file);
     EXPECT_TRUE(az_load_prefs_from_file(file, &actual_prefs));
     fclose(file);
@@ -123,9 +133,16 @@ void test_prefs_missing_values(void) {
   RETURN_IF_FAILED();
   EXPECT_APPROX(0, actual_prefs.sound_volume);
   EXPECT_APPROX(1, actual_prefs.music_volume);
+  EXPECT_APPROX(0.25, actual_prefs.render_scale);
   EXPECT_TRUE(actual_prefs.speedrun_timer);
   EXPECT_TRUE(actual_prefs.fullscreen_on_startup ==
               default_prefs.fullscreen_on_startup);
+  EXPECT_INT_EQ(default_prefs.gfx_backend, actual_prefs.gfx_backend);
+  EXPECT_INT_EQ(default_prefs.antialiasing, actual_prefs.antialiasing);
+  EXPECT_TRUE(actual_prefs.dynamic_render_scale ==
+              default_prefs.dynamic_render_scale);
+  EXPECT_TRUE(actual_prefs.render_thread == default_prefs.render_thread);
+  EXPECT_INT_EQ(default_prefs.room_cache_kb, actual_prefs.room_cache_kb);
   expect_valid_controls(actual_prefs.key_for_control);
   expect_unique_keys_for_controls(actual_prefs.key_for_control);
   expect_controls_to_match(&actual_prefs, &default_prefs);
@@ -55,7 +55,7 @@ static void event_loop(void) {
 
 int main(int argc, char **argv) {
   az_init_zfxr_state(&state);
-  az_init_gui(false, true);
+  az_init_gui(false, AZ_GFX_LEGACY, AZ_AA_MSAA_2X, false, true);
 
   event_loop();
 
@@ -20,7 +20,11 @@
 #include "zfxr/state.h"
 
 #include <math.h>
+#include <string.h>
 
+#include <SDL.h>
+
+#include "azimuth/gui/audio.h"
 #include "azimuth/util/audio.h"
 #include "azimuth/util/misc.h"
 #include "azimuth/util/random.h"
@@ -28,31 +32,95 @@
 
 /*===========================================================================*/
 
+// Long sounds (especially ones with repeat or phaser) can take a good fraction
+// of a second to synthesize, which is too long to wait every time a slider
+// moves.  So instead, we play each new version of the sound by streaming it
+// (synthesizing it as it plays), and meanwhile render it in full on a
+// background thread, so that it can be replayed from the rendered data until
+// the spec changes again.  There's only ever one zfxr state, so the
+// background thread's state can just be global.
+
+static SDL_Thread *render_thread = NULL;
+static SDL_atomic_t render_finished;
+static az_sound_spec_t render_spec;
+static az_sound_data_t render_data;
+
+static int render_thread_main(void *data) {
+  (void)data;
+  az_create_sound_data(&render_spec, &render_data);
+  SDL_AtomicSet(&render_finished, 1);
+  return 0;
+}
+
+static bool specs_equal(const az_sound_spec_t *spec1,
+                        const az_sound_spec_t *spec2) {
+  return memcmp(spec1, spec2, sizeof(az_sound_spec_t)) == 0;
+}
+
+static void update_rendering(az_zfxr_state_t *state) {
+  if (render_thread != NULL) {
+    // Don't replace the old sound data while our soundboard still plays it,
+    // or while we're about to start playing it.  Otherwise, the audio system
+    // will halt it as soon as it gets the soundboard we last sent, so once
+    // it has done that, we can free the data.
+    if (!SDL_AtomicGet(&render_finished) || state->ready_to_play ||
+        state->playing_sound_data || state->sent_sound_data) return;
+    SDL_WaitThread(render_thread, NULL);
+    render_thread = NULL;
+    az_wait_for_audio_commands();
+    az_destroy_sound_data(&state->sound_data);
+    state->sound_data = render_data;
+    state->sound_data_spec = render_spec;
+    state->have_sound_data = true;
+  }
+  if (state->have_sound_data &&
+      specs_equal(&state->sound_data_spec, &state->sound_spec)) return;
+  render_spec = state->sound_spec;
+  AZ_ZERO_OBJECT(&render_data);
+  SDL_AtomicSet(&render_finished, 0);
+  render_thread = SDL_CreateThread(render_thread_main, "zfxr_render", NULL);
+  if (render_thread == NULL) {
+    AZ_FATAL("SDL_CreateThread failed: %s\n", SDL_GetError());
+  }
+}
+
 void az_init_zfxr_state(az_zfxr_state_t *state) {
   AZ_ZERO_OBJECT(state);
   state->sound_spec.wave_kind = AZ_TRIANGLE_WAVE;
   state->sound_spec.env_decay = 0.375;
   state->sound_spec.start_freq = 0.25;
   state->sound_spec.freq_slide = 0.25;
-  az_create_sound_data(&state->sound_spec, &state->sound_data);
   state->request_play = true;
 }
 
 void az_tick_zfxr_state(az_zfxr_state_t *state, double time) {
+  // Our caller passed the soundboard from our previous tick to az_tick_audio.
+  state->sent_sound_data = state->playing_sound_data;
   if (state->request_play) {
-    if (state->ready_to_play) {
-      az_destroy_sound_data(&state->sound_data);
-      az_create_sound_data(&state->sound_spec, &state->sound_data);
-      az_persist_sound_data(&state->soundboard, &state->sound_data, 1);
+    if (state->have_sound_data &&
+        specs_equal(&state->sound_data_spec, &state->sound_spec)) {
+      // The rendered data is up to date, so play that.
+      if (state->ready_to_play) {
+        az_persist_sound_data(&state->soundboard, &state->sound_data, 1);
+        state->playing_sound_data = true;
+        state->request_play = false;
+        state->ready_to_play = false;
+      } else {
+        az_play_sound_stream(NULL, 0);
+        az_reset_sound_data(&state->soundboard, &state->sound_data);
+        state->ready_to_play = true;
+      }
+    } else {
+      // Otherwise, start streaming the sound right away.
+      az_play_sound_stream(az_new_sound_stream(&state->sound_spec), 1);
+      state->playing_sound_data = false;
       state->request_play = false;
       state->ready_to_play = false;
-    } else {
-      az_reset_sound_data(&state->soundboard, &state->sound_data);
-      state->ready_to_play = true;
     }
-  } else {
+  } else if (state->playing_sound_data) {
     az_persist_sound_data(&state->soundboard, &state->sound_data, 1);
   }
+  update_rendering(state);
 }
 
 /*===========================================================================*/
@@ -30,9 +30,18 @@
 
 typedef struct {
   az_sound_spec_t sound_spec;
-  az_sound_data_t sound_data;
   az_soundboard_t soundboard;
   bool request_play, ready_to_play;
+  // The most recently completed rendering of the sound, which is done on a
+  // background thread, and so may be of an earlier version of sound_spec.
+  // Until it catches up, the sound is played by streaming it instead.
+  bool have_sound_data;
+  az_sound_spec_t sound_data_spec;
+  az_sound_data_t sound_data;
+  bool playing_sound_data;
+  // True if the soundboard most recently handed to az_tick_audio played
+  // sound_data (in which case the audio system may still be using it).
+  bool sent_sound_data;
 } az_zfxr_state_t;
 
 void az_init_zfxr_state(az_zfxr_state_t *state);
@@ -25,9 +25,8 @@
 #include <stddef.h>
 #include <stdio.h>
 
-#include <SDL_opengl.h>
-
 #include "azimuth/constants.h"
+#include "azimuth/gui/opengl.h"
 #include "azimuth/util/misc.h"
 #include "azimuth/util/sound.h"
 #include "azimuth/view/cursor.h"